@@ -23,6 +23,7 @@
 #include "command/ImageBuffersReadyFlyweight.h"
 #include "command/ImageMessageFlyweight.h"
 #include "command/ErrorResponseFlyweight.h"
+#include "command/CorrelatedMessageFlyweight.h"
 
 namespace aeron {
 
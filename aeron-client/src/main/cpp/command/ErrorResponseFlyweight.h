@@ -77,16 +77,34 @@ public:
         return m_struct.offendingCommandCorrelationId;
     }
 
+    inline this_t& offendingCommandCorrelationId(std::int64_t value)
+    {
+        m_struct.offendingCommandCorrelationId = value;
+        return *this;
+    }
+
     inline std::int32_t errorCode() const
     {
         return m_struct.errorCode;
     }
 
+    inline this_t& errorCode(std::int32_t value)
+    {
+        m_struct.errorCode = value;
+        return *this;
+    }
+
     inline std::string errorMessage() const
     {
         return stringGet(offsetof(ErrorResponseDefn, errorMessage));
     }
 
+    inline this_t& errorMessage(const std::string& value)
+    {
+        stringPut(offsetof(ErrorResponseDefn, errorMessage), value);
+        return *this;
+    }
+
     inline util::index_t length() const
     {
         return offsetof(ErrorResponseDefn, errorMessage.errorMessageData) + m_struct.errorMessage.errorMessageLength;
@@ -85,7 +85,7 @@ public:
 
     inline void free(std::int32_t counterId)
     {
-        m_metadataBuffer.putInt32Ordered(counterOffset(counterId), RECORD_RECLAIMED);
+        m_metadataBuffer.putInt32Ordered(metadataOffset(counterId), RECORD_RECLAIMED);
         m_freeList.push_back(counterId);
     }
 
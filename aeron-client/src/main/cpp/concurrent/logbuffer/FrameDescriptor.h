@@ -92,6 +92,11 @@ inline static util::index_t computeMaxMessageLength(util::index_t capacity)
     return capacity / 8;
 }
 
+inline static util::index_t versionOffset(util::index_t frameOffset)
+{
+    return frameOffset + DataFrameHeader::VERSION_FIELD_OFFSET;
+}
+
 inline static util::index_t typeOffset(util::index_t frameOffset)
 {
     return frameOffset + DataFrameHeader::TYPE_FIELD_OFFSET;
@@ -119,7 +124,7 @@ inline static void frameType(AtomicBuffer& logBuffer, util::index_t frameOffset,
 
 inline static std::uint16_t frameType(AtomicBuffer& logBuffer, util::index_t frameOffset)
 {
-    return logBuffer.getUInt16(frameOffset);
+    return logBuffer.getUInt16(typeOffset(frameOffset));
 }
 
 inline static void frameFlags(AtomicBuffer& logBuffer, util::index_t frameOffset, std::uint8_t flags)
@@ -151,7 +156,7 @@ inline static void frameLengthOrdered(AtomicBuffer& logBuffer, util::index_t fra
 
 inline static std::uint8_t frameVersion(AtomicBuffer& logBuffer, util::index_t frameOffset)
 {
-    return logBuffer.getUInt8(frameOffset);
+    return logBuffer.getUInt8(versionOffset(frameOffset));
 }
 
 };
@@ -47,6 +47,12 @@ public:
     {
     }
 
+    UnsafeBufferPosition& operator=(const UnsafeBufferPosition& position)
+    {
+        wrap(position);
+        return *this;
+    }
+
     inline void wrap(const UnsafeBufferPosition& position)
     {
         m_buffer.wrap(position.m_buffer);
@@ -54,7 +60,7 @@ public:
         m_offset = position.m_offset;
     }
 
-    inline std::int32_t id()
+    inline std::int32_t id() const
     {
         return m_id;
     }
@@ -114,6 +114,8 @@ public:
     static const std::int32_t HDR_TYPE_ERR = 0x04;
     /** header type SETUP */
     static const std::int32_t HDR_TYPE_SETUP = 0x05;
+    /** header type RTTM */
+    static const std::int32_t HDR_TYPE_RTTM = 0x06;
     /** header type EXT */
     static const std::int32_t HDR_TYPE_EXT = 0xFFFF;
 
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_COMMAND_RTTMEASUREMENTFLYWEIGHT__
+#define INCLUDED_AERON_COMMAND_RTTMEASUREMENTFLYWEIGHT__
+
+#include <cstdint>
+#include <string>
+#include <stddef.h>
+
+#include "../command/Flyweight.h"
+#include "../concurrent/AtomicBuffer.h"
+#include "../util/Index.h"
+
+#include "HeaderFlyweight.h"
+
+namespace aeron { namespace protocol {
+
+/**
+ * Round trip time measurement between a receiver and the source of an image. The receiver sends a probe stamped with
+ * its own clock and the sender echoes it back with the reply flag set, so the receiver can take the RTT as its clock
+ * now less the echoed timestamp and the time the sender held the probe for.
+ *
+ * <p>
+ *    0                   1                   2                   3
+ *    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+ *   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *   |R|                 Frame Length (=header + data)               |
+ *   +---------------+-+-------------+-------------------------------+
+ *   |   Version     |R|    Flags    |          Type (=0x06)         |
+ *   +---------------+-+-------------+-------------------------------+
+ *   |                          Session ID                           |
+ *   +---------------------------------------------------------------+
+ *   |                           Stream ID                           |
+ *   +---------------------------------------------------------------+
+ *   |                      Echo Timestamp (ns)                      |
+ *   |                                                               |
+ *   +---------------------------------------------------------------+
+ *   |                      Reception Delta (ns)                     |
+ *   |                                                               |
+ *   +---------------------------------------------------------------+
+ */
+
+#pragma pack(push)
+#pragma pack(4)
+struct RttMeasurementDefn
+{
+    HeaderDefn headerDefn;
+    std::int32_t sessionId;
+    std::int32_t streamId;
+    std::int64_t echoTimestampNs;
+    std::int64_t receptionDelta;
+};
+#pragma pack(pop)
+
+class RttMeasurementFlyweight : public HeaderFlyweight
+{
+public:
+    typedef RttMeasurementFlyweight this_t;
+
+    /** flag set by a sender on the echo of a probe */
+    static const std::int8_t REPLY_FLAG = (std::int8_t) 0x80;
+
+    RttMeasurementFlyweight(concurrent::AtomicBuffer& buffer, std::int32_t offset)
+        : HeaderFlyweight(buffer, offset), m_struct(overlayStruct<RttMeasurementDefn>(0))
+    {
+    }
+
+    inline std::int32_t sessionId() const
+    {
+        return m_struct.sessionId;
+    }
+
+    inline this_t& sessionId(std::int32_t value)
+    {
+        m_struct.sessionId = value;
+        return *this;
+    }
+
+    inline std::int32_t streamId() const
+    {
+        return m_struct.streamId;
+    }
+
+    inline this_t& streamId(std::int32_t value)
+    {
+        m_struct.streamId = value;
+        return *this;
+    }
+
+    inline std::int64_t echoTimestampNs() const
+    {
+        return m_struct.echoTimestampNs;
+    }
+
+    inline this_t& echoTimestampNs(std::int64_t value)
+    {
+        m_struct.echoTimestampNs = value;
+        return *this;
+    }
+
+    inline std::int64_t receptionDelta() const
+    {
+        return m_struct.receptionDelta;
+    }
+
+    inline this_t& receptionDelta(std::int64_t value)
+    {
+        m_struct.receptionDelta = value;
+        return *this;
+    }
+
+    inline bool isReply() const
+    {
+        return REPLY_FLAG == (flags() & REPLY_FLAG);
+    }
+
+    inline static constexpr std::int32_t headerLength()
+    {
+        return sizeof(RttMeasurementDefn);
+    }
+
+private:
+    RttMeasurementDefn& m_struct;
+};
+
+}}
+
+#endif //INCLUDED_AERON_COMMAND_RTTMEASUREMENTFLYWEIGHT__
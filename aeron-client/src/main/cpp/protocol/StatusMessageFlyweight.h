@@ -81,6 +81,9 @@ class StatusMessageFlyweight : public HeaderFlyweight
 public:
     typedef StatusMessageFlyweight this_t;
 
+    /** flag set by a receiver asking the sender to send a setup frame */
+    static const std::int8_t SEND_SETUP_FLAG = (std::int8_t) 0x80;
+
     inline StatusMessageFlyweight(concurrent::AtomicBuffer& buffer, util::index_t offset)
         : HeaderFlyweight(buffer, offset), m_struct(overlayStruct<StatusMessageDefn>(0))
     {
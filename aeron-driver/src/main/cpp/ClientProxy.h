@@ -0,0 +1,182 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_CLIENTPROXY__
+#define INCLUDED_AERON_DRIVER_CLIENTPROXY__
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "aeron/command/ControlProtocolEvents.h"
+#include "aeron/command/CorrelatedMessageFlyweight.h"
+#include "aeron/command/ErrorResponseFlyweight.h"
+#include "aeron/command/ImageBuffersReadyFlyweight.h"
+#include "aeron/command/ImageMessageFlyweight.h"
+#include "aeron/command/PublicationBuffersReadyFlyweight.h"
+#include "aeron/concurrent/broadcast/BroadcastTransmitter.h"
+
+namespace aeron { namespace driver {
+
+using namespace aeron::command;
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::broadcast;
+
+/**
+ * Replies from the driver to clients over the to-clients broadcast buffer, the counterpart of the DriverProxy of the
+ * client.
+ */
+class ClientProxy
+{
+public:
+    static const std::size_t MAX_ERROR_MESSAGE_LENGTH = 1024;
+
+    ClientProxy(BroadcastTransmitter& transmitter)
+        : m_transmitter(transmitter)
+    {
+    }
+
+    ClientProxy(const ClientProxy& proxy) = delete;
+    ClientProxy& operator=(const ClientProxy& proxy) = delete;
+
+    void onError(std::int64_t correlationId, std::int32_t errorCode, const std::string& errorMessage)
+    {
+        transmit([&](AtomicBuffer& buffer, util::index_t& length)
+        {
+            ErrorResponseFlyweight errorResponse(buffer, 0);
+
+            errorResponse
+                .offendingCommandCorrelationId(correlationId)
+                .errorCode(errorCode)
+                .errorMessage(errorMessage.substr(0, MAX_ERROR_MESSAGE_LENGTH));
+
+            length = errorResponse.length();
+
+            return ControlProtocolEvents::ON_ERROR;
+        });
+    }
+
+    void onPublicationReady(
+        std::int64_t correlationId,
+        std::int32_t streamId,
+        std::int32_t sessionId,
+        std::int32_t positionLimitCounterId,
+        const std::string& logFileName)
+    {
+        transmit([&](AtomicBuffer& buffer, util::index_t& length)
+        {
+            PublicationBuffersReadyFlyweight publicationReady(buffer, 0);
+
+            publicationReady
+                .correlationId(correlationId)
+                .streamId(streamId)
+                .sessionId(sessionId)
+                .positionLimitCounterId(positionLimitCounterId)
+                .logFileName(logFileName);
+
+            length = publicationReady.length();
+
+            return ControlProtocolEvents::ON_PUBLICATION_READY;
+        });
+    }
+
+    void onAvailableImage(
+        std::int64_t correlationId,
+        std::int32_t streamId,
+        std::int32_t sessionId,
+        const std::vector<ImageBuffersReadyDefn::SubscriberPosition>& subscriberPositions,
+        const std::string& logFileName,
+        const std::string& sourceIdentity)
+    {
+        transmit([&](AtomicBuffer& buffer, util::index_t& length)
+        {
+            ImageBuffersReadyFlyweight imageReady(buffer, 0);
+
+            imageReady
+                .correlationId(correlationId)
+                .streamId(streamId)
+                .sessionId(sessionId)
+                .subscriberPositionCount((std::int32_t) subscriberPositions.size());
+
+            for (std::size_t i = 0; i < subscriberPositions.size(); i++)
+            {
+                imageReady.subscriberPosition((std::int32_t) i, subscriberPositions[i]);
+            }
+
+            imageReady
+                .logFileName(logFileName)
+                .sourceIdentity(sourceIdentity);
+
+            length = imageReady.length();
+
+            return ControlProtocolEvents::ON_AVAILABLE_IMAGE;
+        });
+    }
+
+    void onUnavailableImage(std::int64_t correlationId, std::int32_t streamId, const std::string& channel)
+    {
+        transmit([&](AtomicBuffer& buffer, util::index_t& length)
+        {
+            ImageMessageFlyweight imageMessage(buffer, 0);
+
+            imageMessage
+                .correlationId(correlationId)
+                .streamId(streamId)
+                .channel(channel);
+
+            length = imageMessage.length();
+
+            return ControlProtocolEvents::ON_UNAVAILABLE_IMAGE;
+        });
+    }
+
+    void operationSucceeded(std::int64_t correlationId)
+    {
+        transmit([&](AtomicBuffer& buffer, util::index_t& length)
+        {
+            CorrelatedMessageFlyweight correlatedMessage(buffer, 0);
+
+            correlatedMessage.clientId(0);
+            correlatedMessage.correlationId(correlationId);
+
+            length = CORRELATED_MESSAGE_LENGTH;
+
+            return ControlProtocolEvents::ON_OPERATION_SUCCESS;
+        });
+    }
+
+private:
+    typedef std::array<std::uint8_t, 4096> client_proxy_message_buffer_t;
+
+    BroadcastTransmitter& m_transmitter;
+
+    inline void transmit(const std::function<std::int32_t(AtomicBuffer&, util::index_t&)>& filler)
+    {
+        AERON_DECL_ALIGNED(client_proxy_message_buffer_t messageBuffer, 16);
+        AtomicBuffer buffer(&messageBuffer[0], messageBuffer.size());
+        util::index_t length = messageBuffer.size();
+
+        const std::int32_t msgTypeId = filler(buffer, length);
+
+        m_transmitter.transmit(msgTypeId, buffer, 0, length);
+    }
+};
+
+}};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_CONGESTIONCONTROL__
+#define INCLUDED_AERON_DRIVER_CONGESTIONCONTROL__
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include "aeron/concurrent/AtomicCounter.h"
+#include "aeron/concurrent/status/Position.h"
+#include "aeron/concurrent/status/UnsafeBufferPosition.h"
+
+namespace aeron { namespace driver {
+
+/**
+ * Strategy for deciding the window a PublicationImage advertises in its status messages, so a source sharing a
+ * congested path with others backs off rather than sending at the limit of the receiver window. Called from the
+ * Receiver duty cycle only.
+ */
+class CongestionControl
+{
+public:
+    virtual ~CongestionControl() = default;
+
+    /**
+     * Decide the window for a status message that is about to be sent.
+     *
+     * @param nowNs                current time.
+     * @param receiverWindowLength tuned to how fast the subscribers drain the image.
+     * @return the window to advertise, no more than the receiver window.
+     */
+    virtual std::int32_t onStatusMessage(std::int64_t nowNs, std::int32_t receiverWindowLength) = 0;
+
+    /**
+     * Loss has been NAKed for the image.
+     *
+     * @param nowNs current time.
+     */
+    virtual void onLoss(std::int64_t nowNs)
+    {
+    }
+
+    /**
+     * The round trip time to the source of the image has been measured.
+     *
+     * @param nowNs current time.
+     * @param rttNs measured.
+     */
+    virtual void onRttMeasurement(std::int64_t nowNs, std::int64_t rttNs)
+    {
+    }
+};
+
+/**
+ * Advertises the receiver window as it is, the default.
+ */
+class StaticWindowCongestionControl : public CongestionControl
+{
+public:
+    virtual std::int32_t onStatusMessage(std::int64_t nowNs, std::int32_t receiverWindowLength) override
+    {
+        return receiverWindowLength;
+    }
+};
+
+/**
+ * Keeps a congestion window that follows the CUBIC growth function of RFC 8312 and advertises the smaller of it and
+ * the receiver window.
+ *
+ * On loss the window is cut by BETA and the size it had is remembered. It then grows back along a cubic in the time
+ * since the cut that is concave up to the remembered size and convex beyond it, so it settles near the size loss was
+ * last seen at and then probes for more. The window never grows slower than a Reno flow would over the measured RTT,
+ * nor beyond the receiver window it is advertised against, and further loss within an RTT of a cut is taken to be
+ * from the same congestion event. Cuts are counted in the congestion window reductions system counter, and the window
+ * is published to a counter of the image, if given one, each time it changes.
+ */
+class CubicCongestionControl : public CongestionControl
+{
+public:
+    typedef aeron::concurrent::status::Position<aeron::concurrent::status::UnsafeBufferPosition> position_t;
+
+    static constexpr double C = 0.4;
+    static constexpr double BETA = 0.7;
+    static const std::int64_t DEFAULT_RTT_NS = 100 * 1000;
+
+    /**
+     * @param nowNs               current time, at which the window starts growing.
+     * @param initialWindowLength the window starts at.
+     * @param segmentLength       the window grows and is cut in, the MTU of the image.
+     * @param windowReductions    counter of cuts to the window, or nullptr.
+     * @param windowPosition      the window is published to, or nullptr.
+     */
+    CubicCongestionControl(
+        std::int64_t nowNs,
+        std::int32_t initialWindowLength,
+        std::int32_t segmentLength,
+        aeron::concurrent::AtomicCounter* windowReductions = nullptr,
+        std::unique_ptr<position_t> windowPosition = std::unique_ptr<position_t>(nullptr))
+        : m_segmentLength(segmentLength),
+          m_minWindowLength(2 * segmentLength),
+          m_windowReductions(windowReductions),
+          m_windowPosition(std::move(windowPosition)),
+          m_epochStartNs(nowNs),
+          m_windowMaxSegments(std::max(initialWindowLength, m_minWindowLength) / (double) segmentLength),
+          m_windowLength(std::max(initialWindowLength, m_minWindowLength))
+    {
+        publishWindowLength();
+    }
+
+    virtual std::int32_t onStatusMessage(std::int64_t nowNs, std::int32_t receiverWindowLength) override
+    {
+        const double t = (nowNs - m_epochStartNs) / 1e9;
+        const double rtt = m_rttNs / 1e9;
+        const double cubicSegments = C * std::pow(t - m_k, 3) + m_windowMaxSegments;
+        const double renoSegments =
+            (m_windowMaxSegments * BETA) + ((3 * (1 - BETA) / (1 + BETA)) * (t / rtt));
+
+        // held to the receiver window, as a cut from a size never advertised would not slow the source down
+        const double windowLength = std::max(cubicSegments, renoSegments) * m_segmentLength;
+        m_windowLength = (std::int32_t) std::max<double>(
+            m_minWindowLength, std::min<double>(windowLength, receiverWindowLength));
+        publishWindowLength();
+
+        return std::min(m_windowLength, receiverWindowLength);
+    }
+
+    virtual void onLoss(std::int64_t nowNs) override
+    {
+        if (nowNs - m_epochStartNs < m_rttNs)
+        {
+            return;
+        }
+
+        m_windowMaxSegments = m_windowLength / (double) m_segmentLength;
+        m_windowLength = std::max((std::int32_t) (m_windowLength * BETA), m_minWindowLength);
+        m_k = std::cbrt(m_windowMaxSegments * (1 - BETA) / C);
+        m_epochStartNs = nowNs;
+        publishWindowLength();
+
+        if (nullptr != m_windowReductions)
+        {
+            m_windowReductions->orderedIncrement();
+        }
+    }
+
+    virtual void onRttMeasurement(std::int64_t nowNs, std::int64_t rttNs) override
+    {
+        if (rttNs > 0)
+        {
+            m_rttNs = rttNs;
+        }
+    }
+
+    inline std::int32_t windowLength() const
+    {
+        return m_windowLength;
+    }
+
+private:
+    const std::int32_t m_segmentLength;
+    const std::int32_t m_minWindowLength;
+    aeron::concurrent::AtomicCounter* m_windowReductions;
+    std::unique_ptr<position_t> m_windowPosition;
+    std::int64_t m_epochStartNs;
+    std::int64_t m_rttNs = DEFAULT_RTT_NS;
+    double m_windowMaxSegments;
+    double m_k = 0;
+    std::int32_t m_windowLength;
+
+    inline void publishWindowLength()
+    {
+        if (nullptr != m_windowPosition)
+        {
+            m_windowPosition->setOrdered(m_windowLength);
+        }
+    }
+};
+
+}};
+
+#endif
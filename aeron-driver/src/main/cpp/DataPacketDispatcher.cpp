@@ -41,13 +41,19 @@ void DataPacketDispatcher::removeCoolDown(std::int32_t sessionId, std::int32_t s
     }
 }
 
+void DataPacketDispatcher::updateDirectReceiveImage()
+{
+    PublicationImage* soleImage = nullptr;
+    std::size_t imageCount = 0;
 
+    for (auto& sessions : m_sessionsByStreamId)
+    {
+        imageCount += sessions.second.size();
+        if (!sessions.second.empty())
+        {
+            soleImage = sessions.second.begin()->second.get();
+        }
+    }
 
-
-
-
-
-
-
-
-
+    m_directReceiveImage = 1 == imageCount ? soleImage : nullptr;
+}
@@ -70,8 +70,8 @@ public:
 
     DataPacketDispatcher(
         std::shared_ptr<DriverConductorProxy> driverConductorProxy,
-        std::shared_ptr<Receiver> receiver) :
-        m_receiver(std::move(receiver)),
+        Receiver& receiver) :
+        m_receiver(receiver),
         m_driverConductorProxy(std::move(driverConductorProxy))
     {}
 
@@ -106,7 +106,7 @@ public:
 
                 channelEndpoint.sendSetupElicitingStatusMessage(controlAddress, sessionId, streamId);
 
-                m_receiver->addPendingSetupMessage(sessionId, streamId, channelEndpoint);
+                m_receiver.addPendingSetupMessage(sessionId, streamId, channelEndpoint);
             }
         }
 
@@ -153,6 +153,30 @@ public:
         }
     }
 
+    /**
+     * Hand the echo of an RTT probe back to the image that sent it, probes from other receivers are ignored.
+     */
+    inline void onRttMeasurement(
+        ReceiveChannelEndpoint& channelEndpoint,
+        RttMeasurementFlyweight& header,
+        InetAddress& srcAddress)
+    {
+        if (!header.isReply())
+        {
+            return;
+        }
+
+        auto sessions = m_sessionsByStreamId.find(header.streamId());
+        if (sessions != m_sessionsByStreamId.end())
+        {
+            auto session = sessions->second.find(header.sessionId());
+            if (session != sessions->second.end())
+            {
+                session->second->onRttMeasurement(header.echoTimestampNs(), header.receptionDelta());
+            }
+        }
+    }
+
     void removePendingSetup(std::int32_t sessionId, std::int32_t streamId);
 
     inline void addSubscription(std::int32_t streamId)
@@ -179,6 +203,9 @@ public:
         {
             it->second->ifActiveGoInactive();
         }
+
+        m_sessionsByStreamId.erase(sessionsItr);
+        updateDirectReceiveImage();
     }
 
     inline void addPublicationImage(PublicationImage::ptr_t image)
@@ -195,6 +222,7 @@ public:
 
         sessionsItr->second[sessionId] = image;
         m_ignoredSessions.erase({sessionId, streamId});
+        updateDirectReceiveImage();
 
         image->status(PublicationImageStatus::ACTIVE);
     }
@@ -209,6 +237,7 @@ public:
         {
             sessionsItr->second.erase(sessionId);
             m_ignoredSessions.erase({sessionId, streamId});
+            updateDirectReceiveImage();
         }
 
         image->ifActiveGoInactive();
@@ -217,11 +246,23 @@ public:
 
     void removeCoolDown(std::int32_t sessionId, std::int32_t streamId);
 
+    /**
+     * The image that datagrams can be received straight into, which is only the case while it is the sole image on
+     * the channel endpoint so the next datagram can be expected to belong to it.
+     */
+    inline PublicationImage* directReceiveImage() const
+    {
+        return m_directReceiveImage;
+    }
+
 private:
-    std::shared_ptr<Receiver> m_receiver;
+    Receiver& m_receiver;
     std::shared_ptr<DriverConductorProxy> m_driverConductorProxy;
     std::unordered_map<std::pair<std::int32_t, std::int32_t>, SessionStatus, Hasher> m_ignoredSessions;
     std::unordered_map<std::int32_t,std::unordered_map<std::int32_t, PublicationImage::ptr_t>> m_sessionsByStreamId;
+    PublicationImage* m_directReceiveImage = nullptr;
+
+    void updateDirectReceiveImage();
 };
 
 }}
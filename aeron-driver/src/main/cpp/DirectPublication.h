@@ -0,0 +1,271 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_DIRECTPUBLICATION__
+#define INCLUDED_AERON_DRIVER_DIRECTPUBLICATION__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "aeron/concurrent/AtomicBuffer.h"
+#include "aeron/concurrent/logbuffer/LogBufferDescriptor.h"
+#include "aeron/concurrent/status/UnsafeBufferPosition.h"
+#include "aeron/util/BitUtil.h"
+
+#include "buffer/MappedRawLog.h"
+
+namespace aeron { namespace driver {
+
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::logbuffer;
+using namespace aeron::concurrent::status;
+using namespace aeron::driver::buffer;
+
+/**
+ * A publication over an aeron:ipc channel, whose log is appended to by publishers and read in place by subscribers of
+ * the same stream on the same host, so nothing is sent or received over the network.
+ *
+ * The publisher limit is the minimum subscriber position plus a window of half a term, which keeps publishers from
+ * lapping the slowest subscriber. Without subscribers the limit is held at the consumer position so publishers are
+ * back pressured until a subscriber joins. Everything more than a term behind the slowest subscriber is cleaned so the
+ * term is zeroed before publishers append to it again.
+ */
+class DirectPublication
+{
+public:
+    typedef std::shared_ptr<DirectPublication> ptr_t;
+
+    DirectPublication(
+        const std::int64_t registrationId,
+        const std::int32_t sessionId,
+        const std::int32_t streamId,
+        const std::int32_t initialTermId,
+        std::unique_ptr<MappedRawLog> rawLog,
+        std::unique_ptr<Position<UnsafeBufferPosition>> publisherLimit)
+        : m_registrationId(registrationId), m_sessionId(sessionId), m_streamId(streamId),
+        m_initialTermId(initialTermId), m_rawLog(std::move(rawLog)), m_publisherLimit(std::move(publisherLimit))
+    {
+        const std::int32_t termLength = m_rawLog->termLength();
+
+        m_termLengthMask = termLength - 1;
+        m_termWindowLength = termLength / 2;
+        m_positionBitsToShift = util::BitUtil::numberOfTrailingZeroes(termLength);
+        m_consumerPosition = producerPosition();
+        m_cleanPosition = m_consumerPosition;
+        m_publisherLimit->setOrdered(m_consumerPosition);
+    }
+
+    inline std::int64_t registrationId() const
+    {
+        return m_registrationId;
+    }
+
+    inline std::int32_t sessionId() const
+    {
+        return m_sessionId;
+    }
+
+    inline std::int32_t streamId() const
+    {
+        return m_streamId;
+    }
+
+    inline std::int32_t termBufferLength() const
+    {
+        return m_termLengthMask + 1;
+    }
+
+    inline const char* logFileName()
+    {
+        return m_rawLog->logFileName();
+    }
+
+    inline std::int32_t publisherLimitId()
+    {
+        return m_publisherLimit->id();
+    }
+
+    inline std::int64_t publisherLimit()
+    {
+        return m_publisherLimit->get();
+    }
+
+    inline std::size_t subscriberCount() const
+    {
+        return m_subscriberPositions.size();
+    }
+
+    /**
+     * Position up to which publishers have claimed space in the log, from the tail counter of the active term.
+     */
+    inline std::int64_t producerPosition()
+    {
+        AtomicBuffer& logMetaDataBuffer = m_rawLog->logMetaDataBuffer();
+        const std::int32_t partitionIndex = LogBufferDescriptor::activePartitionIndex(logMetaDataBuffer);
+        const std::int64_t rawTail = logMetaDataBuffer.getInt64Volatile(
+            LogBufferDescriptor::TERM_TAIL_COUNTER_OFFSET + (partitionIndex * sizeof(std::int64_t)));
+        const std::int32_t termLength = m_termLengthMask + 1;
+
+        return LogBufferDescriptor::computePosition(
+            LogBufferDescriptor::termId(rawTail),
+            LogBufferDescriptor::termOffset(rawTail, termLength),
+            m_positionBitsToShift,
+            m_initialTermId);
+    }
+
+    /**
+     * Position a subscriber linked from now on starts reading from, which is the furthest any subscriber has got so
+     * it does not see what has already been consumed.
+     */
+    inline std::int64_t joiningPosition() const
+    {
+        return m_consumerPosition;
+    }
+
+    /**
+     * Track the position of a subscription to the stream, which should have been set to the joining position.
+     */
+    inline void addSubscriberPosition(ReadablePosition<UnsafeBufferPosition>& position)
+    {
+        m_subscriberPositions.push_back(position);
+    }
+
+    inline void removeSubscriberPosition(std::int32_t counterId)
+    {
+        for (auto it = m_subscriberPositions.begin(); it != m_subscriberPositions.end(); ++it)
+        {
+            if (it->id() == counterId)
+            {
+                m_subscriberPositions.erase(it);
+                break;
+            }
+        }
+    }
+
+    /**
+     * Move the publisher limit on from the subscriber positions, called from the DriverConductor duty cycle.
+     *
+     * @return 1 if the limit was changed otherwise 0.
+     */
+    inline std::int32_t updatePublisherLimit()
+    {
+        std::int64_t proposedLimit = m_consumerPosition;
+
+        if (!m_subscriberPositions.empty())
+        {
+            std::int64_t minSubscriberPosition = std::numeric_limits<std::int64_t>::max();
+            std::int64_t maxSubscriberPosition = m_consumerPosition;
+
+            for (auto& position : m_subscriberPositions)
+            {
+                const std::int64_t subscriberPosition = position.getVolatile();
+                minSubscriberPosition = std::min(minSubscriberPosition, subscriberPosition);
+                maxSubscriberPosition = std::max(maxSubscriberPosition, subscriberPosition);
+            }
+
+            m_consumerPosition = maxSubscriberPosition;
+            proposedLimit = minSubscriberPosition + m_termWindowLength;
+        }
+
+        if (proposedLimit != m_publisherLimit->get())
+        {
+            m_publisherLimit->setOrdered(proposedLimit);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    /**
+     * Zero what lies more than a term behind the slowest subscriber, called from the DriverConductor duty cycle.
+     *
+     * @return number of bytes cleaned.
+     */
+    inline std::int32_t cleanLogBuffer()
+    {
+        const std::int32_t termLength = m_termLengthMask + 1;
+        const std::int64_t cleanLimit = minConsumerPosition() - termLength;
+        const std::int64_t cleanPosition = m_cleanPosition;
+
+        if (cleanLimit <= cleanPosition)
+        {
+            return 0;
+        }
+
+        const std::int32_t termOffset = (std::int32_t) cleanPosition & m_termLengthMask;
+        const std::int32_t length =
+            (std::int32_t) std::min<std::int64_t>(cleanLimit - cleanPosition, termLength - termOffset);
+
+        m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(cleanPosition, m_positionBitsToShift))
+            .setMemory(termOffset, length, 0);
+        m_cleanPosition = cleanPosition + length;
+
+        return length;
+    }
+
+    /**
+     * Have all subscribers consumed everything appended, which is trivially so once there are none.
+     */
+    inline bool isDrained()
+    {
+        const std::int64_t producerPosition = this->producerPosition();
+
+        for (auto& position : m_subscriberPositions)
+        {
+            if (position.getVolatile() < producerPosition)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    inline std::int64_t minConsumerPosition()
+    {
+        std::int64_t minPosition = m_consumerPosition;
+
+        for (auto& position : m_subscriberPositions)
+        {
+            minPosition = std::min(minPosition, position.getVolatile());
+        }
+
+        return minPosition;
+    }
+
+    const std::int64_t m_registrationId;
+    const std::int32_t m_sessionId;
+    const std::int32_t m_streamId;
+    const std::int32_t m_initialTermId;
+    std::int32_t m_termLengthMask = 0;
+    std::int32_t m_termWindowLength = 0;
+    std::int32_t m_positionBitsToShift = 0;
+
+    std::int64_t m_consumerPosition = 0;
+    std::int64_t m_cleanPosition = 0;
+
+    std::unique_ptr<MappedRawLog> m_rawLog;
+    std::unique_ptr<Position<UnsafeBufferPosition>> m_publisherLimit;
+    std::vector<ReadablePosition<UnsafeBufferPosition>> m_subscriberPositions;
+};
+
+}};
+
+#endif
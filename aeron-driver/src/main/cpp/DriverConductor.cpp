@@ -0,0 +1,1338 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <sstream>
+
+#include "aeron/command/ControlProtocolEvents.h"
+#include "aeron/command/CorrelatedMessageFlyweight.h"
+#include "aeron/command/ErrorResponseFlyweight.h"
+#include "aeron/command/PublicationMessageFlyweight.h"
+#include "aeron/command/RemoveMessageFlyweight.h"
+#include "aeron/command/SubscriptionMessageFlyweight.h"
+#include "aeron/concurrent/logbuffer/DataFrameHeader.h"
+#include "aeron/concurrent/logbuffer/LogBufferDescriptor.h"
+#include "aeron/protocol/DataHeaderFlyweight.h"
+#include "aeron/util/Exceptions.h"
+#include "aeron/util/StringUtil.h"
+
+#include "status/StreamPositionCounter.h"
+#include "uri/AeronUri.h"
+
+#include "DataPacketDispatcher.h"
+#include "DriverConductor.h"
+#include "DriverConductorProxy.h"
+
+using namespace aeron::command;
+using namespace aeron::driver;
+using namespace aeron::driver::status;
+using namespace aeron::protocol;
+using namespace aeron::util;
+
+static const char* PUBLICATIONS_DIR = "publications";
+static const char* IMAGES_DIR = "images";
+static const char* IPC_CHANNEL = "aeron:ipc";
+static const std::string SPY_PREFIX = "aeron-spy:";
+
+static bool isIpcChannel(const std::string& channel)
+{
+    std::string uriString{channel};
+    std::unique_ptr<uri::AeronUri> aeronUri{uri::AeronUri::parse(uriString)};
+
+    return "ipc" == aeronUri->media();
+}
+
+static void ensureDirectory(const std::string& path)
+{
+    if (0 != ::mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IRWXO) && EEXIST != errno)
+    {
+        throw IOException(strPrintf("could not create directory %s: %s", path.c_str(), strerror(errno)), SOURCEINFO);
+    }
+}
+
+static void initialiseLogMetaData(
+    AtomicBuffer& logMetaDataBuffer,
+    std::int64_t correlationId,
+    std::int32_t initialTermId,
+    std::int32_t mtuLength,
+    std::int32_t sessionId,
+    std::int32_t streamId)
+{
+    const std::int64_t rawTail = (std::int64_t) (((std::uint64_t) (std::uint32_t) initialTermId) << 32);
+
+    logMetaDataBuffer.putInt64(LogBufferDescriptor::TERM_TAIL_COUNTER_OFFSET, rawTail);
+    logMetaDataBuffer.putInt32(LogBufferDescriptor::LOG_ACTIVE_PARTITION_INDEX_OFFSET, 0);
+    logMetaDataBuffer.putInt64(offsetof(LogBufferDescriptor::LogMetaDataDefn, correlationId), correlationId);
+    logMetaDataBuffer.putInt32(LogBufferDescriptor::LOG_INITIAL_TERM_ID_OFFSET, initialTermId);
+    logMetaDataBuffer.putInt32(LogBufferDescriptor::LOG_MTU_LENGTH_OFFSET, mtuLength);
+    logMetaDataBuffer.putInt32(LogBufferDescriptor::LOG_DEFAULT_FRAME_HEADER_LENGTH_OFFSET, DataFrameHeader::LENGTH);
+
+    DataHeaderFlyweight defaultHeader{
+        logMetaDataBuffer, LogBufferDescriptor::LOG_DEFAULT_FRAME_HEADER_OFFSET};
+    defaultHeader
+        .sessionId(sessionId)
+        .streamId(streamId)
+        .termId(initialTermId)
+        .termOffset(0)
+        .version(HeaderFlyweight::CURRENT_VERSION)
+        .flags((std::int8_t) FrameDescriptor::UNFRAGMENTED)
+        .type(HeaderFlyweight::HDR_TYPE_DATA)
+        .frameLength(0);
+}
+
+DriverConductor::DriverConductor(
+    const MediaDriver::Context& context,
+    AtomicBuffer& toDriverBuffer,
+    AtomicBuffer& toClientsBuffer,
+    AtomicBuffer& countersMetadataBuffer,
+    AtomicBuffer& countersValuesBuffer,
+    std::shared_ptr<Sender> sender,
+    std::shared_ptr<Receiver> receiver,
+    nano_clock_t nanoClock,
+    epoch_clock_t epochClock) :
+    m_context(context),
+    m_toDriverCommands(toDriverBuffer),
+    m_toClients(toClientsBuffer),
+    m_clientProxy(m_toClients),
+    m_countersValuesBuffer(countersValuesBuffer),
+    m_countersManager(countersMetadataBuffer, countersValuesBuffer),
+    m_systemCounters(m_countersManager),
+    m_sender(sender),
+    m_receiver(receiver),
+    m_senderProxy(m_context.threadingMode(), std::move(sender)),
+    m_receiverProxy(m_context.threadingMode(), std::move(receiver)),
+    m_conductorProxy(std::make_shared<DriverConductorProxy>(m_context.threadingMode(), this)),
+    m_unicastFeedbackDelayGenerator(m_context.nakUnicastDelayNs(), true),
+    m_multicastFeedbackDelayGenerator(m_context.nakMulticastMaxBackoffNs(), m_context.nakMulticastGroupSize()),
+    m_retransmitDelayGenerator(m_context.retransmitDelayNs(), 0 == m_context.retransmitDelayNs()),
+    m_retransmitLingerGenerator(m_context.retransmitLingerNs(), false),
+    m_nanoClock(nanoClock),
+    m_epochClock(epochClock),
+    m_random(std::random_device{}())
+{
+    ensureDirectory(m_context.aeronDir());
+    ensureDirectory(m_context.aeronDir() + "/" + PUBLICATIONS_DIR);
+    ensureDirectory(m_context.aeronDir() + "/" + IMAGES_DIR);
+
+    m_sender->queueingDelayCounter(
+        Sender::HIGH_PRIORITY, m_systemCounters.get(status::SystemCounterDescriptor::HIGH_PRIORITY_QUEUEING_DELAY));
+    m_sender->queueingDelayCounter(
+        Sender::NORMAL_PRIORITY, m_systemCounters.get(status::SystemCounterDescriptor::NORMAL_PRIORITY_QUEUEING_DELAY));
+    m_sender->queueingDelayCounter(
+        Sender::LOW_PRIORITY, m_systemCounters.get(status::SystemCounterDescriptor::LOW_PRIORITY_QUEUEING_DELAY));
+
+    m_nextSessionId = (std::int32_t) m_random();
+    m_timeOfLastTimerCheckNs = m_nanoClock();
+    m_toDriverCommands.consumerHeartbeatTime(m_epochClock());
+}
+
+DriverConductor::~DriverConductor()
+{
+    close();
+}
+
+void DriverConductor::close()
+{
+    // the agents have stopped by the time the conductor is closed, so the Sender and Receiver are released directly
+    for (auto& entry : m_publications)
+    {
+        m_sender->onRemoveNetworkPublication(*entry.publication);
+    }
+
+    // images refer back to their endpoint so the dispatchers must let go of them for the endpoints to be released
+    for (auto& entry : m_images)
+    {
+        entry.dispatcher->removePublicationImage(entry.image);
+        m_receiver->onRemovePublicationImage(entry.image);
+    }
+
+    for (auto& entry : m_receiveChannelEndpoints)
+    {
+        m_receiver->onCloseReceiveChannelEndpoint(*entry.second.endpoint);
+    }
+
+    m_publicationLinks.clear();
+    m_subscriptionLinks.clear();
+    m_publications.clear();
+    m_directPublications.clear();
+    m_images.clear();
+    m_sendChannelEndpoints.clear();
+    m_receiveChannelEndpoints.clear();
+    m_clients.clear();
+}
+
+std::int32_t DriverConductor::doWork()
+{
+    std::int32_t workCount = m_commandQueue.drain();
+
+    workCount += m_toDriverCommands.read(
+        [&](std::int32_t msgTypeId, AtomicBuffer& buffer, util::index_t offset, util::index_t length)
+        {
+            onClientCommand(msgTypeId, buffer, offset, length);
+        });
+
+    workCount += updatePublications();
+
+    const std::int64_t nowNs = m_nanoClock();
+    if (nowNs > (m_timeOfLastTimerCheckNs + TIMER_INTERVAL_NS))
+    {
+        onCheckTimers(nowNs);
+        m_timeOfLastTimerCheckNs = nowNs;
+        workCount++;
+    }
+
+    return workCount;
+}
+
+void DriverConductor::onClientCommand(
+    std::int32_t msgTypeId, AtomicBuffer& buffer, util::index_t offset, util::index_t length)
+{
+    CorrelatedMessageFlyweight correlatedMessage{buffer, offset};
+    const std::int64_t correlationId = correlatedMessage.correlationId();
+    const std::int64_t clientId = correlatedMessage.clientId();
+
+    try
+    {
+        onClientKeepalive(clientId);
+
+        switch (msgTypeId)
+        {
+            case ControlProtocolEvents::ADD_PUBLICATION:
+            {
+                PublicationMessageFlyweight publicationMessage{buffer, offset};
+                onAddPublication(publicationMessage.channel(), publicationMessage.streamId(), correlationId, clientId);
+            }
+            break;
+
+            case ControlProtocolEvents::REMOVE_PUBLICATION:
+            {
+                RemoveMessageFlyweight removeMessage{buffer, offset};
+                onRemovePublication(removeMessage.registrationId(), correlationId);
+            }
+            break;
+
+            case ControlProtocolEvents::ADD_SUBSCRIPTION:
+            {
+                SubscriptionMessageFlyweight subscriptionMessage{buffer, offset};
+                onAddSubscription(
+                    subscriptionMessage.channel(), subscriptionMessage.streamId(), correlationId, clientId);
+            }
+            break;
+
+            case ControlProtocolEvents::REMOVE_SUBSCRIPTION:
+            {
+                RemoveMessageFlyweight removeMessage{buffer, offset};
+                onRemoveSubscription(removeMessage.registrationId(), correlationId);
+            }
+            break;
+
+            case ControlProtocolEvents::CLIENT_KEEPALIVE:
+                break;
+
+            default:
+                throw IllegalArgumentException(strPrintf("unknown command type %d", msgTypeId), SOURCEINFO);
+        }
+    }
+    catch (const InvalidChannelException& e)
+    {
+        m_clientProxy.onError(correlationId, ERROR_CODE_INVALID_CHANNEL, e.what());
+    }
+    catch (const RegistrationException& e)
+    {
+        m_clientProxy.onError(correlationId, e.errorCode(), e.what());
+    }
+    catch (const std::exception& e)
+    {
+        m_clientProxy.onError(correlationId, ERROR_CODE_GENERIC_ERROR, e.what());
+    }
+}
+
+static bool isSpyChannel(const std::string& channel)
+{
+    return 0 == channel.compare(0, SPY_PREFIX.length(), SPY_PREFIX);
+}
+
+void DriverConductor::onAddPublication(
+    const std::string& channel, std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId)
+{
+    if (isIpcChannel(channel))
+    {
+        onAddDirectPublication(streamId, registrationId, clientId);
+        return;
+    }
+
+    std::unique_ptr<UdpChannel> udpChannel = UdpChannel::parse(channel.c_str());
+    const std::string canonicalForm = udpChannel->canonicalForm();
+    PublicationEntry* entry = nullptr;
+
+    for (auto& candidate : m_publications)
+    {
+        if (PUBLICATION_ACTIVE == candidate.status &&
+            streamId == candidate.publication->streamId() &&
+            canonicalForm == candidate.channel)
+        {
+            entry = &candidate;
+            break;
+        }
+    }
+
+    if (nullptr == entry)
+    {
+        entry = &newNetworkPublication(udpChannel, streamId, registrationId);
+    }
+
+    entry->refCount++;
+    m_publicationLinks.push_back(PublicationLink{registrationId, clientId, entry->publication.get(), nullptr});
+
+    m_clientProxy.onPublicationReady(
+        registrationId,
+        streamId,
+        entry->publication->sessionId(),
+        entry->publisherLimit->id(),
+        entry->publication->logFileName());
+}
+
+DriverConductor::PublicationEntry& DriverConductor::newNetworkPublication(
+    std::unique_ptr<UdpChannel>& udpChannel, std::int32_t streamId, std::int64_t registrationId)
+{
+    const std::string canonicalForm = udpChannel->canonicalForm();
+    const std::int32_t termLength = m_context.termBufferLength();
+    LogBufferDescriptor::checkTermLength(termLength);
+
+    std::unique_ptr<FlowControl> flowControl = newFlowControl(*udpChannel);
+    std::unique_ptr<TokenBucket> pacer = newPacer(*udpChannel);
+    const std::int32_t priority = priorityClass(*udpChannel);
+    std::shared_ptr<SendChannelEndpoint> endpoint = getOrCreateSendChannelEndpoint(udpChannel);
+
+    const std::int32_t sessionId = m_nextSessionId++;
+    const std::int32_t initialTermId = (std::int32_t) m_random();
+    const std::string logFile = logFileName(PUBLICATIONS_DIR, registrationId);
+
+    std::unique_ptr<MappedRawLog> rawLog{new MappedRawLog{logFile.c_str(), false, termLength}};
+    initialiseLogMetaData(
+        rawLog->logMetaDataBuffer(), registrationId, initialTermId, m_context.mtuLength(), sessionId, streamId);
+
+    UnsafeBufferPosition publisherLimit{
+        m_countersValuesBuffer,
+        allocatePositionCounter(
+            "publisher limit",
+            StreamPositionCounter::PUBLISHER_LIMIT_TYPE_ID,
+            registrationId, sessionId, streamId, canonicalForm)};
+    UnsafeBufferPosition senderPosition{
+        m_countersValuesBuffer,
+        allocatePositionCounter(
+            "sender pos", StreamPositionCounter::SENDER_POSITION_TYPE_ID,
+            registrationId, sessionId, streamId, canonicalForm)};
+    UnsafeBufferPosition senderLimit{
+        m_countersValuesBuffer,
+        allocatePositionCounter(
+            "sender limit", StreamPositionCounter::SENDER_LIMIT_TYPE_ID,
+            registrationId, sessionId, streamId, canonicalForm)};
+
+    NetworkPublication::ptr_t publication = std::make_shared<NetworkPublication>(
+        registrationId,
+        sessionId,
+        streamId,
+        initialTermId,
+        m_context.mtuLength(),
+        priority,
+        std::move(rawLog),
+        endpoint,
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(senderPosition)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(senderLimit)),
+        std::move(flowControl),
+        std::unique_ptr<RetransmitHandler>(new RetransmitHandler(
+            m_retransmitDelayGenerator,
+            m_retransmitLingerGenerator,
+            m_systemCounters.get(status::SystemCounterDescriptor::RETRANSMITS_SENT))),
+        std::move(pacer),
+        m_nanoClock);
+
+    m_senderProxy.newNetworkPublication(publication);
+
+    m_publications.push_back(PublicationEntry{
+        publication,
+        canonicalForm,
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(publisherLimit)),
+        0,
+        PUBLICATION_ACTIVE,
+        m_nanoClock(),
+        {}});
+    PublicationEntry& entry = m_publications.back();
+
+    for (auto& link : m_subscriptionLinks)
+    {
+        if (streamId == link.streamId && (SPY_PREFIX + canonicalForm) == link.channel)
+        {
+            linkSpy(entry, link);
+        }
+    }
+
+    return entry;
+}
+
+void DriverConductor::linkSpy(PublicationEntry& entry, const SubscriptionLink& link)
+{
+    NetworkPublication& publication = *entry.publication;
+
+    const std::int32_t positionId = allocatePositionCounter(
+        "subscriber pos", StreamPositionCounter::SUBSCRIBER_POSITION_TYPE_ID,
+        link.registrationId, publication.sessionId(), publication.streamId(), link.channel);
+    UnsafeBufferPosition position{m_countersValuesBuffer, positionId};
+    ReadablePosition<UnsafeBufferPosition> spyPosition{position};
+
+    position.setOrdered(publication.senderPosition());
+    publication.addSpyPosition(spyPosition);
+    entry.spies.push_back(ImageSubscriber{link.registrationId, positionId});
+
+    m_clientProxy.onAvailableImage(
+        publication.registrationId(),
+        publication.streamId(),
+        publication.sessionId(),
+        {ImageBuffersReadyDefn::SubscriberPosition{positionId, link.registrationId}},
+        publication.logFileName(),
+        link.channel);
+}
+
+std::unique_ptr<FlowControl> DriverConductor::newFlowControl(const UdpChannel& udpChannel)
+{
+    if (!udpChannel.isMulticast())
+    {
+        return m_context.unicastFlowControlSupplier()();
+    }
+
+    const std::string strategy = udpChannel.flowControl();
+    if (UdpChannel::MIN_FLOW_CONTROL == strategy)
+    {
+        return std::unique_ptr<FlowControl>(new MinMulticastFlowControl());
+    }
+    else if (UdpChannel::MAX_FLOW_CONTROL == strategy)
+    {
+        return std::unique_ptr<FlowControl>(new MaxMulticastFlowControl());
+    }
+
+    return m_context.multicastFlowControlSupplier()();
+}
+
+std::unique_ptr<TokenBucket> DriverConductor::newPacer(const UdpChannel& udpChannel)
+{
+    const std::int64_t rateBytesPerSecond = udpChannel.pacingRate(m_context.pacingRateBytesPerSecond());
+    if (0 == rateBytesPerSecond)
+    {
+        return std::unique_ptr<TokenBucket>(nullptr);
+    }
+
+    const std::int32_t burstLength =
+        std::max(udpChannel.pacingBurstLength(m_context.pacingBurstLength()), m_context.mtuLength());
+
+    return std::unique_ptr<TokenBucket>(new TokenBucket(rateBytesPerSecond, burstLength, m_nanoClock()));
+}
+
+std::int32_t DriverConductor::priorityClass(const UdpChannel& udpChannel)
+{
+    const std::string priority = udpChannel.priority();
+    if (UdpChannel::HIGH_PRIORITY == priority)
+    {
+        return Sender::HIGH_PRIORITY;
+    }
+    else if (UdpChannel::LOW_PRIORITY == priority)
+    {
+        return Sender::LOW_PRIORITY;
+    }
+
+    return Sender::NORMAL_PRIORITY;
+}
+
+std::unique_ptr<CongestionControl> DriverConductor::newCongestionControl(
+    const UdpChannel& udpChannel,
+    std::int32_t mtuLength,
+    std::int64_t correlationId,
+    std::int32_t sessionId,
+    std::int32_t streamId,
+    const std::string& channel,
+    std::int32_t& windowPositionId)
+{
+    windowPositionId = NULL_COUNTER_ID;
+
+    if (UdpChannel::CUBIC_CONGESTION_CONTROL == udpChannel.congestionControl())
+    {
+        windowPositionId = allocatePositionCounter(
+            "receiver congestion window", StreamPositionCounter::RECEIVER_CONGESTION_WINDOW_TYPE_ID,
+            correlationId, sessionId, streamId, channel);
+        UnsafeBufferPosition windowPosition{m_countersValuesBuffer, windowPositionId};
+        typedef CubicCongestionControl::position_t position_t;
+
+        return std::unique_ptr<CongestionControl>(new CubicCongestionControl(
+            m_nanoClock(),
+            m_context.initialWindowLength(),
+            mtuLength,
+            m_systemCounters.get(status::SystemCounterDescriptor::CONGESTION_WINDOW_REDUCTIONS),
+            std::unique_ptr<position_t>(new position_t(windowPosition))));
+    }
+
+    return std::unique_ptr<CongestionControl>(new StaticWindowCongestionControl());
+}
+
+std::shared_ptr<SendChannelEndpoint> DriverConductor::getOrCreateSendChannelEndpoint(
+    std::unique_ptr<UdpChannel>& udpChannel)
+{
+    const std::string canonicalForm = udpChannel->canonicalForm();
+
+    auto it = m_sendChannelEndpoints.find(canonicalForm);
+    if (it != m_sendChannelEndpoints.end())
+    {
+        return it->second;
+    }
+
+    std::shared_ptr<SendChannelEndpoint> endpoint = std::make_shared<SendChannelEndpoint>(
+        std::move(udpChannel), m_systemCounters.get(status::SystemCounterDescriptor::DATA_PACKET_SHORT_SENDS));
+    endpoint->sendBatchCounters(
+        m_systemCounters.get(status::SystemCounterDescriptor::DATA_SEND_BATCHES),
+        m_systemCounters.get(status::SystemCounterDescriptor::DATAGRAMS_SENT_IN_BATCHES));
+    endpoint->ioUring(m_context.ioUring());
+    endpoint->openDatagramChannel();
+
+    m_sendChannelEndpoints.emplace(canonicalForm, endpoint);
+
+    return endpoint;
+}
+
+void DriverConductor::onAddDirectPublication(
+    std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId)
+{
+    DirectPublicationEntry* entry = nullptr;
+
+    for (auto& candidate : m_directPublications)
+    {
+        if (PUBLICATION_ACTIVE == candidate.status && streamId == candidate.publication->streamId())
+        {
+            entry = &candidate;
+            break;
+        }
+    }
+
+    if (nullptr == entry)
+    {
+        entry = &newDirectPublication(streamId, registrationId);
+    }
+
+    entry->refCount++;
+    m_publicationLinks.push_back(PublicationLink{registrationId, clientId, nullptr, entry->publication.get()});
+
+    m_clientProxy.onPublicationReady(
+        registrationId,
+        streamId,
+        entry->publication->sessionId(),
+        entry->publication->publisherLimitId(),
+        entry->publication->logFileName());
+}
+
+DriverConductor::DirectPublicationEntry& DriverConductor::newDirectPublication(
+    std::int32_t streamId, std::int64_t registrationId)
+{
+    const std::int32_t termLength = m_context.termBufferLength();
+    LogBufferDescriptor::checkTermLength(termLength);
+
+    const std::int32_t sessionId = m_nextSessionId++;
+    const std::int32_t initialTermId = (std::int32_t) m_random();
+    const std::string logFile = logFileName(PUBLICATIONS_DIR, registrationId);
+
+    std::unique_ptr<MappedRawLog> rawLog{new MappedRawLog{logFile.c_str(), false, termLength}};
+    initialiseLogMetaData(
+        rawLog->logMetaDataBuffer(), registrationId, initialTermId, m_context.mtuLength(), sessionId, streamId);
+
+    UnsafeBufferPosition publisherLimit{
+        m_countersValuesBuffer,
+        allocatePositionCounter(
+            "publisher limit",
+            StreamPositionCounter::PUBLISHER_LIMIT_TYPE_ID,
+            registrationId, sessionId, streamId, IPC_CHANNEL)};
+
+    DirectPublication::ptr_t publication = std::make_shared<DirectPublication>(
+        registrationId,
+        sessionId,
+        streamId,
+        initialTermId,
+        std::move(rawLog),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(publisherLimit)));
+
+    m_directPublications.push_back(DirectPublicationEntry{publication, 0, PUBLICATION_ACTIVE, m_nanoClock(), {}});
+    DirectPublicationEntry& entry = m_directPublications.back();
+
+    for (auto& link : m_subscriptionLinks)
+    {
+        if (streamId == link.streamId && IPC_CHANNEL == link.channel)
+        {
+            linkDirectPublication(entry, link);
+        }
+    }
+
+    return entry;
+}
+
+void DriverConductor::linkDirectPublication(DirectPublicationEntry& entry, const SubscriptionLink& link)
+{
+    DirectPublication& publication = *entry.publication;
+
+    const std::int32_t positionId = allocatePositionCounter(
+        "subscriber pos", StreamPositionCounter::SUBSCRIBER_POSITION_TYPE_ID,
+        link.registrationId, publication.sessionId(), publication.streamId(), IPC_CHANNEL);
+    UnsafeBufferPosition position{m_countersValuesBuffer, positionId};
+    ReadablePosition<UnsafeBufferPosition> subscriberPosition{position};
+
+    position.setOrdered(publication.joiningPosition());
+    publication.addSubscriberPosition(subscriberPosition);
+    entry.subscribers.push_back(ImageSubscriber{link.registrationId, positionId});
+
+    m_clientProxy.onAvailableImage(
+        publication.registrationId(),
+        publication.streamId(),
+        publication.sessionId(),
+        {ImageBuffersReadyDefn::SubscriberPosition{positionId, link.registrationId}},
+        publication.logFileName(),
+        IPC_CHANNEL);
+}
+
+void DriverConductor::deleteDirectPublication(std::size_t index)
+{
+    DirectPublicationEntry& entry = m_directPublications[index];
+
+    for (auto& subscriber : entry.subscribers)
+    {
+        m_countersManager.free(subscriber.positionId);
+    }
+
+    m_countersManager.free(entry.publication->publisherLimitId());
+    m_directPublications.erase(m_directPublications.begin() + index);
+}
+
+void DriverConductor::onRemovePublication(std::int64_t registrationId, std::int64_t correlationId)
+{
+    auto it = std::find_if(
+        m_publicationLinks.begin(),
+        m_publicationLinks.end(),
+        [&](const PublicationLink& link)
+        {
+            return registrationId == link.registrationId;
+        });
+
+    if (it == m_publicationLinks.end())
+    {
+        throw RegistrationException(
+            ERROR_CODE_UNKNOWN_PUBLICATION,
+            strPrintf("Unknown publication: %lld", (long long) registrationId),
+            SOURCEINFO);
+    }
+
+    const PublicationLink link = *it;
+    m_publicationLinks.erase(it);
+    unlinkPublication(link, m_nanoClock());
+
+    m_clientProxy.operationSucceeded(correlationId);
+}
+
+void DriverConductor::unlinkPublication(const PublicationLink& link, std::int64_t nowNs)
+{
+    for (auto& entry : m_publications)
+    {
+        if (entry.publication.get() == link.publication)
+        {
+            if (0 == --entry.refCount)
+            {
+                entry.status = PUBLICATION_DRAINING;
+                entry.timeOfLastStatusChangeNs = nowNs;
+            }
+
+            return;
+        }
+    }
+
+    for (auto& entry : m_directPublications)
+    {
+        if (entry.publication.get() == link.directPublication)
+        {
+            if (0 == --entry.refCount)
+            {
+                entry.status = PUBLICATION_DRAINING;
+                entry.timeOfLastStatusChangeNs = nowNs;
+            }
+
+            return;
+        }
+    }
+}
+
+void DriverConductor::deletePublication(std::size_t index)
+{
+    PublicationEntry& entry = m_publications[index];
+    const std::string channel = entry.channel;
+
+    m_senderProxy.removeNetworkPublication(entry.publication);
+
+    for (auto& spy : entry.spies)
+    {
+        m_countersManager.free(spy.positionId);
+    }
+
+    m_countersManager.free(entry.publisherLimit->id());
+    m_countersManager.free(entry.publication->senderPositionId());
+    m_countersManager.free(entry.publication->senderLimitId());
+    m_publications.erase(m_publications.begin() + index);
+
+    const bool isEndpointInUse = std::any_of(
+        m_publications.begin(),
+        m_publications.end(),
+        [&](const PublicationEntry& candidate)
+        {
+            return channel == candidate.channel;
+        });
+
+    if (!isEndpointInUse)
+    {
+        m_sendChannelEndpoints.erase(channel);
+    }
+}
+
+void DriverConductor::onAddSubscription(
+    const std::string& channel, std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId)
+{
+    if (isSpyChannel(channel))
+    {
+        onAddSpySubscription(channel, streamId, registrationId, clientId);
+        return;
+    }
+
+    if (isIpcChannel(channel))
+    {
+        onAddDirectSubscription(channel, streamId, registrationId, clientId);
+        return;
+    }
+
+    std::unique_ptr<UdpChannel> udpChannel = UdpChannel::parse(channel.c_str());
+    const std::string canonicalForm = udpChannel->canonicalForm();
+
+    ReceiveChannelEndpointEntry& entry = getOrCreateReceiveChannelEndpoint(udpChannel);
+    if (0 == entry.refCountByStreamId[streamId]++)
+    {
+        m_receiverProxy.addSubscription(entry.dispatcher, streamId);
+    }
+
+    m_subscriptionLinks.push_back(SubscriptionLink{registrationId, clientId, streamId, canonicalForm, channel});
+    m_clientProxy.operationSucceeded(registrationId);
+
+    linkActiveImages(m_subscriptionLinks.back());
+}
+
+void DriverConductor::onAddDirectSubscription(
+    const std::string& channel, std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId)
+{
+    m_subscriptionLinks.push_back(SubscriptionLink{registrationId, clientId, streamId, IPC_CHANNEL, channel});
+    m_clientProxy.operationSucceeded(registrationId);
+
+    const SubscriptionLink& link = m_subscriptionLinks.back();
+    for (auto& entry : m_directPublications)
+    {
+        if (PUBLICATION_ACTIVE == entry.status && streamId == entry.publication->streamId())
+        {
+            linkDirectPublication(entry, link);
+        }
+    }
+}
+
+void DriverConductor::onAddSpySubscription(
+    const std::string& channel, std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId)
+{
+    std::unique_ptr<UdpChannel> udpChannel = UdpChannel::parse(channel.substr(SPY_PREFIX.length()).c_str());
+    const std::string spyChannel = SPY_PREFIX + udpChannel->canonicalForm();
+
+    m_subscriptionLinks.push_back(SubscriptionLink{registrationId, clientId, streamId, spyChannel, channel});
+    m_clientProxy.operationSucceeded(registrationId);
+
+    const SubscriptionLink& link = m_subscriptionLinks.back();
+    for (auto& entry : m_publications)
+    {
+        if (PUBLICATION_ACTIVE == entry.status &&
+            streamId == entry.publication->streamId() &&
+            spyChannel == SPY_PREFIX + entry.channel)
+        {
+            linkSpy(entry, link);
+        }
+    }
+}
+
+DriverConductor::ReceiveChannelEndpointEntry& DriverConductor::getOrCreateReceiveChannelEndpoint(
+    std::unique_ptr<UdpChannel>& udpChannel)
+{
+    const std::string canonicalForm = udpChannel->canonicalForm();
+
+    auto it = m_receiveChannelEndpoints.find(canonicalForm);
+    if (it != m_receiveChannelEndpoints.end())
+    {
+        return it->second;
+    }
+
+    std::shared_ptr<DataPacketDispatcher> dispatcher =
+        std::make_shared<DataPacketDispatcher>(m_conductorProxy, *m_receiver);
+    std::shared_ptr<ReceiveChannelEndpoint> endpoint =
+        std::make_shared<ReceiveChannelEndpoint>(
+            std::move(udpChannel),
+            dispatcher,
+            ReceiveChannelEndpoint::DEFAULT_RECEIVE_BATCH_SIZE,
+            m_systemCounters.get(status::SystemCounterDescriptor::STATUS_MESSAGES_SENT),
+            m_systemCounters.get(status::SystemCounterDescriptor::STATUS_MESSAGE_SHORT_SENDS));
+
+    // only the data endpoints of each side are counted, so every counter is written from the one thread
+    endpoint->receiveBatchCounters(
+        m_systemCounters.get(status::SystemCounterDescriptor::DATA_RECEIVE_BATCHES),
+        m_systemCounters.get(status::SystemCounterDescriptor::DATAGRAMS_RECEIVED_IN_BATCHES));
+    endpoint->ioUring(m_context.ioUring());
+    endpoint->openDatagramChannel();
+    m_receiverProxy.registerReceiveChannelEndpoint(endpoint);
+
+    return m_receiveChannelEndpoints.emplace(
+        canonicalForm, ReceiveChannelEndpointEntry{endpoint, dispatcher, {}}).first->second;
+}
+
+void DriverConductor::linkActiveImages(const SubscriptionLink& link)
+{
+    for (auto& entry : m_images)
+    {
+        PublicationImage& image = *entry.image;
+
+        if (PublicationImageStatus::ACTIVE == image.status() &&
+            link.streamId == image.streamId() &&
+            link.channel == entry.channel)
+        {
+            const std::int32_t positionId = allocatePositionCounter(
+                "subscriber pos", StreamPositionCounter::SUBSCRIBER_POSITION_TYPE_ID,
+                link.registrationId, image.sessionId(), image.streamId(), link.channel);
+            UnsafeBufferPosition position{m_countersValuesBuffer, positionId};
+            ReadablePosition<UnsafeBufferPosition> subscriberPosition{position};
+
+            position.setOrdered(image.rebuildPosition());
+            image.addSubscriberPosition(subscriberPosition);
+            entry.subscribers.push_back(ImageSubscriber{link.registrationId, positionId});
+
+            std::ostringstream sourceIdentity;
+            image.sourceAddress().output(sourceIdentity);
+
+            m_clientProxy.onAvailableImage(
+                image.correlationId(),
+                image.streamId(),
+                image.sessionId(),
+                {ImageBuffersReadyDefn::SubscriberPosition{positionId, link.registrationId}},
+                image.logFileName(),
+                sourceIdentity.str());
+        }
+    }
+}
+
+void DriverConductor::onRemoveSubscription(std::int64_t registrationId, std::int64_t correlationId)
+{
+    auto it = std::find_if(
+        m_subscriptionLinks.begin(),
+        m_subscriptionLinks.end(),
+        [&](const SubscriptionLink& link)
+        {
+            return registrationId == link.registrationId;
+        });
+
+    if (it == m_subscriptionLinks.end())
+    {
+        throw RegistrationException(
+            ERROR_CODE_UNKNOWN_SUBSCRIPTION,
+            strPrintf("Unknown subscription: %lld", (long long) registrationId),
+            SOURCEINFO);
+    }
+
+    const SubscriptionLink link = *it;
+    m_subscriptionLinks.erase(it);
+    unlinkSubscription(link);
+
+    m_clientProxy.operationSucceeded(correlationId);
+}
+
+void DriverConductor::unlinkSubscription(const SubscriptionLink& link)
+{
+    for (auto& entry : m_images)
+    {
+        for (auto it = entry.subscribers.begin(); it != entry.subscribers.end(); ++it)
+        {
+            if (link.registrationId == it->registrationId)
+            {
+                entry.image->removeSubscriberPosition(it->positionId);
+                m_countersManager.free(it->positionId);
+                entry.subscribers.erase(it);
+                break;
+            }
+        }
+    }
+
+    for (auto& entry : m_publications)
+    {
+        for (auto it = entry.spies.begin(); it != entry.spies.end(); ++it)
+        {
+            if (link.registrationId == it->registrationId)
+            {
+                entry.publication->removeSpyPosition(it->positionId);
+                m_countersManager.free(it->positionId);
+                entry.spies.erase(it);
+                break;
+            }
+        }
+    }
+
+    for (auto& entry : m_directPublications)
+    {
+        for (auto it = entry.subscribers.begin(); it != entry.subscribers.end(); ++it)
+        {
+            if (link.registrationId == it->registrationId)
+            {
+                entry.publication->removeSubscriberPosition(it->positionId);
+                m_countersManager.free(it->positionId);
+                entry.subscribers.erase(it);
+                break;
+            }
+        }
+    }
+
+    auto endpointItr = m_receiveChannelEndpoints.find(link.channel);
+    if (endpointItr == m_receiveChannelEndpoints.end())
+    {
+        return;
+    }
+
+    ReceiveChannelEndpointEntry& entry = endpointItr->second;
+    if (0 == --entry.refCountByStreamId[link.streamId])
+    {
+        entry.refCountByStreamId.erase(link.streamId);
+        m_receiverProxy.removeSubscription(entry.dispatcher, link.streamId);
+    }
+
+    if (entry.refCountByStreamId.empty())
+    {
+        m_receiverProxy.closeReceiveChannelEndpoint(entry.endpoint);
+        m_receiveChannelEndpoints.erase(endpointItr);
+    }
+}
+
+void DriverConductor::onClientKeepalive(std::int64_t clientId)
+{
+    const std::int64_t nowNs = m_nanoClock();
+
+    for (auto& client : m_clients)
+    {
+        if (clientId == client.clientId)
+        {
+            client.timeOfLastKeepaliveNs = nowNs;
+            return;
+        }
+    }
+
+    m_clients.push_back(AeronClient{clientId, nowNs});
+}
+
+void DriverConductor::onCreatePublicationImage(
+    std::int32_t sessionId,
+    std::int32_t streamId,
+    std::int32_t initialTermId,
+    std::int32_t activeTermId,
+    std::int32_t termOffset,
+    std::int32_t termLength,
+    std::int32_t mtuLength,
+    InetAddress& controlAddress,
+    InetAddress& srcAddress,
+    ReceiveChannelEndpoint& channelEndpoint)
+{
+    // the endpoint may have been closed while the request was queued, so it is only looked at once it is found
+    auto endpointItr = std::find_if(
+        m_receiveChannelEndpoints.begin(),
+        m_receiveChannelEndpoints.end(),
+        [&](const std::pair<const std::string, ReceiveChannelEndpointEntry>& entry)
+        {
+            return entry.second.endpoint.get() == &channelEndpoint;
+        });
+
+    if (endpointItr == m_receiveChannelEndpoints.end())
+    {
+        return;
+    }
+
+    const std::string& canonicalForm = endpointItr->first;
+
+    std::vector<const SubscriptionLink*> links;
+    for (auto& link : m_subscriptionLinks)
+    {
+        if (streamId == link.streamId && canonicalForm == link.channel)
+        {
+            links.push_back(&link);
+        }
+    }
+
+    if (links.empty())
+    {
+        return;
+    }
+
+    LogBufferDescriptor::checkTermLength(termLength);
+
+    const std::int64_t correlationId = m_toDriverCommands.nextCorrelationId();
+    const std::string logFile = logFileName(IMAGES_DIR, correlationId);
+
+    std::unique_ptr<MappedRawLog> rawLog{new MappedRawLog{logFile.c_str(), false, termLength}};
+    initialiseLogMetaData(rawLog->logMetaDataBuffer(), correlationId, initialTermId, mtuLength, sessionId, streamId);
+
+    const std::int64_t joinPosition = LogBufferDescriptor::computePosition(
+        activeTermId, termOffset, util::BitUtil::numberOfTrailingZeroes(termLength), initialTermId);
+
+    std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>> subscriberPositions{
+        new std::vector<ReadablePosition<UnsafeBufferPosition>>()};
+    std::vector<ImageSubscriber> subscribers;
+    std::vector<ImageBuffersReadyDefn::SubscriberPosition> positionsReady;
+
+    for (const SubscriptionLink* link : links)
+    {
+        const std::int32_t positionId = allocatePositionCounter(
+            "subscriber pos", StreamPositionCounter::SUBSCRIBER_POSITION_TYPE_ID,
+            link->registrationId, sessionId, streamId, canonicalForm);
+        UnsafeBufferPosition position{m_countersValuesBuffer, positionId};
+
+        position.setOrdered(joinPosition);
+        subscriberPositions->push_back(ReadablePosition<UnsafeBufferPosition>{position});
+        subscribers.push_back(ImageSubscriber{link->registrationId, positionId});
+        positionsReady.push_back(ImageBuffersReadyDefn::SubscriberPosition{positionId, link->registrationId});
+    }
+
+    const std::int32_t hwmPositionId = allocatePositionCounter(
+        "receiver hwm", StreamPositionCounter::RECEIVER_HWM_TYPE_ID,
+        correlationId, sessionId, streamId, canonicalForm);
+    UnsafeBufferPosition hwmPosition{m_countersValuesBuffer, hwmPositionId};
+    const std::int32_t receiverWindowPositionId = allocatePositionCounter(
+        "receiver window", StreamPositionCounter::RECEIVER_WINDOW_TYPE_ID,
+        correlationId, sessionId, streamId, canonicalForm);
+    UnsafeBufferPosition receiverWindowPosition{m_countersValuesBuffer, receiverWindowPositionId};
+    const std::int32_t rttPositionId = allocatePositionCounter(
+        "receiver rtt", StreamPositionCounter::RECEIVER_RTT_TYPE_ID,
+        correlationId, sessionId, streamId, canonicalForm);
+    UnsafeBufferPosition rttPosition{m_countersValuesBuffer, rttPositionId};
+    const std::int32_t rttVariancePositionId = allocatePositionCounter(
+        "receiver rtt variance", StreamPositionCounter::RECEIVER_RTT_VARIANCE_TYPE_ID,
+        correlationId, sessionId, streamId, canonicalForm);
+    UnsafeBufferPosition rttVariancePosition{m_countersValuesBuffer, rttVariancePositionId};
+    std::int32_t congestionWindowPositionId;
+    std::unique_ptr<CongestionControl> congestionControl = newCongestionControl(
+        endpointItr->second.endpoint->udpChannel(), mtuLength,
+        correlationId, sessionId, streamId, canonicalForm, congestionWindowPositionId);
+
+    PublicationImage::ptr_t image = std::make_shared<PublicationImage>(
+        correlationId,
+        m_context.imageLivenessTimeoutNs(),
+        m_context.statusMessageTimeoutNs(),
+        sessionId,
+        streamId,
+        initialTermId,
+        activeTermId,
+        termOffset,
+        m_context.initialWindowLength(),
+        0,
+        std::move(rawLog),
+        InetAddress::copyOf(srcAddress),
+        InetAddress::copyOf(controlAddress),
+        endpointItr->second.endpoint,
+        std::move(subscriberPositions),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(hwmPosition)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(receiverWindowPosition)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(rttPosition)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(rttVariancePosition)),
+        std::move(congestionControl),
+        endpointItr->second.endpoint->udpChannel().isMulticast() ?
+            (FeedbackDelayGenerator&) m_multicastFeedbackDelayGenerator :
+            (FeedbackDelayGenerator&) m_unicastFeedbackDelayGenerator,
+        m_nanoClock);
+
+    m_receiverProxy.newPublicationImage(endpointItr->second.dispatcher, image);
+
+    m_images.push_back(ImageEntry{
+        image,
+        endpointItr->second.dispatcher,
+        canonicalForm,
+        links.front()->uri,
+        hwmPositionId,
+        receiverWindowPositionId,
+        rttPositionId,
+        rttVariancePositionId,
+        congestionWindowPositionId,
+        subscribers});
+
+    std::ostringstream sourceIdentity;
+    srcAddress.output(sourceIdentity);
+
+    m_clientProxy.onAvailableImage(correlationId, streamId, sessionId, positionsReady, logFile, sourceIdentity.str());
+}
+
+void DriverConductor::deleteImage(std::size_t index)
+{
+    ImageEntry& entry = m_images[index];
+
+    m_receiverProxy.removeCoolDown(entry.dispatcher, entry.image->sessionId(), entry.image->streamId());
+
+    for (auto& subscriber : entry.subscribers)
+    {
+        m_countersManager.free(subscriber.positionId);
+    }
+
+    m_countersManager.free(entry.hwmPositionId);
+    m_countersManager.free(entry.receiverWindowPositionId);
+    m_countersManager.free(entry.rttPositionId);
+    m_countersManager.free(entry.rttVariancePositionId);
+
+    if (NULL_COUNTER_ID != entry.congestionWindowPositionId)
+    {
+        m_countersManager.free(entry.congestionWindowPositionId);
+    }
+
+    m_images.erase(m_images.begin() + index);
+}
+
+std::int32_t DriverConductor::updatePublications()
+{
+    std::int32_t workCount = 0;
+
+    for (auto& entry : m_publications)
+    {
+        NetworkPublication& publication = *entry.publication;
+
+        workCount += publication.cleanLogBuffer();
+
+        if (PUBLICATION_ACTIVE == entry.status)
+        {
+            const std::int64_t publisherLimit =
+                publication.consumerPosition() + (publication.termBufferLength() / 2);
+
+            if (publisherLimit != entry.publisherLimit->get())
+            {
+                entry.publisherLimit->setOrdered(publisherLimit);
+                workCount++;
+            }
+        }
+    }
+
+    for (auto& entry : m_directPublications)
+    {
+        DirectPublication& publication = *entry.publication;
+
+        workCount += publication.cleanLogBuffer();
+
+        if (PUBLICATION_ACTIVE == entry.status)
+        {
+            workCount += publication.updatePublisherLimit();
+        }
+    }
+
+    return workCount;
+}
+
+void DriverConductor::onCheckTimers(std::int64_t nowNs)
+{
+    m_toDriverCommands.consumerHeartbeatTime(m_epochClock());
+
+    checkClients(nowNs);
+    checkPublications(nowNs);
+    checkDirectPublications(nowNs);
+    checkImages(nowNs);
+}
+
+void DriverConductor::checkClients(std::int64_t nowNs)
+{
+    for (std::size_t i = m_clients.size(); i-- > 0;)
+    {
+        const AeronClient client = m_clients[i];
+
+        if (nowNs > (client.timeOfLastKeepaliveNs + m_context.clientLivenessTimeoutNs()))
+        {
+            for (std::size_t j = m_publicationLinks.size(); j-- > 0;)
+            {
+                if (client.clientId == m_publicationLinks[j].clientId)
+                {
+                    const PublicationLink link = m_publicationLinks[j];
+                    m_publicationLinks.erase(m_publicationLinks.begin() + j);
+                    unlinkPublication(link, nowNs);
+                }
+            }
+
+            for (std::size_t j = m_subscriptionLinks.size(); j-- > 0;)
+            {
+                if (client.clientId == m_subscriptionLinks[j].clientId)
+                {
+                    const SubscriptionLink link = m_subscriptionLinks[j];
+                    m_subscriptionLinks.erase(m_subscriptionLinks.begin() + j);
+                    unlinkSubscription(link);
+                }
+            }
+
+            m_clients.erase(m_clients.begin() + i);
+        }
+    }
+}
+
+void DriverConductor::checkPublications(std::int64_t nowNs)
+{
+    const std::int64_t lingerNs = m_context.publicationLingerNs();
+
+    for (std::size_t i = m_publications.size(); i-- > 0;)
+    {
+        PublicationEntry& entry = m_publications[i];
+
+        switch (entry.status)
+        {
+            case PUBLICATION_DRAINING:
+            {
+                NetworkPublication& publication = *entry.publication;
+
+                if (publication.producerPosition() <= publication.consumerPosition() ||
+                    nowNs > (entry.timeOfLastStatusChangeNs + lingerNs))
+                {
+                    entry.status = PUBLICATION_LINGER;
+                    entry.timeOfLastStatusChangeNs = nowNs;
+
+                    if (!entry.spies.empty())
+                    {
+                        m_clientProxy.onUnavailableImage(
+                            publication.registrationId(), publication.streamId(), SPY_PREFIX + entry.channel);
+                    }
+                }
+            }
+            break;
+
+            case PUBLICATION_LINGER:
+                if (nowNs > (entry.timeOfLastStatusChangeNs + lingerNs))
+                {
+                    deletePublication(i);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void DriverConductor::checkDirectPublications(std::int64_t nowNs)
+{
+    const std::int64_t lingerNs = m_context.publicationLingerNs();
+
+    for (std::size_t i = m_directPublications.size(); i-- > 0;)
+    {
+        DirectPublicationEntry& entry = m_directPublications[i];
+        DirectPublication& publication = *entry.publication;
+
+        switch (entry.status)
+        {
+            case PUBLICATION_DRAINING:
+                if (publication.isDrained() || nowNs > (entry.timeOfLastStatusChangeNs + lingerNs))
+                {
+                    entry.status = PUBLICATION_LINGER;
+                    entry.timeOfLastStatusChangeNs = nowNs;
+                    m_clientProxy.onUnavailableImage(publication.registrationId(), publication.streamId(), IPC_CHANNEL);
+                }
+                break;
+
+            case PUBLICATION_LINGER:
+                if (nowNs > (entry.timeOfLastStatusChangeNs + lingerNs))
+                {
+                    deleteDirectPublication(i);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void DriverConductor::checkImages(std::int64_t nowNs)
+{
+    const std::int64_t livenessTimeoutNs = m_context.imageLivenessTimeoutNs();
+
+    for (std::size_t i = m_images.size(); i-- > 0;)
+    {
+        ImageEntry& entry = m_images[i];
+        PublicationImage& image = *entry.image;
+
+        switch (image.status())
+        {
+            case PublicationImageStatus::ACTIVE:
+                if (nowNs > (image.timeOfLastPacketNs() + livenessTimeoutNs))
+                {
+                    m_receiverProxy.removePublicationImage(entry.dispatcher, entry.image);
+                }
+                break;
+
+            case PublicationImageStatus::INACTIVE:
+                if (image.isDrained() || nowNs > (image.timeOfLastStatusChangeNs() + livenessTimeoutNs))
+                {
+                    image.status(PublicationImageStatus::LINGER);
+                    m_clientProxy.onUnavailableImage(image.correlationId(), image.streamId(), entry.uri);
+                }
+                break;
+
+            case PublicationImageStatus::LINGER:
+                if (nowNs > (image.timeOfLastStatusChangeNs() + livenessTimeoutNs))
+                {
+                    deleteImage(i);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+std::int32_t DriverConductor::allocatePositionCounter(
+    const char* name,
+    std::int32_t typeId,
+    std::int64_t registrationId,
+    std::int32_t sessionId,
+    std::int32_t streamId,
+    const std::string& channel)
+{
+    const std::string label = strPrintf(
+        "%s: %lld %d %d %s", name, (long long) registrationId, sessionId, streamId, channel.c_str());
+
+    return m_countersManager.allocate(
+        label.substr(0, CountersManager::MAX_LABEL_LENGTH),
+        typeId,
+        [&](AtomicBuffer& keyBuffer)
+        {
+            typedef StreamPositionCounter::StreamPositionCounterKeyMetaDataDefn key_t;
+            const util::index_t channelOffset = offsetof(key_t, channel);
+            const std::size_t maxChannelLength =
+                (std::size_t) (keyBuffer.capacity() - channelOffset - (util::index_t) sizeof(std::int32_t));
+
+            keyBuffer.putInt64(offsetof(key_t, registrationId), registrationId);
+            keyBuffer.putInt32(offsetof(key_t, sessionId), sessionId);
+            keyBuffer.putInt32(offsetof(key_t, streamId), streamId);
+            keyBuffer.putStringUtf8(channelOffset, channel.substr(0, maxChannelLength));
+        });
+}
+
+std::string DriverConductor::logFileName(const char* directory, std::int64_t correlationId) const
+{
+    return m_context.aeronDir() + "/" + directory + "/" + std::to_string(correlationId) + ".logbuffer";
+}
@@ -0,0 +1,360 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_DRIVERCONDUCTOR__
+#define INCLUDED_AERON_DRIVER_DRIVERCONDUCTOR__
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "aeron/concurrent/AtomicBuffer.h"
+#include "aeron/concurrent/CountersManager.h"
+#include "aeron/concurrent/broadcast/BroadcastTransmitter.h"
+#include "aeron/concurrent/ringbuffer/ManyToOneRingBuffer.h"
+#include "aeron/concurrent/status/UnsafeBufferPosition.h"
+
+#include "concurrent/CommandQueue.h"
+#include "media/InetAddress.h"
+#include "media/ReceiveChannelEndpoint.h"
+#include "media/SendChannelEndpoint.h"
+#include "media/UdpChannel.h"
+#include "status/SystemCounters.h"
+
+#include "ClientProxy.h"
+#include "DirectPublication.h"
+#include "FeedbackDelayGenerator.h"
+#include "CongestionControl.h"
+#include "FlowControl.h"
+#include "MediaDriver.h"
+#include "NetworkPublication.h"
+#include "PublicationImage.h"
+#include "Receiver.h"
+#include "ReceiverProxy.h"
+#include "RetransmitHandler.h"
+#include "Sender.h"
+#include "SenderProxy.h"
+#include "TokenBucket.h"
+
+namespace aeron { namespace driver {
+
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::broadcast;
+using namespace aeron::concurrent::ringbuffer;
+using namespace aeron::concurrent::status;
+using namespace aeron::driver::media;
+
+class DataPacketDispatcher;
+class DriverConductorProxy;
+
+/**
+ * Duty cycle for the administration of the driver. It services the commands clients write to the to-driver ring
+ * buffer of the CnC file and replies to them over the to-clients broadcast buffer.
+ *
+ * Publications get a log buffer file under the publications directory of the Aeron directory along with publisher
+ * limit, sender position and sender limit counters, and are handed to the Sender. Unicast publications get the
+ * unicast FlowControl of the context and multicast ones the strategy chosen with fc=max or fc=min on the channel,
+ * falling back to the multicast FlowControl of the context. They are paced by a TokenBucket when pacing-rate on the
+ * channel or the pacing rate of the context is set, and scheduled by the Sender in the class chosen with priority on
+ * the channel, whose queueing delay counters are system counters.
+ *
+ * Subscriptions share a ReceiveChannelEndpoint per channel that is registered with the Receiver, and images get a
+ * log buffer file under the images directory once a setup frame arrives for a subscribed stream. Images on unicast
+ * channels NAK loss straight away while those on multicast channels back off with an OptimalMulticastDelayGenerator,
+ * so the group does not flood the sender with NAKs for the same loss. Images advertise the receiver window as it is
+ * unless cc=cubic on the channel of their endpoint gives them a CubicCongestionControl, and get a receiver window
+ * counter with what they advertise along with counters of their smoothed RTT and its variance. Those with a
+ * CubicCongestionControl also get a counter of its congestion window.
+ *
+ * Spy subscriptions on aeron-spy: channels are linked straight to the log of matching network publications instead
+ * of an endpoint, holding back the publisher limit like the sender position does. Publications and subscriptions on
+ * aeron:ipc channels never reach the Sender or Receiver: subscribers read the log of a DirectPublication in place
+ * and the conductor moves its publisher limit on from their positions. Unless the threading mode is SHARED the
+ * Sender and Receiver run on other threads, so everything handed to them goes through a SenderProxy or
+ * ReceiverProxy.
+ *
+ * Resources are reclaimed on timers rather than straight away:
+ * - clients that stop sending keepalives are timed out and all of their publications and subscriptions removed.
+ * - a publication with no clients left drains what was appended and then lingers, so the tail of the stream can
+ *   still be sent and retransmitted, before its log is deleted.
+ * - an image that stops receiving goes inactive and its session is put on cool-down in the DataPacketDispatcher, so
+ *   stray packets do not turn it straight back into a new image. After the image has lingered for clients to let go
+ *   of its log the cool-down is lifted.
+ */
+class DriverConductor
+{
+public:
+    static const std::int64_t TIMER_INTERVAL_NS = 1000 * 1000;
+
+    DriverConductor(
+        const MediaDriver::Context& context,
+        AtomicBuffer& toDriverBuffer,
+        AtomicBuffer& toClientsBuffer,
+        AtomicBuffer& countersMetadataBuffer,
+        AtomicBuffer& countersValuesBuffer,
+        std::shared_ptr<Sender> sender,
+        std::shared_ptr<Receiver> receiver,
+        nano_clock_t nanoClock,
+        epoch_clock_t epochClock);
+
+    ~DriverConductor();
+
+    std::int32_t doWork();
+
+    /**
+     * Let go of the publications, images and channel endpoints of the driver, which closes their sockets and log
+     * buffers. Only called once the agents have stopped, as the Sender and Receiver are released directly.
+     */
+    void close();
+
+    inline void onClose()
+    {
+    }
+
+    /**
+     * Requests from the Receiver when it runs on another thread, see DriverConductorProxy.
+     */
+    inline concurrent::CommandQueue& commandQueue()
+    {
+        return m_commandQueue;
+    }
+
+    /**
+     * Create an image for a session a setup frame has arrived for on a subscribed stream, as forwarded by the
+     * DriverConductorProxy of the DataPacketDispatcher of the channel endpoint.
+     */
+    void onCreatePublicationImage(
+        std::int32_t sessionId,
+        std::int32_t streamId,
+        std::int32_t initialTermId,
+        std::int32_t activeTermId,
+        std::int32_t termOffset,
+        std::int32_t termLength,
+        std::int32_t mtuLength,
+        InetAddress& controlAddress,
+        InetAddress& srcAddress,
+        ReceiveChannelEndpoint& channelEndpoint);
+
+    inline std::size_t clientCount() const
+    {
+        return m_clients.size();
+    }
+
+    inline std::size_t networkPublicationCount() const
+    {
+        return m_publications.size();
+    }
+
+    inline std::size_t directPublicationCount() const
+    {
+        return m_directPublications.size();
+    }
+
+    inline std::size_t subscriptionCount() const
+    {
+        return m_subscriptionLinks.size();
+    }
+
+    inline std::size_t publicationImageCount() const
+    {
+        return m_images.size();
+    }
+
+    inline std::size_t sendChannelEndpointCount() const
+    {
+        return m_sendChannelEndpoints.size();
+    }
+
+    inline std::size_t receiveChannelEndpointCount() const
+    {
+        return m_receiveChannelEndpoints.size();
+    }
+
+private:
+    static const std::int32_t NULL_COUNTER_ID = -1;
+
+    enum PublicationStatus
+    {
+        PUBLICATION_ACTIVE, PUBLICATION_DRAINING, PUBLICATION_LINGER
+    };
+
+    struct AeronClient
+    {
+        std::int64_t clientId;
+        std::int64_t timeOfLastKeepaliveNs;
+    };
+
+    struct ImageSubscriber
+    {
+        std::int64_t registrationId;
+        std::int32_t positionId;
+    };
+
+    struct PublicationEntry
+    {
+        NetworkPublication::ptr_t publication;
+        std::string channel;
+        std::unique_ptr<Position<UnsafeBufferPosition>> publisherLimit;
+        std::int32_t refCount;
+        PublicationStatus status;
+        std::int64_t timeOfLastStatusChangeNs;
+        std::vector<ImageSubscriber> spies;
+    };
+
+    struct PublicationLink
+    {
+        std::int64_t registrationId;
+        std::int64_t clientId;
+        NetworkPublication* publication;
+        DirectPublication* directPublication;
+    };
+
+    struct SubscriptionLink
+    {
+        std::int64_t registrationId;
+        std::int64_t clientId;
+        std::int32_t streamId;
+        std::string channel;
+        std::string uri;
+    };
+
+    struct ReceiveChannelEndpointEntry
+    {
+        std::shared_ptr<ReceiveChannelEndpoint> endpoint;
+        std::shared_ptr<DataPacketDispatcher> dispatcher;
+        std::unordered_map<std::int32_t, std::int32_t> refCountByStreamId;
+    };
+
+    struct DirectPublicationEntry
+    {
+        DirectPublication::ptr_t publication;
+        std::int32_t refCount;
+        PublicationStatus status;
+        std::int64_t timeOfLastStatusChangeNs;
+        std::vector<ImageSubscriber> subscribers;
+    };
+
+    struct ImageEntry
+    {
+        PublicationImage::ptr_t image;
+        std::shared_ptr<DataPacketDispatcher> dispatcher;
+        std::string channel;
+        std::string uri;
+        std::int32_t hwmPositionId;
+        std::int32_t receiverWindowPositionId;
+        std::int32_t rttPositionId;
+        std::int32_t rttVariancePositionId;
+        std::int32_t congestionWindowPositionId;
+        std::vector<ImageSubscriber> subscribers;
+    };
+
+    MediaDriver::Context m_context;
+    ManyToOneRingBuffer m_toDriverCommands;
+    BroadcastTransmitter m_toClients;
+    ClientProxy m_clientProxy;
+    AtomicBuffer m_countersValuesBuffer;
+    CountersManager m_countersManager;
+    status::SystemCounters m_systemCounters;
+    std::shared_ptr<Sender> m_sender;
+    std::shared_ptr<Receiver> m_receiver;
+    SenderProxy m_senderProxy;
+    ReceiverProxy m_receiverProxy;
+    std::shared_ptr<DriverConductorProxy> m_conductorProxy;
+    concurrent::CommandQueue m_commandQueue;
+    StaticFeedbackDelayGenerator m_unicastFeedbackDelayGenerator;
+    OptimalMulticastDelayGenerator m_multicastFeedbackDelayGenerator;
+    StaticFeedbackDelayGenerator m_retransmitDelayGenerator;
+    StaticFeedbackDelayGenerator m_retransmitLingerGenerator;
+    nano_clock_t m_nanoClock;
+    epoch_clock_t m_epochClock;
+    std::default_random_engine m_random;
+
+    std::vector<AeronClient> m_clients;
+    std::vector<PublicationEntry> m_publications;
+    std::vector<DirectPublicationEntry> m_directPublications;
+    std::vector<PublicationLink> m_publicationLinks;
+    std::vector<SubscriptionLink> m_subscriptionLinks;
+    std::vector<ImageEntry> m_images;
+    std::unordered_map<std::string, std::shared_ptr<SendChannelEndpoint>> m_sendChannelEndpoints;
+    std::unordered_map<std::string, ReceiveChannelEndpointEntry> m_receiveChannelEndpoints;
+
+    std::int64_t m_timeOfLastTimerCheckNs;
+    std::int32_t m_nextSessionId;
+
+    void onClientCommand(std::int32_t msgTypeId, AtomicBuffer& buffer, util::index_t offset, util::index_t length);
+    void onAddPublication(
+        const std::string& channel, std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId);
+    void onAddDirectPublication(std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId);
+    void onRemovePublication(std::int64_t registrationId, std::int64_t correlationId);
+    void onAddSubscription(
+        const std::string& channel, std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId);
+    void onAddDirectSubscription(
+        const std::string& channel, std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId);
+    void onAddSpySubscription(
+        const std::string& channel, std::int32_t streamId, std::int64_t registrationId, std::int64_t clientId);
+    void onRemoveSubscription(std::int64_t registrationId, std::int64_t correlationId);
+    void onClientKeepalive(std::int64_t clientId);
+
+    std::int32_t updatePublications();
+    void onCheckTimers(std::int64_t nowNs);
+    void checkClients(std::int64_t nowNs);
+    void checkPublications(std::int64_t nowNs);
+    void checkDirectPublications(std::int64_t nowNs);
+    void checkImages(std::int64_t nowNs);
+
+    PublicationEntry& newNetworkPublication(
+        std::unique_ptr<UdpChannel>& udpChannel, std::int32_t streamId, std::int64_t registrationId);
+    void linkSpy(PublicationEntry& entry, const SubscriptionLink& link);
+    std::unique_ptr<FlowControl> newFlowControl(const UdpChannel& udpChannel);
+    std::unique_ptr<TokenBucket> newPacer(const UdpChannel& udpChannel);
+    static std::int32_t priorityClass(const UdpChannel& udpChannel);
+    std::unique_ptr<CongestionControl> newCongestionControl(
+        const UdpChannel& udpChannel,
+        std::int32_t mtuLength,
+        std::int64_t correlationId,
+        std::int32_t sessionId,
+        std::int32_t streamId,
+        const std::string& channel,
+        std::int32_t& windowPositionId);
+    std::shared_ptr<SendChannelEndpoint> getOrCreateSendChannelEndpoint(std::unique_ptr<UdpChannel>& udpChannel);
+    void unlinkPublication(const PublicationLink& link, std::int64_t nowNs);
+    void deletePublication(std::size_t index);
+
+    DirectPublicationEntry& newDirectPublication(std::int32_t streamId, std::int64_t registrationId);
+    void linkDirectPublication(DirectPublicationEntry& entry, const SubscriptionLink& link);
+    void deleteDirectPublication(std::size_t index);
+
+    ReceiveChannelEndpointEntry& getOrCreateReceiveChannelEndpoint(std::unique_ptr<UdpChannel>& udpChannel);
+    void linkActiveImages(const SubscriptionLink& link);
+    void unlinkSubscription(const SubscriptionLink& link);
+    void deleteImage(std::size_t index);
+
+    std::int32_t allocatePositionCounter(
+        const char* name,
+        std::int32_t typeId,
+        std::int64_t registrationId,
+        std::int32_t sessionId,
+        std::int32_t streamId,
+        const std::string& channel);
+    std::string logFileName(const char* directory, std::int64_t correlationId) const;
+};
+
+}};
+
+#endif
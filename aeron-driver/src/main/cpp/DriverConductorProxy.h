@@ -18,18 +18,29 @@
 #define AERON_DRIVERCONDUCTORPROXY_H
 
 #include <cstdint>
+#include <memory>
 
 #include "media/InetAddress.h"
 #include "media/ReceiveChannelEndpoint.h"
 
+#include "DriverConductor.h"
+
 namespace aeron { namespace driver {
 
 using namespace aeron::driver::media;
 
+/**
+ * Hands requests from the receive side of the driver over to the DriverConductor. They are made on the conductor
+ * straight away when both run on the same thread, otherwise they are queued for the conductor to execute on its own
+ * thread, with copies of anything that lives in the buffers of the Receiver.
+ */
 class DriverConductorProxy
 {
 public:
-    DriverConductorProxy() {}
+    DriverConductorProxy(ThreadingMode threadingMode = SHARED, DriverConductor* driverConductor = nullptr) :
+        m_threadingMode(threadingMode), m_driverConductor(driverConductor)
+    {
+    }
 
     inline COND_MOCK_VIRTUAL void createPublicationImage(
         std::int32_t sessionId,
@@ -43,7 +54,47 @@ public:
         InetAddress& srcAddress,
         ReceiveChannelEndpoint& channelEndpoint)
     {
+        if (SHARED == m_threadingMode)
+        {
+            m_driverConductor->onCreatePublicationImage(
+                sessionId,
+                streamId,
+                initialTermId,
+                activeTermId,
+                termOffset,
+                termLength,
+                mtuLength,
+                controlAddress,
+                srcAddress,
+                channelEndpoint);
+        }
+        else
+        {
+            DriverConductor* driverConductor = m_driverConductor;
+            ReceiveChannelEndpoint* endpoint = &channelEndpoint;
+            std::shared_ptr<InetAddress> control = InetAddress::copyOf(controlAddress);
+            std::shared_ptr<InetAddress> source = InetAddress::copyOf(srcAddress);
+
+            m_driverConductor->commandQueue().offer([=]()
+            {
+                driverConductor->onCreatePublicationImage(
+                    sessionId,
+                    streamId,
+                    initialTermId,
+                    activeTermId,
+                    termOffset,
+                    termLength,
+                    mtuLength,
+                    *control,
+                    *source,
+                    *endpoint);
+            });
+        }
     }
+
+private:
+    ThreadingMode m_threadingMode;
+    DriverConductor* m_driverConductor;
 };
 
 }};
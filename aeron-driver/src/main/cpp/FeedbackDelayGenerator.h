@@ -17,6 +17,10 @@
 #ifndef AERON_FEEDBACKDELAYGENERATOR_H
 #define AERON_FEEDBACKDELAYGENERATOR_H
 
+#include <cmath>
+#include <cstdint>
+#include <random>
+
 namespace aeron { namespace driver {
 
 class FeedbackDelayGenerator
@@ -42,7 +46,7 @@ public:
      */
     bool shouldFeedbackImmediately()
     {
-        return false;
+        return m_feedbackImmediately;
     }
 
 private:
@@ -66,6 +70,49 @@ private:
     std::int64_t m_delay;
 };
 
+/**
+ * Randomised exponential backoff for NAKs from a multicast group, so that when many receivers see the same loss only
+ * a few of them NAK before the retransmit arrives and suppresses the rest.
+ *
+ * Delays fall between 0 and the max backoff, with the density rising exponentially towards the max backoff. The rise
+ * is set by the expected group size: the larger the group, the fewer receivers pick an early delay. See "Optimal
+ * Multicast Feedback" by Nonnenmacher and Biersack.
+ */
+class OptimalMulticastDelayGenerator : public FeedbackDelayGenerator
+{
+public:
+    OptimalMulticastDelayGenerator(std::int64_t maxBackoffNs, std::int64_t groupSize)
+        : OptimalMulticastDelayGenerator(maxBackoffNs, groupSize, std::random_device{}())
+    {
+    }
+
+    OptimalMulticastDelayGenerator(std::int64_t maxBackoffNs, std::int64_t groupSize, std::uint32_t seed)
+        : FeedbackDelayGenerator(false), m_random(seed)
+    {
+        const double maxBackoff = (double) maxBackoffNs;
+        const double lambda = std::log((double) groupSize) + 1;
+
+        m_uniform = std::uniform_real_distribution<double>(0.0, lambda / maxBackoff);
+        m_baseX = lambda / (maxBackoff * (std::exp(lambda) - 1));
+        m_constantT = maxBackoff / lambda;
+        m_factorT = (std::exp(lambda) - 1) * (maxBackoff / lambda);
+    }
+
+    virtual std::int64_t generateDelay() override
+    {
+        const double x = m_uniform(m_random) + m_baseX;
+
+        return (std::int64_t) (m_constantT * std::log(x * m_factorT));
+    }
+
+private:
+    std::default_random_engine m_random;
+    std::uniform_real_distribution<double> m_uniform;
+    double m_baseX;
+    double m_constantT;
+    double m_factorT;
+};
+
 }}
 
 #endif //AERON_FEEDBACKDELAYGENERATOR_H
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_FLOWCONTROL__
+#define INCLUDED_AERON_DRIVER_FLOWCONTROL__
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "aeron/concurrent/logbuffer/LogBufferDescriptor.h"
+#include "aeron/protocol/StatusMessageFlyweight.h"
+
+#include "media/InetAddress.h"
+
+namespace aeron { namespace driver {
+
+/**
+ * Strategy for working out how far a NetworkPublication may send, from the status messages its receivers send back.
+ * Called from the Sender duty cycle only.
+ */
+class FlowControl
+{
+public:
+    virtual ~FlowControl() = default;
+
+    /**
+     * Update the sender limit from a status message.
+     *
+     * @param statusMessage       received.
+     * @param receiverAddress     the status message came from.
+     * @param senderLimit         currently applied.
+     * @param initialTermId       of the publication.
+     * @param positionBitsToShift for the term length of the publication.
+     * @param nowNs               current time.
+     * @return the new sender limit.
+     */
+    virtual std::int64_t onStatusMessage(
+        protocol::StatusMessageFlyweight& statusMessage,
+        media::InetAddress& receiverAddress,
+        std::int64_t senderLimit,
+        std::int32_t initialTermId,
+        std::int32_t positionBitsToShift,
+        std::int64_t nowNs) = 0;
+
+    /**
+     * Called when the publication has nothing to send, to let the sender limit be updated on timers.
+     *
+     * @param nowNs       current time.
+     * @param senderLimit currently applied.
+     * @return the new sender limit.
+     */
+    virtual std::int64_t onIdle(std::int64_t nowNs, std::int64_t senderLimit)
+    {
+        return senderLimit;
+    }
+
+protected:
+    static inline std::int64_t positionPlusWindow(
+        protocol::StatusMessageFlyweight& statusMessage, std::int32_t initialTermId, std::int32_t positionBitsToShift)
+    {
+        const std::int64_t position = aeron::concurrent::logbuffer::LogBufferDescriptor::computePosition(
+            statusMessage.consumptionTermId(),
+            statusMessage.consumptionTermOffset(),
+            positionBitsToShift,
+            initialTermId);
+
+        return position + statusMessage.receiverWindow();
+    }
+};
+
+typedef std::function<std::unique_ptr<FlowControl>()> flow_control_supplier_t;
+
+/**
+ * Flow control for a single receiver, the sender limit is the furthest any status message has allowed.
+ */
+class UnicastFlowControl : public FlowControl
+{
+public:
+    virtual std::int64_t onStatusMessage(
+        protocol::StatusMessageFlyweight& statusMessage,
+        media::InetAddress& receiverAddress,
+        std::int64_t senderLimit,
+        std::int32_t initialTermId,
+        std::int32_t positionBitsToShift,
+        std::int64_t nowNs) override
+    {
+        return std::max(senderLimit, positionPlusWindow(statusMessage, initialTermId, positionBitsToShift));
+    }
+};
+
+/**
+ * Flow control for multicast that keeps up with the fastest receiver. Slower receivers are left to recover what they
+ * miss with NAKs, or drop out, so one slow receiver can not hold back the group. Following the furthest status message
+ * from any receiver is what UnicastFlowControl already does.
+ */
+typedef UnicastFlowControl MaxMulticastFlowControl;
+
+/**
+ * Flow control for multicast that holds the sender to the slowest receiver, so no receiver is overrun.
+ *
+ * Receivers are told apart by the address their status messages come from. A receiver that has not sent a status
+ * message for the receiver timeout is dropped, so a receiver that has gone away does not stall the group for good.
+ * Until the first status message arrives the sender limit is left as it is.
+ */
+class MinMulticastFlowControl : public FlowControl
+{
+public:
+    static const std::int64_t RECEIVER_TIMEOUT_NS = 2000L * 1000 * 1000;
+
+    MinMulticastFlowControl(std::int64_t receiverTimeoutNs = RECEIVER_TIMEOUT_NS)
+        : m_receiverTimeoutNs(receiverTimeoutNs)
+    {
+    }
+
+    virtual std::int64_t onStatusMessage(
+        protocol::StatusMessageFlyweight& statusMessage,
+        media::InetAddress& receiverAddress,
+        std::int64_t senderLimit,
+        std::int32_t initialTermId,
+        std::int32_t positionBitsToShift,
+        std::int64_t nowNs) override
+    {
+        const std::int64_t limit = positionPlusWindow(statusMessage, initialTermId, positionBitsToShift);
+        std::int64_t minLimit = std::numeric_limits<std::int64_t>::max();
+        bool isExisting = false;
+
+        for (auto& receiver : m_receivers)
+        {
+            if (*receiver.address == receiverAddress)
+            {
+                receiver.positionPlusWindow = limit;
+                receiver.timeOfLastStatusMessageNs = nowNs;
+                isExisting = true;
+            }
+
+            minLimit = std::min(minLimit, receiver.positionPlusWindow);
+        }
+
+        if (!isExisting)
+        {
+            m_receivers.push_back(Receiver{media::InetAddress::copyOf(receiverAddress), limit, nowNs});
+            minLimit = std::min(minLimit, limit);
+        }
+
+        return minLimit;
+    }
+
+    virtual std::int64_t onIdle(std::int64_t nowNs, std::int64_t senderLimit) override
+    {
+        std::int64_t minLimit = std::numeric_limits<std::int64_t>::max();
+
+        for (std::size_t i = m_receivers.size(); i-- > 0;)
+        {
+            const Receiver& receiver = m_receivers[i];
+
+            if (nowNs > (receiver.timeOfLastStatusMessageNs + m_receiverTimeoutNs))
+            {
+                m_receivers.erase(m_receivers.begin() + i);
+            }
+            else
+            {
+                minLimit = std::min(minLimit, receiver.positionPlusWindow);
+            }
+        }
+
+        return m_receivers.empty() ? senderLimit : minLimit;
+    }
+
+    inline std::size_t receiverCount() const
+    {
+        return m_receivers.size();
+    }
+
+private:
+    struct Receiver
+    {
+        std::unique_ptr<media::InetAddress> address;
+        std::int64_t positionPlusWindow;
+        std::int64_t timeOfLastStatusMessageNs;
+    };
+
+    const std::int64_t m_receiverTimeoutNs;
+    std::vector<Receiver> m_receivers;
+};
+
+}};
+
+#endif
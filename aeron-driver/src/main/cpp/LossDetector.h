@@ -0,0 +1,224 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_LOSSDETECTOR__
+#define INCLUDED_AERON_DRIVER_LOSSDETECTOR__
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "aeron/concurrent/AtomicBuffer.h"
+#include "aeron/concurrent/logbuffer/FrameDescriptor.h"
+#include "aeron/util/BitUtil.h"
+
+#include "FeedbackDelayGenerator.h"
+
+namespace aeron { namespace driver {
+
+/**
+ * Called to send a NAK for a range of a term.
+ */
+typedef std::function<void(std::int32_t termId, std::int32_t termOffset, std::int32_t length)> nak_handler_t;
+
+/**
+ * Finds the gaps in the term being rebuilt for a PublicationImage and NAKs them.
+ *
+ * Every gap between the rebuild position and the high-water mark is found in one scan. Gaps with less than the
+ * coalesce length of received data between them are merged into one range, so a burst of scattered loss is recovered
+ * with one NAK and retransmit rather than one per gap. Each range has its own timer from the FeedbackDelayGenerator:
+ * it is NAKed when the timer expires, or straight away when feedback is immediate, and again after every further delay
+ * until it is filled. A range that changes shape as retransmits fill part of it keeps the timer it had.
+ *
+ * Called from the Receiver duty cycle only.
+ */
+class LossDetector
+{
+public:
+    static const std::int32_t DEFAULT_COALESCE_LENGTH = 1024;
+
+    LossDetector(
+        FeedbackDelayGenerator& delayGenerator,
+        nak_handler_t nakHandler,
+        std::int32_t coalesceLength = DEFAULT_COALESCE_LENGTH)
+        : m_delayGenerator(delayGenerator), m_nakHandler(std::move(nakHandler)), m_coalesceLength(coalesceLength)
+    {
+    }
+
+    /**
+     * Scan the term the rebuild position is in, up to the high-water mark or the end of the term, for gaps and send
+     * the NAKs that are due.
+     *
+     * @param termBuffer          the rebuild position is in.
+     * @param rebuildPosition     up to which the stream is complete.
+     * @param hwmPosition         the furthest position data has been received for.
+     * @param nowNs               current time.
+     * @param termLengthMask      of the image.
+     * @param positionBitsToShift of the image.
+     * @param initialTermId       of the image.
+     * @return number of NAKs sent.
+     */
+    inline std::int32_t scan(
+        aeron::concurrent::AtomicBuffer& termBuffer,
+        std::int64_t rebuildPosition,
+        std::int64_t hwmPosition,
+        std::int64_t nowNs,
+        std::int32_t termLengthMask,
+        std::int32_t positionBitsToShift,
+        std::int32_t initialTermId)
+    {
+        m_scannedGaps.clear();
+
+        if (rebuildPosition < hwmPosition)
+        {
+            const std::int32_t rebuildOffset = (std::int32_t) rebuildPosition & termLengthMask;
+            const std::int64_t limitPosition = std::min<std::int64_t>(
+                termLengthMask + 1, rebuildOffset + (hwmPosition - rebuildPosition));
+            const std::int32_t limitOffset = (std::int32_t) limitPosition;
+            const std::int32_t termId = initialTermId + (std::int32_t) (rebuildPosition >> positionBitsToShift);
+
+            scanForGaps(termBuffer, termId, rebuildOffset, limitOffset);
+        }
+
+        for (Gap& gap : m_scannedGaps)
+        {
+            gap.expiryNs = expiryOfExistingGap(gap);
+
+            if (NO_EXPIRY == gap.expiryNs)
+            {
+                gap.expiryNs = m_delayGenerator.shouldFeedbackImmediately() ?
+                    nowNs : nowNs + m_delayGenerator.generateDelay();
+            }
+        }
+
+        m_activeGaps.swap(m_scannedGaps);
+
+        std::int32_t naksSent = 0;
+        for (Gap& gap : m_activeGaps)
+        {
+            if (nowNs >= gap.expiryNs)
+            {
+                m_nakHandler(gap.termId, gap.termOffset, gap.length);
+                gap.expiryNs = nowNs + m_delayGenerator.generateDelay();
+                naksSent++;
+            }
+        }
+
+        return naksSent;
+    }
+
+    /**
+     * Number of ranges found by the last scan that are still to be filled.
+     */
+    inline std::size_t activeGapCount() const
+    {
+        return m_activeGaps.size();
+    }
+
+private:
+    static const std::int64_t NO_EXPIRY = -1;
+
+    struct Gap
+    {
+        std::int32_t termId;
+        std::int32_t termOffset;
+        std::int32_t length;
+        std::int64_t expiryNs;
+    };
+
+    FeedbackDelayGenerator& m_delayGenerator;
+    nak_handler_t m_nakHandler;
+    const std::int32_t m_coalesceLength;
+    std::vector<Gap> m_activeGaps;
+    std::vector<Gap> m_scannedGaps;
+
+    /**
+     * Walk the frames from the rebuild offset. A zero frame length starts a gap, which runs until the next frame
+     * alignment boundary with a frame on it, as the rest of the term is clean until data is inserted.
+     */
+    inline void scanForGaps(
+        aeron::concurrent::AtomicBuffer& termBuffer, std::int32_t termId, std::int32_t offset, std::int32_t limitOffset)
+    {
+        namespace FrameDescriptor = aeron::concurrent::logbuffer::FrameDescriptor;
+
+        while (offset < limitOffset)
+        {
+            const std::int32_t frameLength = FrameDescriptor::frameLengthVolatile(termBuffer, offset);
+
+            if (frameLength > 0)
+            {
+                offset += aeron::util::BitUtil::align(frameLength, FrameDescriptor::FRAME_ALIGNMENT);
+                continue;
+            }
+
+            const std::int32_t gapBeginOffset = offset;
+            offset += FrameDescriptor::FRAME_ALIGNMENT;
+
+            while (offset < limitOffset && 0 == FrameDescriptor::frameLengthVolatile(termBuffer, offset))
+            {
+                offset += FrameDescriptor::FRAME_ALIGNMENT;
+            }
+
+            onGap(termId, gapBeginOffset, offset - gapBeginOffset);
+        }
+    }
+
+    inline void onGap(std::int32_t termId, std::int32_t termOffset, std::int32_t length)
+    {
+        if (!m_scannedGaps.empty())
+        {
+            Gap& last = m_scannedGaps.back();
+            const std::int32_t lastEndOffset = last.termOffset + last.length;
+
+            if (termOffset - lastEndOffset <= m_coalesceLength)
+            {
+                last.length = (termOffset + length) - last.termOffset;
+                return;
+            }
+        }
+
+        m_scannedGaps.push_back(Gap{termId, termOffset, length, NO_EXPIRY});
+    }
+
+    /**
+     * The earliest expiry of the active gaps a scanned gap overlaps, as a gap that was partly filled or merged with
+     * another keeps the timer it had.
+     */
+    inline std::int64_t expiryOfExistingGap(const Gap& gap) const
+    {
+        std::int64_t expiryNs = NO_EXPIRY;
+
+        for (const Gap& active : m_activeGaps)
+        {
+            const bool isOverlapping =
+                active.termId == gap.termId &&
+                active.termOffset < (gap.termOffset + gap.length) &&
+                gap.termOffset < (active.termOffset + active.length);
+
+            if (isOverlapping && (NO_EXPIRY == expiryNs || active.expiryNs < expiryNs))
+            {
+                expiryNs = active.expiryNs;
+            }
+        }
+
+        return expiryNs;
+    }
+};
+
+}};
+
+#endif
@@ -14,9 +14,42 @@
  * limitations under the License.
  */
 
+
+#include <sys/stat.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+
+#include "aeron/Context.h"
+#include "aeron/concurrent/CountersReader.h"
+#include "aeron/concurrent/broadcast/BroadcastBufferDescriptor.h"
+#include "aeron/concurrent/ringbuffer/RingBufferDescriptor.h"
+#include "aeron/util/Exceptions.h"
+#include "aeron/util/StringUtil.h"
+
+#include "DriverConductor.h"
 #include "MediaDriver.h"
+#include "Receiver.h"
+#include "Sender.h"
 
+using namespace aeron;
+using namespace aeron::concurrent::broadcast;
+using namespace aeron::concurrent::ringbuffer;
 using namespace aeron::driver;
+using namespace aeron::util;
+
+static long nanoClock()
+{
+    return (long) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static long epochClock()
+{
+    return (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
 
 MediaDriver::MediaDriver(std::map<std::string, std::string>& properties) :
     m_properties(std::move(properties))
@@ -28,7 +61,156 @@ MediaDriver::MediaDriver(std::string &propertiesFile)
 
 }
 
+static MemoryMappedFile::ptr_t createCncFile(const MediaDriver::Context& context)
+{
+    if (0 != ::mkdir(context.aeronDir().c_str(), S_IRWXU | S_IRWXG | S_IRWXO) && EEXIST != errno)
+    {
+        throw IOException(
+            strPrintf("could not create directory %s: %s", context.aeronDir().c_str(), strerror(errno)), SOURCEINFO);
+    }
+
+    CncFileDescriptor::MetaDataDefn metaData;
+    metaData.cncVersion = 0;
+    metaData.toDriverBufferLength = context.toDriverBufferLength() + RingBufferDescriptor::TRAILER_LENGTH;
+    metaData.toClientsBufferLength = context.toClientsBufferLength() + BroadcastBufferDescriptor::TRAILER_LENGTH;
+    metaData.counterValuesBufferLength = context.counterValuesBufferLength();
+    metaData.counterMetadataBufferLength =
+        (context.counterValuesBufferLength() / CountersReader::COUNTER_LENGTH) * CountersReader::METADATA_LENGTH;
+    metaData.clientLivenessTimeout = context.clientLivenessTimeoutNs();
+    metaData.errorLogBufferLength = 0;
+
+    const size_t cncLength =
+        CncFileDescriptor::VERSION_AND_META_DATA_LENGTH +
+        metaData.toDriverBufferLength +
+        metaData.toClientsBufferLength +
+        metaData.counterMetadataBufferLength +
+        metaData.counterValuesBufferLength +
+        metaData.errorLogBufferLength;
+
+    const std::string cncFileName = context.aeronDir() + "/" + CncFileDescriptor::CNC_FILE;
+    MemoryMappedFile::ptr_t cncFile = MemoryMappedFile::createNew(cncFileName.c_str(), 0, cncLength);
+
+    AtomicBuffer metaDataBuffer(cncFile->getMemoryPtr(), cncFile->getMemorySize());
+    metaDataBuffer.overlayStruct<CncFileDescriptor::MetaDataDefn>(0) = metaData;
+
+    return cncFile;
+}
+
+MediaDriver::MediaDriver(const Context& context) :
+    m_context(context),
+    m_errorHandler(context.errorHandler()),
+    m_cncFile(createCncFile(context)),
+    m_toDriverBuffer(CncFileDescriptor::createToDriverBuffer(m_cncFile)),
+    m_toClientsBuffer(CncFileDescriptor::createToClientsBuffer(m_cncFile)),
+    m_countersMetadataBuffer(CncFileDescriptor::createCounterMetadataBuffer(m_cncFile)),
+    m_countersValuesBuffer(CncFileDescriptor::createCounterValuesBuffer(m_cncFile))
+{
+    m_sender = std::make_shared<Sender>(
+        nanoClock,
+        m_context.highPriorityQuantumLength(),
+        m_context.normalPriorityQuantumLength(),
+        m_context.lowPriorityQuantumLength());
+    std::unique_ptr<media::PacketRingTransportPoller> packetRingTransportPoller;
+    if (!m_context.packetRingInterface().empty())
+    {
+        try
+        {
+            packetRingTransportPoller.reset(
+                new media::PacketRingTransportPoller(m_context.packetRingInterface().c_str()));
+        }
+        catch (IOException& e)
+        {
+            m_errorHandler(e);
+        }
+    }
+
+    m_receiver = std::make_shared<Receiver>(nanoClock, std::move(packetRingTransportPoller));
+    m_conductor = std::make_shared<DriverConductor>(
+        m_context,
+        m_toDriverBuffer,
+        m_toClientsBuffer,
+        m_countersMetadataBuffer,
+        m_countersValuesBuffer,
+        m_sender,
+        m_receiver,
+        nanoClock,
+        epochClock);
+
+    // clients wait on the version, so it is set once the rest of the file is ready for them
+    AtomicBuffer metaDataBuffer(m_cncFile->getMemoryPtr(), m_cncFile->getMemorySize());
+    metaDataBuffer.putInt32Ordered(offsetof(CncFileDescriptor::MetaDataDefn, cncVersion), CncFileDescriptor::CNC_VERSION);
+}
+
 MediaDriver::~MediaDriver()
 {
+    close();
+}
+
+void MediaDriver::start()
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    switch (m_context.threadingMode())
+    {
+        case DEDICATED:
+            addRunner(m_context.conductorIdleStrategy(), concurrent::CompositeAgent().add(m_conductor));
+            addRunner(m_context.senderIdleStrategy(), concurrent::CompositeAgent().add(m_sender));
+            addRunner(m_context.receiverIdleStrategy(), concurrent::CompositeAgent().add(m_receiver));
+            break;
+
+        case SHARED_NETWORK:
+            addRunner(m_context.conductorIdleStrategy(), concurrent::CompositeAgent().add(m_conductor));
+            addRunner(
+                m_context.sharedNetworkIdleStrategy(), concurrent::CompositeAgent().add(m_sender).add(m_receiver));
+            break;
+
+        case SHARED:
+            addRunner(
+                m_context.sharedIdleStrategy(),
+                concurrent::CompositeAgent().add(m_conductor).add(m_sender).add(m_receiver));
+            break;
+    }
+
+    for (auto& entry : m_runners)
+    {
+        entry->runner->start();
+    }
+
+    m_running = true;
+}
+
+void MediaDriver::close()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    for (auto& entry : m_runners)
+    {
+        entry->runner->close();
+    }
+
+    m_runners.clear();
+
+    // queued commands hold on to the endpoints and images they refer to, so they are run now that no agent will
+    m_conductor->commandQueue().drain();
+    m_sender->commandQueue().drain();
+    m_receiver->commandQueue().drain();
+    m_conductor->close();
+
+    m_running = false;
+}
+
+MediaDriver::agent_runner_t& MediaDriver::addRunner(
+    const concurrent::IdleStrategy& idleStrategy, concurrent::CompositeAgent agent)
+{
+    std::unique_ptr<AgentRunnerEntry> entry{new AgentRunnerEntry{std::move(agent), idleStrategy, nullptr}};
+    entry->runner.reset(new agent_runner_t(entry->agent, entry->idleStrategy, m_errorHandler));
+    m_runners.push_back(std::move(entry));
 
+    return *m_runners.back()->runner;
 }
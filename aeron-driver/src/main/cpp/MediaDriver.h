@@ -17,26 +17,614 @@
 #ifndef INCLUDED_AERON_DRIVER_MEDIADRIVER_H_
 #define INCLUDED_AERON_DRIVER_MEDIADRIVER_H_
 
+#include <cstdint>
+#include <functional>
+#include <iostream>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "aeron/Context.h"
+#include "aeron/concurrent/AgentRunner.h"
+#include "aeron/concurrent/BusySpinIdleStrategy.h"
+#include "aeron/concurrent/SleepingIdleStrategy.h"
+#include "aeron/util/MemoryMappedFile.h"
+
+#include "concurrent/CompositeAgent.h"
+#include "concurrent/IdleStrategy.h"
+
+#include "FlowControl.h"
 
 namespace aeron { namespace driver {
 
+typedef std::function<long()> nano_clock_t;
+typedef std::function<long()> epoch_clock_t;
+
+class Sender;
+class Receiver;
+class DriverConductor;
+
+/**
+ * How the conductor, sender and receiver agents of the driver are spread over threads.
+ *
+ * - DEDICATED: each agent has a thread of its own, for the lowest latency.
+ * - SHARED_NETWORK: the sender and receiver share a thread and the conductor has another.
+ * - SHARED: all agents share a single thread, to save cores on small machines.
+ */
+enum ThreadingMode
+{
+    DEDICATED, SHARED_NETWORK, SHARED
+};
+
+inline void defaultDriverErrorHandler(std::exception& exception)
+{
+    std::cerr << "ERROR: " << exception.what() << std::endl;
+}
 
 class MediaDriver
 {
 public:
     class Context
     {
+    public:
+        /**
+         * Use io_uring for the socket I/O of channel endpoints, where the kernel supports it, in place of socket calls.
+         */
+        inline Context& ioUring(bool ioUring)
+        {
+            m_ioUring = ioUring;
+            return *this;
+        }
+
+        inline bool ioUring() const
+        {
+            return m_ioUring;
+        }
+
+        /**
+         * Receive the datagrams of receive channel endpoints from an AF_PACKET ring on this interface, see PacketRing,
+         * in place of their sockets. Empty, the default, to receive from the sockets. Falls back to the sockets with an
+         * error reported when the ring can not be set up.
+         */
+        inline Context& packetRingInterface(const std::string& interfaceName)
+        {
+            m_packetRingInterface = interfaceName;
+            return *this;
+        }
+
+        inline const std::string& packetRingInterface() const
+        {
+            return m_packetRingInterface;
+        }
+
+        /**
+         * Directory holding the CnC file and the log buffers of publications and images.
+         */
+        inline Context& aeronDir(const std::string& dir)
+        {
+            m_aeronDir = dir;
+            return *this;
+        }
+
+        inline const std::string& aeronDir() const
+        {
+            return m_aeronDir;
+        }
+
+        /**
+         * Length of each term of the log buffers of publications, a power of 2.
+         */
+        inline Context& termBufferLength(std::int32_t length)
+        {
+            m_termBufferLength = length;
+            return *this;
+        }
+
+        inline std::int32_t termBufferLength() const
+        {
+            return m_termBufferLength;
+        }
+
+        /**
+         * Maximum length of the datagrams sent for publications.
+         */
+        inline Context& mtuLength(std::int32_t length)
+        {
+            m_mtuLength = length;
+            return *this;
+        }
+
+        inline std::int32_t mtuLength() const
+        {
+            return m_mtuLength;
+        }
+
+        /**
+         * Length of the receiver window images start out with, it is then tuned to how fast their subscribers drain
+         * them and is at most half a term.
+         */
+        inline Context& initialWindowLength(std::int32_t length)
+        {
+            m_initialWindowLength = length;
+            return *this;
+        }
+
+        inline std::int32_t initialWindowLength() const
+        {
+            return m_initialWindowLength;
+        }
+
+        /**
+         * Time after the last status message for an image at which another is sent even if its subscribers have not
+         * consumed past the gain of the window.
+         */
+        inline Context& statusMessageTimeoutNs(std::int64_t timeoutNs)
+        {
+            m_statusMessageTimeoutNs = timeoutNs;
+            return *this;
+        }
+
+        inline std::int64_t statusMessageTimeoutNs() const
+        {
+            return m_statusMessageTimeoutNs;
+        }
+
+        /**
+         * Time after the last keepalive from a client at which it is timed out and its resources are released.
+         */
+        inline Context& clientLivenessTimeoutNs(std::int64_t timeoutNs)
+        {
+            m_clientLivenessTimeoutNs = timeoutNs;
+            return *this;
+        }
+
+        inline std::int64_t clientLivenessTimeoutNs() const
+        {
+            return m_clientLivenessTimeoutNs;
+        }
+
+        /**
+         * Time after the last packet for an image at which it goes inactive, which is also how long it lingers for
+         * and how long its session is then ignored for.
+         */
+        inline Context& imageLivenessTimeoutNs(std::int64_t timeoutNs)
+        {
+            m_imageLivenessTimeoutNs = timeoutNs;
+            return *this;
+        }
+
+        inline std::int64_t imageLivenessTimeoutNs() const
+        {
+            return m_imageLivenessTimeoutNs;
+        }
+
+        /**
+         * Time a publication lingers for after it is removed, so it is still there to retransmit the tail of the
+         * stream.
+         */
+        inline Context& publicationLingerNs(std::int64_t lingerNs)
+        {
+            m_publicationLingerNs = lingerNs;
+            return *this;
+        }
+
+        inline std::int64_t publicationLingerNs() const
+        {
+            return m_publicationLingerNs;
+        }
+
+        /**
+         * How the agents of the driver are spread over threads.
+         */
+        inline Context& threadingMode(ThreadingMode mode)
+        {
+            m_threadingMode = mode;
+            return *this;
+        }
+
+        inline ThreadingMode threadingMode() const
+        {
+            return m_threadingMode;
+        }
+
+        /**
+         * Idle strategy for the conductor when it runs on a thread of its own.
+         */
+        inline Context& conductorIdleStrategy(const concurrent::IdleStrategy& idleStrategy)
+        {
+            m_conductorIdleStrategy = idleStrategy;
+            return *this;
+        }
+
+        inline const concurrent::IdleStrategy& conductorIdleStrategy() const
+        {
+            return m_conductorIdleStrategy;
+        }
+
+        /**
+         * Idle strategy for the sender when it runs on a thread of its own.
+         */
+        inline Context& senderIdleStrategy(const concurrent::IdleStrategy& idleStrategy)
+        {
+            m_senderIdleStrategy = idleStrategy;
+            return *this;
+        }
+
+        inline const concurrent::IdleStrategy& senderIdleStrategy() const
+        {
+            return m_senderIdleStrategy;
+        }
+
+        /**
+         * Idle strategy for the receiver when it runs on a thread of its own.
+         */
+        inline Context& receiverIdleStrategy(const concurrent::IdleStrategy& idleStrategy)
+        {
+            m_receiverIdleStrategy = idleStrategy;
+            return *this;
+        }
+
+        inline const concurrent::IdleStrategy& receiverIdleStrategy() const
+        {
+            return m_receiverIdleStrategy;
+        }
+
+        /**
+         * Idle strategy for the thread the sender and receiver share in SHARED_NETWORK mode.
+         */
+        inline Context& sharedNetworkIdleStrategy(const concurrent::IdleStrategy& idleStrategy)
+        {
+            m_sharedNetworkIdleStrategy = idleStrategy;
+            return *this;
+        }
+
+        inline const concurrent::IdleStrategy& sharedNetworkIdleStrategy() const
+        {
+            return m_sharedNetworkIdleStrategy;
+        }
+
+        /**
+         * Idle strategy for the single thread of SHARED mode.
+         */
+        inline Context& sharedIdleStrategy(const concurrent::IdleStrategy& idleStrategy)
+        {
+            m_sharedIdleStrategy = idleStrategy;
+            return *this;
+        }
+
+        inline const concurrent::IdleStrategy& sharedIdleStrategy() const
+        {
+            return m_sharedIdleStrategy;
+        }
+
+        /**
+         * Handler for exceptions thrown out of the duty cycles of the agents.
+         */
+        inline Context& errorHandler(const aeron::concurrent::logbuffer::exception_handler_t& handler)
+        {
+            m_errorHandler = handler;
+            return *this;
+        }
+
+        inline const aeron::concurrent::logbuffer::exception_handler_t& errorHandler() const
+        {
+            return m_errorHandler;
+        }
+
+        /**
+         * Length of the to-driver ring buffer of the CnC file, excluding its trailer. A power of 2.
+         */
+        inline Context& toDriverBufferLength(std::int32_t length)
+        {
+            m_toDriverBufferLength = length;
+            return *this;
+        }
+
+        inline std::int32_t toDriverBufferLength() const
+        {
+            return m_toDriverBufferLength;
+        }
+
+        /**
+         * Length of the to-clients broadcast buffer of the CnC file, excluding its trailer. A power of 2.
+         */
+        inline Context& toClientsBufferLength(std::int32_t length)
+        {
+            m_toClientsBufferLength = length;
+            return *this;
+        }
+
+        inline std::int32_t toClientsBufferLength() const
+        {
+            return m_toClientsBufferLength;
+        }
+
+        /**
+         * Length of the counter values buffer of the CnC file, which the metadata buffer is sized from.
+         */
+        inline Context& counterValuesBufferLength(std::int32_t length)
+        {
+            m_counterValuesBufferLength = length;
+            return *this;
+        }
+
+        inline std::int32_t counterValuesBufferLength() const
+        {
+            return m_counterValuesBufferLength;
+        }
+
+        /**
+         * Delay before a receiver on a unicast channel NAKs a gap. Unicast receivers NAK as soon as a gap is seen, this
+         * is the delay before the NAK is repeated.
+         */
+        inline Context& nakUnicastDelayNs(std::int64_t delayNs)
+        {
+            m_nakUnicastDelayNs = delayNs;
+            return *this;
+        }
+
+        inline std::int64_t nakUnicastDelayNs() const
+        {
+            return m_nakUnicastDelayNs;
+        }
+
+        /**
+         * Longest a receiver on a multicast channel backs off for before it NAKs a gap, see
+         * OptimalMulticastDelayGenerator.
+         */
+        inline Context& nakMulticastMaxBackoffNs(std::int64_t maxBackoffNs)
+        {
+            m_nakMulticastMaxBackoffNs = maxBackoffNs;
+            return *this;
+        }
+
+        inline std::int64_t nakMulticastMaxBackoffNs() const
+        {
+            return m_nakMulticastMaxBackoffNs;
+        }
+
+        /**
+         * Expected number of receivers in a multicast group, which shapes the NAK backoff so the group sends few NAKs
+         * for the same loss.
+         */
+        inline Context& nakMulticastGroupSize(std::int64_t groupSize)
+        {
+            m_nakMulticastGroupSize = groupSize;
+            return *this;
+        }
+
+        inline std::int64_t nakMulticastGroupSize() const
+        {
+            return m_nakMulticastGroupSize;
+        }
+
+        /**
+         * Delay before a publication retransmits a range it has been NAKed for, during which NAKs from other receivers
+         * for the same range are merged into the one retransmit. 0 to retransmit as soon as the first NAK arrives.
+         */
+        inline Context& retransmitDelayNs(std::int64_t delayNs)
+        {
+            m_retransmitDelayNs = delayNs;
+            return *this;
+        }
+
+        inline std::int64_t retransmitDelayNs() const
+        {
+            return m_retransmitDelayNs;
+        }
+
+        /**
+         * Time after a retransmit for which further NAKs for the same range are ignored, as they were most likely sent
+         * before the retransmit arrived.
+         */
+        inline Context& retransmitLingerNs(std::int64_t lingerNs)
+        {
+            m_retransmitLingerNs = lingerNs;
+            return *this;
+        }
+
+        inline std::int64_t retransmitLingerNs() const
+        {
+            return m_retransmitLingerNs;
+        }
+
+        /**
+         * Rate in bytes per second the data of each publication is paced to, for those that do not choose one with
+         * the pacing-rate parameter of their channel. 0 for no pacing.
+         */
+        inline Context& pacingRateBytesPerSecond(std::int64_t rateBytesPerSecond)
+        {
+            m_pacingRateBytesPerSecond = rateBytesPerSecond;
+            return *this;
+        }
+
+        inline std::int64_t pacingRateBytesPerSecond() const
+        {
+            return m_pacingRateBytesPerSecond;
+        }
+
+        /**
+         * Length a paced publication may send back to back, for those that do not choose one with the pacing-burst
+         * parameter of their channel. Never less than the MTU.
+         */
+        inline Context& pacingBurstLength(std::int32_t burstLength)
+        {
+            m_pacingBurstLength = burstLength;
+            return *this;
+        }
+
+        inline std::int32_t pacingBurstLength() const
+        {
+            return m_pacingBurstLength;
+        }
+
+        /**
+         * Bytes the Sender credits a publication with priority=high on each cycle.
+         */
+        inline Context& highPriorityQuantumLength(std::int32_t quantumLength)
+        {
+            m_highPriorityQuantumLength = quantumLength;
+            return *this;
+        }
+
+        inline std::int32_t highPriorityQuantumLength() const
+        {
+            return m_highPriorityQuantumLength;
+        }
+
+        /**
+         * Bytes the Sender credits a publication with priority=normal, or no priority, on each cycle.
+         */
+        inline Context& normalPriorityQuantumLength(std::int32_t quantumLength)
+        {
+            m_normalPriorityQuantumLength = quantumLength;
+            return *this;
+        }
+
+        inline std::int32_t normalPriorityQuantumLength() const
+        {
+            return m_normalPriorityQuantumLength;
+        }
+
+        /**
+         * Bytes the Sender credits a publication with priority=low on each cycle.
+         */
+        inline Context& lowPriorityQuantumLength(std::int32_t quantumLength)
+        {
+            m_lowPriorityQuantumLength = quantumLength;
+            return *this;
+        }
+
+        inline std::int32_t lowPriorityQuantumLength() const
+        {
+            return m_lowPriorityQuantumLength;
+        }
+
+        /**
+         * Flow control for publications on unicast channels.
+         */
+        inline Context& unicastFlowControlSupplier(const flow_control_supplier_t& supplier)
+        {
+            m_unicastFlowControlSupplier = supplier;
+            return *this;
+        }
+
+        inline const flow_control_supplier_t& unicastFlowControlSupplier() const
+        {
+            return m_unicastFlowControlSupplier;
+        }
+
+        /**
+         * Flow control for publications on multicast channels that do not choose one with the fc parameter.
+         */
+        inline Context& multicastFlowControlSupplier(const flow_control_supplier_t& supplier)
+        {
+            m_multicastFlowControlSupplier = supplier;
+            return *this;
+        }
+
+        inline const flow_control_supplier_t& multicastFlowControlSupplier() const
+        {
+            return m_multicastFlowControlSupplier;
+        }
+
+    private:
+        bool m_ioUring = false;
+        std::string m_packetRingInterface;
+        std::string m_aeronDir = aeron::Context::defaultAeronPath();
+        std::int32_t m_termBufferLength = 16 * 1024 * 1024;
+        std::int32_t m_mtuLength = 4096;
+        std::int32_t m_initialWindowLength = 128 * 1024;
+        std::int64_t m_statusMessageTimeoutNs = 200L * 1000 * 1000;
+        std::int64_t m_clientLivenessTimeoutNs = 5000L * 1000 * 1000;
+        std::int64_t m_imageLivenessTimeoutNs = 10000L * 1000 * 1000;
+        std::int64_t m_publicationLingerNs = 5000L * 1000 * 1000;
+        ThreadingMode m_threadingMode = DEDICATED;
+        concurrent::IdleStrategy m_conductorIdleStrategy =
+            aeron::concurrent::SleepingIdleStrategy(std::chrono::milliseconds(1));
+        concurrent::IdleStrategy m_senderIdleStrategy = aeron::concurrent::BusySpinIdleStrategy();
+        concurrent::IdleStrategy m_receiverIdleStrategy = aeron::concurrent::BusySpinIdleStrategy();
+        concurrent::IdleStrategy m_sharedNetworkIdleStrategy = aeron::concurrent::BusySpinIdleStrategy();
+        concurrent::IdleStrategy m_sharedIdleStrategy =
+            aeron::concurrent::SleepingIdleStrategy(std::chrono::milliseconds(1));
+        aeron::concurrent::logbuffer::exception_handler_t m_errorHandler = defaultDriverErrorHandler;
+        std::int32_t m_toDriverBufferLength = 1024 * 1024;
+        std::int32_t m_toClientsBufferLength = 1024 * 1024;
+        std::int32_t m_counterValuesBufferLength = 1024 * 1024;
+        std::int64_t m_nakUnicastDelayNs = 60L * 1000 * 1000;
+        std::int64_t m_nakMulticastMaxBackoffNs = 60L * 1000 * 1000;
+        std::int64_t m_nakMulticastGroupSize = 10;
+        std::int64_t m_retransmitDelayNs = 0;
+        std::int64_t m_retransmitLingerNs = 60L * 1000 * 1000;
+        std::int64_t m_pacingRateBytesPerSecond = 0;
+        std::int32_t m_pacingBurstLength = 64 * 1024;
+        std::int32_t m_highPriorityQuantumLength = 256 * 1024;
+        std::int32_t m_normalPriorityQuantumLength = 64 * 1024;
+        std::int32_t m_lowPriorityQuantumLength = 16 * 1024;
+        flow_control_supplier_t m_unicastFlowControlSupplier =
+            []() { return std::unique_ptr<FlowControl>(new UnicastFlowControl()); };
+        flow_control_supplier_t m_multicastFlowControlSupplier =
+            []() { return std::unique_ptr<FlowControl>(new MaxMulticastFlowControl()); };
     };
 
     MediaDriver(std::map<std::string, std::string>& properties);
     MediaDriver(std::string& propertiesFile);
 
+    /**
+     * Driver with the CnC file and log buffers under the Aeron directory of the context. The CnC file is created
+     * straight away, so clients can map it, but no commands are serviced until the driver is started.
+     */
+    MediaDriver(const Context& context);
+
     ~MediaDriver();
 
+    /**
+     * Start the agent runners for the threading mode of the context.
+     */
+    void start();
+
+    /**
+     * Stop the agent runners, waiting for their threads to finish, and then close the publications, images and channel
+     * endpoints of the driver.
+     */
+    void close();
+
+    inline const Context& context() const
+    {
+        return m_context;
+    }
+
+    inline std::size_t agentRunnerCount() const
+    {
+        return m_runners.size();
+    }
+
 private:
+    typedef aeron::concurrent::AgentRunner<concurrent::CompositeAgent, concurrent::IdleStrategy> agent_runner_t;
+
+    struct AgentRunnerEntry
+    {
+        concurrent::CompositeAgent agent;
+        concurrent::IdleStrategy idleStrategy;
+        std::unique_ptr<agent_runner_t> runner;
+    };
+
     std::map<std::string, std::string> m_properties;
+    Context m_context;
+    aeron::concurrent::logbuffer::exception_handler_t m_errorHandler;
+    aeron::util::MemoryMappedFile::ptr_t m_cncFile;
+    aeron::concurrent::AtomicBuffer m_toDriverBuffer;
+    aeron::concurrent::AtomicBuffer m_toClientsBuffer;
+    aeron::concurrent::AtomicBuffer m_countersMetadataBuffer;
+    aeron::concurrent::AtomicBuffer m_countersValuesBuffer;
+    std::shared_ptr<Sender> m_sender;
+    std::shared_ptr<Receiver> m_receiver;
+    std::shared_ptr<DriverConductor> m_conductor;
+    std::vector<std::unique_ptr<AgentRunnerEntry>> m_runners;
+    bool m_running = false;
+
+    agent_runner_t& addRunner(const concurrent::IdleStrategy& idleStrategy, concurrent::CompositeAgent agent);
 };
 
 
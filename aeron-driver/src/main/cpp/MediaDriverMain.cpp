@@ -19,6 +19,7 @@
 #include <thread>
 #include <array>
 #include <atomic>
+#include <chrono>
 
 #include "aeron/util/CommandOptionParser.h"
 
@@ -36,12 +37,32 @@ void sigIntHandler (int param)
 
 static const char optHelp     = 'h';
 static const char optPrefix   = 'p';
+static const char optThreading = 't';
 
 struct Settings
 {
     std::string dirPrefix = "";
+    std::string threadingMode = "dedicated";
 };
 
+static aeron::driver::ThreadingMode parseThreadingMode(const std::string& threadingMode)
+{
+    if (threadingMode == "dedicated")
+    {
+        return aeron::driver::DEDICATED;
+    }
+    else if (threadingMode == "shared_network")
+    {
+        return aeron::driver::SHARED_NETWORK;
+    }
+    else if (threadingMode == "shared")
+    {
+        return aeron::driver::SHARED;
+    }
+
+    throw CommandOptionException(std::string("unknown threading mode: ") + threadingMode, SOURCEINFO);
+}
+
 Settings parseCmdLine(CommandOptionParser& cp, int argc, char** argv)
 {
     cp.parse(argc, argv);
@@ -54,6 +75,7 @@ Settings parseCmdLine(CommandOptionParser& cp, int argc, char** argv)
     Settings s;
 
     s.dirPrefix = cp.getOption(optPrefix).getParam(0, s.dirPrefix);
+    s.threadingMode = cp.getOption(optThreading).getParam(0, s.threadingMode);
 
     return s;
 }
@@ -63,6 +85,7 @@ int main(int argc, char** argv)
     CommandOptionParser cp;
     cp.addOption(CommandOption(optHelp, 0, 0, "                Displays help information."));
     cp.addOption(CommandOption(optPrefix, 1, 1, "dir             Prefix directory for aeron driver."));
+    cp.addOption(CommandOption(optThreading, 1, 1, "mode            Threading mode: dedicated, shared_network or shared."));
 
     signal(SIGINT, sigIntHandler);
 
@@ -70,16 +93,25 @@ int main(int argc, char** argv)
     {
         Settings settings = parseCmdLine(cp, argc, argv);
 
-//        if (settings.dirPrefix != "")
-//        {
-//            context.aeronDir(settings.dirPrefix);
-//        }
+        aeron::driver::MediaDriver::Context context;
 
-        while (running)
+        if (settings.dirPrefix != "")
         {
+            context.aeronDir(settings.dirPrefix);
+        }
+
+        context.threadingMode(parseThreadingMode(settings.threadingMode));
 
+        aeron::driver::MediaDriver driver{context};
+        driver.start();
+
+        while (running)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
 
+        driver.close();
+
         std::cout << "Shutting Down..." << std::endl;
     }
     catch (CommandOptionException& e)
@@ -0,0 +1,616 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_NETWORKPUBLICATION__
+#define INCLUDED_AERON_DRIVER_NETWORKPUBLICATION__
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "aeron/concurrent/AtomicBuffer.h"
+#include "aeron/concurrent/logbuffer/DataFrameHeader.h"
+#include "aeron/concurrent/logbuffer/FrameDescriptor.h"
+#include "aeron/concurrent/logbuffer/LogBufferDescriptor.h"
+#include "aeron/concurrent/status/UnsafeBufferPosition.h"
+#include "aeron/protocol/DataHeaderFlyweight.h"
+#include "aeron/protocol/SetupFlyweight.h"
+#include "aeron/protocol/StatusMessageFlyweight.h"
+#include "aeron/util/BitUtil.h"
+#include "aeron/util/MacroUtil.h"
+
+#include "buffer/MappedRawLog.h"
+#include "media/SendChannelEndpoint.h"
+
+#include "FlowControl.h"
+#include "MediaDriver.h"
+#include "RetransmitHandler.h"
+#include "TokenBucket.h"
+
+namespace aeron { namespace driver {
+
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::logbuffer;
+using namespace aeron::concurrent::status;
+using namespace aeron::driver::buffer;
+using namespace aeron::driver::media;
+
+/**
+ * A publication sent over UDP to a channel, whose log is appended to by clients and sent by the Sender.
+ *
+ * Each call to send() sends whatever has been appended since the sender position, up to the sender limit set by flow
+ * control, straight from the term buffer in datagrams of whole frames of up to the MTU. The sender position counter is
+ * advanced by what was sent, including any padding frame at the end of a term so the position moves on to the next
+ * term. Setup frames are sent until a status message has been received and heartbeats keep the stream alive when there
+ * is no data to send.
+ *
+ * Status messages from receivers are handed to the FlowControl strategy of the publication, which sets the sender
+ * limit. The limit is published in the sender limit counter so it can be watched alongside the sender position.
+ *
+ * NAKs are handed to the RetransmitHandler of the publication, which decides when a range is sent again. Retransmits
+ * are sent straight from the term buffer like new data, but only from what has already been sent.
+ *
+ * A publication with a TokenBucket is paced to its rate: new data is only sent while tokens are available and both
+ * new data and retransmits take the tokens for what they send.
+ *
+ * The priority class of a publication decides how the Sender schedules it against others, which it does by limiting
+ * how much new data each call to send() may send.
+ *
+ * Spy subscriptions read the log in place on the publishing side. Their positions are only touched by the
+ * DriverConductor, which holds back the publisher limit and cleaning of the log to the slowest of the sender and spies.
+ */
+class NetworkPublication
+{
+public:
+    typedef std::shared_ptr<NetworkPublication> ptr_t;
+
+    static const std::int64_t PUBLICATION_HEARTBEAT_TIMEOUT_NS = 100 * 1000 * 1000;
+    static const std::int64_t PUBLICATION_SETUP_TIMEOUT_NS = 100 * 1000 * 1000;
+
+    NetworkPublication(
+        const std::int64_t registrationId,
+        const std::int32_t sessionId,
+        const std::int32_t streamId,
+        const std::int32_t initialTermId,
+        const std::int32_t mtuLength,
+        const std::int32_t priorityClass,
+        std::unique_ptr<MappedRawLog> rawLog,
+        std::shared_ptr<SendChannelEndpoint> channelEndpoint,
+        std::unique_ptr<Position<UnsafeBufferPosition>> senderPosition,
+        std::unique_ptr<Position<UnsafeBufferPosition>> senderLimit,
+        std::unique_ptr<FlowControl> flowControl,
+        std::unique_ptr<RetransmitHandler> retransmitHandler,
+        std::unique_ptr<TokenBucket> pacer,
+        nano_clock_t nanoClock)
+        : m_registrationId(registrationId), m_sessionId(sessionId), m_streamId(streamId),
+        m_initialTermId(initialTermId), m_mtuLength(mtuLength), m_priorityClass(priorityClass),
+        m_rawLog(std::move(rawLog)),
+        m_channelEndpoint(channelEndpoint), m_senderPosition(std::move(senderPosition)),
+        m_senderLimit(std::move(senderLimit)), m_flowControl(std::move(flowControl)),
+        m_retransmitHandler(std::move(retransmitHandler)), m_pacer(std::move(pacer)),
+        m_resendHandler(
+            [this](std::int32_t termId, std::int32_t termOffset, std::int32_t length)
+            {
+                resend(termId, termOffset, length);
+            }),
+        m_nanoClock(nanoClock),
+        m_heartbeatBuffer(m_heartbeatBufferBytes, DataFrameHeader::LENGTH),
+        m_setupBuffer(m_setupBufferBytes, protocol::SetupFlyweight::headerLength()),
+        m_heartbeatFlyweight(m_heartbeatBuffer, 0),
+        m_setupFlyweight(m_setupBuffer, 0)
+    {
+        const std::int32_t termLength = m_rawLog->termLength();
+
+        m_termLengthMask = termLength - 1;
+        m_positionBitsToShift = util::BitUtil::numberOfTrailingZeroes(termLength);
+        m_cleanPosition = m_senderPosition->get();
+        m_senderPositionLimit = m_senderLimit->get();
+
+        const std::int64_t time = m_nanoClock();
+        m_timeOfLastSendOrHeartbeat = time - PUBLICATION_HEARTBEAT_TIMEOUT_NS - 1;
+        m_timeOfLastSetup = time - PUBLICATION_SETUP_TIMEOUT_NS - 1;
+
+        m_heartbeatBuffer.setMemory(0, m_heartbeatBuffer.capacity(), 0);
+        m_heartbeatFlyweight
+            .sessionId(sessionId)
+            .streamId(streamId)
+            .version(protocol::HeaderFlyweight::CURRENT_VERSION)
+            .flags((std::int8_t) FrameDescriptor::UNFRAGMENTED)
+            .type(protocol::HeaderFlyweight::HDR_TYPE_DATA)
+            .frameLength(0);
+
+        m_setupBuffer.setMemory(0, m_setupBuffer.capacity(), 0);
+        m_setupFlyweight
+            .sessionId(sessionId)
+            .streamId(streamId)
+            .initialTermId(initialTermId)
+            .termLength(termLength)
+            .mtu(mtuLength)
+            .version(protocol::HeaderFlyweight::CURRENT_VERSION)
+            .type(protocol::HeaderFlyweight::HDR_TYPE_SETUP)
+            .frameLength(protocol::SetupFlyweight::headerLength());
+    }
+
+    virtual ~NetworkPublication(){}
+
+    inline std::int64_t registrationId() const
+    {
+        return m_registrationId;
+    }
+
+    inline std::int32_t sessionId() const
+    {
+        return m_sessionId;
+    }
+
+    inline std::int32_t streamId() const
+    {
+        return m_streamId;
+    }
+
+    inline std::int32_t mtuLength() const
+    {
+        return m_mtuLength;
+    }
+
+    /**
+     * Class the Sender schedules this publication in, see Sender.
+     */
+    inline std::int32_t priorityClass() const
+    {
+        return m_priorityClass;
+    }
+
+    inline SendChannelEndpoint& sendChannelEndpoint()
+    {
+        return *m_channelEndpoint;
+    }
+
+    inline std::int64_t senderPosition()
+    {
+        return m_senderPosition->get();
+    }
+
+    inline std::int32_t senderPositionId()
+    {
+        return m_senderPosition->id();
+    }
+
+    inline std::int32_t senderLimitId()
+    {
+        return m_senderLimit->id();
+    }
+
+    /**
+     * Track the position of a spy subscription, which should have been set to the sender position.
+     */
+    inline void addSpyPosition(ReadablePosition<UnsafeBufferPosition>& position)
+    {
+        m_spyPositions.push_back(position);
+    }
+
+    inline void removeSpyPosition(std::int32_t counterId)
+    {
+        for (auto it = m_spyPositions.begin(); it != m_spyPositions.end(); ++it)
+        {
+            if (it->id() == counterId)
+            {
+                m_spyPositions.erase(it);
+                break;
+            }
+        }
+    }
+
+    inline std::size_t spyCount() const
+    {
+        return m_spyPositions.size();
+    }
+
+    /**
+     * Position of the slowest of the sender and any spies, which is as far as the log has been consumed.
+     */
+    inline std::int64_t consumerPosition()
+    {
+        std::int64_t position = m_senderPosition->getVolatile();
+
+        for (auto& spyPosition : m_spyPositions)
+        {
+            position = std::min(position, spyPosition.getVolatile());
+        }
+
+        return position;
+    }
+
+    inline std::int32_t termBufferLength() const
+    {
+        return m_termLengthMask + 1;
+    }
+
+    inline const char* logFileName()
+    {
+        return m_rawLog->logFileName();
+    }
+
+    /**
+     * Position up to which clients have claimed space in the log, from the tail counter of the active term.
+     */
+    inline std::int64_t producerPosition()
+    {
+        AtomicBuffer& logMetaDataBuffer = m_rawLog->logMetaDataBuffer();
+        const std::int32_t partitionIndex = LogBufferDescriptor::activePartitionIndex(logMetaDataBuffer);
+        const std::int64_t rawTail = logMetaDataBuffer.getInt64Volatile(
+            LogBufferDescriptor::TERM_TAIL_COUNTER_OFFSET + (partitionIndex * sizeof(std::int64_t)));
+        const std::int32_t termLength = m_termLengthMask + 1;
+
+        return LogBufferDescriptor::computePosition(
+            LogBufferDescriptor::termId(rawTail),
+            LogBufferDescriptor::termOffset(rawTail, termLength),
+            m_positionBitsToShift,
+            m_initialTermId);
+    }
+
+    /**
+     * Zero what lies more than a term behind the consumer position so the term is clean by the time clients append to
+     * it again, called from the DriverConductor duty cycle. Data still referenced by zero-copy sends is left until the
+     * Sender has seen the kernel release it, see zeroCopyHeldPosition().
+     *
+     * @return number of bytes cleaned.
+     */
+    inline std::int32_t cleanLogBuffer()
+    {
+        const std::int32_t termLength = m_termLengthMask + 1;
+        const std::int64_t cleanLimit = std::min(consumerPosition() - termLength, zeroCopyHeldPosition());
+        const std::int64_t cleanPosition = m_cleanPosition;
+
+        if (cleanLimit <= cleanPosition)
+        {
+            return 0;
+        }
+
+        const std::int32_t termOffset = (std::int32_t) cleanPosition & m_termLengthMask;
+        const std::int32_t length =
+            (std::int32_t) std::min<std::int64_t>(cleanLimit - cleanPosition, termLength - termOffset);
+        AtomicBuffer& dirtyTerm =
+            m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(cleanPosition, m_positionBitsToShift));
+
+        dirtyTerm.setMemory(termOffset, length, 0);
+        m_cleanPosition = cleanPosition + length;
+
+        return length;
+    }
+
+    /**
+     * Lowest position of the log the kernel may still be reading for a zero-copy send, or the maximum position when
+     * it holds none. Published by the Sender, which alone reaps the completions, and read by the DriverConductor to
+     * clean the log.
+     */
+    inline std::int64_t zeroCopyHeldPosition() const
+    {
+        return m_zeroCopyHeldPosition.load(std::memory_order_acquire);
+    }
+
+    inline std::int64_t senderPositionLimit() const
+    {
+        return m_senderPositionLimit;
+    }
+
+    /**
+     * Set the limit up to which data may be sent, as applied by flow control on receipt of a status message. As a
+     * receiver has then been heard from, setup frames are no longer sent.
+     */
+    inline void senderPositionLimit(std::int64_t positionLimit)
+    {
+        applySenderLimit(positionLimit);
+        m_shouldSendSetupFrame = false;
+    }
+
+    /**
+     * A status message for this publication has arrived on the channel endpoint, called from the Sender duty cycle.
+     * Either asks for a setup frame or carries a receiver position and window for flow control.
+     */
+    inline void onStatusMessage(protocol::StatusMessageFlyweight& statusMessage, InetAddress& receiverAddress)
+    {
+        if (protocol::StatusMessageFlyweight::SEND_SETUP_FLAG ==
+            (statusMessage.flags() & protocol::StatusMessageFlyweight::SEND_SETUP_FLAG))
+        {
+            triggerSendSetupFrame();
+            return;
+        }
+
+        senderPositionLimit(m_flowControl->onStatusMessage(
+            statusMessage,
+            receiverAddress,
+            m_senderPositionLimit,
+            m_initialTermId,
+            m_positionBitsToShift,
+            m_nanoClock()));
+    }
+
+    /**
+     * A NAK for this publication has arrived on the channel endpoint, called from the Sender duty cycle.
+     */
+    inline void onNak(std::int32_t termId, std::int32_t termOffset, std::int32_t length)
+    {
+        m_retransmitHandler->onNak(termId, termOffset, length, m_termLengthMask + 1, m_nanoClock(), m_resendHandler);
+    }
+
+    /**
+     * Start sending setup frames again, e.g. when a receiver asks for one.
+     */
+    inline void triggerSendSetupFrame()
+    {
+        m_shouldSendSetupFrame = true;
+    }
+
+    /**
+     * Send what is available to send, called from the Sender duty cycle.
+     *
+     * @param nowNs     current time.
+     * @param maxLength of new data that may be sent, retransmits are not limited.
+     * @return number of bytes of new data put on the wire, which leaves out the body of a padding frame at the end of
+     *         a term as only its header is sent.
+     */
+    inline COND_MOCK_VIRTUAL std::int32_t send(std::int64_t nowNs, std::int32_t maxLength)
+    {
+        const std::int64_t senderPosition = m_senderPosition->get();
+        const std::int32_t activeTermId = m_initialTermId + (std::int32_t) (senderPosition >> m_positionBitsToShift);
+        const std::int32_t termOffset = (std::int32_t) senderPosition & m_termLengthMask;
+
+        if (m_shouldSendSetupFrame)
+        {
+            setupMessageCheck(nowNs, activeTermId, termOffset);
+        }
+
+        releaseZeroCopySends();
+        m_retransmitHandler->processTimeouts(nowNs, m_resendHandler);
+
+        const std::int32_t bytesSent = sendData(nowNs, senderPosition, termOffset, maxLength);
+
+        if (0 == bytesSent)
+        {
+            heartbeatMessageCheck(nowNs, activeTermId, termOffset);
+            applySenderLimit(m_flowControl->onIdle(nowNs, m_senderPositionLimit));
+        }
+
+        return bytesSent;
+    }
+
+private:
+    inline std::int32_t sendData(
+        std::int64_t nowNs, std::int64_t senderPosition, std::int32_t termOffset, std::int32_t maxLength)
+    {
+        const std::int64_t availableWindow = m_senderPositionLimit - senderPosition;
+        if (availableWindow <= 0)
+        {
+            return 0;
+        }
+
+        const std::int32_t termLength = m_termLengthMask + 1;
+        std::int32_t length = (std::int32_t) std::min<std::int64_t>(
+            std::min<std::int64_t>(availableWindow, termLength - termOffset), maxLength);
+        if (nullptr != m_pacer)
+        {
+            length = std::min(length, m_pacer->available(nowNs));
+            if (0 == length)
+            {
+                return 0;
+            }
+        }
+
+        AtomicBuffer& termBuffer =
+            m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(senderPosition, m_positionBitsToShift));
+
+        // consumed covers any padding frame sent, so the position moves on to the next term at the end of this one
+        std::int32_t bytesSent = 0;
+        const std::int32_t consumed = sendFromTerm(senderPosition, termBuffer, termOffset, length, bytesSent);
+        if (consumed > 0)
+        {
+            m_senderPosition->setOrdered(senderPosition + consumed);
+            m_timeOfLastSendOrHeartbeat = nowNs;
+
+            if (nullptr != m_pacer)
+            {
+                m_pacer->consume(bytesSent);
+            }
+        }
+
+        return bytesSent;
+    }
+
+    /**
+     * Send a range of a term again in datagrams of up to the MTU. Only what lies within the last term length before
+     * the sender position is sent, as the rest has either not been sent yet or may already have been cleaned.
+     */
+    inline void resend(std::int32_t termId, std::int32_t termOffset, std::int32_t length)
+    {
+        const std::int64_t senderPosition = m_senderPosition->get();
+        const std::int64_t resendPosition =
+            LogBufferDescriptor::computePosition(termId, termOffset, m_positionBitsToShift, m_initialTermId);
+        const std::int32_t termLength = m_termLengthMask + 1;
+
+        if (resendPosition >= senderPosition || resendPosition < (senderPosition - termLength) || resendPosition < 0)
+        {
+            return;
+        }
+
+        const std::int32_t resendLength =
+            (std::int32_t) std::min<std::int64_t>(length, senderPosition - resendPosition);
+        AtomicBuffer& termBuffer =
+            m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(resendPosition, m_positionBitsToShift));
+        std::int32_t resent = 0;
+        std::int32_t bytesSent = 0;
+
+        while (resent < resendLength)
+        {
+            std::int32_t sent = 0;
+            const std::int32_t consumed = sendFromTerm(
+                resendPosition + resent, termBuffer, termOffset + resent, resendLength - resent, sent);
+
+            if (consumed <= 0)
+            {
+                break;
+            }
+
+            resent += consumed;
+            bytesSent += sent;
+        }
+
+        if (nullptr != m_pacer)
+        {
+            m_pacer->consume(bytesSent);
+        }
+    }
+
+    /**
+     * Send from the term at the given position, remembering it while the kernel holds any zero-copy sends made.
+     */
+    inline std::int32_t sendFromTerm(
+        std::int64_t position,
+        AtomicBuffer& termBuffer,
+        std::int32_t termOffset,
+        std::int32_t length,
+        std::int32_t& bytesSent)
+    {
+        const std::uint32_t sequenceBegin = m_channelEndpoint->zeroCopySequence();
+        const std::int32_t consumed =
+            m_channelEndpoint->sendFromTerm(termBuffer, termOffset, length, m_mtuLength, &bytesSent);
+        const std::uint32_t sequenceEnd = m_channelEndpoint->zeroCopySequence();
+
+        if (sequenceEnd != sequenceBegin)
+        {
+            m_zeroCopySends.push_back(ZeroCopySend{position, sequenceEnd});
+            if (position < zeroCopyHeldPosition())
+            {
+                m_zeroCopyHeldPosition.store(position, std::memory_order_release);
+            }
+        }
+
+        return consumed;
+    }
+
+    inline void releaseZeroCopySends()
+    {
+        if (m_zeroCopySends.empty())
+        {
+            return;
+        }
+
+        const std::uint32_t released = m_channelEndpoint->reapZeroCopyCompletions();
+        while (!m_zeroCopySends.empty() && (std::int32_t) (m_zeroCopySends.front().sequenceEnd - released) <= 0)
+        {
+            m_zeroCopySends.pop_front();
+        }
+
+        // retransmits go out of position order
+        std::int64_t heldPosition = std::numeric_limits<std::int64_t>::max();
+        for (const ZeroCopySend& send : m_zeroCopySends)
+        {
+            heldPosition = std::min(heldPosition, send.position);
+        }
+
+        m_zeroCopyHeldPosition.store(heldPosition, std::memory_order_release);
+    }
+
+    inline void setupMessageCheck(std::int64_t nowNs, std::int32_t activeTermId, std::int32_t termOffset)
+    {
+        if (nowNs > (m_timeOfLastSetup + PUBLICATION_SETUP_TIMEOUT_NS))
+        {
+            m_setupFlyweight.actionTermId(activeTermId).termOffset(termOffset);
+            sendControlFrame(m_setupBuffer.buffer(), protocol::SetupFlyweight::headerLength());
+            m_timeOfLastSetup = nowNs;
+            m_timeOfLastSendOrHeartbeat = nowNs;
+        }
+    }
+
+    inline void heartbeatMessageCheck(std::int64_t nowNs, std::int32_t activeTermId, std::int32_t termOffset)
+    {
+        if (nowNs > (m_timeOfLastSendOrHeartbeat + PUBLICATION_HEARTBEAT_TIMEOUT_NS))
+        {
+            m_heartbeatFlyweight.termId(activeTermId).termOffset(termOffset);
+            sendControlFrame(m_heartbeatBuffer.buffer(), DataFrameHeader::LENGTH);
+            m_timeOfLastSendOrHeartbeat = nowNs;
+        }
+    }
+
+    inline void applySenderLimit(std::int64_t positionLimit)
+    {
+        if (positionLimit != m_senderPositionLimit)
+        {
+            m_senderPositionLimit = positionLimit;
+            m_senderLimit->setOrdered(positionLimit);
+        }
+    }
+
+    inline void sendControlFrame(std::uint8_t* frame, std::int32_t length)
+    {
+        if (m_channelEndpoint->queuedSendCount() > 0)
+        {
+            m_channelEndpoint->sendQueuedFrames();
+        }
+
+        m_channelEndpoint->queueSend(frame, length);
+        m_channelEndpoint->sendQueuedFrames();
+    }
+
+    struct ZeroCopySend
+    {
+        std::int64_t position;
+        std::uint32_t sequenceEnd;
+    };
+
+    const std::int64_t m_registrationId;
+    const std::int32_t m_sessionId;
+    const std::int32_t m_streamId;
+    const std::int32_t m_initialTermId;
+    const std::int32_t m_mtuLength;
+    const std::int32_t m_priorityClass;
+    std::int32_t m_termLengthMask = 0;
+    std::int32_t m_positionBitsToShift = 0;
+
+    std::int64_t m_senderPositionLimit = 0;
+    std::int64_t m_cleanPosition = 0;
+    std::int64_t m_timeOfLastSendOrHeartbeat = 0;
+    std::int64_t m_timeOfLastSetup = 0;
+    bool m_shouldSendSetupFrame = true;
+
+    std::unique_ptr<MappedRawLog> m_rawLog;
+    std::shared_ptr<SendChannelEndpoint> m_channelEndpoint;
+    std::unique_ptr<Position<UnsafeBufferPosition>> m_senderPosition;
+    std::unique_ptr<Position<UnsafeBufferPosition>> m_senderLimit;
+    std::unique_ptr<FlowControl> m_flowControl;
+    std::unique_ptr<RetransmitHandler> m_retransmitHandler;
+    std::unique_ptr<TokenBucket> m_pacer;
+    resend_handler_t m_resendHandler;
+    std::vector<ReadablePosition<UnsafeBufferPosition>> m_spyPositions;
+    nano_clock_t m_nanoClock;
+
+    std::uint8_t m_heartbeatBufferBytes[DataFrameHeader::LENGTH];
+    std::uint8_t m_setupBufferBytes[sizeof(protocol::SetupDefn)];
+    AtomicBuffer m_heartbeatBuffer;
+    AtomicBuffer m_setupBuffer;
+    protocol::DataHeaderFlyweight m_heartbeatFlyweight;
+    protocol::SetupFlyweight m_setupFlyweight;
+    std::deque<ZeroCopySend> m_zeroCopySends;
+    std::atomic<std::int64_t> m_zeroCopyHeldPosition{std::numeric_limits<std::int64_t>::max()};
+};
+
+}};
+
+#endif
@@ -18,22 +18,32 @@
 #define AERON_PUBLICATIONIMAGE_H
 
 #include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
 
 #include "aeron/concurrent/AtomicBuffer.h"
+#include "aeron/concurrent/logbuffer/DataFrameHeader.h"
+#include "aeron/concurrent/logbuffer/FrameDescriptor.h"
+#include "aeron/concurrent/logbuffer/LogBufferDescriptor.h"
+#include "aeron/concurrent/logbuffer/TermRebuilder.h"
 #include "aeron/concurrent/status/ReadablePosition.h"
 #include "aeron/concurrent/status/UnsafeBufferPosition.h"
 #include "aeron/util/MacroUtil.h"
 
 #include "buffer/MappedRawLog.h"
 #include "media/InetAddress.h"
+#include "media/ReceiveChannelEndpoint.h"
 
+#include "CongestionControl.h"
 #include "FeedbackDelayGenerator.h"
+#include "LossDetector.h"
+#include "MediaDriver.h"
 
 namespace aeron { namespace driver {
 
-typedef std::function<long()> nano_clock_t;
-
 using namespace aeron::concurrent;
+using namespace aeron::concurrent::logbuffer;
 using namespace aeron::concurrent::status;
 using namespace aeron::driver::buffer;
 using namespace aeron::driver::media;
@@ -48,10 +58,12 @@ class PublicationImage
 public:
 
     typedef std::shared_ptr<PublicationImage> ptr_t;
+    typedef std::vector<ReadablePosition<UnsafeBufferPosition>> subscriber_positions_t;
 
     PublicationImage(
         const int64_t correlationId,
         const int64_t imageLivenessTimeoutNs,
+        const int64_t statusMessageTimeoutNs,
         const int32_t sessionId,
         const int32_t streamId,
         const int32_t initialTermId,
@@ -65,109 +77,659 @@ public:
         std::shared_ptr<ReceiveChannelEndpoint> channelEndpoint,
         std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>> subscriberPositions,
         std::unique_ptr<Position<UnsafeBufferPosition>> hwmPosition,
+        std::unique_ptr<Position<UnsafeBufferPosition>> receiverWindowPosition,
+        std::unique_ptr<Position<UnsafeBufferPosition>> rttPosition,
+        std::unique_ptr<Position<UnsafeBufferPosition>> rttVariancePosition,
+        std::unique_ptr<CongestionControl> congestionControl,
         FeedbackDelayGenerator& feedbackDelayGenerator,
         nano_clock_t nanoClock
     )
         : m_correlationId(correlationId), m_imageLivenessTimeoutNs(imageLivenessTimeoutNs),
+        m_statusMessageTimeoutNs(statusMessageTimeoutNs),
         m_sessionId(sessionId), m_streamId(streamId), m_initialTermId(initialTermId),
         m_currentGain(currentGain), m_rawLog(std::move(rawLog)),
         m_sourceAddress(sourceAddress), m_controlAddress(controlAddress), m_channelEndpoint(channelEndpoint),
         m_subscriberPositions(std::move(subscriberPositions)), m_hwmPosition(std::move(hwmPosition)),
+        m_receiverWindowPosition(std::move(receiverWindowPosition)),
+        m_rttPosition(std::move(rttPosition)), m_rttVariancePosition(std::move(rttVariancePosition)),
+        m_congestionControl(std::move(congestionControl)),
+        m_lossDetector(
+            feedbackDelayGenerator,
+            [this](std::int32_t termId, std::int32_t termOffset, std::int32_t length)
+            {
+                m_channelEndpoint->sendNakMessage(
+                    *m_controlAddress, m_sessionId, m_streamId, termId, termOffset, length);
+            }),
         m_nanoClock(nanoClock)
     {
-        // TODO: uncomment when we figure out how to mock MappedRawLog and UnsafeBufferPosition
-//        std::int32_t termLength = m_rawLog->termLength();
-//
-//        long time = m_nanoClock();
-//        m_timeOfLastStatusChange = time;
-//        m_lastPacketTimestamp = time;
-//
-//        m_currentWindowLength = termLength < initialWindowLength ? termLength : initialWindowLength;
-//        m_currentGain = m_currentWindowLength / 4;
-//
-//        m_termLengthMask = termLength - 1;
-//        m_positionBitsToShift = BitUtil::numberOfTrailingZeroes(termLength);
-//
-//        std::int64_t initialPosition =
-//            LogBufferDescriptor::computePosition(activeTermId, initialTermOffset, m_positionBitsToShift, initialTermId);
-//
-//        m_lastStatusMessagePosition = initialPosition - (currentGain - 1);
-//        m_newStatusMessagePosition = m_lastStatusMessagePosition;
-//        m_rebuildPosition = initialPosition;
-//        m_hwmPosition->setOrdered(initialPosition);
+        if (nullptr == m_rawLog)
+        {
+            return;
+        }
+
+        std::int32_t termLength = m_rawLog->termLength();
+
+        long time = m_nanoClock();
+        m_timeOfLastStatusChange = time;
+        m_lastPacketTimestamp = time;
+
+        m_maxWindowLength = termLength / 2;
+        m_currentWindowLength = std::min(initialWindowLength, m_maxWindowLength);
+        m_currentGain = m_currentWindowLength / 4;
+
+        m_termLengthMask = termLength - 1;
+        m_positionBitsToShift = util::BitUtil::numberOfTrailingZeroes(termLength);
+
+        std::int64_t initialPosition =
+            LogBufferDescriptor::computePosition(activeTermId, initialTermOffset, m_positionBitsToShift, initialTermId);
+
+        m_lastStatusMessagePosition = initialPosition - (m_currentGain - 1);
+        m_lastStatusMessageTimestamp = time - m_statusMessageTimeoutNs;
+        m_lastRttMeasurementTimestamp = time - m_statusMessageTimeoutNs;
+        m_lastDrainPosition = initialPosition;
+        m_lastDrainTimestamp = time;
+        m_rebuildPosition = initialPosition;
+        m_cleanPosition = initialPosition;
+        m_hwmPosition->setOrdered(initialPosition);
     }
 
     virtual ~PublicationImage(){}
 
     inline COND_MOCK_VIRTUAL std::int32_t sessionId()
     {
-        return 0;
+        return m_sessionId;
     }
 
     inline COND_MOCK_VIRTUAL std::int32_t streamId()
     {
-        return 0;
+        return m_streamId;
+    }
+
+    inline std::int64_t correlationId() const
+    {
+        return m_correlationId;
+    }
+
+    inline std::int64_t rebuildPosition() const
+    {
+        return m_rebuildPosition;
+    }
+
+    inline const char* logFileName()
+    {
+        return m_rawLog->logFileName();
+    }
+
+    inline InetAddress& sourceAddress()
+    {
+        return *m_sourceAddress;
+    }
+
+    inline ReceiveChannelEndpoint& channelEndpoint()
+    {
+        return *m_channelEndpoint;
+    }
+
+    inline std::int64_t timeOfLastPacketNs() const
+    {
+        return m_lastPacketTimestamp;
+    }
+
+    inline std::int64_t timeOfLastStatusChangeNs() const
+    {
+        return m_timeOfLastStatusChange;
+    }
+
+    /**
+     * Track the position of a subscription that has been linked to this image after it was created. Called from the
+     * conductor while the Receiver reads the positions, so the change is made to a copy which then replaces them.
+     */
+    inline void addSubscriberPosition(ReadablePosition<UnsafeBufferPosition>& position)
+    {
+        std::shared_ptr<subscriber_positions_t> positions =
+            std::make_shared<subscriber_positions_t>(*subscriberPositions());
+
+        positions->push_back(position);
+        std::atomic_store(&m_subscriberPositions, positions);
+    }
+
+    inline void removeSubscriberPosition(std::int32_t counterId)
+    {
+        std::shared_ptr<subscriber_positions_t> positions =
+            std::make_shared<subscriber_positions_t>(*subscriberPositions());
+
+        for (auto it = positions->begin(); it != positions->end(); ++it)
+        {
+            if (it->id() == counterId)
+            {
+                positions->erase(it);
+                std::atomic_store(&m_subscriberPositions, positions);
+                break;
+            }
+        }
+    }
+
+    /**
+     * Have all subscribers consumed everything rebuilt so far.
+     */
+    inline bool isDrained()
+    {
+        for (auto& position : *subscriberPositions())
+        {
+            if (position.getVolatile() < m_rebuildPosition)
+            {
+                return false;
+            }
+        }
+
+        return true;
     }
 
     inline COND_MOCK_VIRTUAL std::int32_t insertPacket(
         std::int32_t termId, std::int32_t termOffset, AtomicBuffer& buffer, std::int32_t length)
     {
-        return 0;
+        const bool isHeartbeat = isHeartbeatFrame(length, buffer.getInt32(0));
+        const std::int64_t packetPosition =
+            LogBufferDescriptor::computePosition(termId, termOffset, m_positionBitsToShift, m_initialTermId);
+        const std::int64_t proposedPosition = isHeartbeat ? packetPosition : packetPosition + length;
+        const std::int64_t endPosition = isHeartbeat ?
+            packetPosition :
+            packetPosition + frameExtent(length, buffer.getInt32(0), FrameDescriptor::frameType(buffer, 0));
+
+        if (isWithinFlowControlWindow(packetPosition, proposedPosition))
+        {
+            if (!isHeartbeat)
+            {
+                AtomicBuffer& termBuffer =
+                    m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(packetPosition, m_positionBitsToShift));
+
+                if (isDuplicate(termBuffer, termOffset, proposedPosition))
+                {
+                    return length;
+                }
+
+                TermRebuilder::insert(termBuffer, termOffset, buffer, length);
+            }
+
+            onPacketInserted(packetPosition, endPosition, isHeartbeat ? 0 : length);
+        }
+
+        return length;
+    }
+
+    /**
+     * Where the datagram index places on from the next one should land in the term if the stream carries on in order,
+     * so it can be received straight into the term rather than copied there by insertPacket().
+     *
+     * Only offered while everything up to the high-water mark has been rebuilt, as only then is the term known to be
+     * clear from the rebuild position on. Targets after the first are spaced by the largest datagram seen so far, which
+     * settles at the MTU for a stream of full sized datagrams.
+     *
+     * @return true with the term id, term offset, address and length of the region set if there is a target.
+     */
+    inline COND_MOCK_VIRTUAL bool receiveTarget(
+        std::int32_t index, std::int32_t& termId, std::int32_t& termOffset, std::uint8_t*& address, std::int32_t& length)
+    {
+        if (nullptr == m_rawLog || m_hwmPosition->get() != m_rebuildPosition || (index > 0 && 0 == m_receiveStride))
+        {
+            return false;
+        }
+
+        const std::int32_t termLength = m_termLengthMask + 1;
+        const std::int32_t rebuildOffset = (std::int32_t) m_rebuildPosition & m_termLengthMask;
+        const std::int64_t offsetFromRebuild = (std::int64_t) index * m_receiveStride;
+        const std::int64_t windowLimit = m_lastStatusMessagePosition + m_currentWindowLength;
+
+        if (rebuildOffset + offsetFromRebuild >= termLength)
+        {
+            return false;
+        }
+
+        const std::int64_t position = m_rebuildPosition + offsetFromRebuild;
+        termOffset = rebuildOffset + (std::int32_t) offsetFromRebuild;
+        termId = m_initialTermId + (std::int32_t) (position >> m_positionBitsToShift);
+        length = (std::int32_t) std::min<std::int64_t>(termLength - termOffset, windowLimit - position);
+        if (m_receiveStride > 0)
+        {
+            length = std::min(length, m_receiveStride);
+        }
+
+        if (length <= DataFrameHeader::LENGTH)
+        {
+            return false;
+        }
+
+        address = m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(position, m_positionBitsToShift))
+            .buffer() + termOffset;
+
+        return true;
+    }
+
+    /**
+     * Complete a datagram received straight into the region given by receiveTarget() for its term id and offset, with
+     * every byte but the first frame length already in place. Has the same outcome as insertPacket(), and if it is
+     * not accepted the region is cleared again.
+     */
+    inline COND_MOCK_VIRTUAL std::int32_t insertPacketInPlace(
+        std::int32_t termId, std::int32_t termOffset, std::int32_t firstFrameLength, std::int32_t length)
+    {
+        const bool isHeartbeat = isHeartbeatFrame(length, firstFrameLength);
+        const std::int64_t packetPosition =
+            LogBufferDescriptor::computePosition(termId, termOffset, m_positionBitsToShift, m_initialTermId);
+        const std::int64_t proposedPosition = isHeartbeat ? packetPosition : packetPosition + length;
+        AtomicBuffer& termBuffer =
+            m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(packetPosition, m_positionBitsToShift));
+
+        const std::uint16_t frameType = FrameDescriptor::frameType(termBuffer, termOffset);
+
+        const bool isAccepted = isWithinFlowControlWindow(packetPosition, proposedPosition);
+        if (isAccepted && !isHeartbeat)
+        {
+            FrameDescriptor::frameLengthOrdered(termBuffer, termOffset, firstFrameLength);
+        }
+        else
+        {
+            termBuffer.setMemory(termOffset, length, 0);
+        }
+
+        if (isAccepted)
+        {
+            const std::int64_t endPosition = isHeartbeat ?
+                packetPosition : packetPosition + frameExtent(length, firstFrameLength, frameType);
+            onPacketInserted(packetPosition, endPosition, isHeartbeat ? 0 : length);
+        }
+
+        return length;
+    }
+
+    /**
+     * Zero what the subscribers left a term length or more behind them, a term at most at a time, so that the partition
+     * is clean when the stream comes round to it again. Rebuilding, loss detection and receiving in place all take a
+     * zero frame length to mean nothing has been received there yet. Must run before scheduleStatusMessage() lets the
+     * source send into the next term.
+     *
+     * @return 1 if some of the log was cleaned, otherwise 0.
+     */
+    inline std::int32_t cleanBuffer()
+    {
+        if (nullptr == m_rawLog)
+        {
+            return 0;
+        }
+
+        const std::shared_ptr<subscriber_positions_t> positions = subscriberPositions();
+        if (positions->empty())
+        {
+            return 0;
+        }
+
+        return cleanBufferTo(minSubscriberPosition(*positions) - (m_termLengthMask + 1));
+    }
+
+    /**
+     * Look for loss between the rebuild position and the high-water mark and send the NAKs that are due for it, letting
+     * the CongestionControl know of the loss.
+     *
+     * @return number of NAKs sent.
+     */
+    inline COND_MOCK_VIRTUAL std::int32_t trackRebuild(std::int64_t nowNs)
+    {
+        if (nullptr == m_rawLog)
+        {
+            return 0;
+        }
+
+        AtomicBuffer& termBuffer =
+            m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(m_rebuildPosition, m_positionBitsToShift));
+
+        const std::int32_t naksSent = m_lossDetector.scan(
+            termBuffer,
+            m_rebuildPosition,
+            m_hwmPosition->get(),
+            nowNs,
+            m_termLengthMask,
+            m_positionBitsToShift,
+            m_initialTermId);
+
+        if (naksSent > 0)
+        {
+            m_congestionControl->onLoss(nowNs);
+        }
+
+        return naksSent;
+    }
+
+    /**
+     * Queue a status message with the channel endpoint once the subscribers have consumed past the gain since the
+     * last one was sent, or once the status message timeout has passed without one. The receiver window is retuned
+     * first and the CongestionControl then decides how much of it to advertise, which is kept in the receiver window
+     * counter of the image. An RTT probe is sent along with it at most once per status message timeout.
+     *
+     * @return 1 if a status message was queued, otherwise 0.
+     */
+    inline COND_MOCK_VIRTUAL std::int32_t scheduleStatusMessage(std::int64_t nowNs)
+    {
+        if (nullptr == m_rawLog)
+        {
+            return 0;
+        }
+
+        const std::shared_ptr<subscriber_positions_t> positions = subscriberPositions();
+        if (positions->empty())
+        {
+            return 0;
+        }
+
+        const std::int64_t consumptionPosition = minSubscriberPosition(*positions);
+        const bool isGainPassed = consumptionPosition >= (m_lastStatusMessagePosition + m_currentGain);
+        const bool isTimedOut = nowNs >= (m_lastStatusMessageTimestamp + m_statusMessageTimeoutNs);
+
+        if (!isGainPassed && !isTimedOut)
+        {
+            return 0;
+        }
+
+        tuneWindow(consumptionPosition, nowNs);
+
+        const std::int32_t termId = m_initialTermId + (std::int32_t) (consumptionPosition >> m_positionBitsToShift);
+        const std::int32_t termOffset = (std::int32_t) consumptionPosition & m_termLengthMask;
+
+        const std::int32_t windowLength = m_congestionControl->onStatusMessage(nowNs, m_currentWindowLength);
+
+        m_channelEndpoint->queueStatusMessage(
+            *m_controlAddress, m_sessionId, m_streamId, termId, termOffset, windowLength);
+        m_receiverWindowPosition->setOrdered(windowLength);
+
+        m_lastStatusMessagePosition = consumptionPosition;
+        m_lastStatusMessageTimestamp = nowNs;
+
+        if (nowNs >= (m_lastRttMeasurementTimestamp + m_statusMessageTimeoutNs))
+        {
+            m_channelEndpoint->sendRttMeasurement(*m_controlAddress, m_sessionId, m_streamId, nowNs);
+            m_lastRttMeasurementTimestamp = nowNs;
+        }
+
+        return 1;
+    }
+
+    /**
+     * Take an RTT sample from the echo of a probe sent by scheduleStatusMessage() and smooth it along with its
+     * variance as in RFC 6298, keeping both in the RTT counters of the image. The smoothed RTT is what the receiver
+     * window is tuned over and is passed on to the CongestionControl.
+     *
+     * @param echoTimestampNs time the probe was sent at.
+     * @param receptionDelta  time the source held the probe for before echoing it.
+     */
+    inline COND_MOCK_VIRTUAL void onRttMeasurement(std::int64_t echoTimestampNs, std::int64_t receptionDelta)
+    {
+        const std::int64_t nowNs = m_nanoClock();
+        const std::int64_t rttNs = nowNs - echoTimestampNs - receptionDelta;
+
+        if (rttNs <= 0)
+        {
+            return;
+        }
+
+        if (m_isRttMeasured)
+        {
+            m_rttVarianceNs += (std::abs(m_rttNs - rttNs) - m_rttVarianceNs) / 4;
+            m_rttNs += (rttNs - m_rttNs) / 8;
+        }
+        else
+        {
+            m_rttNs = rttNs;
+            m_rttVarianceNs = rttNs / 2;
+            m_isRttMeasured = true;
+        }
+
+        m_rttPosition->setOrdered(m_rttNs);
+        m_rttVariancePosition->setOrdered(m_rttVarianceNs);
+        m_congestionControl->onRttMeasurement(nowNs, m_rttNs);
+    }
+
+    /**
+     * Smoothed RTT, or the default until a probe has been echoed.
+     */
+    inline std::int64_t rttNs() const
+    {
+        return m_rttNs;
+    }
+
+    inline std::int64_t rttVarianceNs() const
+    {
+        return m_rttVarianceNs;
+    }
+
+    /**
+     * Receiver window as last tuned, before the CongestionControl has had its say.
+     */
+    inline std::int32_t windowLength() const
+    {
+        return m_currentWindowLength;
     }
 
     inline COND_MOCK_VIRTUAL void ifActiveGoInactive()
     {
+        if (PublicationImageStatus::ACTIVE == status())
+        {
+            status(PublicationImageStatus::INACTIVE);
+        }
+    }
+
+    inline PublicationImageStatus status()
+    {
+        return m_status;
     }
 
     inline COND_MOCK_VIRTUAL void status(PublicationImageStatus status)
     {
+        m_timeOfLastStatusChange = m_nanoClock();
         atomic::putValueVolatile(&m_status, status);
     }
 
 private:
+    static const std::int32_t MIN_WINDOW_LENGTH = 8 * 1024;
+    static const std::int64_t DEFAULT_RTT_NS = 100 * 1000;
+
+    static inline bool isHeartbeatFrame(std::int32_t length, std::int32_t frameLength)
+    {
+        return DataFrameHeader::LENGTH == length && 0 == frameLength;
+    }
+
+    /**
+     * How far into the term a datagram reaches. The padding frame at the end of a term is sent as its header alone but
+     * stands for the rest of the term, so rebuilding carries on into the next term once it has been received.
+     */
+    static inline std::int32_t frameExtent(std::int32_t length, std::int32_t frameLength, std::uint16_t frameType)
+    {
+        if (DataFrameHeader::LENGTH == length && DataFrameHeader::HDR_TYPE_PAD == frameType && frameLength > length)
+        {
+            return util::BitUtil::align(frameLength, FrameDescriptor::FRAME_ALIGNMENT);
+        }
+
+        return length;
+    }
+
+    /**
+     * A retransmit or repeat of data already rebuilt, or already inserted ahead of a gap, is not written again as a
+     * subscriber may be reading it.
+     */
+    inline bool isDuplicate(AtomicBuffer& termBuffer, std::int32_t termOffset, std::int64_t proposedPosition)
+    {
+        return proposedPosition <= m_rebuildPosition || 0 != FrameDescriptor::frameLengthVolatile(termBuffer, termOffset);
+    }
+
+    inline bool isWithinFlowControlWindow(std::int64_t packetPosition, std::int64_t proposedPosition)
+    {
+        const std::int64_t windowPosition = m_lastStatusMessagePosition;
+
+        return packetPosition >= windowPosition && proposedPosition <= (windowPosition + m_currentWindowLength);
+    }
+
+    inline void onPacketInserted(std::int64_t packetPosition, std::int64_t endPosition, std::int32_t length)
+    {
+        const std::int64_t hwmPosition = m_hwmPosition->get();
+
+        const std::int64_t newHwmPosition = std::max(hwmPosition, endPosition);
+
+        if (packetPosition == m_rebuildPosition && hwmPosition == m_rebuildPosition)
+        {
+            m_rebuildPosition = endPosition;
+        }
+        else if (packetPosition == m_rebuildPosition && length > 0)
+        {
+            // a gap has been filled so carry on over anything already received beyond it
+            advanceRebuildPosition(newHwmPosition);
+        }
+
+        if (newHwmPosition > hwmPosition)
+        {
+            m_hwmPosition->setOrdered(newHwmPosition);
+        }
+
+        if (length > m_receiveStride)
+        {
+            m_receiveStride = length;
+        }
+
+        m_lastPacketTimestamp = m_nanoClock();
+    }
+
+    /**
+     * The positions as last replaced by the conductor, which are not changed once they are seen.
+     */
+    inline std::shared_ptr<subscriber_positions_t> subscriberPositions() const
+    {
+        return std::atomic_load(&m_subscriberPositions);
+    }
+
+    static inline std::int64_t minSubscriberPosition(subscriber_positions_t& positions)
+    {
+        std::int64_t position = positions[0].getVolatile();
+
+        for (auto& subscriberPosition : positions)
+        {
+            position = std::min(position, subscriberPosition.getVolatile());
+        }
+
+        return position;
+    }
+
+    /**
+     * Size the window to what the subscribers drain in two round trips, so a fast consumer is not held up waiting on
+     * status messages and a slow one does not have more buffered for it than it can drain. The drain rate is smoothed
+     * over the status messages sent. Subscribers that have caught up with the rebuild are not what is limiting the
+     * stream, so their window doubles towards half a term instead.
+     */
+    inline void tuneWindow(std::int64_t consumptionPosition, std::int64_t nowNs)
+    {
+        const std::int64_t elapsedNs = nowNs - m_lastDrainTimestamp;
+        if (elapsedNs > 0)
+        {
+            const double drainRate = (double) (consumptionPosition - m_lastDrainPosition) / (double) elapsedNs;
+            m_drainRateBytesPerNs += (drainRate - m_drainRateBytesPerNs) / 4;
+            m_lastDrainPosition = consumptionPosition;
+            m_lastDrainTimestamp = nowNs;
+        }
+
+        std::int64_t windowLength = consumptionPosition >= m_rebuildPosition ?
+            2 * (std::int64_t) m_currentWindowLength : (std::int64_t) (m_drainRateBytesPerNs * 2 * m_rttNs);
+
+        const std::int32_t minWindowLength = std::max((std::int32_t) MIN_WINDOW_LENGTH, 2 * m_receiveStride);
+        windowLength = std::min<std::int64_t>(std::max<std::int64_t>(windowLength, minWindowLength), m_maxWindowLength);
+
+        m_currentWindowLength = util::BitUtil::align((std::int32_t) windowLength, FrameDescriptor::FRAME_ALIGNMENT);
+        m_currentGain = m_currentWindowLength / 4;
+    }
+
+    inline std::int32_t cleanBufferTo(std::int64_t newCleanPosition)
+    {
+        const std::int64_t cleanPosition = m_cleanPosition;
+        if (newCleanPosition <= cleanPosition)
+        {
+            return 0;
+        }
+
+        AtomicBuffer& dirtyTerm =
+            m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(cleanPosition, m_positionBitsToShift));
+        const std::int32_t termOffset = (std::int32_t) cleanPosition & m_termLengthMask;
+        const std::int32_t length =
+            (std::int32_t) std::min<std::int64_t>(newCleanPosition - cleanPosition, dirtyTerm.capacity() - termOffset);
+
+        dirtyTerm.setMemory(termOffset, length, 0);
+        m_cleanPosition = cleanPosition + length;
+
+        return 1;
+    }
+
+    inline void advanceRebuildPosition(std::int64_t hwmPosition)
+    {
+        while (m_rebuildPosition < hwmPosition)
+        {
+            const std::int32_t termOffset = (std::int32_t) m_rebuildPosition & m_termLengthMask;
+            AtomicBuffer& termBuffer =
+                m_rawLog->termBuffer(LogBufferDescriptor::indexByPosition(m_rebuildPosition, m_positionBitsToShift));
+            const std::int32_t frameLength = FrameDescriptor::frameLengthVolatile(termBuffer, termOffset);
+
+            if (frameLength <= 0)
+            {
+                break;
+            }
+
+            m_rebuildPosition += util::BitUtil::align(frameLength, FrameDescriptor::FRAME_ALIGNMENT);
+        }
+    }
 
     // -- Cache-line padding
 
     std::int64_t m_timeOfLastStatusChange = 0;
     std::int64_t m_rebuildPosition = 0;
-
-    volatile std::int64_t m_beginLossChange = -1;
-    volatile std::int64_t m_endLossChange = -1;
-
-    std::int32_t m_lossTermId = 0;
-    std::int32_t m_lossTermOffset = 0;
-    std::int32_t m_lossLength = 0;
+    std::int64_t m_cleanPosition = 0;
 
     // -- Cache-line padding
 
     std::int64_t m_lastPacketTimestamp = 0;
     std::int64_t m_lastStatusMessageTimestamp = 0;
     std::int64_t m_lastStatusMessagePosition = 0;
+    std::int64_t m_lastDrainTimestamp = 0;
+    std::int64_t m_lastDrainPosition = 0;
     std::int64_t m_lastChangeNumber = -1;
+    std::int64_t m_lastRttMeasurementTimestamp = 0;
+    std::int64_t m_rttNs = DEFAULT_RTT_NS;
+    std::int64_t m_rttVarianceNs = 0;
+    bool m_isRttMeasured = false;
+    double m_drainRateBytesPerNs = 0;
 
     // -- Cache-line padding
 
-    volatile std::int64_t m_newStatusMessagePosition;
     volatile PublicationImageStatus m_status = PublicationImageStatus::INIT;
 
     // -- Cache-line padding
 
     const std::int64_t m_correlationId;
     const std::int64_t m_imageLivenessTimeoutNs;
+    const std::int64_t m_statusMessageTimeoutNs;
     const std::int32_t m_sessionId;
     const std::int32_t m_streamId;
-    std::int32_t m_positionBitsToShift;
-    std::int32_t m_termLengthMask;
+    std::int32_t m_positionBitsToShift = 0;
+    std::int32_t m_termLengthMask = 0;
     const std::int32_t m_initialTermId;
-    std::int32_t m_currentWindowLength;
+    std::int32_t m_currentWindowLength = 0;
+    std::int32_t m_maxWindowLength = 0;
     std::int32_t m_currentGain;
+    std::int32_t m_receiveStride = 0;
 
     std::unique_ptr<MappedRawLog> m_rawLog;
     std::shared_ptr<InetAddress> m_sourceAddress;
     std::shared_ptr<InetAddress> m_controlAddress;
     std::shared_ptr<ReceiveChannelEndpoint> m_channelEndpoint;
-    std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>> m_subscriberPositions;
+    std::shared_ptr<subscriber_positions_t> m_subscriberPositions;
     std::unique_ptr<Position<UnsafeBufferPosition>> m_hwmPosition;
+    std::unique_ptr<Position<UnsafeBufferPosition>> m_receiverWindowPosition;
+    std::unique_ptr<Position<UnsafeBufferPosition>> m_rttPosition;
+    std::unique_ptr<Position<UnsafeBufferPosition>> m_rttVariancePosition;
+    std::unique_ptr<CongestionControl> m_congestionControl;
+    LossDetector m_lossDetector;
 
     nano_clock_t m_nanoClock;
 };
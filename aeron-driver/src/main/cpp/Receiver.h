@@ -17,25 +17,228 @@
 #ifndef INCLUDED_AERON_DRIVER_RECEIVER_
 #define INCLUDED_AERON_DRIVER_RECEIVER_
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
+#include "aeron/util/Exceptions.h"
+
+#include "concurrent/CommandQueue.h"
 #include "media/ReceiveChannelEndpoint.h"
+#include "media/DataTransportPoller.h"
+#include "media/PacketRingTransportPoller.h"
 
 #include "MediaDriver.h"
+#include "PublicationImage.h"
 
 using namespace aeron::driver;
 using namespace aeron::driver::media;
 
 namespace aeron { namespace driver {
 
+/**
+ * Duty cycle for receiving on the channel endpoints of the driver.
+ *
+ * Besides polling the endpoints for data it expires the setup messages that the DataPacketDispatcher is waiting on for
+ * sessions it has elicited a setup for, so a setup can be elicited again if the first one never arrives, and has each
+ * active PublicationImage track its rebuild so loss is NAKed and schedule the status messages it owes. Status messages
+ * are queued on the channel endpoint of their image and each endpoint sends its queue in one batch per duty cycle.
+ *
+ * Given a PacketRingTransportPoller, endpoints receive from its ring rather than their sockets. An endpoint the ring
+ * can not take, e.g. one sharing a port with another, is polled on its socket as usual.
+ */
 class Receiver
 {
 public:
+    static const std::int64_t PENDING_SETUP_TIMEOUT_NS = 1000 * 1000 * 1000;
+
+    Receiver(
+        nano_clock_t nanoClock = defaultNanoClock,
+        std::unique_ptr<PacketRingTransportPoller> packetRingTransportPoller =
+            std::unique_ptr<PacketRingTransportPoller>(nullptr))
+        : m_packetRingTransportPoller(std::move(packetRingTransportPoller)), m_nanoClock(nanoClock)
+    {
+    }
+
     virtual ~Receiver() = default;
 
+    inline std::int32_t doWork()
+    {
+        std::int32_t workCount = m_commandQueue.drain();
+
+        workCount += m_dataTransportPoller.pollTransports();
+        if (nullptr != m_packetRingTransportPoller)
+        {
+            workCount += m_packetRingTransportPoller->pollTransports();
+        }
+
+        if (!m_publicationImages.empty() || !m_pendingSetupMessages.empty())
+        {
+            const std::int64_t nowNs = m_nanoClock();
+
+            workCount += trackImages(nowNs);
+            workCount += checkPendingSetupMessages(nowNs);
+        }
+
+        return workCount;
+    }
+
+    inline void onClose()
+    {
+    }
+
+    /**
+     * Commands from the conductor when it runs on another thread, see ReceiverProxy.
+     */
+    inline concurrent::CommandQueue& commandQueue()
+    {
+        return m_commandQueue;
+    }
+
+    inline void onRegisterReceiveChannelEndpoint(ReceiveChannelEndpoint& receiveChannelEndpoint)
+    {
+        if (nullptr != m_packetRingTransportPoller)
+        {
+            try
+            {
+                m_packetRingTransportPoller->registerForRead(receiveChannelEndpoint);
+                return;
+            }
+            catch (aeron::util::IOException&)
+            {
+                // stays with its socket
+            }
+        }
+
+        m_dataTransportPoller.registerForRead(receiveChannelEndpoint);
+    }
+
+    inline void onCloseReceiveChannelEndpoint(ReceiveChannelEndpoint& receiveChannelEndpoint)
+    {
+        if (nullptr != m_packetRingTransportPoller)
+        {
+            m_packetRingTransportPoller->cancelRead(receiveChannelEndpoint);
+        }
+
+        m_dataTransportPoller.cancelRead(receiveChannelEndpoint);
+
+        for (auto it = m_pendingSetupMessages.begin(); it != m_pendingSetupMessages.end();)
+        {
+            it = it->channelEndpoint == &receiveChannelEndpoint ? m_pendingSetupMessages.erase(it) : it + 1;
+        }
+    }
+
+    inline void onNewPublicationImage(PublicationImage::ptr_t image)
+    {
+        m_publicationImages.push_back(std::move(image));
+    }
+
+    inline void onRemovePublicationImage(PublicationImage::ptr_t image)
+    {
+        for (auto it = m_publicationImages.begin(); it != m_publicationImages.end(); ++it)
+        {
+            if (*it == image)
+            {
+                m_publicationImages.erase(it);
+                break;
+            }
+        }
+    }
+
+    inline bool isPacketRingEnabled() const
+    {
+        return nullptr != m_packetRingTransportPoller;
+    }
+
+    inline std::size_t publicationImageCount() const
+    {
+        return m_publicationImages.size();
+    }
+
     inline COND_MOCK_VIRTUAL void addPendingSetupMessage(
         std::int32_t sessionId, std::int32_t streamId, ReceiveChannelEndpoint& receiveChannelEndpoint)
     {
+        m_pendingSetupMessages.push_back(
+            PendingSetupMessage{sessionId, streamId, &receiveChannelEndpoint, m_nanoClock()});
+    }
+
+    inline std::size_t pendingSetupMessageCount() const
+    {
+        return m_pendingSetupMessages.size();
+    }
+
+private:
+    struct PendingSetupMessage
+    {
+        std::int32_t sessionId;
+        std::int32_t streamId;
+        ReceiveChannelEndpoint* channelEndpoint;
+        std::int64_t timeOfStatusMessageNs;
+    };
+
+    concurrent::CommandQueue m_commandQueue;
+    DataTransportPoller m_dataTransportPoller;
+    std::unique_ptr<PacketRingTransportPoller> m_packetRingTransportPoller;
+    std::vector<PendingSetupMessage> m_pendingSetupMessages;
+    std::vector<PublicationImage::ptr_t> m_publicationImages;
+    nano_clock_t m_nanoClock;
+
+    static long defaultNanoClock()
+    {
+        return (long) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Images stop being tracked once they are no longer active, e.g. when their subscription is removed.
+     */
+    inline std::int32_t trackImages(std::int64_t nowNs)
+    {
+        std::int32_t workCount = 0;
+
+        for (std::size_t i = m_publicationImages.size(); i-- > 0;)
+        {
+            PublicationImage& image = *m_publicationImages[i];
+
+            if (PublicationImageStatus::ACTIVE == image.status())
+            {
+                workCount += image.cleanBuffer();
+                workCount += image.trackRebuild(nowNs);
+                workCount += image.scheduleStatusMessage(nowNs);
+            }
+            else
+            {
+                m_publicationImages.erase(m_publicationImages.begin() + i);
+            }
+        }
+
+        // the first image of an endpoint sends the batch for all of them, which leaves nothing for the rest
+        for (PublicationImage::ptr_t& image : m_publicationImages)
+        {
+            image->channelEndpoint().sendPendingStatusMessages();
+        }
+
+        return workCount;
+    }
+
+    inline std::int32_t checkPendingSetupMessages(std::int64_t nowNs)
+    {
+        std::int32_t workCount = 0;
+
+        for (std::size_t i = m_pendingSetupMessages.size(); i-- > 0;)
+        {
+            PendingSetupMessage& pending = m_pendingSetupMessages[i];
+
+            if (nowNs > (pending.timeOfStatusMessageNs + PENDING_SETUP_TIMEOUT_NS))
+            {
+                pending.channelEndpoint->removePendingSetup(pending.sessionId, pending.streamId);
+                m_pendingSetupMessages.erase(m_pendingSetupMessages.begin() + i);
+                workCount++;
+            }
+        }
+
+        return workCount;
     }
 };
 
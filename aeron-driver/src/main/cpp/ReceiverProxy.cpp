@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataPacketDispatcher.h"
+#include "ReceiverProxy.h"
+
+using namespace aeron::driver;
+
+void ReceiverProxy::registerReceiveChannelEndpoint(std::shared_ptr<ReceiveChannelEndpoint> endpoint)
+{
+    Receiver* receiver = m_receiver.get();
+    execute([receiver, endpoint]() { receiver->onRegisterReceiveChannelEndpoint(*endpoint); });
+}
+
+void ReceiverProxy::closeReceiveChannelEndpoint(std::shared_ptr<ReceiveChannelEndpoint> endpoint)
+{
+    Receiver* receiver = m_receiver.get();
+    execute([receiver, endpoint]() { receiver->onCloseReceiveChannelEndpoint(*endpoint); });
+}
+
+void ReceiverProxy::addSubscription(std::shared_ptr<DataPacketDispatcher> dispatcher, std::int32_t streamId)
+{
+    execute([dispatcher, streamId]() { dispatcher->addSubscription(streamId); });
+}
+
+void ReceiverProxy::removeSubscription(std::shared_ptr<DataPacketDispatcher> dispatcher, std::int32_t streamId)
+{
+    execute([dispatcher, streamId]() { dispatcher->removeSubscription(streamId); });
+}
+
+void ReceiverProxy::newPublicationImage(
+    std::shared_ptr<DataPacketDispatcher> dispatcher, PublicationImage::ptr_t image)
+{
+    Receiver* receiver = m_receiver.get();
+    execute(
+        [receiver, dispatcher, image]()
+        {
+            dispatcher->addPublicationImage(image);
+            receiver->onNewPublicationImage(image);
+        });
+}
+
+void ReceiverProxy::removePublicationImage(
+    std::shared_ptr<DataPacketDispatcher> dispatcher, PublicationImage::ptr_t image)
+{
+    Receiver* receiver = m_receiver.get();
+    execute(
+        [receiver, dispatcher, image]()
+        {
+            dispatcher->removePublicationImage(image);
+            receiver->onRemovePublicationImage(image);
+        });
+}
+
+void ReceiverProxy::removeCoolDown(
+    std::shared_ptr<DataPacketDispatcher> dispatcher, std::int32_t sessionId, std::int32_t streamId)
+{
+    execute([dispatcher, sessionId, streamId]() { dispatcher->removeCoolDown(sessionId, streamId); });
+}
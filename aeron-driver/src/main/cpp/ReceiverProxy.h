@@ -0,0 +1,76 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_RECEIVERPROXY_
+#define INCLUDED_AERON_DRIVER_RECEIVERPROXY_
+
+#include <cstdint>
+#include <memory>
+
+#include "media/ReceiveChannelEndpoint.h"
+
+#include "MediaDriver.h"
+#include "PublicationImage.h"
+#include "Receiver.h"
+
+namespace aeron { namespace driver {
+
+using namespace aeron::driver::media;
+
+class DataPacketDispatcher;
+
+/**
+ * Hands requests from the DriverConductor over to the Receiver, along with changes to the DataPacketDispatchers the
+ * Receiver dispatches to. They are made straight away when both run on the same thread, otherwise they are queued for
+ * the Receiver to execute on its own thread.
+ */
+class ReceiverProxy
+{
+public:
+    ReceiverProxy(ThreadingMode threadingMode, std::shared_ptr<Receiver> receiver) :
+        m_threadingMode(threadingMode), m_receiver(std::move(receiver))
+    {
+    }
+
+    void registerReceiveChannelEndpoint(std::shared_ptr<ReceiveChannelEndpoint> endpoint);
+    void closeReceiveChannelEndpoint(std::shared_ptr<ReceiveChannelEndpoint> endpoint);
+    void addSubscription(std::shared_ptr<DataPacketDispatcher> dispatcher, std::int32_t streamId);
+    void removeSubscription(std::shared_ptr<DataPacketDispatcher> dispatcher, std::int32_t streamId);
+    void newPublicationImage(std::shared_ptr<DataPacketDispatcher> dispatcher, PublicationImage::ptr_t image);
+    void removePublicationImage(std::shared_ptr<DataPacketDispatcher> dispatcher, PublicationImage::ptr_t image);
+    void removeCoolDown(std::shared_ptr<DataPacketDispatcher> dispatcher, std::int32_t sessionId, std::int32_t streamId);
+
+private:
+    ThreadingMode m_threadingMode;
+    std::shared_ptr<Receiver> m_receiver;
+
+    template<typename Command>
+    inline void execute(Command command)
+    {
+        if (SHARED == m_threadingMode)
+        {
+            command();
+        }
+        else
+        {
+            m_receiver->commandQueue().offer(command);
+        }
+    }
+};
+
+}};
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_RETRANSMITHANDLER__
+#define INCLUDED_AERON_DRIVER_RETRANSMITHANDLER__
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "aeron/concurrent/AtomicCounter.h"
+
+#include "FeedbackDelayGenerator.h"
+
+namespace aeron { namespace driver {
+
+/**
+ * Called to retransmit a range of a term.
+ */
+typedef std::function<void(std::int32_t termId, std::int32_t termOffset, std::int32_t length)> resend_handler_t;
+
+/**
+ * Turns the NAKs received for a NetworkPublication into retransmits, so a range NAKed by many receivers is only sent
+ * again once.
+ *
+ * Each NAK that is not already covered starts a retransmit action for its term id and offset. The action waits for a
+ * delay from the delay generator, or is sent straight away when feedback is immediate, and then lingers for a delay
+ * from the linger generator. NAKs for a range that is waiting to be sent are merged into it, and NAKs for what was
+ * sent while it lingers are ignored, as they were most likely sent before the retransmit arrived. At most
+ * MAX_RETRANSMITS actions are active at once, further NAKs are dropped until one finishes.
+ *
+ * Called from the Sender duty cycle only.
+ */
+class RetransmitHandler
+{
+public:
+    static const std::int32_t MAX_RETRANSMITS = 16;
+
+    RetransmitHandler(
+        FeedbackDelayGenerator& delayGenerator,
+        FeedbackDelayGenerator& lingerGenerator,
+        aeron::concurrent::AtomicCounter* retransmitsSent = nullptr)
+        : m_delayGenerator(delayGenerator), m_lingerGenerator(lingerGenerator), m_retransmitsSent(retransmitsSent)
+    {
+        m_actions.reserve(MAX_RETRANSMITS);
+    }
+
+    /**
+     * A NAK has been received for a range of a term.
+     *
+     * @param termId        of the range.
+     * @param termOffset    at which the range begins.
+     * @param length        of the range.
+     * @param termLength    of the publication, ranges that do not fit in a term are ignored.
+     * @param nowNs         current time.
+     * @param resendHandler to retransmit the range with if it is to be sent straight away.
+     */
+    inline void onNak(
+        std::int32_t termId,
+        std::int32_t termOffset,
+        std::int32_t length,
+        std::int32_t termLength,
+        std::int64_t nowNs,
+        const resend_handler_t& resendHandler)
+    {
+        if (termOffset < 0 || length <= 0 || termOffset > termLength - length)
+        {
+            return;
+        }
+
+        std::int32_t beginOffset = termOffset;
+        std::int32_t endOffset = termOffset + length;
+
+        for (RetransmitAction& action : m_actions)
+        {
+            if (action.termId != termId || !action.overlaps(beginOffset, endOffset))
+            {
+                continue;
+            }
+
+            if (DELAYED == action.state)
+            {
+                const std::int32_t actionEndOffset = std::max(action.termOffset + action.length, endOffset);
+                action.termOffset = std::min(action.termOffset, beginOffset);
+                action.length = actionEndOffset - action.termOffset;
+                return;
+            }
+
+            // lingering, so only what lies outside what was just sent is still wanted
+            if (action.termOffset <= beginOffset)
+            {
+                beginOffset = std::max(beginOffset, action.termOffset + action.length);
+            }
+            else if (action.termOffset + action.length >= endOffset)
+            {
+                endOffset = action.termOffset;
+            }
+
+            if (endOffset <= beginOffset)
+            {
+                return;
+            }
+        }
+
+        if (m_actions.size() >= (std::size_t) MAX_RETRANSMITS)
+        {
+            return;
+        }
+
+        m_actions.push_back(RetransmitAction{termId, beginOffset, endOffset - beginOffset, DELAYED, 0});
+        RetransmitAction& action = m_actions.back();
+
+        if (m_delayGenerator.shouldFeedbackImmediately())
+        {
+            resend(action, nowNs, resendHandler);
+        }
+        else
+        {
+            action.expiryNs = nowNs + m_delayGenerator.generateDelay();
+        }
+    }
+
+    /**
+     * Send the retransmits whose delay has expired and finish those that have lingered long enough.
+     *
+     * @param nowNs         current time.
+     * @param resendHandler to retransmit ranges with.
+     * @return number of retransmits sent.
+     */
+    inline std::int32_t processTimeouts(std::int64_t nowNs, const resend_handler_t& resendHandler)
+    {
+        std::int32_t retransmits = 0;
+
+        for (std::size_t i = m_actions.size(); i-- > 0;)
+        {
+            RetransmitAction& action = m_actions[i];
+
+            if (nowNs < action.expiryNs)
+            {
+                continue;
+            }
+
+            if (DELAYED == action.state)
+            {
+                resend(action, nowNs, resendHandler);
+                retransmits++;
+            }
+            else
+            {
+                m_actions.erase(m_actions.begin() + i);
+            }
+        }
+
+        return retransmits;
+    }
+
+    /**
+     * Number of retransmits waiting to be sent or lingering.
+     */
+    inline std::size_t activeRetransmitCount() const
+    {
+        return m_actions.size();
+    }
+
+private:
+    enum State
+    {
+        DELAYED, LINGERING
+    };
+
+    struct RetransmitAction
+    {
+        std::int32_t termId;
+        std::int32_t termOffset;
+        std::int32_t length;
+        State state;
+        std::int64_t expiryNs;
+
+        inline bool overlaps(std::int32_t beginOffset, std::int32_t endOffset) const
+        {
+            return termOffset < endOffset && beginOffset < (termOffset + length);
+        }
+    };
+
+    FeedbackDelayGenerator& m_delayGenerator;
+    FeedbackDelayGenerator& m_lingerGenerator;
+    aeron::concurrent::AtomicCounter* m_retransmitsSent;
+    std::vector<RetransmitAction> m_actions;
+
+    inline void resend(RetransmitAction& action, std::int64_t nowNs, const resend_handler_t& resendHandler)
+    {
+        resendHandler(action.termId, action.termOffset, action.length);
+
+        action.state = LINGERING;
+        action.expiryNs = nowNs + m_lingerGenerator.generateDelay();
+
+        if (nullptr != m_retransmitsSent)
+        {
+            m_retransmitsSent->orderedIncrement();
+        }
+    }
+};
+
+}};
+
+#endif
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_SENDER_
+#define INCLUDED_AERON_DRIVER_SENDER_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "aeron/concurrent/AtomicCounter.h"
+#include "concurrent/CommandQueue.h"
+
+#include "NetworkPublication.h"
+
+namespace aeron { namespace driver {
+
+/**
+ * Duty cycle for sending the network publications of the driver.
+ *
+ * Publications are scheduled by deficit round-robin over priority classes, so a bulk stream cannot hold back a latency
+ * sensitive one on the same driver. Each cycle visits the high, normal and then low class, and within a class sends
+ * the publications round-robin, starting one further along on each cycle, so none of them is always last to be sent
+ * when a burst fills the socket buffers. A publication is credited the quantum of its class on each visit and may send
+ * new data until the credit is spent. Only what goes on the wire is charged, so the padding skipped at the end of a
+ * term costs no more than its header. Credit left short of a frame is carried to the next cycle, while a publication
+ * that runs out of data, window or tokens first gives up the rest so idle publications do not save up bursts.
+ *
+ * The queueing delay of a class is sampled as the time from a visit finding data waiting to the sender position
+ * passing it, and a smoothed delay is published in the counter of the class when one is set.
+ *
+ * The channel endpoints of the publications are polled for the status messages that drive their flow control.
+ */
+class Sender
+{
+public:
+    static const std::int32_t HIGH_PRIORITY = 0;
+    static const std::int32_t NORMAL_PRIORITY = 1;
+    static const std::int32_t LOW_PRIORITY = 2;
+    static const std::int32_t PRIORITY_CLASS_COUNT = 3;
+
+    static const std::int32_t DEFAULT_HIGH_PRIORITY_QUANTUM_LENGTH = 256 * 1024;
+    static const std::int32_t DEFAULT_NORMAL_PRIORITY_QUANTUM_LENGTH = 64 * 1024;
+    static const std::int32_t DEFAULT_LOW_PRIORITY_QUANTUM_LENGTH = 16 * 1024;
+
+    /**
+     * @param nanoClock                   for the current time on each cycle.
+     * @param highPriorityQuantumLength   bytes a high priority publication may send per cycle.
+     * @param normalPriorityQuantumLength bytes a normal priority publication may send per cycle.
+     * @param lowPriorityQuantumLength    bytes a low priority publication may send per cycle.
+     */
+    Sender(
+        nano_clock_t nanoClock,
+        std::int32_t highPriorityQuantumLength = DEFAULT_HIGH_PRIORITY_QUANTUM_LENGTH,
+        std::int32_t normalPriorityQuantumLength = DEFAULT_NORMAL_PRIORITY_QUANTUM_LENGTH,
+        std::int32_t lowPriorityQuantumLength = DEFAULT_LOW_PRIORITY_QUANTUM_LENGTH)
+        : m_nanoClock(nanoClock)
+    {
+        m_priorityClasses[HIGH_PRIORITY].quantumLength = highPriorityQuantumLength;
+        m_priorityClasses[NORMAL_PRIORITY].quantumLength = normalPriorityQuantumLength;
+        m_priorityClasses[LOW_PRIORITY].quantumLength = lowPriorityQuantumLength;
+    }
+
+    virtual ~Sender() = default;
+
+    inline std::int32_t doWork()
+    {
+        const std::int32_t workCount = m_commandQueue.drain() + doSend(m_nanoClock());
+
+        return workCount + pollControlEndpoints();
+    }
+
+    inline void onClose()
+    {
+    }
+
+    /**
+     * Commands from the conductor when it runs on another thread, see SenderProxy.
+     */
+    inline concurrent::CommandQueue& commandQueue()
+    {
+        return m_commandQueue;
+    }
+
+    inline void onNewNetworkPublication(NetworkPublication::ptr_t publication)
+    {
+        SendChannelEndpoint& endpoint = publication->sendChannelEndpoint();
+
+        endpoint.registerForSend(*publication);
+        if (std::find(m_controlEndpoints.begin(), m_controlEndpoints.end(), &endpoint) == m_controlEndpoints.end())
+        {
+            m_controlEndpoints.push_back(&endpoint);
+        }
+
+        m_priorityClasses[publication->priorityClass()].publications.push_back(ScheduledPublication{publication});
+    }
+
+    inline void onRemoveNetworkPublication(NetworkPublication& publication)
+    {
+        SendChannelEndpoint& endpoint = publication.sendChannelEndpoint();
+
+        endpoint.unregisterForSend(publication);
+        if (0 == endpoint.registeredPublicationCount())
+        {
+            m_controlEndpoints.erase(
+                std::remove(m_controlEndpoints.begin(), m_controlEndpoints.end(), &endpoint), m_controlEndpoints.end());
+        }
+
+        std::vector<ScheduledPublication>& publications = m_priorityClasses[publication.priorityClass()].publications;
+        publications.erase(
+            std::remove_if(
+                publications.begin(),
+                publications.end(),
+                [&](const ScheduledPublication& candidate)
+                {
+                    return candidate.publication.get() == &publication;
+                }),
+            publications.end());
+    }
+
+    inline std::size_t networkPublicationCount() const
+    {
+        std::size_t count = 0;
+
+        for (const PriorityClass& priorityClass : m_priorityClasses)
+        {
+            count += priorityClass.publications.size();
+        }
+
+        return count;
+    }
+
+    /**
+     * Set the counter the smoothed queueing delay in ns of a priority class is published in, before the duty cycle
+     * starts.
+     */
+    inline void queueingDelayCounter(std::int32_t priorityClass, AtomicCounter* counter)
+    {
+        m_priorityClasses[priorityClass].queueingDelay = counter;
+    }
+
+private:
+    struct ScheduledPublication
+    {
+        NetworkPublication::ptr_t publication;
+        std::int32_t deficit = 0;
+        std::int64_t markPosition = -1;
+        std::int64_t markTimestampNs = 0;
+
+        explicit ScheduledPublication(NetworkPublication::ptr_t publication) : publication(std::move(publication))
+        {
+        }
+    };
+
+    struct PriorityClass
+    {
+        std::vector<ScheduledPublication> publications;
+        std::int32_t quantumLength = 0;
+        std::size_t roundRobinIndex = 0;
+        AtomicCounter* queueingDelay = nullptr;
+    };
+
+    concurrent::CommandQueue m_commandQueue;
+    std::array<PriorityClass, PRIORITY_CLASS_COUNT> m_priorityClasses;
+    std::vector<SendChannelEndpoint*> m_controlEndpoints;
+    nano_clock_t m_nanoClock;
+
+    inline std::int32_t doSend(std::int64_t nowNs)
+    {
+        std::int32_t bytesSent = 0;
+
+        for (PriorityClass& priorityClass : m_priorityClasses)
+        {
+            std::vector<ScheduledPublication>& publications = priorityClass.publications;
+            const std::size_t length = publications.size();
+            std::size_t startingIndex = priorityClass.roundRobinIndex++;
+            if (startingIndex >= length)
+            {
+                priorityClass.roundRobinIndex = startingIndex = 0;
+            }
+
+            for (std::size_t i = startingIndex; i < length; i++)
+            {
+                bytesSent += send(priorityClass, publications[i], nowNs);
+            }
+
+            for (std::size_t i = 0; i < startingIndex; i++)
+            {
+                bytesSent += send(priorityClass, publications[i], nowNs);
+            }
+        }
+
+        return bytesSent;
+    }
+
+    inline std::int32_t send(PriorityClass& priorityClass, ScheduledPublication& scheduled, std::int64_t nowNs)
+    {
+        NetworkPublication& publication = *scheduled.publication;
+        const std::int32_t mtuLength = publication.mtuLength();
+
+        if (nullptr != priorityClass.queueingDelay && scheduled.markPosition < 0)
+        {
+            const std::int64_t producerPosition = publication.producerPosition();
+            if (producerPosition > publication.senderPosition())
+            {
+                scheduled.markPosition = producerPosition;
+                scheduled.markTimestampNs = nowNs;
+            }
+        }
+
+        std::int32_t deficit = scheduled.deficit + priorityClass.quantumLength;
+        std::int32_t bytesSent = 0;
+        std::int32_t sent;
+
+        do
+        {
+            sent = publication.send(nowNs, deficit);
+            deficit -= sent;
+            bytesSent += sent;
+        }
+        while (sent > 0 && deficit >= mtuLength);
+
+        scheduled.deficit = deficit < mtuLength ? std::max(deficit, 0) : 0;
+
+        if (scheduled.markPosition >= 0 && publication.senderPosition() >= scheduled.markPosition)
+        {
+            const std::int64_t sampleNs = nowNs - scheduled.markTimestampNs;
+            const std::int64_t delayNs = priorityClass.queueingDelay->get();
+
+            priorityClass.queueingDelay->setOrdered(delayNs + ((sampleNs - delayNs) / 8));
+            scheduled.markPosition = -1;
+        }
+
+        return bytesSent;
+    }
+
+    inline std::int32_t pollControlEndpoints()
+    {
+        std::int32_t messagesReceived = 0;
+
+        for (SendChannelEndpoint* endpoint : m_controlEndpoints)
+        {
+            messagesReceived += endpoint->pollForControl();
+        }
+
+        return messagesReceived;
+    }
+};
+
+}};
+
+#endif
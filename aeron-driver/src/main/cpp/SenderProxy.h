@@ -0,0 +1,79 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_SENDERPROXY_
+#define INCLUDED_AERON_DRIVER_SENDERPROXY_
+
+#include <memory>
+
+#include "MediaDriver.h"
+#include "NetworkPublication.h"
+#include "Sender.h"
+
+namespace aeron { namespace driver {
+
+/**
+ * Hands requests from the DriverConductor over to the Sender. They are made on the Sender straight away when both run
+ * on the same thread, otherwise they are queued for the Sender to execute on its own thread.
+ */
+class SenderProxy
+{
+public:
+    SenderProxy(ThreadingMode threadingMode, std::shared_ptr<Sender> sender) :
+        m_threadingMode(threadingMode), m_sender(std::move(sender))
+    {
+    }
+
+    inline void newNetworkPublication(NetworkPublication::ptr_t publication)
+    {
+        if (SHARED == m_threadingMode)
+        {
+            m_sender->onNewNetworkPublication(publication);
+        }
+        else
+        {
+            Sender* sender = m_sender.get();
+            m_sender->commandQueue().offer([sender, publication]()
+            {
+                sender->onNewNetworkPublication(publication);
+            });
+        }
+    }
+
+    inline void removeNetworkPublication(NetworkPublication::ptr_t publication)
+    {
+        if (SHARED == m_threadingMode)
+        {
+            m_sender->onRemoveNetworkPublication(*publication);
+        }
+        else
+        {
+            Sender* sender = m_sender.get();
+            m_sender->commandQueue().offer([sender, publication]()
+            {
+                sender->onRemoveNetworkPublication(*publication);
+            });
+        }
+    }
+
+private:
+    ThreadingMode m_threadingMode;
+    std::shared_ptr<Sender> m_sender;
+};
+
+}};
+
+#endif
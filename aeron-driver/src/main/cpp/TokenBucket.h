@@ -0,0 +1,94 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_TOKENBUCKET__
+#define INCLUDED_AERON_DRIVER_TOKENBUCKET__
+
+#include <algorithm>
+#include <cstdint>
+
+namespace aeron { namespace driver {
+
+/**
+ * Paces what a NetworkPublication sends to a rate, so a batch appended to the log all at once is spread out rather
+ * than overrunning switch buffers and the socket buffers of receivers. Tokens are bytes that accrue at the rate up to
+ * the burst length, which is as much as may go out back to back. Called from the Sender duty cycle only.
+ *
+ * Sends may take more than is available, e.g. retransmits, leaving the bucket in debt until enough has accrued again.
+ */
+class TokenBucket
+{
+public:
+    /**
+     * @param rateBytesPerSecond tokens accrue at.
+     * @param burstLength        tokens are capped at and start at.
+     * @param nowNs              current time.
+     */
+    TokenBucket(std::int64_t rateBytesPerSecond, std::int32_t burstLength, std::int64_t nowNs)
+        : m_bytesPerNs(rateBytesPerSecond / 1e9),
+          m_burstLength(burstLength),
+          m_tokens(burstLength),
+          m_lastRefillNs(nowNs)
+    {
+    }
+
+    /**
+     * Bytes that may be sent now.
+     *
+     * @param nowNs current time.
+     * @return tokens accrued, 0 while in debt.
+     */
+    inline std::int32_t available(std::int64_t nowNs)
+    {
+        if (nowNs > m_lastRefillNs)
+        {
+            m_tokens = std::min<double>(m_tokens + ((nowNs - m_lastRefillNs) * m_bytesPerNs), m_burstLength);
+            m_lastRefillNs = nowNs;
+        }
+
+        return m_tokens > 0 ? (std::int32_t) m_tokens : 0;
+    }
+
+    /**
+     * Take the tokens for bytes that have been sent.
+     *
+     * @param length sent.
+     */
+    inline void consume(std::int32_t length)
+    {
+        m_tokens -= length;
+    }
+
+    inline std::int64_t rateBytesPerSecond() const
+    {
+        return (std::int64_t) (m_bytesPerNs * 1e9);
+    }
+
+    inline std::int32_t burstLength() const
+    {
+        return m_burstLength;
+    }
+
+private:
+    const double m_bytesPerNs;
+    const std::int32_t m_burstLength;
+    double m_tokens;
+    std::int64_t m_lastRefillNs;
+};
+
+}};
+
+#endif
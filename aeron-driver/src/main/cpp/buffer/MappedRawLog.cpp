@@ -32,7 +32,7 @@ MappedRawLog::MappedRawLog(
 
     if (logLength < LogBufferDescriptor::MAX_SINGLE_MAPPING_SIZE)
     {
-        m_memoryMappedFiles.push_back(MemoryMappedFile::createNew(m_location, 0, (size_t) logLength));
+        m_memoryMappedFiles.push_back(MemoryMappedFile::createNew(m_location.c_str(), 0, (size_t) logLength));
 
         std::uint8_t *basePtr = m_memoryMappedFiles[0]->getMemoryPtr();
 
@@ -56,14 +56,14 @@ MappedRawLog::MappedRawLog(
         const std::int64_t metaDataSectionLength = (index_t) (logLength - metaDataSectionOffset);
 
         m_memoryMappedFiles.push_back(
-            MemoryMappedFile::createNew(location, metaDataSectionOffset, metaDataSectionLength));
+            MemoryMappedFile::createNew(m_location.c_str(), metaDataSectionOffset, metaDataSectionLength));
 
         std::uint8_t *metaDataBasePtr = m_memoryMappedFiles[0]->getMemoryPtr();
 
         for (int i = 0; i < LogBufferDescriptor::PARTITION_COUNT; i++)
         {
             // one map for each term
-            m_memoryMappedFiles.push_back(MemoryMappedFile::mapExisting(location, i * termLength, termLength));
+            m_memoryMappedFiles.push_back(MemoryMappedFile::mapExisting(m_location.c_str(), i * termLength, termLength));
 
             std::uint8_t *basePtr = m_memoryMappedFiles[i + 1]->getMemoryPtr();
 
@@ -81,7 +81,7 @@ MappedRawLog::MappedRawLog(
 
 MappedRawLog::~MappedRawLog()
 {
-    ::unlink(m_location);
+    ::unlink(m_location.c_str());
 }
 
 std::int32_t MappedRawLog::termLength()
@@ -91,7 +91,7 @@ std::int32_t MappedRawLog::termLength()
 
 const char* MappedRawLog::logFileName()
 {
-    return m_location;
+    return m_location.c_str();
 }
 
 void MappedRawLog::allocatePages(std::uint8_t *mapping, size_t length)
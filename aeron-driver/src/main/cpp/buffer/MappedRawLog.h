@@ -20,6 +20,7 @@
 
 #include <sys/types.h>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 #include "aeron/concurrent/logbuffer/LogBufferDescriptor.h"
@@ -41,8 +42,18 @@ public:
     std::int32_t termLength();
     const char* logFileName();
 
+    inline AtomicBuffer& termBuffer(int index)
+    {
+        return m_buffers[index];
+    }
+
+    inline AtomicBuffer& logMetaDataBuffer()
+    {
+        return m_logMetaDataBuffer;
+    }
+
 private:
-    const char* m_location;
+    std::string m_location;
     bool m_useSparseFiles;
     std::int32_t m_termLength;
     std::vector<MemoryMappedFile::ptr_t> m_memoryMappedFiles;
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_COMMANDQUEUE_
+#define INCLUDED_AERON_DRIVER_COMMANDQUEUE_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "OneToOneConcurrentArrayQueue.h"
+
+namespace aeron { namespace driver { namespace concurrent {
+
+/**
+ * Queue of commands for an agent that is run on another thread than the one issuing them. The agent drains the queue
+ * as part of its duty cycle so commands are executed on its own thread, in the order they were offered.
+ */
+class CommandQueue
+{
+public:
+    typedef std::function<void()> command_t;
+
+    static const std::int32_t DEFAULT_CAPACITY = 1024;
+
+    CommandQueue(std::int32_t capacity = DEFAULT_CAPACITY) : m_queue(capacity)
+    {
+    }
+
+    ~CommandQueue()
+    {
+        command_t* command;
+        while (nullptr != (command = m_queue.poll()))
+        {
+            delete command;
+        }
+    }
+
+    CommandQueue(const CommandQueue& queue) = delete;
+    CommandQueue& operator=(const CommandQueue& queue) = delete;
+
+    /**
+     * Offer a command to the agent, yielding while the queue is full so commands are never dropped.
+     */
+    inline void offer(command_t command)
+    {
+        command_t* queued = new command_t(std::move(command));
+
+        while (!m_queue.offer(queued))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Execute the commands that have been offered.
+     *
+     * @return number of commands executed.
+     */
+    inline std::int32_t drain()
+    {
+        std::int32_t count = 0;
+        command_t* command;
+
+        while (nullptr != (command = m_queue.poll()))
+        {
+            std::unique_ptr<command_t> owned{command};
+            (*owned)();
+            count++;
+        }
+
+        return count;
+    }
+
+private:
+    OneToOneConcurrentArrayQueue<command_t> m_queue;
+};
+
+}}};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_COMPOSITEAGENT_
+#define INCLUDED_AERON_DRIVER_COMPOSITEAGENT_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace aeron { namespace driver { namespace concurrent {
+
+/**
+ * Agent that runs the duty cycles of several agents in turn, so they can share one AgentRunner and its thread.
+ *
+ * Agents are anything with doWork() and onClose(). Their duty cycles are run in the order they were added, and they
+ * are closed in that order too.
+ */
+class CompositeAgent
+{
+public:
+    template<typename Agent>
+    inline CompositeAgent& add(std::shared_ptr<Agent> agent)
+    {
+        m_agents.push_back(AgentInvoker{
+            [agent]() { return (int) agent->doWork(); },
+            [agent]() { agent->onClose(); }});
+
+        return *this;
+    }
+
+    inline int doWork()
+    {
+        int workCount = 0;
+
+        for (auto& agent : m_agents)
+        {
+            workCount += agent.doWork();
+        }
+
+        return workCount;
+    }
+
+    inline void onClose()
+    {
+        for (auto& agent : m_agents)
+        {
+            agent.onClose();
+        }
+    }
+
+    inline std::size_t agentCount() const
+    {
+        return m_agents.size();
+    }
+
+private:
+    struct AgentInvoker
+    {
+        std::function<int()> doWork;
+        std::function<void()> onClose;
+    };
+
+    std::vector<AgentInvoker> m_agents;
+};
+
+}}};
+
+#endif
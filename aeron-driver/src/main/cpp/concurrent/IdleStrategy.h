@@ -0,0 +1,54 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_IDLESTRATEGY_
+#define INCLUDED_AERON_DRIVER_IDLESTRATEGY_
+
+#include <functional>
+#include <type_traits>
+
+namespace aeron { namespace driver { namespace concurrent {
+
+/**
+ * Holds any idle strategy, such as a BusySpinIdleStrategy or SleepingIdleStrategy, so the one an AgentRunner uses can
+ * be chosen when the driver is configured rather than when it is compiled.
+ *
+ * Copies hold their own copy of the strategy, so each runner configured from the same strategy keeps its own state.
+ */
+class IdleStrategy
+{
+public:
+    template<
+        typename Strategy,
+        typename = typename std::enable_if<
+            !std::is_same<typename std::decay<Strategy>::type, IdleStrategy>::value>::type>
+    IdleStrategy(Strategy strategy) :
+        m_idle([strategy](int workCount) mutable { strategy.idle(workCount); })
+    {
+    }
+
+    inline void idle(int workCount)
+    {
+        m_idle(workCount);
+    }
+
+private:
+    std::function<void(int)> m_idle;
+};
+
+}}};
+
+#endif
@@ -44,7 +44,7 @@ public:
             m_buffer[i].store(nullptr, std::memory_order_relaxed);
         }
 
-        m_buffer[m_capacity - 1].store(nullptr, std::memory_order_acq_rel);
+        m_buffer[m_capacity - 1].store(nullptr, std::memory_order_release);
     }
 
     ~OneToOneConcurrentArrayQueue()
@@ -66,8 +66,8 @@ public:
         volatile T* ptr = source->load(std::memory_order_seq_cst);
         if (nullptr == ptr)
         {
-            source->store(t, std::memory_order_acq_rel);
-            m_tail.store(currentTail + 1, std::memory_order_acq_rel);
+            source->store(t, std::memory_order_release);
+            m_tail.store(currentTail + 1, std::memory_order_release);
 
             return true;
         }
@@ -84,8 +84,8 @@ public:
 
         if (nullptr != t)
         {
-            source->store(nullptr, std::memory_order_acq_rel);
-            m_head.store(currentHead + 1, std::memory_order_acq_rel);
+            source->store(nullptr, std::memory_order_release);
+            m_head.store(currentHead + 1, std::memory_order_release);
         }
 
         return const_cast<T*>(t);
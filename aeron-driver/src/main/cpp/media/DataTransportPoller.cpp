@@ -0,0 +1,96 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#include "aeron/util/Exceptions.h"
+#include "aeron/util/StringUtil.h"
+
+#include "DataTransportPoller.h"
+
+using namespace aeron::driver::media;
+
+const std::int32_t DataTransportPoller::ITERATION_THRESHOLD;
+const std::int32_t DataTransportPoller::MAX_EVENTS;
+
+DataTransportPoller::DataTransportPoller(std::int32_t iterationThreshold)
+    : m_iterationThreshold(iterationThreshold)
+{
+#if defined(__linux__)
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to create epoll instance: %s", strerror(errno)), SOURCEINFO};
+    }
+
+    m_events.resize(MAX_EVENTS);
+#endif
+}
+
+DataTransportPoller::~DataTransportPoller()
+{
+    if (m_epollFd >= 0)
+    {
+        close(m_epollFd);
+    }
+}
+
+void DataTransportPoller::registerForRead(ReceiveChannelEndpoint& endpoint)
+{
+    m_transports.push_back(&endpoint);
+
+    if (endpoint.isIoUringEnabled())
+    {
+        m_alwaysPolledTransports.push_back(&endpoint);
+        return;
+    }
+
+#if defined(__linux__)
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = &endpoint;
+
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, endpoint.receiveSocketFd(), &event) < 0)
+    {
+        m_transports.pop_back();
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to register endpoint for read: %s", strerror(errno)), SOURCEINFO};
+    }
+#endif
+}
+
+void DataTransportPoller::cancelRead(ReceiveChannelEndpoint& endpoint)
+{
+    m_transports.erase(std::remove(m_transports.begin(), m_transports.end(), &endpoint), m_transports.end());
+
+    auto alwaysPolled = std::find(m_alwaysPolledTransports.begin(), m_alwaysPolledTransports.end(), &endpoint);
+    if (alwaysPolled != m_alwaysPolledTransports.end())
+    {
+        m_alwaysPolledTransports.erase(alwaysPolled);
+        return;
+    }
+
+#if defined(__linux__)
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, endpoint.receiveSocketFd(), &event);
+#endif
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_MEDIA_DATATRANSPORTPOLLER__
+#define INCLUDED_AERON_DRIVER_MEDIA_DATATRANSPORTPOLLER__
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
+#include "ReceiveChannelEndpoint.h"
+
+namespace aeron { namespace driver { namespace media {
+
+/**
+ * Polls the ReceiveChannelEndpoints of the receiver for data.
+ *
+ * Up to the iteration threshold every endpoint is polled on each pass, which for a few endpoints is cheaper than
+ * asking the kernel which of them are readable. Beyond it the sockets are registered in one epoll set and only those
+ * that are readable are polled, so the cost of a pass follows the number of active channels rather than the number
+ * registered. Endpoints receiving through io_uring are polled on every pass as their datagrams complete to the ring
+ * without the socket becoming readable, and checking the ring needs no system call.
+ */
+class DataTransportPoller
+{
+public:
+    static const std::int32_t ITERATION_THRESHOLD = 5;
+    static const std::int32_t MAX_EVENTS = 64;
+
+    DataTransportPoller(std::int32_t iterationThreshold = ITERATION_THRESHOLD);
+
+    ~DataTransportPoller();
+
+    DataTransportPoller(const DataTransportPoller&) = delete;
+    DataTransportPoller& operator=(const DataTransportPoller&) = delete;
+
+    /**
+     * Start polling an endpoint, which must already have its channel open.
+     */
+    void registerForRead(ReceiveChannelEndpoint& endpoint);
+
+    /**
+     * Stop polling an endpoint, before its channel is closed.
+     */
+    void cancelRead(ReceiveChannelEndpoint& endpoint);
+
+    inline std::size_t transportCount() const
+    {
+        return m_transports.size();
+    }
+
+    /**
+     * Poll the endpoints that may have data once each.
+     *
+     * @return number of bytes received.
+     */
+    inline std::int32_t pollTransports()
+    {
+        std::int32_t bytesReceived = 0;
+
+        if (m_transports.size() <= (std::size_t) m_iterationThreshold || m_epollFd < 0)
+        {
+            for (ReceiveChannelEndpoint* transport : m_transports)
+            {
+                bytesReceived += transport->pollForData();
+            }
+
+            return bytesReceived;
+        }
+
+        for (ReceiveChannelEndpoint* transport : m_alwaysPolledTransports)
+        {
+            bytesReceived += transport->pollForData();
+        }
+
+#if defined(__linux__)
+        const int readyCount = epoll_wait(m_epollFd, m_events.data(), MAX_EVENTS, 0);
+
+        for (int i = 0; i < readyCount; i++)
+        {
+            bytesReceived += static_cast<ReceiveChannelEndpoint*>(m_events[i].data.ptr)->pollForData();
+        }
+#endif
+
+        return bytesReceived;
+    }
+
+private:
+    const std::int32_t m_iterationThreshold;
+    int m_epollFd = -1;
+    std::vector<ReceiveChannelEndpoint*> m_transports;
+    std::vector<ReceiveChannelEndpoint*> m_alwaysPolledTransports;
+
+#if defined(__linux__)
+    std::vector<epoll_event> m_events;
+#endif
+};
+
+}}}
+
+#endif
@@ -146,6 +146,17 @@ std::unique_ptr<InetAddress> InetAddress::any(int familyHint)
     }
 }
 
+std::unique_ptr<InetAddress> InetAddress::copyOf(const InetAddress& address)
+{
+    if (AF_INET6 == address.family())
+    {
+        sockaddr_in6* in6 = (sockaddr_in6*) address.address();
+        return std::unique_ptr<InetAddress>{new Inet6Address{in6->sin6_addr, address.port(), in6->sin6_scope_id}};
+    }
+
+    return std::unique_ptr<InetAddress>{new Inet4Address{((sockaddr_in*) address.address())->sin_addr, address.port()}};
+}
+
 
 bool Inet4Address::isEven() const
 {
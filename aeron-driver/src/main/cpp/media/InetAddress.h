@@ -85,6 +85,11 @@ public:
 
     static std::unique_ptr<InetAddress> fromHostname(std::string& address, uint16_t port, int familyHint);
     static std::unique_ptr<InetAddress> any(int familyHint);
+
+    /**
+     * Copy of an address, for keeping hold of one that lives in a buffer which is about to be reused.
+     */
+    static std::unique_ptr<InetAddress> copyOf(const InetAddress& address);
 };
 
 class Inet4Address : public InetAddress
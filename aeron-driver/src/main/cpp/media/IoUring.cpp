@@ -0,0 +1,617 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#include "aeron/util/Exceptions.h"
+#include "aeron/util/StringUtil.h"
+
+#include "IoUring.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_RECV_MULTISHOT)
+#define AERON_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#if defined(AERON_HAVE_IO_URING)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace aeron::driver::media;
+
+const std::uint32_t IoUring::DEFAULT_ENTRIES;
+const std::uint32_t IoUring::DEFAULT_RECEIVE_BUFFER_COUNT;
+
+#if defined(AERON_HAVE_IO_URING)
+
+static const std::uint64_t SEND_TAG = 1ULL << 63;
+static const std::uint64_t RECEIVE_TAG = 1ULL << 62;
+static const std::uint64_t PROVIDE_BUFFERS_TAG = 1ULL << 61;
+static const std::uint64_t CANCEL_TAG = 1ULL << 60;
+static const std::uint16_t BUFFER_GROUP_ID = 0;
+static const std::size_t BUFFER_ALIGNMENT = 64;
+
+static void* mapRing(int ringFd, std::size_t length, off_t offset)
+{
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+    if (MAP_FAILED == ptr)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to map io_uring: %s", strerror(errno)), SOURCEINFO};
+    }
+
+    return ptr;
+}
+
+static inline std::size_t alignLength(std::size_t length, std::size_t alignment)
+{
+    return (length + alignment - 1) & ~(alignment - 1);
+}
+
+IoUring::IoUring(
+    std::uint32_t entries,
+    std::uint32_t receiveBufferCount,
+    std::int32_t receiveBufferLength,
+    socklen_t nameLength,
+    socklen_t controlLength) :
+    m_ringFd(-1),
+    m_receiveSocketFd(-1),
+    m_receiveError(0),
+    m_receiveArmed(false),
+    m_enterCount(0),
+    m_sqRing(nullptr),
+    m_sqRingLength(0),
+    m_cqRing(nullptr),
+    m_cqRingLength(0),
+    m_sqes(nullptr),
+    m_sqesLength(0),
+    m_buffers(nullptr),
+    m_buffersLength(0),
+    m_bufferCount(receiveBufferCount),
+    m_bufferLength((std::uint32_t) alignLength(
+        sizeof(io_uring_recvmsg_out) + nameLength + controlLength + receiveBufferLength, BUFFER_ALIGNMENT)),
+    m_receiveBufferLength(receiveBufferLength),
+    m_nameLength(nameLength),
+    m_controlLength(controlLength)
+{
+    if (0 == receiveBufferCount || receiveBufferCount > 65536)
+    {
+        throw aeron::util::IllegalArgumentException{
+            aeron::util::strPrintf("Receive buffer count must be between 1 and 65536: %u", receiveBufferCount),
+            SOURCEINFO};
+    }
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    m_ringFd = (int) syscall(__NR_io_uring_setup, entries, &params);
+    if (m_ringFd < 0)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to set up io_uring: %s", strerror(errno)), SOURCEINFO};
+    }
+
+    try
+    {
+        m_sqRingLength = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+        m_cqRingLength = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            m_sqRingLength = m_cqRingLength = std::max(m_sqRingLength, m_cqRingLength);
+            m_sqRing = mapRing(m_ringFd, m_sqRingLength, IORING_OFF_SQ_RING);
+            m_cqRing = m_sqRing;
+        }
+        else
+        {
+            m_sqRing = mapRing(m_ringFd, m_sqRingLength, IORING_OFF_SQ_RING);
+            m_cqRing = mapRing(m_ringFd, m_cqRingLength, IORING_OFF_CQ_RING);
+        }
+
+        m_sqesLength = params.sq_entries * sizeof(io_uring_sqe);
+        m_sqes = mapRing(m_ringFd, m_sqesLength, IORING_OFF_SQES);
+
+        std::uint8_t* sq = static_cast<std::uint8_t*>(m_sqRing);
+        m_sqHead = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.head);
+        m_sqTail = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<std::uint32_t*>(sq + params.sq_off.ring_mask);
+        m_sqEntries = params.sq_entries;
+        m_sqArray = reinterpret_cast<std::uint32_t*>(sq + params.sq_off.array);
+
+        std::uint8_t* cq = static_cast<std::uint8_t*>(m_cqRing);
+        m_cqHead = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.head);
+        m_cqTail = reinterpret_cast<std::uint32_t*>(cq + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<std::uint32_t*>(cq + params.cq_off.ring_mask);
+        m_cqes = cq + params.cq_off.cqes;
+
+        m_buffersLength = (std::size_t) m_bufferCount * m_bufferLength;
+        void* buffers = mmap(
+            nullptr, m_buffersLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (MAP_FAILED == buffers)
+        {
+            throw aeron::util::IOException{
+                aeron::util::strPrintf("Failed to map io_uring buffers: %s", strerror(errno)), SOURCEINFO};
+        }
+        m_buffers = static_cast<std::uint8_t*>(buffers);
+
+        m_buffersHeld.reserve(m_bufferCount);
+        m_buffersToProvide.reserve(m_bufferCount);
+        m_pendingReceives.reserve(params.cq_entries);
+
+        for (std::uint32_t i = 0; i < m_bufferCount; i++)
+        {
+            m_buffersToProvide.push_back((std::uint16_t) i);
+        }
+
+        const std::uint32_t toSubmit = queueProvideBuffers();
+        if (enter(toSubmit, toSubmit, IORING_ENTER_GETEVENTS) < 0)
+        {
+            throw aeron::util::IOException{
+                aeron::util::strPrintf("Failed to provide io_uring buffers: %s", strerror(errno)), SOURCEINFO};
+        }
+
+        std::uint32_t head = *m_cqHead;
+        const std::uint32_t tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        const io_uring_cqe* cqes = static_cast<const io_uring_cqe*>(m_cqes);
+
+        for (; head != tail; head++)
+        {
+            const io_uring_cqe& cqe = cqes[head & m_cqMask];
+            if (cqe.res < 0)
+            {
+                throw aeron::util::IOException{
+                    aeron::util::strPrintf("Failed to provide io_uring buffers: %s", strerror(-cqe.res)), SOURCEINFO};
+            }
+        }
+
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+
+    memset(&m_receiveHeader, 0, sizeof(m_receiveHeader));
+    m_receiveHeader.msg_namelen = m_nameLength;
+    m_receiveHeader.msg_controllen = m_controlLength;
+}
+
+IoUring::~IoUring()
+{
+    cancelReceive();
+    release();
+}
+
+void IoUring::cancelReceive()
+{
+    io_uring_sqe* sqe = m_receiveArmed ? static_cast<io_uring_sqe*>(nextSqe()) : nullptr;
+    if (nullptr == sqe)
+    {
+        return;
+    }
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = RECEIVE_TAG;
+    sqe->user_data = CANCEL_TAG;
+
+    // the receive holds a reference to the socket until it completes, so wait for it to be cancelled to release it
+    std::uint32_t toSubmit = 1;
+    while (m_receiveArmed && enter(toSubmit, 1, IORING_ENTER_GETEVENTS) >= 0)
+    {
+        std::uint32_t head = *m_cqHead;
+        const std::uint32_t tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        const io_uring_cqe* cqes = static_cast<const io_uring_cqe*>(m_cqes);
+
+        for (; head != tail; head++)
+        {
+            const io_uring_cqe& cqe = cqes[head & m_cqMask];
+            if (RECEIVE_TAG == cqe.user_data && 0 == (cqe.flags & IORING_CQE_F_MORE))
+            {
+                m_receiveArmed = false;
+            }
+        }
+
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+        toSubmit = 0;
+    }
+}
+
+void IoUring::release()
+{
+    if (m_ringFd >= 0)
+    {
+        close(m_ringFd);
+        m_ringFd = -1;
+    }
+
+    if (nullptr != m_buffers)
+    {
+        munmap(m_buffers, m_buffersLength);
+        m_buffers = nullptr;
+    }
+
+    if (nullptr != m_sqes)
+    {
+        munmap(m_sqes, m_sqesLength);
+        m_sqes = nullptr;
+    }
+
+    if (nullptr != m_cqRing && m_cqRing != m_sqRing)
+    {
+        munmap(m_cqRing, m_cqRingLength);
+    }
+    m_cqRing = nullptr;
+
+    if (nullptr != m_sqRing)
+    {
+        munmap(m_sqRing, m_sqRingLength);
+        m_sqRing = nullptr;
+    }
+}
+
+void* IoUring::nextSqe()
+{
+    const std::uint32_t head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+    const std::uint32_t tail = *m_sqTail;
+
+    if (tail - head >= m_sqEntries)
+    {
+        return nullptr;
+    }
+
+    const std::uint32_t index = tail & m_sqMask;
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(m_sqes) + index;
+    memset(sqe, 0, sizeof(io_uring_sqe));
+    m_sqArray[index] = index;
+
+    __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    return sqe;
+}
+
+int IoUring::enter(std::uint32_t toSubmit, std::uint32_t minComplete, std::uint32_t flags)
+{
+    int result;
+
+    do
+    {
+        m_enterCount++;
+        result = (int) syscall(__NR_io_uring_enter, m_ringFd, toSubmit, minComplete, flags, nullptr, 0);
+    }
+    while (result < 0 && EINTR == errno);
+
+    return result;
+}
+
+void IoUring::submit(std::uint32_t toSubmit)
+{
+    if (toSubmit > 0 && enter(toSubmit, 0, 0) < 0)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to submit to io_uring: %s", strerror(errno)), SOURCEINFO};
+    }
+}
+
+void IoUring::armReceive(int socketFd)
+{
+    m_receiveSocketFd = socketFd;
+    submit(queueReceive());
+}
+
+std::uint32_t IoUring::queueReceive()
+{
+    io_uring_sqe* sqe = static_cast<io_uring_sqe*>(nextSqe());
+    if (nullptr == sqe)
+    {
+        return 0;
+    }
+
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = m_receiveSocketFd;
+    sqe->addr = (std::uint64_t) &m_receiveHeader;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP_ID;
+    sqe->user_data = RECEIVE_TAG;
+
+    m_receiveArmed = true;
+
+    return 1;
+}
+
+std::uint32_t IoUring::queueProvideBuffers()
+{
+    std::uint32_t queued = 0;
+    std::size_t index = 0;
+    const std::size_t count = m_buffersToProvide.size();
+
+    std::sort(m_buffersToProvide.begin(), m_buffersToProvide.end());
+
+    while (index < count)
+    {
+        const std::uint16_t firstId = m_buffersToProvide[index];
+        std::size_t runLength = 1;
+
+        while (index + runLength < count && m_buffersToProvide[index + runLength] == firstId + runLength)
+        {
+            runLength++;
+        }
+
+        io_uring_sqe* sqe = static_cast<io_uring_sqe*>(nextSqe());
+        if (nullptr == sqe)
+        {
+            break;
+        }
+
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = (std::int32_t) runLength;
+        sqe->addr = (std::uint64_t) (m_buffers + (std::size_t) firstId * m_bufferLength);
+        sqe->len = m_bufferLength;
+        sqe->off = firstId;
+        sqe->buf_group = BUFFER_GROUP_ID;
+        sqe->user_data = PROVIDE_BUFFERS_TAG;
+
+        queued++;
+        index += runLength;
+    }
+
+    m_buffersToProvide.erase(m_buffersToProvide.begin(), m_buffersToProvide.begin() + index);
+
+    return queued;
+}
+
+bool IoUring::onReceiveCompletion(const Completion& completion, Received& received)
+{
+    if (RECEIVE_TAG != completion.userData)
+    {
+        return false;
+    }
+
+    if (0 == (completion.flags & IORING_CQE_F_MORE))
+    {
+        m_receiveArmed = false;
+    }
+
+    if (completion.result < 0)
+    {
+        if (-ENOBUFS != completion.result && -EINTR != completion.result && -EAGAIN != completion.result)
+        {
+            m_receiveError = -completion.result;
+        }
+
+        return false;
+    }
+
+    const std::uint32_t bufferId = completion.flags >> IORING_CQE_BUFFER_SHIFT;
+    if (0 == (completion.flags & IORING_CQE_F_BUFFER) || bufferId >= m_bufferCount)
+    {
+        return false;
+    }
+
+    m_buffersHeld.push_back((std::uint16_t) bufferId);
+
+    std::uint8_t* buffer = m_buffers + (std::size_t) bufferId * m_bufferLength;
+    const io_uring_recvmsg_out* out = reinterpret_cast<const io_uring_recvmsg_out*>(buffer);
+    std::uint8_t* name = buffer + sizeof(io_uring_recvmsg_out);
+    std::uint8_t* control = name + m_nameLength;
+    std::uint8_t* payload = control + m_controlLength;
+
+    received.payload = payload;
+    received.length = completion.result - (std::int32_t) (payload - buffer);
+    received.name = reinterpret_cast<const sockaddr*>(name);
+    received.nameLength = std::min((socklen_t) out->namelen, m_nameLength);
+
+    memset(&received.controlHeader, 0, sizeof(received.controlHeader));
+    if (m_controlLength > 0)
+    {
+        received.controlHeader.msg_control = control;
+        received.controlHeader.msg_controllen = std::min((socklen_t) out->controllen, m_controlLength);
+    }
+
+    return received.length >= 0;
+}
+
+std::int32_t IoUring::pollReceives(Received* received, std::int32_t limit)
+{
+    std::int32_t count = 0;
+
+    m_buffersToProvide.insert(m_buffersToProvide.end(), m_buffersHeld.begin(), m_buffersHeld.end());
+    m_buffersHeld.clear();
+
+    std::size_t pendingConsumed = 0;
+    while (count < limit && pendingConsumed < m_pendingReceives.size())
+    {
+        if (onReceiveCompletion(m_pendingReceives[pendingConsumed++], received[count]))
+        {
+            count++;
+        }
+    }
+    m_pendingReceives.erase(m_pendingReceives.begin(), m_pendingReceives.begin() + pendingConsumed);
+
+    std::uint32_t head = *m_cqHead;
+    const std::uint32_t tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    const io_uring_cqe* cqes = static_cast<const io_uring_cqe*>(m_cqes);
+
+    while (count < limit && head != tail)
+    {
+        const io_uring_cqe& cqe = cqes[head & m_cqMask];
+        const Completion completion = { cqe.user_data, cqe.res, cqe.flags };
+        head++;
+
+        if (onReceiveCompletion(completion, received[count]))
+        {
+            count++;
+        }
+    }
+
+    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+
+    const bool rearm = !m_receiveArmed && 0 == m_receiveError && m_receiveSocketFd >= 0;
+    std::uint32_t toSubmit = 0;
+
+    if (rearm || m_buffersToProvide.size() >= m_bufferCount / 2)
+    {
+        toSubmit += queueProvideBuffers();
+    }
+
+    if (rearm)
+    {
+        toSubmit += queueReceive();
+    }
+
+    submit(toSubmit);
+
+    return count;
+}
+
+int IoUring::sendMessages(int socketFd, mmsghdr* messages, std::int32_t messageCount)
+{
+    std::uint32_t submitted = 0;
+
+    for (std::int32_t i = 0; i < messageCount; i++)
+    {
+        io_uring_sqe* sqe = static_cast<io_uring_sqe*>(nextSqe());
+        if (nullptr == sqe)
+        {
+            break;
+        }
+
+        messages[i].msg_len = 0;
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = socketFd;
+        sqe->addr = (std::uint64_t) &messages[i].msg_hdr;
+        sqe->len = 1;
+        sqe->msg_flags = MSG_DONTWAIT;
+        sqe->user_data = SEND_TAG | (std::uint64_t) i;
+        submitted++;
+    }
+
+    if (0 == submitted)
+    {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    if (enter(submitted, submitted, IORING_ENTER_GETEVENTS) < 0)
+    {
+        return -1;
+    }
+
+    std::int32_t firstError = 0;
+    std::int32_t firstFailed = (std::int32_t) submitted;
+    std::uint32_t remaining = submitted;
+    const io_uring_cqe* cqes = static_cast<const io_uring_cqe*>(m_cqes);
+
+    while (remaining > 0)
+    {
+        std::uint32_t head = *m_cqHead;
+        const std::uint32_t tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+        if (head == tail)
+        {
+            if (enter(0, remaining, IORING_ENTER_GETEVENTS) < 0)
+            {
+                return -1;
+            }
+            continue;
+        }
+
+        for (; head != tail; head++)
+        {
+            const io_uring_cqe& cqe = cqes[head & m_cqMask];
+
+            if (0 != (cqe.user_data & SEND_TAG))
+            {
+                const std::int32_t index = (std::int32_t) (cqe.user_data & ~SEND_TAG);
+
+                if (cqe.res >= 0)
+                {
+                    messages[index].msg_len = (unsigned int) cqe.res;
+                }
+                else if (index < firstFailed)
+                {
+                    firstFailed = index;
+                    firstError = -cqe.res;
+                }
+
+                remaining--;
+            }
+            else if (RECEIVE_TAG == cqe.user_data)
+            {
+                m_pendingReceives.push_back({ cqe.user_data, cqe.res, cqe.flags });
+            }
+        }
+
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    if (0 == firstFailed)
+    {
+        errno = firstError;
+        return -1;
+    }
+
+    return firstFailed;
+}
+
+#else
+
+IoUring::IoUring(
+    std::uint32_t entries,
+    std::uint32_t receiveBufferCount,
+    std::int32_t receiveBufferLength,
+    socklen_t nameLength,
+    socklen_t controlLength) :
+    m_ringFd(-1),
+    m_bufferCount(receiveBufferCount),
+    m_bufferLength(0),
+    m_receiveBufferLength(receiveBufferLength),
+    m_nameLength(nameLength),
+    m_controlLength(controlLength)
+{
+    throw aeron::util::IOException{"io_uring is not supported on this platform", SOURCEINFO};
+}
+
+IoUring::~IoUring()
+{
+}
+
+void IoUring::armReceive(int socketFd)
+{
+}
+
+std::int32_t IoUring::pollReceives(Received* received, std::int32_t limit)
+{
+    return 0;
+}
+
+int IoUring::sendMessages(int socketFd, mmsghdr* messages, std::int32_t messageCount)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+#endif
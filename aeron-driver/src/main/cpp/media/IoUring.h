@@ -0,0 +1,182 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_MEDIA_IOURING__
+#define INCLUDED_AERON_DRIVER_MEDIA_IOURING__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <sys/socket.h>
+
+#if defined(__linux__)
+#include <sys/uio.h>
+#endif
+
+struct mmsghdr;
+
+namespace aeron { namespace driver { namespace media {
+
+/**
+ * An io_uring instance driving the socket I/O of a single UdpChannelTransport.
+ *
+ * Receives are served by one multishot recvmsg that the kernel keeps armed, filling buffers from a group of buffers
+ * provided to the kernel up front. Buffers are handed back in batches once half of them are in use, so most duty cycles
+ * with data waiting cost no system calls to receive it. Sends are queued as one sendmsg entry per message and submitted
+ * with a single io_uring_enter.
+ *
+ * Only available on Linux kernels with multishot receive (6.0 and later), construction throws an IOException otherwise
+ * so the caller can fall back to plain socket calls.
+ */
+class IoUring
+{
+public:
+    static const std::uint32_t DEFAULT_ENTRIES = 256;
+    static const std::uint32_t DEFAULT_RECEIVE_BUFFER_COUNT = 256;
+
+    struct Received
+    {
+        std::uint8_t* payload;
+        std::int32_t length;
+        const sockaddr* name;
+        socklen_t nameLength;
+        msghdr controlHeader;
+    };
+
+    /**
+     * @param entries             size of the submission queue, rounded up to a power of 2 by the kernel.
+     * @param receiveBufferCount  number of receive buffers provided to the kernel, up to 65536.
+     * @param receiveBufferLength maximum datagram length that can be received.
+     * @param nameLength          length of the source address to capture for each datagram.
+     * @param controlLength       length of the control message space to capture for each datagram.
+     */
+    IoUring(
+        std::uint32_t entries,
+        std::uint32_t receiveBufferCount,
+        std::int32_t receiveBufferLength,
+        socklen_t nameLength,
+        socklen_t controlLength);
+
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * Arm the multishot receive on a socket. It stays armed until the kernel reports otherwise, in which case it is
+     * re-armed by pollReceives().
+     */
+    void armReceive(int socketFd);
+
+    /**
+     * Collect datagrams completed by the multishot receive. The buffers returned remain valid until the next call,
+     * which returns them to the kernel.
+     *
+     * @param received array to fill.
+     * @param limit    length of the received array.
+     * @return number of datagrams received, 0 if none are available.
+     */
+    std::int32_t pollReceives(Received* received, std::int32_t limit);
+
+    /**
+     * Send messages on a socket with one sendmsg entry each, submitted and completed with a single io_uring_enter.
+     * Follows sendmmsg conventions: msg_len is set for each message sent and the count returned stops at the first
+     * message that failed, with -1 and errno set when that is the first.
+     *
+     * @return number of messages sent before the first failure or -1 if the first failed.
+     */
+    int sendMessages(int socketFd, mmsghdr* messages, std::int32_t messageCount);
+
+    /**
+     * True once the kernel has rejected the multishot receive, e.g. an older kernel that accepted the ring setup.
+     * Receives should then go back to the socket.
+     */
+    inline bool hasReceiveFailed() const
+    {
+        return 0 != m_receiveError;
+    }
+
+    inline int receiveError() const
+    {
+        return m_receiveError;
+    }
+
+    /**
+     * Number of io_uring_enter system calls made, for comparing against the socket path.
+     */
+    inline std::int64_t enterCount() const
+    {
+        return m_enterCount;
+    }
+
+private:
+    struct Completion
+    {
+        std::uint64_t userData;
+        std::int32_t result;
+        std::uint32_t flags;
+    };
+
+    int m_ringFd;
+    int m_receiveSocketFd;
+    int m_receiveError;
+    bool m_receiveArmed;
+    std::int64_t m_enterCount;
+
+    void* m_sqRing;
+    std::size_t m_sqRingLength;
+    void* m_cqRing;
+    std::size_t m_cqRingLength;
+    void* m_sqes;
+    std::size_t m_sqesLength;
+
+    std::uint32_t* m_sqHead;
+    std::uint32_t* m_sqTail;
+    std::uint32_t m_sqMask;
+    std::uint32_t m_sqEntries;
+    std::uint32_t* m_sqArray;
+    std::uint32_t* m_cqHead;
+    std::uint32_t* m_cqTail;
+    std::uint32_t m_cqMask;
+    void* m_cqes;
+
+    std::uint8_t* m_buffers;
+    std::size_t m_buffersLength;
+    const std::uint32_t m_bufferCount;
+    const std::uint32_t m_bufferLength;
+
+    const std::int32_t m_receiveBufferLength;
+    const socklen_t m_nameLength;
+    const socklen_t m_controlLength;
+    msghdr m_receiveHeader;
+
+    std::vector<std::uint16_t> m_buffersHeld;
+    std::vector<std::uint16_t> m_buffersToProvide;
+    std::vector<Completion> m_pendingReceives;
+
+    void* nextSqe();
+    int enter(std::uint32_t toSubmit, std::uint32_t minComplete, std::uint32_t flags);
+    std::uint32_t queueReceive();
+    std::uint32_t queueProvideBuffers();
+    void submit(std::uint32_t toSubmit);
+    void cancelReceive();
+    bool onReceiveCompletion(const Completion& completion, Received& received);
+    void release();
+};
+
+}}}
+
+#endif
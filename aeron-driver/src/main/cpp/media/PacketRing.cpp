@@ -0,0 +1,220 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <net/if.h>
+#include <sys/mman.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#endif
+
+#include "aeron/util/Exceptions.h"
+#include "aeron/util/StringUtil.h"
+
+#include "PacketRing.h"
+
+using namespace aeron::driver::media;
+
+const std::uint32_t PacketRing::DEFAULT_BLOCK_LENGTH;
+const std::uint32_t PacketRing::DEFAULT_BLOCK_COUNT;
+const std::uint32_t PacketRing::DEFAULT_RETIRE_TIMEOUT_MS;
+
+#if defined(__linux__)
+
+static const std::uint32_t FRAME_LENGTH = 2048;
+static const std::uint32_t SNAP_LENGTH = 65535;
+static const std::uint32_t MAX_FILTER_INSTRUCTIONS = 4096;
+
+static void attachFilter(int fd, std::vector<sock_filter>& program)
+{
+    sock_fprog filter;
+    filter.len = (unsigned short) program.size();
+    filter.filter = program.data();
+
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) < 0)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to attach packet filter: %s", strerror(errno)), SOURCEINFO};
+    }
+}
+
+PacketRing::PacketRing(
+    const char* interfaceName, std::uint32_t blockLength, std::uint32_t blockCount, std::uint32_t retireTimeoutMs)
+    : m_blockLength(blockLength), m_blockCount(blockCount)
+{
+    const unsigned int interfaceIndex = if_nametoindex(interfaceName);
+    if (0 == interfaceIndex)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Unknown interface %s: %s", interfaceName, strerror(errno)), SOURCEINFO};
+    }
+
+    m_fd = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_ALL));
+    if (m_fd < 0)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to open packet socket: %s", strerror(errno)), SOURCEINFO};
+    }
+
+    try
+    {
+        // accept nothing until the ports are known
+        filterPorts(std::vector<std::uint16_t>());
+
+        int version = TPACKET_V3;
+        if (setsockopt(m_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0)
+        {
+            throw aeron::util::IOException{
+                aeron::util::strPrintf("Failed to select TPACKET_V3: %s", strerror(errno)), SOURCEINFO};
+        }
+
+        tpacket_req3 request;
+        memset(&request, 0, sizeof(request));
+        request.tp_block_size = blockLength;
+        request.tp_block_nr = blockCount;
+        request.tp_frame_size = FRAME_LENGTH;
+        request.tp_frame_nr = (blockLength / FRAME_LENGTH) * blockCount;
+        request.tp_retire_blk_tov = retireTimeoutMs;
+
+        if (setsockopt(m_fd, SOL_PACKET, PACKET_RX_RING, &request, sizeof(request)) < 0)
+        {
+            throw aeron::util::IOException{
+                aeron::util::strPrintf("Failed to set up packet ring: %s", strerror(errno)), SOURCEINFO};
+        }
+
+        m_ringLength = (std::size_t) blockLength * blockCount;
+        void* ring = mmap(nullptr, m_ringLength, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, 0);
+        if (MAP_FAILED == ring)
+        {
+            m_ringLength = 0;
+            throw aeron::util::IOException{
+                aeron::util::strPrintf("Failed to map packet ring: %s", strerror(errno)), SOURCEINFO};
+        }
+
+        m_ring = static_cast<std::uint8_t*>(ring);
+
+        sockaddr_ll address;
+        memset(&address, 0, sizeof(address));
+        address.sll_family = AF_PACKET;
+        address.sll_protocol = htons(ETH_P_ALL);
+        address.sll_ifindex = (int) interfaceIndex;
+
+        if (bind(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+        {
+            throw aeron::util::IOException{
+                aeron::util::strPrintf("Failed to bind packet socket to %s: %s", interfaceName, strerror(errno)),
+                SOURCEINFO};
+        }
+    }
+    catch (aeron::util::IOException&)
+    {
+        release();
+        throw;
+    }
+}
+
+PacketRing::~PacketRing()
+{
+    release();
+}
+
+void PacketRing::release()
+{
+    if (nullptr != m_ring)
+    {
+        munmap(m_ring, m_ringLength);
+        m_ring = nullptr;
+    }
+
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void PacketRing::filterPorts(const std::vector<std::uint16_t>& ports)
+{
+    // offsets are from the network header as the socket is SOCK_DGRAM, jumps are kept short so the number of ports is
+    // only limited by the maximum program length
+    static const std::uint8_t V4_BLOCK_LENGTH = 9;
+    static const std::uint8_t V6_BLOCK_LENGTH = 6;
+
+    std::vector<sock_filter> program;
+
+    if (7 + V4_BLOCK_LENGTH + V6_BLOCK_LENGTH + (2 * ports.size()) > MAX_FILTER_INSTRUCTIONS)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Too many ports to filter: %d", (int) ports.size()), SOURCEINFO};
+    }
+
+    program.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0));
+    program.push_back(BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 4));
+    program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 4, 0, V4_BLOCK_LENGTH));
+
+    program.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9));
+    program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 1, 0));
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+    program.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 6));
+    program.push_back(BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x1FFF, 0, 1));
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+    program.push_back(BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0));
+    program.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2));
+    program.push_back(BPF_STMT(BPF_JMP | BPF_JA, V6_BLOCK_LENGTH));
+
+    program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 6, 1, 0));
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+    program.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 6));
+    program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 1, 0));
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+    program.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 42));
+
+    for (std::uint16_t port : ports)
+    {
+        program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, port, 0, 1));
+        program.push_back(BPF_STMT(BPF_RET | BPF_K, SNAP_LENGTH));
+    }
+
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+
+    attachFilter(m_fd, program);
+}
+
+#else
+
+PacketRing::PacketRing(
+    const char* interfaceName, std::uint32_t blockLength, std::uint32_t blockCount, std::uint32_t retireTimeoutMs)
+    : m_blockLength(blockLength), m_blockCount(blockCount)
+{
+    throw aeron::util::IOException{"Packet rings are only supported on Linux", SOURCEINFO};
+}
+
+PacketRing::~PacketRing()
+{
+}
+
+void PacketRing::release()
+{
+}
+
+void PacketRing::filterPorts(const std::vector<std::uint16_t>& ports)
+{
+}
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_MEDIA_PACKETRING__
+#define INCLUDED_AERON_DRIVER_MEDIA_PACKETRING__
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#if defined(__linux__)
+#include <linux/if_packet.h>
+#endif
+
+namespace aeron { namespace driver { namespace media {
+
+/**
+ * An AF_PACKET TPACKET_V3 receive ring bound to one network interface, filtered in the kernel to UDP datagrams for a
+ * set of destination ports.
+ *
+ * The kernel fills blocks of the ring with every matching datagram seen on the interface and hands a block over once it
+ * is full or its retire timeout expires, so a whole block of datagrams is read with no system calls at all. The cost is
+ * latency: a datagram is only visible once its block is retired, which under light load is the retire timeout.
+ *
+ * Datagrams are taken as they cross the interface, before the UDP socket layer, so checksums are not verified and the
+ * sockets bound to the ports still receive their own copy.
+ *
+ * Needs CAP_NET_RAW, construction throws an IOException when the ring can not be set up so the caller can stay with
+ * socket receives.
+ */
+class PacketRing
+{
+public:
+    static const std::uint32_t DEFAULT_BLOCK_LENGTH = 1 << 20;
+    static const std::uint32_t DEFAULT_BLOCK_COUNT = 16;
+    static const std::uint32_t DEFAULT_RETIRE_TIMEOUT_MS = 1;
+
+    /**
+     * @param interfaceName   to bind to, e.g. "lo" or one end of a veth pair.
+     * @param blockLength     length of each block, a multiple of the page size.
+     * @param blockCount      number of blocks in the ring.
+     * @param retireTimeoutMs after which the kernel hands over a block that is not full.
+     */
+    PacketRing(
+        const char* interfaceName,
+        std::uint32_t blockLength = DEFAULT_BLOCK_LENGTH,
+        std::uint32_t blockCount = DEFAULT_BLOCK_COUNT,
+        std::uint32_t retireTimeoutMs = DEFAULT_RETIRE_TIMEOUT_MS);
+
+    ~PacketRing();
+
+    PacketRing(const PacketRing&) = delete;
+    PacketRing& operator=(const PacketRing&) = delete;
+
+    /**
+     * Replace the kernel filter with one that accepts IPv4 and IPv6 UDP datagrams to any of the ports, an empty list
+     * accepts nothing.
+     */
+    void filterPorts(const std::vector<std::uint16_t>& ports);
+
+    /**
+     * Hand the datagrams in the blocks retired by the kernel to a handler and give the blocks back.
+     *
+     * @param handler    called as handler(payload, length, sourceAddress, destinationPort) for each datagram, the
+     *                   payload and source address are only valid for the duration of the call.
+     * @param blockLimit maximum number of blocks to process.
+     * @return number of datagrams handled.
+     */
+    template <typename H>
+    inline std::int32_t poll(H&& handler, std::int32_t blockLimit)
+    {
+        std::int32_t datagrams = 0;
+
+#if defined(__linux__)
+        for (std::int32_t i = 0; i < blockLimit; i++)
+        {
+            tpacket_block_desc* block = reinterpret_cast<tpacket_block_desc*>(m_ring + (m_blockIndex * m_blockLength));
+            if (0 == (__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER))
+            {
+                break;
+            }
+
+            const std::uint32_t packetCount = block->hdr.bh1.num_pkts;
+            std::uint8_t* packet = reinterpret_cast<std::uint8_t*>(block) + block->hdr.bh1.offset_to_first_pkt;
+
+            for (std::uint32_t p = 0; p < packetCount; p++)
+            {
+                const tpacket3_hdr* header = reinterpret_cast<const tpacket3_hdr*>(packet);
+                const sockaddr_ll* link = reinterpret_cast<const sockaddr_ll*>(
+                    packet + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+
+                if (PACKET_OUTGOING != link->sll_pkttype && onPacket(packet + header->tp_net, header->tp_snaplen, handler))
+                {
+                    datagrams++;
+                }
+
+                packet += header->tp_next_offset;
+            }
+
+            __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            m_blockIndex = (m_blockIndex + 1) % m_blockCount;
+        }
+#endif
+
+        return datagrams;
+    }
+
+    inline int fd() const
+    {
+        return m_fd;
+    }
+
+private:
+    int m_fd = -1;
+    std::uint8_t* m_ring = nullptr;
+    std::size_t m_ringLength = 0;
+    const std::uint32_t m_blockLength;
+    const std::uint32_t m_blockCount;
+    std::uint32_t m_blockIndex = 0;
+
+    union SourceAddress
+    {
+        sockaddr_in v4;
+        sockaddr_in6 v6;
+    };
+
+    template <typename H>
+    static inline bool onPacket(const std::uint8_t* ip, std::uint32_t length, H& handler)
+    {
+        static const std::uint32_t UDP_HEADER_LENGTH = 8;
+        SourceAddress source;
+        std::uint32_t ipHeaderLength;
+
+        if (length < 1)
+        {
+            return false;
+        }
+
+        const std::uint8_t version = ip[0] >> 4;
+        if (4 == version && length >= 20)
+        {
+            ipHeaderLength = (ip[0] & 0x0F) * 4u;
+            memset(&source.v4, 0, sizeof(source.v4));
+            source.v4.sin_family = AF_INET;
+            memcpy(&source.v4.sin_addr, ip + 12, 4);
+        }
+        else if (6 == version && length >= 40)
+        {
+            ipHeaderLength = 40;
+            memset(&source.v6, 0, sizeof(source.v6));
+            source.v6.sin6_family = AF_INET6;
+            memcpy(&source.v6.sin6_addr, ip + 8, 16);
+        }
+        else
+        {
+            return false;
+        }
+
+        if (length < ipHeaderLength + UDP_HEADER_LENGTH)
+        {
+            return false;
+        }
+
+        const std::uint8_t* udp = ip + ipHeaderLength;
+        const std::uint16_t sourcePort = (std::uint16_t) ((udp[0] << 8) | udp[1]);
+        const std::uint16_t destinationPort = (std::uint16_t) ((udp[2] << 8) | udp[3]);
+        const std::uint32_t udpLength = (std::uint32_t) ((udp[4] << 8) | udp[5]);
+
+        if (udpLength < UDP_HEADER_LENGTH || ipHeaderLength + udpLength > length)
+        {
+            return false;
+        }
+
+        if (AF_INET == source.v4.sin_family)
+        {
+            source.v4.sin_port = htons(sourcePort);
+        }
+        else
+        {
+            source.v6.sin6_port = htons(sourcePort);
+        }
+
+        handler(
+            udp + UDP_HEADER_LENGTH,
+            (std::int32_t) (udpLength - UDP_HEADER_LENGTH),
+            reinterpret_cast<const sockaddr*>(&source),
+            destinationPort);
+
+        return true;
+    }
+
+    void release();
+};
+
+}}}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
+#include "aeron/util/Exceptions.h"
+#include "aeron/util/StringUtil.h"
+
+#include "PacketRingTransportPoller.h"
+
+using namespace aeron::driver::media;
+
+const std::int32_t PacketRingTransportPoller::BLOCK_LIMIT;
+
+PacketRingTransportPoller::PacketRingTransportPoller(
+    const char* interfaceName, std::uint32_t blockLength, std::uint32_t blockCount, std::uint32_t retireTimeoutMs)
+    : m_ring(interfaceName, blockLength, blockCount, retireTimeoutMs),
+      m_sourceV4(InetAddress::any(AF_INET)),
+      m_sourceV6(InetAddress::any(AF_INET6))
+{
+}
+
+void PacketRingTransportPoller::registerForRead(ReceiveChannelEndpoint& endpoint)
+{
+    const std::uint16_t port = endpoint.udpChannel().remoteData().port();
+
+    if (m_transportsByPort.find(port) != m_transportsByPort.end())
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Port %d is already registered with the packet ring", (int) port), SOURCEINFO};
+    }
+
+#if defined(__linux__)
+    sock_filter dropAll = BPF_STMT(BPF_RET | BPF_K, 0);
+    sock_fprog filter;
+    filter.len = 1;
+    filter.filter = &dropAll;
+
+    if (setsockopt(endpoint.receiveSocketFd(), SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) < 0)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to attach filter to endpoint socket: %s", strerror(errno)), SOURCEINFO};
+    }
+#endif
+
+    m_transportsByPort[port] = &endpoint;
+
+    try
+    {
+        refilter();
+    }
+    catch (aeron::util::IOException&)
+    {
+        cancelRead(endpoint);
+        throw;
+    }
+}
+
+void PacketRingTransportPoller::cancelRead(ReceiveChannelEndpoint& endpoint)
+{
+    auto transport = m_transportsByPort.find(endpoint.udpChannel().remoteData().port());
+    if (transport == m_transportsByPort.end() || transport->second != &endpoint)
+    {
+        return;
+    }
+
+    m_transportsByPort.erase(transport);
+
+#if defined(__linux__)
+    int unused = 0;
+    setsockopt(endpoint.receiveSocketFd(), SOL_SOCKET, SO_DETACH_FILTER, &unused, sizeof(unused));
+#endif
+
+    refilter();
+}
+
+void PacketRingTransportPoller::refilter()
+{
+    std::vector<std::uint16_t> ports;
+    ports.reserve(m_transportsByPort.size());
+
+    for (auto& transport : m_transportsByPort)
+    {
+        ports.push_back(transport.first);
+    }
+
+    m_ring.filterPorts(ports);
+}
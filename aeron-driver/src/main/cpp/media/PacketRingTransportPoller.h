@@ -0,0 +1,106 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INCLUDED_AERON_DRIVER_MEDIA_PACKETRINGTRANSPORTPOLLER__
+#define INCLUDED_AERON_DRIVER_MEDIA_PACKETRINGTRANSPORTPOLLER__
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "aeron/concurrent/AtomicBuffer.h"
+
+#include "PacketRing.h"
+#include "ReceiveChannelEndpoint.h"
+
+namespace aeron { namespace driver { namespace media {
+
+/**
+ * Receives the datagrams for a set of ReceiveChannelEndpoints from a PacketRing on one interface rather than from their
+ * sockets, and hands them to the endpoint bound to their destination port.
+ *
+ * The endpoint sockets stay open to hold their ports but have a filter attached that drops everything while they are
+ * registered, so datagrams are not queued twice.
+ */
+class PacketRingTransportPoller
+{
+public:
+    static const std::int32_t BLOCK_LIMIT = 4;
+
+    PacketRingTransportPoller(
+        const char* interfaceName,
+        std::uint32_t blockLength = PacketRing::DEFAULT_BLOCK_LENGTH,
+        std::uint32_t blockCount = PacketRing::DEFAULT_BLOCK_COUNT,
+        std::uint32_t retireTimeoutMs = PacketRing::DEFAULT_RETIRE_TIMEOUT_MS);
+
+    PacketRingTransportPoller(const PacketRingTransportPoller&) = delete;
+    PacketRingTransportPoller& operator=(const PacketRingTransportPoller&) = delete;
+
+    /**
+     * Start receiving for an endpoint, which must already have its channel open.
+     */
+    void registerForRead(ReceiveChannelEndpoint& endpoint);
+
+    /**
+     * Stop receiving for an endpoint and give its socket back its datagrams.
+     */
+    void cancelRead(ReceiveChannelEndpoint& endpoint);
+
+    inline std::size_t transportCount() const
+    {
+        return m_transportsByPort.size();
+    }
+
+    /**
+     * Dispatch the datagrams in the blocks retired since the last poll.
+     *
+     * @return number of bytes received.
+     */
+    inline std::int32_t pollTransports()
+    {
+        std::int32_t bytesReceived = 0;
+
+        m_ring.poll(
+            [&](const std::uint8_t* payload, std::int32_t length, const sockaddr* source, std::uint16_t port)
+            {
+                auto transport = m_transportsByPort.find(port);
+                if (transport != m_transportsByPort.end())
+                {
+                    InetAddress& address = AF_INET == source->sa_family ? *m_sourceV4 : *m_sourceV6;
+                    memcpy(address.address(), source, address.length());
+
+                    aeron::concurrent::AtomicBuffer buffer{
+                        const_cast<std::uint8_t*>(payload), static_cast<util::index_t>(length)};
+                    bytesReceived += transport->second->onDatagram(buffer, length, address);
+                }
+            },
+            BLOCK_LIMIT);
+
+        return bytesReceived;
+    }
+
+private:
+    PacketRing m_ring;
+    std::unordered_map<std::uint16_t, ReceiveChannelEndpoint*> m_transportsByPort;
+    std::unique_ptr<InetAddress> m_sourceV4;
+    std::unique_ptr<InetAddress> m_sourceV6;
+
+    void refilter();
+};
+
+}}}
+
+#endif
@@ -19,21 +19,231 @@
 #include "aeron/concurrent/logbuffer/FrameDescriptor.h"
 
 #include "ReceiveChannelEndpoint.h"
+#include "../DataPacketDispatcher.h"
 
 using namespace aeron::driver::media;
 
 std::int32_t ReceiveChannelEndpoint::dispatch(
-    concurrent::AtomicBuffer &buffer, std::int32_t length, InetAddress& address)
+    aeron::concurrent::AtomicBuffer &buffer, std::int32_t length, InetAddress& address)
 {
     std::int32_t bytesReceived = 0;
-    switch (concurrent::logbuffer::FrameDescriptor::frameType(buffer, 0))
+
+    if (nullptr == m_dispatcher)
     {
-        case concurrent::logbuffer::DataFrameHeader::HDR_TYPE_PAD:
-        case concurrent::logbuffer::DataFrameHeader::HDR_TYPE_DATA:
+        return bytesReceived;
+    }
+
+    switch (aeron::concurrent::logbuffer::FrameDescriptor::frameType(buffer, 0))
+    {
+        case aeron::concurrent::logbuffer::DataFrameHeader::HDR_TYPE_PAD:
+        case aeron::concurrent::logbuffer::DataFrameHeader::HDR_TYPE_DATA:
+        {
+            protocol::DataHeaderFlyweight header{buffer, 0};
+            bytesReceived = m_dispatcher->onDataPacket(*this, header, buffer, length, address);
+            break;
+        }
+
+        case aeron::concurrent::logbuffer::DataFrameHeader::HDR_TYPE_SETUP:
+        {
+            protocol::SetupFlyweight header{buffer, 0};
+            m_dispatcher->onSetupMessage(*this, header, buffer, address);
+            break;
+        }
+
+        case protocol::HeaderFlyweight::HDR_TYPE_RTTM:
+        {
+            if (length >= protocol::RttMeasurementFlyweight::headerLength())
+            {
+                protocol::RttMeasurementFlyweight header{buffer, 0};
+                m_dispatcher->onRttMeasurement(*this, header, address);
+            }
             break;
-            // dispatch
-        case concurrent::logbuffer::DataFrameHeader::HDR_TYPE_SETUP:
+        }
+    }
+
+    return bytesReceived;
+}
+
+void ReceiveChannelEndpoint::removePendingSetup(std::int32_t sessionId, std::int32_t streamId)
+{
+    if (nullptr != m_dispatcher)
+    {
+        m_dispatcher->removePendingSetup(sessionId, streamId);
+    }
+}
+
+void ReceiveChannelEndpoint::sendNakMessage(
+    InetAddress& address,
+    std::int32_t sessionId,
+    std::int32_t streamId,
+    std::int32_t termId,
+    std::int32_t termOffset,
+    std::int32_t length)
+{
+    m_nakFlyweight
+        .sessionId(sessionId)
+        .streamId(streamId)
+        .termId(termId)
+        .termOffset(termOffset)
+        .length(length)
+        .version(aeron::concurrent::logbuffer::DataFrameHeader::CURRENT_VERSION)
+        .flags(0)
+        .type(protocol::HeaderFlyweight::HDR_TYPE_NAK)
+        .frameLength(protocol::NakFlyweight::headerLength());
+
+    sendTo(m_nakBuffer.buffer(), m_nakBuffer.capacity(), address);
+}
+
+void ReceiveChannelEndpoint::sendRttMeasurement(
+    InetAddress& address, std::int32_t sessionId, std::int32_t streamId, std::int64_t echoTimestampNs)
+{
+    m_rttMeasurementFlyweight
+        .sessionId(sessionId)
+        .streamId(streamId)
+        .echoTimestampNs(echoTimestampNs)
+        .receptionDelta(0)
+        .version(aeron::concurrent::logbuffer::DataFrameHeader::CURRENT_VERSION)
+        .flags(0)
+        .type(protocol::HeaderFlyweight::HDR_TYPE_RTTM)
+        .frameLength(protocol::RttMeasurementFlyweight::headerLength());
+
+    sendTo(m_rttMeasurementBuffer.buffer(), m_rttMeasurementBuffer.capacity(), address);
+}
+
+void ReceiveChannelEndpoint::queueStatusMessage(
+    InetAddress& address,
+    std::int32_t sessionId,
+    std::int32_t streamId,
+    std::int32_t termId,
+    std::int32_t termOffset,
+    std::int32_t receiverWindow)
+{
+    if (m_pendingStatusMessageCount >= sendBatchSize())
+    {
+        sendPendingStatusMessages();
+    }
+
+    const std::int32_t length = protocol::StatusMessageFlyweight::headerLength();
+    aeron::concurrent::AtomicBuffer buffer{&m_pendingStatusMessageBytes[m_pendingStatusMessageCount * length], length};
+    protocol::StatusMessageFlyweight statusMessage{buffer, 0};
+
+    statusMessage
+        .sessionId(sessionId)
+        .streamId(streamId)
+        .consumptionTermId(termId)
+        .consumptionTermOffset(termOffset)
+        .receiverWindow(receiverWindow)
+        .version(aeron::concurrent::logbuffer::DataFrameHeader::CURRENT_VERSION)
+        .flags(0)
+        .type(protocol::HeaderFlyweight::HDR_TYPE_SM)
+        .frameLength(length);
+
+    queueSend(buffer.buffer(), length, &address);
+    m_pendingStatusMessageCount++;
+}
+
+std::int32_t ReceiveChannelEndpoint::sendPendingStatusMessages()
+{
+    const std::int32_t pendingCount = m_pendingStatusMessageCount;
+    if (0 == pendingCount)
+    {
+        return 0;
+    }
+
+    m_pendingStatusMessageCount = 0;
+
+    std::int32_t shortSends = 0;
+    sendQueued(&shortSends);
+
+    if (nullptr != m_statusMessagesSent)
+    {
+        m_statusMessagesSent->addOrdered(pendingCount - shortSends);
+    }
+
+    if (shortSends > 0 && nullptr != m_statusMessageShortSends)
+    {
+        m_statusMessageShortSends->addOrdered(shortSends);
+    }
+
+    return pendingCount - shortSends;
+}
+
+std::int32_t ReceiveChannelEndpoint::prepareReceiveTargets()
+{
+    m_directReceiveImage =
+        (nullptr != m_dispatcher && supportsReceiveTargets()) ? m_dispatcher->directReceiveImage() : nullptr;
+
+    if (nullptr == m_directReceiveImage)
+    {
+        return 0;
+    }
+
+    std::int32_t targetCount = 0;
+    for (; targetCount < receiveBatchSize(); targetCount++)
+    {
+        std::uint8_t* address = nullptr;
+        std::int32_t length = 0;
+
+        if (!m_directReceiveImage->receiveTarget(
+            targetCount, m_receiveTargetTermIds[targetCount], m_receiveTargetTermOffsets[targetCount], address, length))
+        {
             break;
+        }
+
+        receiveTarget(targetCount, address, length);
+    }
+
+    return targetCount;
+}
+
+bool ReceiveChannelEndpoint::isReceivedInPlace(std::int32_t index)
+{
+    const std::int32_t length = receiveLength(index);
+    const std::int32_t firstFrameLength = receiveBuffer(index).getInt32(0);
+
+    if (length > receivedTargetLength(index) || firstFrameLength < 0 || firstFrameLength > length)
+    {
+        return false;
+    }
+
+    aeron::concurrent::AtomicBuffer frame{receivedTarget(index), length};
+    if (!isValidFrame(frame, length))
+    {
+        return false;
+    }
+
+    const std::uint16_t type = aeron::concurrent::logbuffer::FrameDescriptor::frameType(frame, 0);
+    protocol::DataHeaderFlyweight header{frame, 0};
+
+    return
+        (aeron::concurrent::logbuffer::DataFrameHeader::HDR_TYPE_DATA == type ||
+            aeron::concurrent::logbuffer::DataFrameHeader::HDR_TYPE_PAD == type) &&
+        header.sessionId() == m_directReceiveImage->sessionId() &&
+        header.streamId() == m_directReceiveImage->streamId() &&
+        header.termId() == m_receiveTargetTermIds[index] &&
+        header.termOffset() == m_receiveTargetTermOffsets[index];
+}
+
+std::int32_t ReceiveChannelEndpoint::completeReceiveTargets(std::int32_t messagesReceived)
+{
+    std::int32_t bytesReceived = 0;
+
+    // move every datagram that landed in the wrong place out of the term before any of them are inserted properly
+    for (std::int32_t i = 0; i < messagesReceived; i++)
+    {
+        if (nullptr != receivedTarget(i) && !isReceivedInPlace(i))
+        {
+            unscatterReceive(i);
+        }
+    }
+
+    for (std::int32_t i = 0; i < messagesReceived; i++)
+    {
+        if (nullptr != receivedTarget(i))
+        {
+            bytesReceived += m_directReceiveImage->insertPacketInPlace(
+                m_receiveTargetTermIds[i], m_receiveTargetTermOffsets[i], receiveBuffer(i).getInt32(0), receiveLength(i));
+        }
     }
 
     return bytesReceived;
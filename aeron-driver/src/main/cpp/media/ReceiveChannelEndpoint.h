@@ -20,66 +20,191 @@
 #include "aeron/protocol/DataHeaderFlyweight.h"
 #include "aeron/protocol/HeaderFlyweight.h"
 #include "aeron/protocol/NakFlyweight.h"
+#include "aeron/protocol/RttMeasurementFlyweight.h"
 #include "aeron/protocol/SetupFlyweight.h"
 #include "aeron/protocol/StatusMessageFlyweight.h"
+#include "aeron/concurrent/AtomicCounter.h"
 #include "aeron/util/MacroUtil.h"
 
 #include "UdpChannelTransport.h"
 
+namespace aeron { namespace driver {
+
+class DataPacketDispatcher;
+class PublicationImage;
+
+}}
+
 namespace aeron { namespace driver { namespace media {
 
 class ReceiveChannelEndpoint : public UdpChannelTransport
 {
 public:
-    inline ReceiveChannelEndpoint(std::unique_ptr<UdpChannel>&& channel)
-        : UdpChannelTransport(channel, &channel->remoteData(), &channel->remoteData(), nullptr),
+    inline ReceiveChannelEndpoint(
+        std::unique_ptr<UdpChannel>&& channel,
+        std::shared_ptr<DataPacketDispatcher> dispatcher = nullptr,
+        std::int32_t receiveBatchSize = DEFAULT_RECEIVE_BATCH_SIZE,
+        AtomicCounter* statusMessagesSent = nullptr,
+        AtomicCounter* statusMessageShortSends = nullptr)
+        : UdpChannelTransport(channel, &channel->remoteData(), &channel->remoteData(), nullptr, receiveBatchSize),
+          m_dispatcher(std::move(dispatcher)),
           m_smBuffer(m_smBufferBytes, protocol::StatusMessageFlyweight::headerLength()),
           m_nakBuffer(m_nakBufferBytes, protocol::NakFlyweight::headerLength()),
-          m_dataHeaderFlyweight(receiveBuffer(), 0),
-          m_setupFlyweight(receiveBuffer(), 0),
+          m_rttMeasurementBuffer(m_rttMeasurementBufferBytes, protocol::RttMeasurementFlyweight::headerLength()),
           m_smFlyweight(m_smBuffer, 0),
-          m_nakFlyweight(m_nakBuffer, 0)
+          m_nakFlyweight(m_nakBuffer, 0),
+          m_rttMeasurementFlyweight(m_rttMeasurementBuffer, 0),
+          m_statusMessagesSent(statusMessagesSent),
+          m_statusMessageShortSends(statusMessageShortSends),
+          m_pendingStatusMessageBytes((size_t) (sendBatchSize() * protocol::StatusMessageFlyweight::headerLength()), 0)
     {
         m_smBuffer.setMemory(0, m_smBuffer.capacity(), 0);
         m_nakBuffer.setMemory(0, m_nakBuffer.capacity(), 0);
+        m_rttMeasurementBuffer.setMemory(0, m_rttMeasurementBuffer.capacity(), 0);
+        m_receiveTargetTermIds.resize((size_t) this->receiveBatchSize());
+        m_receiveTargetTermOffsets.resize((size_t) this->receiveBatchSize());
     }
 
     inline COND_MOCK_VIRTUAL std::int32_t pollForData()
     {
-        std::int32_t bytesReceived = 0;
-        std::int32_t bytesRead = 0;
+        const std::int32_t targetCount = prepareReceiveTargets();
+        const std::int32_t messagesReceived = receiveBatch();
+        std::int32_t bytesReceived =
+            0 == targetCount ? 0 : completeReceiveTargets(std::min(targetCount, messagesReceived));
 
-        InetAddress* srcAddress = receive(&bytesReceived);
-
-        if (nullptr != srcAddress)
+        for (std::int32_t i = 0; i < messagesReceived; i++)
         {
-            if (isValidFrame(receiveBuffer(), bytesRead))
+            if (i < targetCount && nullptr != receivedTarget(i))
             {
-                bytesReceived = dispatch(receiveBuffer(), bytesRead, *srcAddress);
+                continue;
+            }
+
+            AtomicBuffer& buffer = receiveBuffer(i);
+            const std::int32_t length = receiveLength(i);
+            const std::int32_t segmentLength = receiveSegmentLength(i);
+
+            if (segmentLength == length)
+            {
+                bytesReceived += onDatagram(buffer, length, receiveAddress(i));
+            }
+            else
+            {
+                for (std::int32_t offset = 0; offset < length; offset += segmentLength)
+                {
+                    const std::int32_t datagramLength = std::min(segmentLength, length - offset);
+                    AtomicBuffer datagram{buffer.buffer() + offset, datagramLength};
+
+                    bytesReceived += onDatagram(datagram, datagramLength, receiveAddress(i));
+                }
             }
         }
 
         return bytesReceived;
     }
 
+    /**
+     * Dispatch a datagram received for this endpoint by other means than its own socket, e.g. from a PacketRing.
+     *
+     * @return number of bytes of data received.
+     */
+    inline std::int32_t onDatagram(aeron::concurrent::AtomicBuffer& buffer, std::int32_t length, InetAddress& address)
+    {
+        return isValidFrame(buffer, length) ? dispatch(buffer, length, address) : 0;
+    }
+
+    /**
+     * Allow a setup to be elicited again for a session whose pending setup message timed out.
+     */
+    void removePendingSetup(std::int32_t sessionId, std::int32_t streamId);
 
     inline COND_MOCK_VIRTUAL void sendSetupElicitingStatusMessage(
         InetAddress& address, std::int32_t sessionId, std::int32_t streamId)
     {}
 
+    /**
+     * Ask the source of an image to retransmit a range of a term.
+     */
+    COND_MOCK_VIRTUAL void sendNakMessage(
+        InetAddress& address,
+        std::int32_t sessionId,
+        std::int32_t streamId,
+        std::int32_t termId,
+        std::int32_t termOffset,
+        std::int32_t length);
+
+    /**
+     * Send a probe to the source of an image for it to echo back, so the round trip time can be measured.
+     *
+     * @param address         of the source of the image.
+     * @param sessionId       of the image.
+     * @param streamId        of the image.
+     * @param echoTimestampNs time the probe is sent at, to be echoed back.
+     */
+    COND_MOCK_VIRTUAL void sendRttMeasurement(
+        InetAddress& address, std::int32_t sessionId, std::int32_t streamId, std::int64_t echoTimestampNs);
+
+    /**
+     * Queue a status message for an image of this endpoint, to be sent along with those for its other images in one
+     * batch by sendPendingStatusMessages(). The batch is sent first if it is already full. The address is not copied so
+     * it must remain valid until the batch is sent.
+     *
+     * @param address          of the source of the image to send the status message to.
+     * @param sessionId        of the image.
+     * @param streamId         of the image.
+     * @param termId           the subscribers have consumed up to.
+     * @param termOffset       the subscribers have consumed up to.
+     * @param receiverWindow   the source may send beyond the consumption position.
+     */
+    COND_MOCK_VIRTUAL void queueStatusMessage(
+        InetAddress& address,
+        std::int32_t sessionId,
+        std::int32_t streamId,
+        std::int32_t termId,
+        std::int32_t termOffset,
+        std::int32_t receiverWindow);
+
+    /**
+     * Send the status messages queued by the images of this endpoint in one batch, counting them against the
+     * STATUS_MESSAGES_SENT system counter and any that were not sent in full against STATUS_MESSAGE_SHORT_SENDS.
+     *
+     * @return number of status messages sent.
+     */
+    COND_MOCK_VIRTUAL std::int32_t sendPendingStatusMessages();
+
+    inline std::int32_t pendingStatusMessageCount() const
+    {
+        return m_pendingStatusMessageCount;
+    }
+
 private:
+    std::shared_ptr<DataPacketDispatcher> m_dispatcher;
+
     std::uint8_t m_smBufferBytes[protocol::StatusMessageFlyweight::headerLength()];
     std::uint8_t m_nakBufferBytes[protocol::NakFlyweight::headerLength()];
+    std::uint8_t m_rttMeasurementBufferBytes[protocol::RttMeasurementFlyweight::headerLength()];
 
-    concurrent::AtomicBuffer m_smBuffer;
-    concurrent::AtomicBuffer m_nakBuffer;
+    aeron::concurrent::AtomicBuffer m_smBuffer;
+    aeron::concurrent::AtomicBuffer m_nakBuffer;
+    aeron::concurrent::AtomicBuffer m_rttMeasurementBuffer;
 
-    protocol::DataHeaderFlyweight m_dataHeaderFlyweight;
-    protocol::SetupFlyweight m_setupFlyweight;
     protocol::StatusMessageFlyweight m_smFlyweight;
     protocol::NakFlyweight m_nakFlyweight;
+    protocol::RttMeasurementFlyweight m_rttMeasurementFlyweight;
+
+    AtomicCounter* m_statusMessagesSent;
+    AtomicCounter* m_statusMessageShortSends;
+
+    std::vector<std::uint8_t> m_pendingStatusMessageBytes;
+    std::int32_t m_pendingStatusMessageCount = 0;
+
+    PublicationImage* m_directReceiveImage = nullptr;
+    std::vector<std::int32_t> m_receiveTargetTermIds;
+    std::vector<std::int32_t> m_receiveTargetTermOffsets;
 
-    std::int32_t dispatch(concurrent::AtomicBuffer &buffer, std::int32_t length, InetAddress& address);
+    std::int32_t dispatch(aeron::concurrent::AtomicBuffer &buffer, std::int32_t length, InetAddress& address);
+    std::int32_t prepareReceiveTargets();
+    bool isReceivedInPlace(std::int32_t index);
+    std::int32_t completeReceiveTargets(std::int32_t messagesReceived);
 };
 
 }}}
@@ -15,3 +15,187 @@
  */
 
 #include "SendChannelEndpoint.h"
+#include "../NetworkPublication.h"
+
+using namespace aeron::driver;
+using namespace aeron::driver::media;
+
+void SendChannelEndpoint::registerForSend(NetworkPublication& publication)
+{
+    m_publicationBySessionAndStreamId[sessionAndStreamKey(publication.sessionId(), publication.streamId())] =
+        &publication;
+}
+
+void SendChannelEndpoint::unregisterForSend(NetworkPublication& publication)
+{
+    auto it = m_publicationBySessionAndStreamId.find(
+        sessionAndStreamKey(publication.sessionId(), publication.streamId()));
+
+    if (it != m_publicationBySessionAndStreamId.end() && it->second == &publication)
+    {
+        m_publicationBySessionAndStreamId.erase(it);
+    }
+}
+
+std::int32_t SendChannelEndpoint::pollForControl()
+{
+    const std::int32_t messagesReceived = receiveBatch();
+    std::int32_t messagesDispatched = 0;
+
+    for (std::int32_t i = 0; i < messagesReceived; i++)
+    {
+        AtomicBuffer& buffer = receiveBuffer(i);
+        const std::int32_t length = receiveLength(i);
+        const std::int32_t segmentLength = receiveSegmentLength(i);
+
+        for (std::int32_t offset = 0; offset < length; offset += segmentLength)
+        {
+            const std::int32_t datagramLength = std::min(segmentLength, length - offset);
+            AtomicBuffer datagram{buffer.buffer() + offset, datagramLength};
+
+            if (isValidFrame(datagram, datagramLength))
+            {
+                messagesDispatched += dispatchControl(datagram, datagramLength, receiveAddress(i));
+            }
+        }
+    }
+
+    return messagesDispatched;
+}
+
+std::int32_t SendChannelEndpoint::dispatchControl(AtomicBuffer& buffer, std::int32_t length, InetAddress& address)
+{
+    switch (FrameDescriptor::frameType(buffer, 0))
+    {
+        case HeaderFlyweight::HDR_TYPE_SM:
+        {
+            if (length < StatusMessageFlyweight::headerLength())
+            {
+                return 0;
+            }
+
+            StatusMessageFlyweight statusMessage{buffer, 0};
+            NetworkPublication* publication = findPublication(statusMessage.sessionId(), statusMessage.streamId());
+            if (nullptr == publication)
+            {
+                return 0;
+            }
+
+            publication->onStatusMessage(statusMessage, address);
+            return 1;
+        }
+
+        case HeaderFlyweight::HDR_TYPE_NAK:
+        {
+            if (length < NakFlyweight::headerLength())
+            {
+                return 0;
+            }
+
+            NakFlyweight nak{buffer, 0};
+            NetworkPublication* publication = findPublication(nak.sessionId(), nak.streamId());
+            if (nullptr == publication)
+            {
+                return 0;
+            }
+
+            publication->onNak(nak.termId(), nak.termOffset(), nak.length());
+            return 1;
+        }
+
+        case HeaderFlyweight::HDR_TYPE_RTTM:
+        {
+            if (length < RttMeasurementFlyweight::headerLength())
+            {
+                return 0;
+            }
+
+            RttMeasurementFlyweight rttMeasurement{buffer, 0};
+            if (rttMeasurement.isReply() ||
+                nullptr == findPublication(rttMeasurement.sessionId(), rttMeasurement.streamId()))
+            {
+                return 0;
+            }
+
+            rttMeasurement
+                .receptionDelta(0)
+                .flags(RttMeasurementFlyweight::REPLY_FLAG);
+            sendTo(buffer.buffer(), RttMeasurementFlyweight::headerLength(), address);
+            return 1;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+NetworkPublication* SendChannelEndpoint::findPublication(std::int32_t sessionId, std::int32_t streamId)
+{
+    auto it = m_publicationBySessionAndStreamId.find(sessionAndStreamKey(sessionId, streamId));
+
+    return it == m_publicationBySessionAndStreamId.end() ? nullptr : it->second;
+}
+
+std::int32_t SendChannelEndpoint::sendFromTerm(
+    AtomicBuffer& termBuffer,
+    std::int32_t termOffset,
+    std::int32_t length,
+    std::int32_t mtuLength,
+    std::int32_t* bytesSent)
+{
+    if (queuedSendCount() > 0)
+    {
+        sendQueuedFrames();
+    }
+
+    std::int32_t regionCount = 0;
+    std::int32_t scanned = 0;
+
+    while (scanned < length && regionCount < sendBatchSize())
+    {
+        const std::int32_t offset = termOffset + scanned;
+        const std::int64_t scanOutcome = TermScanner::scanForAvailability(
+            termBuffer, offset, std::min(mtuLength, length - scanned));
+        const std::int32_t available = TermScanner::available(scanOutcome);
+
+        if (available <= 0)
+        {
+            break;
+        }
+
+        queueSend(termBuffer.buffer() + offset, available);
+
+        m_termRegionLengths[regionCount] = available;
+        m_termRegionPaddings[regionCount] = TermScanner::padding(scanOutcome);
+        scanned += available + m_termRegionPaddings[regionCount];
+        regionCount++;
+    }
+
+    if (nullptr != bytesSent)
+    {
+        *bytesSent = 0;
+    }
+
+    if (0 == regionCount)
+    {
+        return 0;
+    }
+
+    std::int32_t unaccounted = sendQueuedFrames(isZeroCopyEnabled());
+    std::int32_t sent = 0;
+    std::int32_t consumed = 0;
+
+    for (std::int32_t i = 0; i < regionCount && unaccounted >= m_termRegionLengths[i]; i++)
+    {
+        unaccounted -= m_termRegionLengths[i];
+        sent += m_termRegionLengths[i];
+        consumed += m_termRegionLengths[i] + m_termRegionPaddings[i];
+    }
+
+    if (nullptr != bytesSent)
+    {
+        *bytesSent = sent;
+    }
+
+    return consumed;
+}
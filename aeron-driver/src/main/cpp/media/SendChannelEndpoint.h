@@ -17,11 +17,23 @@
 #ifndef INCLUDED_AERON_DRIVER_MEDIA_SENDCHANNELENDPOINT__
 #define INCLUDED_AERON_DRIVER_MEDIA_SENDCHANNELENDPOINT__
 
+#include <unordered_map>
+
 #include "aeron/protocol/DataHeaderFlyweight.h"
+#include "aeron/protocol/NakFlyweight.h"
+#include "aeron/protocol/RttMeasurementFlyweight.h"
 #include "aeron/protocol/StatusMessageFlyweight.h"
+#include "aeron/concurrent/AtomicCounter.h"
+#include "aeron/concurrent/logbuffer/TermScanner.h"
 
 #include "UdpChannelTransport.h"
 
+namespace aeron { namespace driver {
+
+class NetworkPublication;
+
+}}
+
 namespace aeron { namespace driver { namespace media {
 
 using namespace aeron::protocol;
@@ -29,16 +41,99 @@ using namespace aeron::protocol;
 class SendChannelEndpoint : public UdpChannelTransport
 {
 public:
-    inline SendChannelEndpoint(std::unique_ptr<UdpChannel>&& channel)
+    inline SendChannelEndpoint(std::unique_ptr<UdpChannel>&& channel, AtomicCounter* shortSends = nullptr)
         : UdpChannelTransport(channel, &channel->remoteControl(), &channel->localControl(), &channel->remoteData()),
           m_dataHeaderFlyweight(receiveBuffer(), 0),
-          m_smFlyweight(receiveBuffer(), 0)
+          m_smFlyweight(receiveBuffer(), 0),
+          m_shortSends(shortSends),
+          m_termRegionLengths((size_t) sendBatchSize()),
+          m_termRegionPaddings((size_t) sendBatchSize())
+    {
+        segmentationOffload(udpChannel().isGso());
+        zeroCopy(udpChannel().isZeroCopy());
+    }
+
+    /**
+     * Route status messages and NAKs for the session and stream of a publication sent on this endpoint to it.
+     */
+    void registerForSend(NetworkPublication& publication);
+
+    void unregisterForSend(NetworkPublication& publication);
+
+    inline std::size_t registeredPublicationCount() const
+    {
+        return m_publicationBySessionAndStreamId.size();
+    }
+
+    /**
+     * Receive a batch of control messages sent back by receivers and dispatch status messages and NAKs to the
+     * registered publications they are for, called from the Sender duty cycle. RTT probes for a registered
+     * publication are echoed straight back to the receiver that sent them.
+     *
+     * @return number of control messages dispatched.
+     */
+    std::int32_t pollForControl();
+
+    /**
+     * Send the data frames queued with queueSend() in one batch, counting any that were not sent in full against
+     * the DATA_PACKET_SHORT_SENDS system counter.
+     *
+     * @param zeroCopy true to send with MSG_ZEROCOPY if enabled, only for frames in memory that is tracked until
+     *                 released, see sendFromTerm().
+     * @return number of bytes sent.
+     */
+    inline std::int32_t sendQueuedFrames(bool zeroCopy = false)
     {
+        std::int32_t shortSends = 0;
+        const std::int32_t bytesSent = sendQueued(&shortSends, zeroCopy);
+
+        if (shortSends > 0 && nullptr != m_shortSends)
+        {
+            m_shortSends->addOrdered(shortSends);
+        }
+
+        return bytesSent;
     }
 
+    /**
+     * Send frames straight out of a term buffer without staging them. The range is scanned with
+     * TermScanner::scanForAvailability into blocks of up to mtuLength, each block is queued as a datagram whose iovec
+     * points into the term buffer, and the queue is sent in one batch. Used for both new data and retransmits.
+     *
+     * With zero-copy enabled the kernel keeps referencing the range after the call returns, until
+     * reapZeroCopyCompletions() has reported the zero-copy sequence the call took as released. The caller tracks that
+     * so the range is not cleaned for reuse before then, and as reaping is not thread safe it is done from the Sender.
+     *
+     * @param termBuffer to send from, normally a term of a MappedRawLog.
+     * @param termOffset at which the frames to send begin.
+     * @param length     of the range to send, blocks beyond the send batch size are left for the next call.
+     * @param mtuLength  maximum length of a datagram.
+     * @param bytesSent  if given, set to the length of the blocks sent in full, which leaves out padding not sent.
+     * @return length of the term consumed by blocks sent in full, including any trailing padding, for advancing the
+     *         sender position.
+     */
+    std::int32_t sendFromTerm(
+        AtomicBuffer& termBuffer,
+        std::int32_t termOffset,
+        std::int32_t length,
+        std::int32_t mtuLength,
+        std::int32_t* bytesSent = nullptr);
+
 private:
     DataHeaderFlyweight m_dataHeaderFlyweight;
     StatusMessageFlyweight m_smFlyweight;
+    AtomicCounter* m_shortSends;
+    std::vector<std::int32_t> m_termRegionLengths;
+    std::vector<std::int32_t> m_termRegionPaddings;
+    std::unordered_map<std::int64_t, NetworkPublication*> m_publicationBySessionAndStreamId;
+
+    static inline std::int64_t sessionAndStreamKey(std::int32_t sessionId, std::int32_t streamId)
+    {
+        return (std::int64_t) (((std::uint64_t) (std::uint32_t) sessionId) << 32 | (std::uint32_t) streamId);
+    }
+
+    std::int32_t dispatchControl(AtomicBuffer& buffer, std::int32_t length, InetAddress& address);
+    NetworkPublication* findPublication(std::int32_t sessionId, std::int32_t streamId);
 };
 
 }}}
@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 
+#include <sstream>
+
+#include "aeron/util/StringUtil.h"
+
 #include "../uri/AeronUri.h"
 
 #include "InetAddress.h"
@@ -23,11 +27,30 @@
 using namespace aeron::driver::media;
 using namespace aeron::driver::uri;
 
+constexpr const char* UdpChannel::GSO_KEY;
+constexpr const char* UdpChannel::GRO_KEY;
+constexpr const char* UdpChannel::ZERO_COPY_KEY;
+constexpr const char* UdpChannel::FLOW_CONTROL_KEY;
+constexpr const char* UdpChannel::MAX_FLOW_CONTROL;
+constexpr const char* UdpChannel::MIN_FLOW_CONTROL;
+constexpr const char* UdpChannel::PACING_RATE_KEY;
+constexpr const char* UdpChannel::PACING_BURST_KEY;
+constexpr const char* UdpChannel::PRIORITY_KEY;
+constexpr const char* UdpChannel::HIGH_PRIORITY;
+constexpr const char* UdpChannel::NORMAL_PRIORITY;
+constexpr const char* UdpChannel::LOW_PRIORITY;
+
 static const char* ENDPOINT_KEY = "endpoint";
 static const char* INTERFACE_KEY = "interface";
 static const char* LOCAL_KEY = "local";
 static const char* REMOTE_KEY = "remote";
 
+static bool isByteCount(const std::string& value, std::size_t maxDigits)
+{
+    return !value.empty() && value.length() <= maxDigits &&
+        value.find_first_not_of("0123456789") == std::string::npos;
+}
+
 static void validateUri(const AeronUri* uri)
 {
     if (uri->media() != "udp")
@@ -35,6 +58,45 @@ static void validateUri(const AeronUri* uri)
         throw InvalidChannelException("Only UDP media supported for UdpChannel", SOURCEINFO);
     }
 
+    for (const char* key : { UdpChannel::GSO_KEY, UdpChannel::GRO_KEY, UdpChannel::ZERO_COPY_KEY })
+    {
+        if (uri->hasParam(key) && uri->param(key) != "true" && uri->param(key) != "false")
+        {
+            throw InvalidChannelException(
+                aeron::util::strPrintf("Invalid value for '%s', must be true or false", key), SOURCEINFO);
+        }
+    }
+
+    if (uri->hasParam(UdpChannel::FLOW_CONTROL_KEY) &&
+        uri->param(UdpChannel::FLOW_CONTROL_KEY) != UdpChannel::MAX_FLOW_CONTROL &&
+        uri->param(UdpChannel::FLOW_CONTROL_KEY) != UdpChannel::MIN_FLOW_CONTROL)
+    {
+        throw InvalidChannelException(
+            aeron::util::strPrintf("Invalid value for '%s', must be max or min", UdpChannel::FLOW_CONTROL_KEY),
+            SOURCEINFO);
+    }
+
+    if ((uri->hasParam(UdpChannel::PACING_RATE_KEY) && !isByteCount(uri->param(UdpChannel::PACING_RATE_KEY), 18)) ||
+        (uri->hasParam(UdpChannel::PACING_BURST_KEY) && !isByteCount(uri->param(UdpChannel::PACING_BURST_KEY), 9)))
+    {
+        throw InvalidChannelException(
+            aeron::util::strPrintf(
+                "Invalid value for '%s' or '%s', must be a number of bytes",
+                UdpChannel::PACING_RATE_KEY,
+                UdpChannel::PACING_BURST_KEY),
+            SOURCEINFO);
+    }
+
+    if (uri->hasParam(UdpChannel::PRIORITY_KEY) &&
+        uri->param(UdpChannel::PRIORITY_KEY) != UdpChannel::HIGH_PRIORITY &&
+        uri->param(UdpChannel::PRIORITY_KEY) != UdpChannel::NORMAL_PRIORITY &&
+        uri->param(UdpChannel::PRIORITY_KEY) != UdpChannel::LOW_PRIORITY)
+    {
+        throw InvalidChannelException(
+            aeron::util::strPrintf("Invalid value for '%s', must be high, normal or low", UdpChannel::PRIORITY_KEY),
+            SOURCEINFO);
+    }
+
     bool hasMulticastKeys = uri->hasParam(ENDPOINT_KEY) || uri->hasParam(INTERFACE_KEY);
     bool hasUnicastKeys = uri->hasParam(LOCAL_KEY) || uri->hasParam(REMOTE_KEY);
 
@@ -48,9 +110,9 @@ std::unique_ptr<UdpChannel> UdpChannel::parse(const char* uri, int familyHint, I
 {
     std::string uriStr{uri};
 
-    auto aeronUri = AeronUri::parse(uriStr);
+    std::unique_ptr<AeronUri> aeronUri{AeronUri::parse(uriStr)};
 
-    validateUri(aeronUri);
+    validateUri(aeronUri.get());
 
     auto dataAddress = InetAddress::parse(aeronUri->param(ENDPOINT_KEY), familyHint);
 
@@ -67,7 +129,7 @@ std::unique_ptr<UdpChannel> UdpChannel::parse(const char* uri, int familyHint, I
         auto interfaceSearchAddress = InterfaceSearchAddress::parse(interfaceAddressString, familyHint);
         auto localAddress = interfaceSearchAddress->findLocalAddress(lookup);
 
-        return std::unique_ptr<UdpChannel>{new UdpChannel{dataAddress, controlAddress, localAddress, true}};
+        return std::unique_ptr<UdpChannel>{new UdpChannel{dataAddress, controlAddress, localAddress, true, std::move(aeronUri)}};
     }
     else
     {
@@ -77,11 +139,21 @@ std::unique_ptr<UdpChannel> UdpChannel::parse(const char* uri, int familyHint, I
 
         std::unique_ptr<InetAddress> empty{nullptr};
         auto localInterface = std::unique_ptr<NetworkInterface>{new NetworkInterface{std::move(localAddress), nullptr, 0}};
-        return std::unique_ptr<UdpChannel>(new UdpChannel{dataAddress, empty, localInterface, false});
+        return std::unique_ptr<UdpChannel>(new UdpChannel{dataAddress, empty, localInterface, false, std::move(aeronUri)});
     }
 }
 
 const char* UdpChannel::canonicalForm()
 {
-    return nullptr;
+    if (m_canonicalForm.empty())
+    {
+        std::ostringstream stream;
+        stream << "UDP-";
+        localData().output(stream);
+        stream << "-";
+        remoteData().output(stream);
+        m_canonicalForm = stream.str();
+    }
+
+    return m_canonicalForm.c_str();
 }
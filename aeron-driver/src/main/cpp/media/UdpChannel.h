@@ -19,8 +19,12 @@
 
 #include <memory>
 #include <iostream>
+#include <string>
 
 #include "aeron/util/Exceptions.h"
+#include "aeron/util/StringUtil.h"
+
+#include "../uri/AeronUri.h"
 
 #include "InetAddress.h"
 #include "InterfaceLookup.h"
@@ -33,18 +37,40 @@ DECLARE_SOURCED_EXCEPTION (InvalidChannelException);
 class UdpChannel
 {
 public:
+    static constexpr const char* GSO_KEY = "gso";
+    static constexpr const char* GRO_KEY = "gro";
+    static constexpr const char* ZERO_COPY_KEY = "zc";
+    static constexpr const char* FLOW_CONTROL_KEY = "fc";
+    static constexpr const char* MAX_FLOW_CONTROL = "max";
+    static constexpr const char* MIN_FLOW_CONTROL = "min";
+    static constexpr const char* CONGESTION_CONTROL_KEY = "cc";
+    static constexpr const char* STATIC_CONGESTION_CONTROL = "static";
+    static constexpr const char* CUBIC_CONGESTION_CONTROL = "cubic";
+    static constexpr const char* PACING_RATE_KEY = "pacing-rate";
+    static constexpr const char* PACING_BURST_KEY = "pacing-burst";
+    static constexpr const char* PRIORITY_KEY = "priority";
+    static constexpr const char* HIGH_PRIORITY = "high";
+    static constexpr const char* NORMAL_PRIORITY = "normal";
+    static constexpr const char* LOW_PRIORITY = "low";
+
     UdpChannel(
         std::unique_ptr<InetAddress>& remoteData,
         std::unique_ptr<InetAddress>& remoteControl,
         std::unique_ptr<NetworkInterface>& localData,
-        bool isMulticast)
+        bool isMulticast,
+        std::unique_ptr<uri::AeronUri> uri = nullptr)
         : m_remoteControl(std::move(remoteControl)),
           m_remoteData(std::move(remoteData)),
           m_localData(std::move(localData)),
-          m_isMulticast(isMulticast)
+          m_isMulticast(isMulticast),
+          m_uri(std::move(uri))
     {
     }
 
+    /**
+     * Form of the channel that is the same for all URIs resolving to the same local and remote addresses, for use as
+     * the key when sharing channel endpoints.
+     */
     const char* canonicalForm();
 
     inline bool isMulticast() const
@@ -82,6 +108,78 @@ public:
         return *m_localData;
     }
 
+    /**
+     * Has UDP generic segmentation offload been requested for sends on this channel with gso=true.
+     */
+    inline bool isGso() const
+    {
+        return hasBooleanParam(GSO_KEY);
+    }
+
+    /**
+     * Has UDP generic receive offload been requested for this channel with gro=true.
+     */
+    inline bool isGro() const
+    {
+        return hasBooleanParam(GRO_KEY);
+    }
+
+    /**
+     * Has MSG_ZEROCOPY been requested for sending data frames from term buffers on this channel with zc=true.
+     */
+    inline bool isZeroCopy() const
+    {
+        return hasBooleanParam(ZERO_COPY_KEY);
+    }
+
+    /**
+     * Flow control chosen for a multicast channel with fc=max or fc=min, or empty to use the driver default.
+     */
+    inline std::string flowControl() const
+    {
+        return (nullptr != m_uri && m_uri->hasParam(FLOW_CONTROL_KEY)) ? m_uri->param(FLOW_CONTROL_KEY) : "";
+    }
+
+    /**
+     * Congestion control chosen for the images received on a channel with cc=static or cc=cubic, or empty for the
+     * default static window.
+     */
+    inline std::string congestionControl() const
+    {
+        return (nullptr != m_uri && m_uri->hasParam(CONGESTION_CONTROL_KEY)) ?
+            m_uri->param(CONGESTION_CONTROL_KEY) : "";
+    }
+
+    /**
+     * Rate in bytes per second a publication on this channel is paced to with pacing-rate, 0 for no pacing.
+     */
+    inline std::int64_t pacingRate(std::int64_t defaultRate) const
+    {
+        return integerParam<std::int64_t>(PACING_RATE_KEY, defaultRate);
+    }
+
+    /**
+     * Length a paced publication on this channel may send back to back with pacing-burst.
+     */
+    inline std::int32_t pacingBurstLength(std::int32_t defaultLength) const
+    {
+        return integerParam<std::int32_t>(PACING_BURST_KEY, defaultLength);
+    }
+
+    /**
+     * Class the Sender schedules a publication on this channel in with priority=high, priority=normal or
+     * priority=low, or empty for normal.
+     */
+    inline std::string priority() const
+    {
+        return (nullptr != m_uri && m_uri->hasParam(PRIORITY_KEY)) ? m_uri->param(PRIORITY_KEY) : "";
+    }
+
+    inline const uri::AeronUri* uri() const
+    {
+        return m_uri.get();
+    }
+
     static std::unique_ptr<UdpChannel> parse(
         const char* uri, int familyHint = PF_INET, InterfaceLookup& lookup = BsdInterfaceLookup::get());
 
@@ -90,6 +188,19 @@ private:
     std::unique_ptr<InetAddress> m_remoteData;
     std::unique_ptr<NetworkInterface> m_localData;
     bool m_isMulticast;
+    std::unique_ptr<uri::AeronUri> m_uri;
+    std::string m_canonicalForm;
+
+    inline bool hasBooleanParam(const char* key) const
+    {
+        return nullptr != m_uri && m_uri->hasParam(key) && m_uri->param(key) == "true";
+    }
+
+    template <typename T>
+    inline T integerParam(const char* key, T defaultValue) const
+    {
+        return (nullptr != m_uri && m_uri->hasParam(key)) ? util::parse<T>(m_uri->param(key)) : defaultValue;
+    }
 };
 
 
@@ -16,8 +16,14 @@
 
 
 #include <sys/errno.h>
+#include <algorithm>
 #include <iostream>
 #include <sys/fcntl.h>
+#include <netinet/udp.h>
+
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#endif
 
 #include "aeron/util/StringUtil.h"
 
@@ -25,6 +31,75 @@
 
 using namespace aeron::driver::media;
 
+const std::int32_t UdpChannelTransport::RECEIVE_BUFFER_LENGTH;
+const std::int32_t UdpChannelTransport::DEFAULT_RECEIVE_BATCH_SIZE;
+const std::int32_t UdpChannelTransport::DEFAULT_SEND_BATCH_SIZE;
+const std::int32_t UdpChannelTransport::GSO_MAX_SEGMENTS;
+const std::int32_t UdpChannelTransport::GSO_MAX_LENGTH;
+const std::int32_t UdpChannelTransport::RECEIVE_TARGET_HEADER_LENGTH;
+
+static const std::int32_t RECEIVE_IOVECS_PER_MESSAGE = 3;
+
+#if defined(__linux__) && !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+
+#if defined(__linux__) && !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+
+#if defined(__linux__) && !defined(SO_ZEROCOPY)
+#define SO_ZEROCOPY 60
+#endif
+
+#if defined(__linux__) && !defined(MSG_ZEROCOPY)
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+#if defined(__linux__) && !defined(SO_EE_ORIGIN_ZEROCOPY)
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+
+static inline std::int32_t groSegmentLength(msghdr& header, std::int32_t length)
+{
+    std::int32_t segmentLength = length;
+
+#if defined(__linux__)
+    if (nullptr == header.msg_control)
+    {
+        return segmentLength;
+    }
+
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); nullptr != cmsg; cmsg = CMSG_NXTHDR(&header, cmsg))
+    {
+        if (IPPROTO_UDP == cmsg->cmsg_level && UDP_GRO == cmsg->cmsg_type)
+        {
+            int groSegmentLength;
+            memcpy(&groSegmentLength, CMSG_DATA(cmsg), sizeof(groSegmentLength));
+
+            if (groSegmentLength > 0 && groSegmentLength < segmentLength)
+            {
+                segmentLength = groSegmentLength;
+            }
+            break;
+        }
+    }
+#endif
+
+    return segmentLength;
+}
+
+static inline bool isTransientSendError(int error)
+{
+    return EAGAIN == error || EWOULDBLOCK == error || ENOBUFS == error || EINTR == error;
+}
+
+static inline bool isGsoRejectedError(int error)
+{
+    return EIO == error || EINVAL == error || ENOPROTOOPT == error || EOPNOTSUPP == error;
+}
+
 static void setSocketOption(
     int socket, int level, int option_name, const void* option_value, socklen_t option_len)
 {
@@ -149,6 +224,44 @@ void UdpChannelTransport::openDatagramChannel()
 
     setNonBlocking(m_sendSocketFd);
     setNonBlocking(m_recvSocketFd);
+
+#if defined(__linux__)
+    if (m_channel->isGro())
+    {
+        m_groEnabled = setsockopt(m_recvSocketFd, IPPROTO_UDP, UDP_GRO, &yes, sizeof(yes)) == 0;
+    }
+
+    if (m_gsoRequested)
+    {
+        int segmentSize = 0;
+        socklen_t length = sizeof(segmentSize);
+        m_gsoEnabled = getsockopt(m_sendSocketFd, IPPROTO_UDP, UDP_SEGMENT, &segmentSize, &length) == 0;
+    }
+
+    if (m_zeroCopyRequested)
+    {
+        m_zeroCopyEnabled = setsockopt(m_sendSocketFd, SOL_SOCKET, SO_ZEROCOPY, &yes, sizeof(yes)) == 0;
+    }
+#endif
+
+    if (m_ioUringRequested)
+    {
+        try
+        {
+            m_ioUring.reset(new IoUring(
+                IoUring::DEFAULT_ENTRIES,
+                IoUring::DEFAULT_RECEIVE_BUFFER_COUNT,
+                m_receiveBufferLength,
+                m_receiveAddresses[0]->length(),
+                m_groEnabled ? sizeof(ControlMessageBuffer::buffer) : 0));
+            m_ioUring->armReceive(m_recvSocketFd);
+            m_ioUringReceived.resize((size_t) m_receiveBatchSize);
+        }
+        catch (aeron::util::IOException&)
+        {
+            m_ioUring.reset();
+        }
+    }
 }
 
 void UdpChannelTransport::send(const void* data, const int32_t len)
@@ -163,6 +276,274 @@ void UdpChannelTransport::send(const void* data, const int32_t len)
     }
 }
 
+void UdpChannelTransport::sendTo(const void* data, const int32_t len, InetAddress& address)
+{
+    ssize_t bytesSent = sendto(m_sendSocketFd, data, (size_t) len, 0, address.address(), address.length());
+
+    if (bytesSent < 0)
+    {
+        throw aeron::util::IOException{
+            aeron::util::strPrintf("Failed to send: %s", strerror(errno)), SOURCEINFO};
+    }
+}
+
+std::int32_t UdpChannelTransport::prepareSendMessages(std::int32_t firstDatagram, bool coalesce)
+{
+    std::int32_t messageCount = 0;
+    std::int32_t index = firstDatagram;
+
+    while (index < m_sendQueueLength)
+    {
+        const iovec& first = m_sendIovecs[index];
+        const size_t segmentLength = first.iov_len;
+        size_t totalLength = segmentLength;
+        std::int32_t datagrams = 1;
+
+        while (coalesce && index + datagrams < m_sendQueueLength && datagrams < GSO_MAX_SEGMENTS)
+        {
+            const iovec& next = m_sendIovecs[index + datagrams];
+            const bool isContiguous = ((std::uint8_t*) first.iov_base + totalLength) == next.iov_base;
+            const bool isSameAddress = m_sendAddresses[index] == m_sendAddresses[index + datagrams];
+
+            if (!isContiguous || !isSameAddress ||
+                next.iov_len > segmentLength || totalLength + next.iov_len > GSO_MAX_LENGTH)
+            {
+                break;
+            }
+
+            totalLength += next.iov_len;
+            datagrams++;
+
+            if (next.iov_len < segmentLength)
+            {
+                break;
+            }
+        }
+
+        iovec& iov = m_sendMessageIovecs[messageCount];
+        iov.iov_base = first.iov_base;
+        iov.iov_len = totalLength;
+
+        msghdr& header = m_sendMessages[messageCount].msg_hdr;
+        memset(&header, 0, sizeof(header));
+        header.msg_name = m_sendAddresses[index]->address();
+        header.msg_namelen = m_sendAddresses[index]->length();
+        header.msg_iov = &iov;
+        header.msg_iovlen = 1;
+
+#if defined(__linux__)
+        if (datagrams > 1)
+        {
+            header.msg_control = m_sendControls[messageCount].buffer;
+            header.msg_controllen = sizeof(m_sendControls[messageCount].buffer);
+
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&header);
+            cmsg->cmsg_level = IPPROTO_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+
+            const std::uint16_t segmentSize = (std::uint16_t) segmentLength;
+            memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+        }
+#endif
+
+        m_sendMessages[messageCount].msg_len = 0;
+        m_sendMessageDatagrams[messageCount] = datagrams;
+
+        messageCount++;
+        index += datagrams;
+    }
+
+    return messageCount;
+}
+
+int UdpChannelTransport::sendMessages(std::int32_t messageCount, int flags)
+{
+    if (nullptr != m_ioUring)
+    {
+        return m_ioUring->sendMessages(m_sendSocketFd, m_sendMessages.data(), messageCount);
+    }
+
+#if defined(__linux__)
+    return sendmmsg(m_sendSocketFd, m_sendMessages.data(), (unsigned int) messageCount, flags);
+#else
+    int sent = 0;
+    for (; sent < messageCount; sent++)
+    {
+        ssize_t result = sendmsg(m_sendSocketFd, &m_sendMessages[sent].msg_hdr, flags);
+        if (result < 0)
+        {
+            return 0 == sent ? -1 : sent;
+        }
+
+        m_sendMessages[sent].msg_len = (unsigned int) result;
+    }
+
+    return sent;
+#endif
+}
+
+std::int32_t UdpChannelTransport::sendQueued(std::int32_t* shortSends, bool zeroCopy)
+{
+    std::int32_t bytesSent = 0;
+
+    *shortSends = 0;
+    if (0 == m_sendQueueLength)
+    {
+        return 0;
+    }
+
+#if defined(__linux__)
+    // io_uring sends complete independently of each other so the ids taken could not be accounted for
+    const int flags = (zeroCopy && m_zeroCopyEnabled && nullptr == m_ioUring) ? MSG_ZEROCOPY : 0;
+#else
+    const int flags = 0;
+#endif
+
+    std::int32_t datagramIndex = 0;
+
+    // sendmmsg stops at a failing message without reporting its error, so the rest is sent again to surface it, e.g.
+    // a GSO rejection after earlier messages went out
+    while (datagramIndex < m_sendQueueLength)
+    {
+        const std::int32_t messageCount = prepareSendMessages(datagramIndex, m_gsoEnabled);
+        int sent = sendMessages(messageCount, flags);
+
+        if (sent < 0 && m_gsoEnabled && isGsoRejectedError(errno))
+        {
+            // prepare the same datagrams again, one message each
+            m_gsoEnabled = false;
+            continue;
+        }
+
+        if (sent > 0 && 0 != flags)
+        {
+            m_zeroCopySequence += (std::uint32_t) sent;
+        }
+
+        if (sent < 0)
+        {
+            if (!isTransientSendError(errno))
+            {
+                m_sendQueueLength = 0;
+                throw aeron::util::IOException{
+                    aeron::util::strPrintf("Failed to sendmmsg: %s", strerror(errno)), SOURCEINFO};
+            }
+
+            sent = 0;
+        }
+
+        const std::int32_t firstDatagram = datagramIndex;
+        for (std::int32_t i = 0; i < sent; i++)
+        {
+            bytesSent += (std::int32_t) m_sendMessages[i].msg_len;
+            if (m_sendMessages[i].msg_len < m_sendMessageIovecs[i].iov_len)
+            {
+                (*shortSends) += m_sendMessageDatagrams[i];
+            }
+
+            datagramIndex += m_sendMessageDatagrams[i];
+        }
+
+        if (0 == sent)
+        {
+            (*shortSends) += m_sendQueueLength - datagramIndex;
+            break;
+        }
+
+        onSendBatch(datagramIndex - firstDatagram);
+    }
+
+    m_sendQueueLength = 0;
+
+    return bytesSent;
+}
+
+std::uint32_t UdpChannelTransport::reapZeroCopyCompletions()
+{
+#if defined(__linux__)
+    if (!m_zeroCopyEnabled)
+    {
+        return m_zeroCopyReleased;
+    }
+
+    union
+    {
+        char buffer[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+        cmsghdr align;
+    } control;
+
+    while (m_zeroCopyReleased != m_zeroCopySequence)
+    {
+        msghdr header;
+        memset(&header, 0, sizeof(header));
+        header.msg_control = control.buffer;
+        header.msg_controllen = sizeof(control.buffer);
+
+        if (recvmsg(m_sendSocketFd, &header, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+        {
+            if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno)
+            {
+                throw aeron::util::IOException{
+                    aeron::util::strPrintf("Failed to read socket error queue: %s", strerror(errno)), SOURCEINFO};
+            }
+
+            break;
+        }
+
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); nullptr != cmsg; cmsg = CMSG_NXTHDR(&header, cmsg))
+        {
+            const bool isRecvErr =
+                (SOL_IP == cmsg->cmsg_level && IP_RECVERR == cmsg->cmsg_type) ||
+                (SOL_IPV6 == cmsg->cmsg_level && IPV6_RECVERR == cmsg->cmsg_type);
+
+            if (!isRecvErr)
+            {
+                continue;
+            }
+
+            sock_extended_err error;
+            memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+
+            if (SO_EE_ORIGIN_ZEROCOPY == error.ee_origin && 0 == error.ee_errno)
+            {
+                if (SO_EE_CODE_ZEROCOPY_COPIED == error.ee_code)
+                {
+                    m_zeroCopyCopiedCount += (std::int64_t) (error.ee_data - error.ee_info) + 1;
+                }
+
+                onZeroCopyCompletion(error.ee_info, error.ee_data);
+            }
+        }
+    }
+#endif
+
+    return m_zeroCopyReleased;
+}
+
+void UdpChannelTransport::onZeroCopyCompletion(std::uint32_t first, std::uint32_t last)
+{
+    // completions normally arrive in order, hold back any range that arrives early until the gap before it is filled
+    m_zeroCopyCompletedRanges.emplace_back(first, last);
+
+    bool isAdvanced = true;
+    while (isAdvanced)
+    {
+        isAdvanced = false;
+
+        for (auto it = m_zeroCopyCompletedRanges.begin(); it != m_zeroCopyCompletedRanges.end(); ++it)
+        {
+            if (it->first == m_zeroCopyReleased)
+            {
+                m_zeroCopyReleased = it->second + 1;
+                m_zeroCopyCompletedRanges.erase(it);
+                isAdvanced = true;
+                break;
+            }
+        }
+    }
+}
+
 std::int32_t UdpChannelTransport::recv(char* data, const int32_t len)
 {
     socklen_t socklen = m_connectAddress->length();
@@ -186,10 +567,272 @@ void UdpChannelTransport::setTimeout(timeval timeout)
     setSocketOption(m_recvSocketFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
 }
 
+void UdpChannelTransport::allocateReceiveBatch()
+{
+    m_receiveBuffers.reserve((size_t) m_receiveBatchSize);
+    m_receiveAddresses.reserve((size_t) m_receiveBatchSize);
+    m_receiveIovecs.resize((size_t) (m_receiveBatchSize * RECEIVE_IOVECS_PER_MESSAGE));
+    m_receiveMessages.resize((size_t) m_receiveBatchSize);
+    m_receiveSegmentLengths.resize((size_t) m_receiveBatchSize);
+    m_receiveTargets.assign((size_t) m_receiveBatchSize, nullptr);
+    m_receiveTargetLengths.assign((size_t) m_receiveBatchSize, 0);
+    m_receivedTargets.assign((size_t) m_receiveBatchSize, nullptr);
+
+    for (std::int32_t i = 0; i < m_receiveBatchSize; i++)
+    {
+        std::uint8_t* slot = m_receiveBufferBytes.get() + (i * m_receiveBufferLength);
+
+        m_receiveBuffers.emplace_back(slot, m_receiveBufferLength);
+        m_receiveBuffers[i].setMemory(0, m_receiveBufferLength, 0);
+        m_receiveAddresses.push_back(InetAddress::any(m_endPointAddress->domain()));
+
+        iovec* iov = &m_receiveIovecs[i * RECEIVE_IOVECS_PER_MESSAGE];
+        iov[0].iov_base = slot;
+        iov[0].iov_len = (size_t) m_receiveBufferLength;
+
+        msghdr& header = m_receiveMessages[i].msg_hdr;
+        memset(&header, 0, sizeof(header));
+        header.msg_iov = iov;
+        header.msg_iovlen = 1;
+        header.msg_name = m_receiveAddresses[i]->address();
+        header.msg_namelen = m_receiveAddresses[i]->length();
+        m_receiveMessages[i].msg_len = 0;
+        m_receiveSegmentLengths[i] = 0;
+    }
+}
+
+void UdpChannelTransport::prepareReceiveMessage(std::int32_t index, bool useTarget)
+{
+    msghdr& header = m_receiveMessages[index].msg_hdr;
+    iovec* iov = header.msg_iov;
+    std::uint8_t* slot = m_receiveBuffers[index].buffer();
+    std::uint8_t* target = useTarget ? m_receiveTargets[index] : nullptr;
+
+    header.msg_namelen = m_receiveAddresses[index]->length();
+
+    m_receivedTargets[index] = target;
+    m_receiveTargets[index] = nullptr;
+
+    if (nullptr == target)
+    {
+        iov[0].iov_base = slot;
+        iov[0].iov_len = (size_t) m_receiveBufferLength;
+        header.msg_iovlen = 1;
+    }
+    else
+    {
+        const std::int32_t targetLength = m_receiveTargetLengths[index];
+
+        iov[0].iov_base = slot;
+        iov[0].iov_len = (size_t) RECEIVE_TARGET_HEADER_LENGTH;
+        iov[1].iov_base = target + RECEIVE_TARGET_HEADER_LENGTH;
+        iov[1].iov_len = (size_t) (targetLength - RECEIVE_TARGET_HEADER_LENGTH);
+        iov[2].iov_base = slot + targetLength;
+        iov[2].iov_len = (size_t) (m_receiveBufferLength - targetLength);
+        header.msg_iovlen = m_receiveBufferLength > targetLength ? 3 : 2;
+    }
+
+    if (m_groEnabled)
+    {
+        header.msg_control = m_receiveControls[index].buffer;
+        header.msg_controllen = sizeof(m_receiveControls[index].buffer);
+    }
+}
+
+void UdpChannelTransport::completeReceiveMessage(std::int32_t index)
+{
+    const std::int32_t length = (std::int32_t) m_receiveMessages[index].msg_len;
+
+    m_receiveSegmentLengths[index] =
+        m_groEnabled ? groSegmentLength(m_receiveMessages[index].msg_hdr, length) : length;
+}
+
+void UdpChannelTransport::restoreReceiveBuffers()
+{
+    for (std::int32_t i = 0; i < m_receiveBatchSize; i++)
+    {
+        m_receiveBuffers[i].wrap(m_receiveBufferBytes.get() + (i * m_receiveBufferLength), m_receiveBufferLength);
+    }
+
+    m_receiveBuffersRemapped = false;
+}
+
+void UdpChannelTransport::unscatterReceive(std::int32_t index)
+{
+    std::uint8_t* target = m_receivedTargets[index];
+    if (nullptr == target)
+    {
+        return;
+    }
+
+    const std::int32_t length = std::min((std::int32_t) m_receiveMessages[index].msg_len, m_receiveTargetLengths[index]);
+    if (length > RECEIVE_TARGET_HEADER_LENGTH)
+    {
+        const size_t targetBytes = (size_t) (length - RECEIVE_TARGET_HEADER_LENGTH);
+
+        memcpy(m_receiveBuffers[index].buffer() + RECEIVE_TARGET_HEADER_LENGTH, target + RECEIVE_TARGET_HEADER_LENGTH, targetBytes);
+        memset(target + RECEIVE_TARGET_HEADER_LENGTH, 0, targetBytes);
+    }
+
+    m_receivedTargets[index] = nullptr;
+}
+
+std::int32_t UdpChannelTransport::receiveBatchFromIoUring(std::int32_t limit)
+{
+    const std::int32_t messagesReceived = m_ioUring->pollReceives(m_ioUringReceived.data(), limit);
+
+    for (std::int32_t i = 0; i < messagesReceived; i++)
+    {
+        IoUring::Received& received = m_ioUringReceived[i];
+        InetAddress& address = *m_receiveAddresses[i];
+
+        m_receiveBuffers[i].wrap(received.payload, received.length);
+        m_receiveMessages[i].msg_len = (unsigned int) received.length;
+        memcpy(address.address(), received.name, std::min(received.nameLength, address.length()));
+        m_receiveSegmentLengths[i] =
+            m_groEnabled ? groSegmentLength(received.controlHeader, received.length) : received.length;
+    }
+
+    if (messagesReceived > 0)
+    {
+        m_receiveBuffersRemapped = true;
+    }
+
+    return messagesReceived;
+}
+
+std::int32_t UdpChannelTransport::receiveBatch()
+{
+    if (nullptr != m_ioUring && !m_ioUring->hasReceiveFailed())
+    {
+        const std::int32_t messagesReceived = receiveBatchFromIoUring(m_receiveBatchSize);
+        if (messagesReceived > 0)
+        {
+            onReceiveBatch(messagesReceived);
+        }
+
+        return messagesReceived;
+    }
+
+    if (m_receiveBuffersRemapped)
+    {
+        restoreReceiveBuffers();
+    }
+
+    for (std::int32_t i = 0; i < m_receiveBatchSize; i++)
+    {
+        prepareReceiveMessage(i, true);
+    }
+
+#if defined(__linux__)
+    int messagesReceived = recvmmsg(m_recvSocketFd, m_receiveMessages.data(), (unsigned int) m_receiveBatchSize, 0, nullptr);
+    if (messagesReceived < 0)
+    {
+        if (EAGAIN != errno && EWOULDBLOCK != errno)
+        {
+            throw aeron::util::IOException{
+                aeron::util::strPrintf("Failed to recvmmsg: %s", strerror(errno)), SOURCEINFO};
+        }
+
+        messagesReceived = 0;
+    }
+#else
+    int messagesReceived = 0;
+    for (; messagesReceived < m_receiveBatchSize; messagesReceived++)
+    {
+        ssize_t size = recvmsg(m_recvSocketFd, &m_receiveMessages[messagesReceived].msg_hdr, 0);
+        if (size < 0)
+        {
+            if (EAGAIN != errno && EWOULDBLOCK != errno)
+            {
+                throw aeron::util::IOException{
+                    aeron::util::strPrintf("Failed to recvmsg: %s", strerror(errno)), SOURCEINFO};
+            }
+
+            break;
+        }
+
+        m_receiveMessages[messagesReceived].msg_len = (unsigned int) size;
+    }
+#endif
+
+    for (std::int32_t i = 0; i < messagesReceived; i++)
+    {
+        completeReceiveMessage(i);
+    }
+
+    if (messagesReceived > 0)
+    {
+        onReceiveBatch(messagesReceived);
+    }
+
+    return messagesReceived;
+}
+
+void UdpChannelTransport::onReceiveBatch(std::int32_t datagramCount)
+{
+    m_receiveBatchCount++;
+    m_datagramsReceivedCount += datagramCount;
+
+    if (nullptr != m_receiveBatches)
+    {
+        m_receiveBatches->orderedIncrement();
+    }
+
+    if (nullptr != m_datagramsReceived)
+    {
+        m_datagramsReceived->addOrdered(datagramCount);
+    }
+}
+
+void UdpChannelTransport::onSendBatch(std::int32_t datagramCount)
+{
+    if (nullptr != m_sendBatches)
+    {
+        m_sendBatches->orderedIncrement();
+    }
+
+    if (nullptr != m_datagramsSent)
+    {
+        m_datagramsSent->addOrdered(datagramCount);
+    }
+}
+
 InetAddress* UdpChannelTransport::receive(int32_t* bytesRead)
 {
+    mmsghdr& message = m_receiveMessages[0];
+
+    if (nullptr != m_ioUring && !m_ioUring->hasReceiveFailed())
+    {
+        *bytesRead = 0 == receiveBatchFromIoUring(1) ? 0 : (std::int32_t) message.msg_len;
+        return 0 == *bytesRead ? nullptr : m_receiveAddresses[0].get();
+    }
+
+    if (m_receiveBuffersRemapped)
+    {
+        restoreReceiveBuffers();
+    }
+
+    prepareReceiveMessage(0, false);
+
+    ssize_t size = recvmsg(m_recvSocketFd, &message.msg_hdr, 0);
+    if (size < 0)
+    {
+        if (EAGAIN != errno && EWOULDBLOCK != errno)
+        {
+            throw aeron::util::IOException{
+                aeron::util::strPrintf("Failed to recvmsg: %s", strerror(errno)), SOURCEINFO};
+        }
+
+        *bytesRead = 0;
+        return nullptr;
+    }
+
+    message.msg_len = (unsigned int) size;
+    completeReceiveMessage(0);
+    *bytesRead = (std::int32_t) size;
 
-    return nullptr;
+    return m_receiveAddresses[0].get();
 }
 
 bool UdpChannelTransport::isMulticast()
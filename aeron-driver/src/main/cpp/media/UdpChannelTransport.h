@@ -18,12 +18,24 @@
 #define INCLUDED_AERON_DRIVER_UDPCHANNELTRANSPORT__
 
 #include <unistd.h>
+#include <vector>
+#include <sys/socket.h>
 
 #include "aeron/protocol/HeaderFlyweight.h"
 #include "aeron/concurrent/AtomicBuffer.h"
+#include "aeron/concurrent/AtomicCounter.h"
 #include "aeron/concurrent/logbuffer/FrameDescriptor.h"
 
 #include "UdpChannel.h"
+#include "IoUring.h"
+
+#if !defined(__linux__)
+struct mmsghdr
+{
+    msghdr msg_hdr;
+    unsigned int msg_len;
+};
+#endif
 
 namespace aeron { namespace driver { namespace media {
 
@@ -34,23 +46,45 @@ using namespace aeron::protocol;
 class UdpChannelTransport
 {
 public:
+    /** Length of each slot of the receive slab, which holds the largest UDP datagram whatever MTU the source uses. */
+    static const std::int32_t RECEIVE_BUFFER_LENGTH = 65536;
+    static const std::int32_t DEFAULT_RECEIVE_BATCH_SIZE = 16;
+    static const std::int32_t DEFAULT_SEND_BATCH_SIZE = 16;
+    static const std::int32_t GSO_MAX_SEGMENTS = 64;
+    static const std::int32_t GSO_MAX_LENGTH = 65507;
+    static const std::int32_t RECEIVE_TARGET_HEADER_LENGTH = 4;
+
     UdpChannelTransport(
         std::unique_ptr<UdpChannel>& channel,
         InetAddress* endPointAddress,
         InetAddress* bindAddress,
-        InetAddress* connectAddress)
+        InetAddress* connectAddress,
+        std::int32_t receiveBatchSize = DEFAULT_RECEIVE_BATCH_SIZE,
+        std::int32_t sendBatchSize = DEFAULT_SEND_BATCH_SIZE)
         : m_channel(std::move(channel)),
           m_endPointAddress(endPointAddress),
           m_bindAddress(bindAddress),
           m_connectAddress(connectAddress),
           m_sendSocketFd(0),
-          m_receiveBuffer(m_receiveBufferBytes, m_receiveBufferLength)
+          m_receiveBatchSize(receiveBatchSize < 1 ? 1 : receiveBatchSize),
+          m_receiveBufferLength(RECEIVE_BUFFER_LENGTH),
+          m_receiveBufferBytes(new std::uint8_t[m_receiveBatchSize * m_receiveBufferLength]),
+          m_receiveControls((size_t) m_receiveBatchSize),
+          m_sendBatchSize(sendBatchSize < 1 ? 1 : sendBatchSize),
+          m_sendIovecs((size_t) m_sendBatchSize),
+          m_sendAddresses((size_t) m_sendBatchSize),
+          m_sendMessageIovecs((size_t) m_sendBatchSize),
+          m_sendMessages((size_t) m_sendBatchSize),
+          m_sendMessageDatagrams((size_t) m_sendBatchSize),
+          m_sendControls((size_t) m_sendBatchSize)
     {
-        m_receiveBuffer.setMemory(0, m_receiveBuffer.capacity(), 0);
+        allocateReceiveBatch();
     }
 
     virtual ~UdpChannelTransport()
     {
+        m_ioUring.reset();
+
         if (0 != m_sendSocketFd)
         {
             close(m_sendSocketFd);
@@ -75,16 +109,285 @@ public:
 
     void openDatagramChannel();
     void send(const void* data, const int32_t len);
+
+    /**
+     * Send a datagram to an address other than the endpoint, e.g. a control message back to the source of the data.
+     */
+    void sendTo(const void* data, const int32_t len, InetAddress& address);
     std::int32_t recv(char* data, const int32_t len);
     void setTimeout(timeval timeout);
     InetAddress* receive(int32_t* pInt);
     bool isMulticast();
     UdpChannel& udpChannel();
 
+    /**
+     * Drain up to the receive batch size of datagrams from the socket in a single call. Each datagram is placed in
+     * its own slot of the receive slab along with its source address.
+     *
+     * @return number of datagrams received, 0 if none are available.
+     */
+    std::int32_t receiveBatch();
+
+    /**
+     * Queue a datagram to be sent to the endpoint, or to another address, on the next call to sendQueued(). The data
+     * and the address are not copied so they must remain valid until the queue has been sent.
+     *
+     * @param data    of the datagram.
+     * @param length  of the datagram.
+     * @param address to send the datagram to or nullptr for the endpoint.
+     * @return true if queued or false if the send batch is full and needs to be sent first.
+     */
+    inline bool queueSend(const void* data, const std::int32_t length, InetAddress* address = nullptr)
+    {
+        if (m_sendQueueLength >= m_sendBatchSize)
+        {
+            return false;
+        }
+
+        iovec& iov = m_sendIovecs[m_sendQueueLength];
+        iov.iov_base = const_cast<void*>(data);
+        iov.iov_len = (size_t) length;
+        m_sendAddresses[m_sendQueueLength] = nullptr != address ? address : m_endPointAddress;
+
+        m_sendQueueLength++;
+
+        return true;
+    }
+
+    /**
+     * Send all queued datagrams with a single sendmmsg call. Datagrams the kernel would not take, or only took in
+     * part, are dropped from the queue and reported as short sends rather than raised as errors.
+     *
+     * With segmentation offload enabled, runs of queued datagrams that are contiguous in memory and of equal length,
+     * apart from a possibly shorter last one, are handed to the kernel as one buffer to be split with UDP_SEGMENT.
+     *
+     * With zeroCopy set and zero-copy enabled on the socket the datagrams are sent with MSG_ZEROCOPY, so the kernel
+     * pins the queued memory rather than copying it and the memory must then stay untouched until
+     * reapZeroCopyCompletions() reports the sends released. Each message handed to the kernel takes one id from
+     * zeroCopySequence().
+     *
+     * @param shortSends set to the number of queued datagrams that were not sent in full.
+     * @param zeroCopy   true to send with MSG_ZEROCOPY if zero-copy is enabled.
+     * @return number of bytes sent.
+     */
+    std::int32_t sendQueued(std::int32_t* shortSends, bool zeroCopy = false);
+
+    /**
+     * Request UDP generic segmentation offload for sendQueued(). Takes effect when the channel is opened and only
+     * if the kernel supports UDP_SEGMENT, it is turned off again if the kernel later rejects a segmented send.
+     *
+     * @param requested true to use segmentation offload when available.
+     */
+    inline void segmentationOffload(bool requested)
+    {
+        m_gsoRequested = requested;
+    }
+
+    inline bool isGsoEnabled() const
+    {
+        return m_gsoEnabled;
+    }
+
+    inline int receiveSocketFd() const
+    {
+        return m_recvSocketFd;
+    }
+
+    /**
+     * Request that socket I/O goes through io_uring rather than socket calls. Takes effect when the channel is opened
+     * and only if the kernel supports multishot receive into registered buffers, otherwise the socket calls are kept.
+     * Received datagrams are then read in place from the registered buffers, the buffer for a slot is only valid
+     * until the next receive.
+     *
+     * @param requested true to use io_uring when available.
+     */
+    inline void ioUring(bool requested)
+    {
+        m_ioUringRequested = requested;
+    }
+
+    inline bool isIoUringEnabled() const
+    {
+        return nullptr != m_ioUring;
+    }
+
+    /**
+     * Request SO_ZEROCOPY on the send socket so sendQueued() can send with MSG_ZEROCOPY. Takes effect when the channel
+     * is opened and only if the kernel supports it. Pays off for large datagrams on a NIC that can gather from user
+     * memory, for small datagrams the page pinning and completion handling cost more than the copy saved, and on
+     * loopback the kernel copies anyway.
+     *
+     * @param requested true to use zero-copy sends when available.
+     */
+    inline void zeroCopy(bool requested)
+    {
+        m_zeroCopyRequested = requested;
+    }
+
+    inline bool isZeroCopyEnabled() const
+    {
+        return m_zeroCopyEnabled;
+    }
+
+    /**
+     * Id the kernel gives the next message sent with MSG_ZEROCOPY, ids run from 0 and wrap.
+     */
+    inline std::uint32_t zeroCopySequence() const
+    {
+        return m_zeroCopySequence;
+    }
+
+    /**
+     * Drain the completion notifications for MSG_ZEROCOPY sends from the socket error queue.
+     *
+     * @return the id below which all zero-copy sends have been released by the kernel.
+     */
+    std::uint32_t reapZeroCopyCompletions();
+
+    /**
+     * Number of zero-copy sends the kernel completed by copying after all, e.g. on loopback or when the device can not
+     * gather from user memory. A high ratio to zeroCopySequence() means zero-copy is not worth having on the channel.
+     */
+    inline std::int64_t zeroCopyCopiedCount() const
+    {
+        return m_zeroCopyCopiedCount;
+    }
+
+    inline std::int32_t queuedSendCount() const
+    {
+        return m_sendQueueLength;
+    }
+
+    inline std::int32_t sendBatchSize() const
+    {
+        return m_sendBatchSize;
+    }
+
+    inline std::int32_t receiveBatchSize() const
+    {
+        return m_receiveBatchSize;
+    }
+
+    inline AtomicBuffer& receiveBuffer(std::int32_t index)
+    {
+        return m_receiveBuffers[index];
+    }
+
+    inline std::int32_t receiveLength(std::int32_t index) const
+    {
+        return (std::int32_t) m_receiveMessages[index].msg_len;
+    }
+
+    inline InetAddress& receiveAddress(std::int32_t index)
+    {
+        return *m_receiveAddresses[index];
+    }
+
+    /**
+     * Length of the datagrams coalesced into the slot at index by UDP_GRO, the last of which may be shorter. When
+     * the slot holds a single datagram this is the same as its length.
+     */
+    inline std::int32_t receiveSegmentLength(std::int32_t index) const
+    {
+        return m_receiveSegmentLengths[index];
+    }
+
+    inline bool isGroEnabled() const
+    {
+        return m_groEnabled;
+    }
+
+    /**
+     * Receive targets are only honoured by recvmmsg into the receive slab, not with GRO or io_uring receives.
+     */
+    inline bool supportsReceiveTargets() const
+    {
+        return !m_groEnabled && (nullptr == m_ioUring || m_ioUring->hasReceiveFailed());
+    }
+
+    /**
+     * Scatter the datagram received into slot index on the next receiveBatch() straight into a target region, such as
+     * the place in a term buffer where the next in-order frame is expected. The first RECEIVE_TARGET_HEADER_LENGTH
+     * bytes, the frame length, stay in the slot so the frame is not visible in the target until it has been checked,
+     * and anything beyond length bytes is left in the slot too.
+     *
+     * The target applies to the next receiveBatch() only. Afterwards receivedTarget() says whether the datagram
+     * landed in it, if not or if it is rejected then unscatterReceive() brings it back to the slot.
+     *
+     * @param index  of the receive slot.
+     * @param target address the datagram is to be received at.
+     * @param length of the target region.
+     */
+    inline void receiveTarget(std::int32_t index, std::uint8_t* target, std::int32_t length)
+    {
+        if (length > RECEIVE_TARGET_HEADER_LENGTH && supportsReceiveTargets())
+        {
+            m_receiveTargets[index] = target;
+            m_receiveTargetLengths[index] = std::min(length, m_receiveBufferLength);
+        }
+    }
+
+    /**
+     * The target the datagram in slot index was received into by the last receiveBatch(), or nullptr if it is held
+     * entirely in the slot. The frame length is then at the start of receiveBuffer(index) and the rest of the datagram
+     * at the same offsets from the target.
+     */
+    inline std::uint8_t* receivedTarget(std::int32_t index) const
+    {
+        return m_receivedTargets[index];
+    }
+
+    inline std::int32_t receivedTargetLength(std::int32_t index) const
+    {
+        return m_receiveTargetLengths[index];
+    }
+
+    /**
+     * Copy the part of a datagram received into a target back into its slot and zero the target region, leaving the
+     * datagram in receiveBuffer(index) as though it had been received there.
+     */
+    void unscatterReceive(std::int32_t index);
+
+    /**
+     * Number of receive calls that returned at least one datagram.
+     */
+    inline std::int64_t receiveBatchCount() const
+    {
+        return m_receiveBatchCount;
+    }
+
+    /**
+     * Number of datagrams received over all receive calls, divide by receiveBatchCount() for datagrams per call.
+     */
+    inline std::int64_t datagramsReceivedCount() const
+    {
+        return m_datagramsReceivedCount;
+    }
+
+    /**
+     * Also count the receive calls that return datagrams, and the datagrams they return, in system counters so the
+     * datagrams per call can be watched on a running driver. Either may be null. The counters are written with
+     * ordered stores, so they must only be given to transports polled from the same thread.
+     */
+    inline void receiveBatchCounters(AtomicCounter* batches, AtomicCounter* datagrams)
+    {
+        m_receiveBatches = batches;
+        m_datagramsReceived = datagrams;
+    }
+
+    /**
+     * As receiveBatchCounters() for the send calls of sendQueued() that send datagrams.
+     */
+    inline void sendBatchCounters(AtomicCounter* batches, AtomicCounter* datagrams)
+    {
+        m_sendBatches = batches;
+        m_datagramsSent = datagrams;
+    }
+
 protected:
     inline AtomicBuffer& receiveBuffer()
     {
-        return m_receiveBuffer;
+        return m_receiveBuffers[0];
     }
 
     inline bool isValidFrame(AtomicBuffer& buffer, std::int32_t length)
@@ -104,16 +407,76 @@ protected:
     }
 
 private:
-    static const int m_receiveBufferLength = 4096;
-
     std::unique_ptr <UdpChannel> m_channel;
     InetAddress* m_endPointAddress;
     InetAddress* m_bindAddress;
     InetAddress* m_connectAddress;
     int m_sendSocketFd;
     int m_recvSocketFd;
-    std::uint8_t m_receiveBufferBytes[m_receiveBufferLength];
-    AtomicBuffer m_receiveBuffer;
+
+    struct ControlMessageBuffer
+    {
+        union
+        {
+            char buffer[CMSG_SPACE(sizeof(int))];
+            cmsghdr align;
+        };
+    };
+
+    const std::int32_t m_receiveBatchSize;
+    const std::int32_t m_receiveBufferLength;
+    std::unique_ptr<std::uint8_t[]> m_receiveBufferBytes;
+    std::vector<ControlMessageBuffer> m_receiveControls;
+    std::vector<std::int32_t> m_receiveSegmentLengths;
+    std::vector<AtomicBuffer> m_receiveBuffers;
+    std::vector<std::unique_ptr<InetAddress>> m_receiveAddresses;
+    std::vector<iovec> m_receiveIovecs;
+    std::vector<mmsghdr> m_receiveMessages;
+    std::vector<std::uint8_t*> m_receiveTargets;
+    std::vector<std::int32_t> m_receiveTargetLengths;
+    std::vector<std::uint8_t*> m_receivedTargets;
+
+    std::int64_t m_receiveBatchCount = 0;
+    std::int64_t m_datagramsReceivedCount = 0;
+    AtomicCounter* m_receiveBatches = nullptr;
+    AtomicCounter* m_datagramsReceived = nullptr;
+    AtomicCounter* m_sendBatches = nullptr;
+    AtomicCounter* m_datagramsSent = nullptr;
+    bool m_groEnabled = false;
+
+    const std::int32_t m_sendBatchSize;
+    std::int32_t m_sendQueueLength = 0;
+    std::vector<iovec> m_sendIovecs;
+    std::vector<InetAddress*> m_sendAddresses;
+    std::vector<iovec> m_sendMessageIovecs;
+    std::vector<mmsghdr> m_sendMessages;
+    std::vector<std::int32_t> m_sendMessageDatagrams;
+    std::vector<ControlMessageBuffer> m_sendControls;
+    bool m_gsoRequested = false;
+    bool m_gsoEnabled = false;
+
+    bool m_zeroCopyRequested = false;
+    bool m_zeroCopyEnabled = false;
+    std::uint32_t m_zeroCopySequence = 0;
+    std::uint32_t m_zeroCopyReleased = 0;
+    std::int64_t m_zeroCopyCopiedCount = 0;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> m_zeroCopyCompletedRanges;
+
+    bool m_ioUringRequested = false;
+    bool m_receiveBuffersRemapped = false;
+    std::unique_ptr<IoUring> m_ioUring;
+    std::vector<IoUring::Received> m_ioUringReceived;
+
+    void allocateReceiveBatch();
+    void restoreReceiveBuffers();
+    std::int32_t receiveBatchFromIoUring(std::int32_t limit);
+    void prepareReceiveMessage(std::int32_t index, bool useTarget);
+    void completeReceiveMessage(std::int32_t index);
+    std::int32_t prepareSendMessages(std::int32_t firstDatagram, bool coalesce);
+    int sendMessages(std::int32_t messageCount, int flags);
+    void onReceiveBatch(std::int32_t datagramCount);
+    void onSendBatch(std::int32_t datagramCount);
+    void onZeroCopyCompletion(std::uint32_t first, std::uint32_t last);
 };
 
 inline std::ostream& operator<<(std::ostream& os, const UdpChannelTransport& dt)
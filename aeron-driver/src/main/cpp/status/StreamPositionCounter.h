@@ -26,6 +26,11 @@ static const std::int32_t PUBLISHER_LIMIT_TYPE_ID = 1;
 static const std::int32_t SENDER_POSITION_TYPE_ID = 2;
 static const std::int32_t RECEIVER_HWM_TYPE_ID = 3;
 static const std::int32_t SUBSCRIBER_POSITION_TYPE_ID = 4;
+static const std::int32_t SENDER_LIMIT_TYPE_ID = 5;
+static const std::int32_t RECEIVER_WINDOW_TYPE_ID = 6;
+static const std::int32_t RECEIVER_CONGESTION_WINDOW_TYPE_ID = 7;
+static const std::int32_t RECEIVER_RTT_TYPE_ID = 8;
+static const std::int32_t RECEIVER_RTT_VARIANCE_TYPE_ID = 9;
 
 #pragma pack(push)
 #pragma pack(4)
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <array>
+
+#include "aeron/concurrent/AtomicCounter.h"
+#include "aeron/concurrent/CountersManager.h"
+
+#include "SystemCounterDescriptor.h"
+
+namespace aeron { namespace driver { namespace status {
+
+const SystemCounterDescriptor SystemCounterDescriptor::BYTES_SENT = SystemCounterDescriptor{0, "Bytes Sent"};
+const SystemCounterDescriptor SystemCounterDescriptor::BYTES_RECEIVED = SystemCounterDescriptor(1, "Bytes received");
+const SystemCounterDescriptor SystemCounterDescriptor::RECEIVER_PROXY_FAILS = SystemCounterDescriptor(2, "Failed offers to ReceiverProxy");
+const SystemCounterDescriptor SystemCounterDescriptor::SENDER_PROXY_FAILS = SystemCounterDescriptor(3, "Failed offers to SenderProxy");
+const SystemCounterDescriptor SystemCounterDescriptor::CONDUCTOR_PROXY_FAILS = SystemCounterDescriptor(4, "Failed offers to DriverConductorProxy");
+const SystemCounterDescriptor SystemCounterDescriptor::NAK_MESSAGES_SENT = SystemCounterDescriptor(5, "NAKs sent");
+const SystemCounterDescriptor SystemCounterDescriptor::NAK_MESSAGES_RECEIVED = SystemCounterDescriptor(6, "NAKs received");
+const SystemCounterDescriptor SystemCounterDescriptor::STATUS_MESSAGES_SENT = SystemCounterDescriptor(7, "Status Messages sent");
+const SystemCounterDescriptor SystemCounterDescriptor::STATUS_MESSAGES_RECEIVED = SystemCounterDescriptor(8, "Status Messages received");
+const SystemCounterDescriptor SystemCounterDescriptor::HEARTBEATS_SENT = SystemCounterDescriptor(9, "Heartbeats sent");
+const SystemCounterDescriptor SystemCounterDescriptor::HEARTBEATS_RECEIVED = SystemCounterDescriptor(10, "Heartbeats received");
+const SystemCounterDescriptor SystemCounterDescriptor::RETRANSMITS_SENT = SystemCounterDescriptor(11, "Retransmits sent");
+const SystemCounterDescriptor SystemCounterDescriptor::FLOW_CONTROL_UNDER_RUNS = SystemCounterDescriptor(12, "Flow control under runs");
+const SystemCounterDescriptor SystemCounterDescriptor::FLOW_CONTROL_OVER_RUNS = SystemCounterDescriptor(13, "Flow control over runs");
+const SystemCounterDescriptor SystemCounterDescriptor::INVALID_PACKETS = SystemCounterDescriptor(14, "Invalid packets");
+const SystemCounterDescriptor SystemCounterDescriptor::ERRORS = SystemCounterDescriptor(15, "Errors");
+const SystemCounterDescriptor SystemCounterDescriptor::DATA_PACKET_SHORT_SENDS = SystemCounterDescriptor(16, "Data Packet short sends");
+const SystemCounterDescriptor SystemCounterDescriptor::SETUP_MESSAGE_SHORT_SENDS = SystemCounterDescriptor(17, "Setup Message short sends");
+const SystemCounterDescriptor SystemCounterDescriptor::STATUS_MESSAGE_SHORT_SENDS = SystemCounterDescriptor(18, "Status Message short sends");
+const SystemCounterDescriptor SystemCounterDescriptor::NAK_MESSAGE_SHORT_SENDS = SystemCounterDescriptor(19, "NAK Message short sends");
+const SystemCounterDescriptor SystemCounterDescriptor::CLIENT_KEEP_ALIVES = SystemCounterDescriptor(20, "Client keep-alives");
+const SystemCounterDescriptor SystemCounterDescriptor::SENDER_FLOW_CONTROL_LIMITS = SystemCounterDescriptor(21, "Sender flow control limits applied");
+const SystemCounterDescriptor SystemCounterDescriptor::UNBLOCKED_PUBLICATIONS = SystemCounterDescriptor(22, "Unblocked Publications");
+const SystemCounterDescriptor SystemCounterDescriptor::UNBLOCKED_COMMANDS = SystemCounterDescriptor(23, "Unblocked Control Commands");
+const SystemCounterDescriptor SystemCounterDescriptor::POSSIBLE_TTL_ASYMMETRY = SystemCounterDescriptor(24, "Possible TTL Asymmetry");
+const SystemCounterDescriptor SystemCounterDescriptor::DATA_RECEIVE_BATCHES = SystemCounterDescriptor(25, "Receive calls returning data");
+const SystemCounterDescriptor SystemCounterDescriptor::DATAGRAMS_RECEIVED_IN_BATCHES = SystemCounterDescriptor(26, "Datagrams returned by data receive calls");
+const SystemCounterDescriptor SystemCounterDescriptor::DATA_SEND_BATCHES = SystemCounterDescriptor(27, "Send calls sending data");
+const SystemCounterDescriptor SystemCounterDescriptor::DATAGRAMS_SENT_IN_BATCHES = SystemCounterDescriptor(28, "Datagrams sent by data send calls");
+const SystemCounterDescriptor SystemCounterDescriptor::CONGESTION_WINDOW_REDUCTIONS = SystemCounterDescriptor(29, "Congestion window reductions");
+const SystemCounterDescriptor SystemCounterDescriptor::HIGH_PRIORITY_QUEUEING_DELAY = SystemCounterDescriptor(30, "Sender queueing delay ns: high priority");
+const SystemCounterDescriptor SystemCounterDescriptor::NORMAL_PRIORITY_QUEUEING_DELAY = SystemCounterDescriptor(31, "Sender queueing delay ns: normal priority");
+const SystemCounterDescriptor SystemCounterDescriptor::LOW_PRIORITY_QUEUEING_DELAY = SystemCounterDescriptor(32, "Sender queueing delay ns: low priority");
+
+const SystemCounterDescriptor::values_t SystemCounterDescriptor::VALUES = {
+    SystemCounterDescriptor::BYTES_SENT,
+    SystemCounterDescriptor::BYTES_RECEIVED,
+    SystemCounterDescriptor::RECEIVER_PROXY_FAILS,
+    SystemCounterDescriptor::SENDER_PROXY_FAILS,
+    SystemCounterDescriptor::CONDUCTOR_PROXY_FAILS,
+    SystemCounterDescriptor::NAK_MESSAGES_SENT,
+    SystemCounterDescriptor::NAK_MESSAGES_RECEIVED,
+    SystemCounterDescriptor::STATUS_MESSAGES_SENT,
+    SystemCounterDescriptor::STATUS_MESSAGES_RECEIVED,
+    SystemCounterDescriptor::HEARTBEATS_SENT,
+    SystemCounterDescriptor::HEARTBEATS_RECEIVED,
+    SystemCounterDescriptor::RETRANSMITS_SENT,
+    SystemCounterDescriptor::FLOW_CONTROL_UNDER_RUNS,
+    SystemCounterDescriptor::FLOW_CONTROL_OVER_RUNS,
+    SystemCounterDescriptor::INVALID_PACKETS,
+    SystemCounterDescriptor::ERRORS,
+    SystemCounterDescriptor::DATA_PACKET_SHORT_SENDS,
+    SystemCounterDescriptor::SETUP_MESSAGE_SHORT_SENDS,
+    SystemCounterDescriptor::STATUS_MESSAGE_SHORT_SENDS,
+    SystemCounterDescriptor::NAK_MESSAGE_SHORT_SENDS,
+    SystemCounterDescriptor::CLIENT_KEEP_ALIVES,
+    SystemCounterDescriptor::SENDER_FLOW_CONTROL_LIMITS,
+    SystemCounterDescriptor::UNBLOCKED_PUBLICATIONS,
+    SystemCounterDescriptor::UNBLOCKED_COMMANDS,
+    SystemCounterDescriptor::POSSIBLE_TTL_ASYMMETRY,
+    SystemCounterDescriptor::DATA_RECEIVE_BATCHES,
+    SystemCounterDescriptor::DATAGRAMS_RECEIVED_IN_BATCHES,
+    SystemCounterDescriptor::DATA_SEND_BATCHES,
+    SystemCounterDescriptor::DATAGRAMS_SENT_IN_BATCHES,
+    SystemCounterDescriptor::CONGESTION_WINDOW_REDUCTIONS,
+    SystemCounterDescriptor::HIGH_PRIORITY_QUEUEING_DELAY,
+    SystemCounterDescriptor::NORMAL_PRIORITY_QUEUEING_DELAY,
+    SystemCounterDescriptor::LOW_PRIORITY_QUEUEING_DELAY
+};
+
+}}};
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+
+#include <gtest/gtest.h>
+
+#include <concurrent/CountersManager.h>
+
+#include "CongestionControl.h"
+
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::status;
+using namespace aeron::driver;
+using namespace testing;
+
+#define SEGMENT_LENGTH (1024)
+#define INITIAL_WINDOW_LENGTH (64 * 1024)
+#define RECEIVER_WINDOW_LENGTH (1024 * 1024)
+#define RTT_NS (1000 * 1000)
+#define SECOND_NS (1000L * 1000 * 1000)
+
+class CongestionControlTest : public Test
+{
+public:
+    CongestionControlTest() :
+        m_metaDataBuffer(&m_metaDataBytes[0], m_metaDataBytes.size()),
+        m_valuesBuffer(&m_valuesBytes[0], m_valuesBytes.size()),
+        m_countersManager(m_metaDataBuffer, m_valuesBuffer),
+        m_windowReductions(m_valuesBuffer, m_countersManager.allocate("window reductions"), m_countersManager)
+    {
+    }
+
+protected:
+    std::array<std::uint8_t, 4096> m_metaDataBytes;
+    std::array<std::uint8_t, 1024> m_valuesBytes;
+    AtomicBuffer m_metaDataBuffer;
+    AtomicBuffer m_valuesBuffer;
+    CountersManager m_countersManager;
+    AtomicCounter m_windowReductions;
+};
+
+TEST_F(CongestionControlTest, shouldAdvertiseReceiverWindowWithStaticWindow)
+{
+    StaticWindowCongestionControl congestionControl;
+
+    congestionControl.onLoss(SECOND_NS);
+
+    EXPECT_EQ(RECEIVER_WINDOW_LENGTH, congestionControl.onStatusMessage(SECOND_NS, RECEIVER_WINDOW_LENGTH));
+}
+
+TEST_F(CongestionControlTest, shouldNotAdvertiseMoreThanReceiverWindowWithCubic)
+{
+    CubicCongestionControl congestionControl{0, INITIAL_WINDOW_LENGTH, SEGMENT_LENGTH};
+
+    EXPECT_EQ(INITIAL_WINDOW_LENGTH, congestionControl.onStatusMessage(0, RECEIVER_WINDOW_LENGTH));
+    EXPECT_EQ(SEGMENT_LENGTH, congestionControl.onStatusMessage(0, SEGMENT_LENGTH));
+}
+
+TEST_F(CongestionControlTest, shouldCutWindowOncePerRttOnLossAndCountIt)
+{
+    CubicCongestionControl congestionControl{0, INITIAL_WINDOW_LENGTH, SEGMENT_LENGTH, &m_windowReductions};
+    congestionControl.onRttMeasurement(0, RTT_NS);
+
+    congestionControl.onLoss(RTT_NS);
+    congestionControl.onLoss(RTT_NS + (RTT_NS / 2));
+
+    const std::int32_t cutWindowLength = (std::int32_t) (INITIAL_WINDOW_LENGTH * CubicCongestionControl::BETA);
+    EXPECT_EQ(cutWindowLength, congestionControl.windowLength());
+    EXPECT_EQ(1, m_windowReductions.get());
+
+    congestionControl.onLoss(2 * RTT_NS);
+
+    EXPECT_EQ((std::int32_t) (cutWindowLength * CubicCongestionControl::BETA), congestionControl.windowLength());
+    EXPECT_EQ(2, m_windowReductions.get());
+}
+
+TEST_F(CongestionControlTest, shouldPublishWindowToPositionOfImage)
+{
+    const std::int32_t windowId = m_countersManager.allocate("congestion window");
+    UnsafeBufferPosition window{m_valuesBuffer, windowId};
+    CubicCongestionControl congestionControl{
+        0, INITIAL_WINDOW_LENGTH, SEGMENT_LENGTH, nullptr,
+        std::unique_ptr<CubicCongestionControl::position_t>(new CubicCongestionControl::position_t(window))};
+    congestionControl.onRttMeasurement(0, RTT_NS);
+
+    EXPECT_EQ(INITIAL_WINDOW_LENGTH, window.get());
+
+    congestionControl.onLoss(RTT_NS);
+
+    EXPECT_EQ(congestionControl.windowLength(), window.get());
+    EXPECT_LT(window.get(), INITIAL_WINDOW_LENGTH);
+
+    congestionControl.onStatusMessage(10 * SECOND_NS, RECEIVER_WINDOW_LENGTH);
+
+    EXPECT_EQ(congestionControl.windowLength(), window.get());
+    EXPECT_GT(window.get(), INITIAL_WINDOW_LENGTH);
+
+    m_countersManager.free(windowId);
+}
+
+TEST_F(CongestionControlTest, shouldGrowBackToWindowAtLossAndThenBeyond)
+{
+    CubicCongestionControl congestionControl{0, INITIAL_WINDOW_LENGTH, SEGMENT_LENGTH};
+    congestionControl.onRttMeasurement(0, RTT_NS);
+    congestionControl.onLoss(SECOND_NS);
+
+    const std::int32_t afterLoss = congestionControl.onStatusMessage(SECOND_NS, RECEIVER_WINDOW_LENGTH);
+    const std::int32_t midway = congestionControl.onStatusMessage(2 * SECOND_NS, RECEIVER_WINDOW_LENGTH);
+    const std::int32_t later = congestionControl.onStatusMessage(10 * SECOND_NS, RECEIVER_WINDOW_LENGTH);
+
+    EXPECT_LT(afterLoss, midway);
+    EXPECT_LT(midway, later);
+    EXPECT_GT(later, INITIAL_WINDOW_LENGTH);
+}
+
+TEST_F(CongestionControlTest, shouldReduceAdvertisedWindowOnLossAfterLongGrowth)
+{
+    CubicCongestionControl congestionControl{0, INITIAL_WINDOW_LENGTH, SEGMENT_LENGTH};
+    congestionControl.onRttMeasurement(0, RTT_NS);
+
+    EXPECT_EQ(RECEIVER_WINDOW_LENGTH, congestionControl.onStatusMessage(100 * SECOND_NS, RECEIVER_WINDOW_LENGTH));
+    EXPECT_EQ(RECEIVER_WINDOW_LENGTH, congestionControl.windowLength());
+
+    congestionControl.onLoss(100 * SECOND_NS);
+    const std::int32_t afterLoss = congestionControl.onStatusMessage(100 * SECOND_NS, RECEIVER_WINDOW_LENGTH);
+
+    EXPECT_LT(afterLoss, RECEIVER_WINDOW_LENGTH);
+    EXPECT_NEAR(RECEIVER_WINDOW_LENGTH * CubicCongestionControl::BETA, afterLoss, SEGMENT_LENGTH);
+}
+
+TEST_F(CongestionControlTest, shouldNotCutWindowBelowTwoSegments)
+{
+    CubicCongestionControl congestionControl{0, 2 * SEGMENT_LENGTH, SEGMENT_LENGTH};
+
+    congestionControl.onLoss(SECOND_NS);
+
+    EXPECT_EQ(2 * SEGMENT_LENGTH, congestionControl.windowLength());
+    EXPECT_EQ(2 * SEGMENT_LENGTH, congestionControl.onStatusMessage(SECOND_NS, RECEIVER_WINDOW_LENGTH));
+}
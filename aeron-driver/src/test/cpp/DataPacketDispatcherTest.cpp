@@ -60,7 +60,7 @@ public:
         m_driverConductorProxy(new MockDriverConductorProxy{}),
         m_receiveChannelEndpoint(UdpChannel::parse("aeron:udp?endpoint=127.0.0.1:4444")),
         m_publicationImage(new MockPublicationImage{}),
-        m_dataPacketDispatcher(m_driverConductorProxy, m_receiver)
+        m_dataPacketDispatcher(m_driverConductorProxy, *m_receiver)
     {
         m_dataBuffer.fill(0);
         m_setupBuffer.fill(0);
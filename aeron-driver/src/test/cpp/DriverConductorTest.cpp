@@ -0,0 +1,561 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <DriverListenerAdapter.h>
+#include <DriverProxy.h>
+#include <concurrent/broadcast/BroadcastBufferDescriptor.h>
+#include <concurrent/ringbuffer/RingBufferDescriptor.h>
+#include <protocol/SetupFlyweight.h>
+
+#include "DriverConductor.h"
+
+using namespace aeron;
+using namespace aeron::command;
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::broadcast;
+using namespace aeron::concurrent::ringbuffer;
+using namespace aeron::driver;
+using namespace aeron::driver::media;
+using namespace testing;
+
+#define STREAM_ID (10)
+#define SESSION_ID (7)
+#define INITIAL_TERM_ID (3)
+#define TERM_LENGTH (LogBufferDescriptor::TERM_MIN_LENGTH)
+#define MTU_LENGTH (4096)
+#define CHANNEL "aeron:udp?endpoint=localhost:9071"
+#define IPC_CHANNEL "aeron:ipc"
+#define SPY_CHANNEL "aeron-spy:" CHANNEL
+#define SETUP_ENDPOINT "127.0.0.1:9071"
+#define AERON_DIR "./driver-conductor-test"
+
+static const std::int64_t CLIENT_LIVENESS_TIMEOUT_NS = 1000L * 1000 * 1000;
+static const std::int64_t IMAGE_LIVENESS_TIMEOUT_NS = 2000L * 1000 * 1000;
+static const std::int64_t PUBLICATION_LINGER_NS = 3000L * 1000 * 1000;
+
+struct DriverResponses
+{
+    std::vector<std::int64_t> publicationsReady;
+    std::vector<std::string> logFileNames;
+    std::vector<std::int32_t> sessionIds;
+    std::vector<std::int32_t> positionLimitCounterIds;
+    std::vector<std::int64_t> operationsSucceeded;
+    std::vector<std::int64_t> availableImages;
+    std::vector<std::int64_t> imageSubscriptions;
+    std::vector<std::int32_t> subscriberPositionIds;
+    std::vector<std::int64_t> unavailableImages;
+    std::vector<std::int32_t> errorCodes;
+
+    void onNewPublication(
+        std::int32_t streamId,
+        std::int32_t sessionId,
+        std::int32_t positionLimitCounterId,
+        const std::string& logFileName,
+        std::int64_t correlationId)
+    {
+        publicationsReady.push_back(correlationId);
+        logFileNames.push_back(logFileName);
+        sessionIds.push_back(sessionId);
+        positionLimitCounterIds.push_back(positionLimitCounterId);
+    }
+
+    void onAvailableImage(
+        std::int32_t streamId,
+        std::int32_t sessionId,
+        const std::string& logFileName,
+        const std::string& sourceIdentity,
+        std::int32_t subscriberPositionCount,
+        const ImageBuffersReadyDefn::SubscriberPosition* subscriberPositions,
+        std::int64_t correlationId)
+    {
+        availableImages.push_back(correlationId);
+        logFileNames.push_back(logFileName);
+
+        for (std::int32_t i = 0; i < subscriberPositionCount; i++)
+        {
+            imageSubscriptions.push_back(subscriberPositions[i].registrationId);
+            subscriberPositionIds.push_back(subscriberPositions[i].indicatorId);
+        }
+    }
+
+    void onOperationSuccess(std::int64_t correlationId)
+    {
+        operationsSucceeded.push_back(correlationId);
+    }
+
+    void onUnavailableImage(std::int32_t streamId, std::int64_t correlationId)
+    {
+        unavailableImages.push_back(correlationId);
+    }
+
+    void onErrorResponse(std::int64_t offendingCommandCorrelationId, std::int32_t errorCode, const std::string& message)
+    {
+        errorCodes.push_back(errorCode);
+    }
+};
+
+class DriverConductorTest : public Test
+{
+public:
+    DriverConductorTest() :
+        m_toDriver(),
+        m_toClients(),
+        m_countersMetadata(),
+        m_countersValues(),
+        m_toDriverBuffer(&m_toDriver[0], m_toDriver.size()),
+        m_toClientsBuffer(&m_toClients[0], m_toClients.size()),
+        m_countersMetadataBuffer(&m_countersMetadata[0], m_countersMetadata.size()),
+        m_countersValuesBuffer(&m_countersValues[0], m_countersValues.size()),
+        m_toDriverCommands(m_toDriverBuffer),
+        m_driverProxy(m_toDriverCommands),
+        m_broadcastReceiver(m_toClientsBuffer),
+        m_copyBroadcastReceiver(m_broadcastReceiver),
+        m_listenerAdapter(m_copyBroadcastReceiver, m_responses),
+        m_sender(std::make_shared<Sender>([&]() { return m_nanoTime; })),
+        m_receiver(std::make_shared<Receiver>([&]() { return m_nanoTime; }))
+    {
+        m_context
+            .threadingMode(SHARED)
+            .aeronDir(AERON_DIR)
+            .termBufferLength(TERM_LENGTH)
+            .mtuLength(MTU_LENGTH)
+            .clientLivenessTimeoutNs(CLIENT_LIVENESS_TIMEOUT_NS)
+            .imageLivenessTimeoutNs(IMAGE_LIVENESS_TIMEOUT_NS)
+            .publicationLingerNs(PUBLICATION_LINGER_NS);
+
+        m_conductor.reset(new DriverConductor(
+            m_context,
+            m_toDriverBuffer,
+            m_toClientsBuffer,
+            m_countersMetadataBuffer,
+            m_countersValuesBuffer,
+            m_sender,
+            m_receiver,
+            [&]() { return m_nanoTime; },
+            [&]() { return m_epochTime; }));
+    }
+
+    virtual void TearDown()
+    {
+        m_conductor.reset();
+        ::rmdir(AERON_DIR "/publications");
+        ::rmdir(AERON_DIR "/images");
+        ::rmdir(AERON_DIR);
+    }
+
+protected:
+    std::array<std::uint8_t, 64 * 1024 + RingBufferDescriptor::TRAILER_LENGTH> m_toDriver;
+    std::array<std::uint8_t, 64 * 1024 + BroadcastBufferDescriptor::TRAILER_LENGTH> m_toClients;
+    std::array<std::uint8_t, 64 * 1024> m_countersMetadata;
+    std::array<std::uint8_t, 16 * 1024> m_countersValues;
+    AtomicBuffer m_toDriverBuffer;
+    AtomicBuffer m_toClientsBuffer;
+    AtomicBuffer m_countersMetadataBuffer;
+    AtomicBuffer m_countersValuesBuffer;
+    ManyToOneRingBuffer m_toDriverCommands;
+    DriverProxy m_driverProxy;
+    BroadcastReceiver m_broadcastReceiver;
+    CopyBroadcastReceiver m_copyBroadcastReceiver;
+    DriverResponses m_responses;
+    DriverListenerAdapter<DriverResponses> m_listenerAdapter;
+    long m_nanoTime = 0;
+    long m_epochTime = 0;
+    MediaDriver::Context m_context;
+    std::shared_ptr<Sender> m_sender;
+    std::shared_ptr<Receiver> m_receiver;
+    std::unique_ptr<DriverConductor> m_conductor;
+
+    void doWorkAndReceive()
+    {
+        m_conductor->doWork();
+        receiveResponses();
+    }
+
+    void receiveResponses()
+    {
+        while (m_listenerAdapter.receiveMessages() > 0)
+        {
+        }
+    }
+
+    void advanceTimeAndDoWork(std::int64_t durationNs)
+    {
+        m_nanoTime += durationNs;
+        doWorkAndReceive();
+    }
+
+    void keepaliveAndAdvanceTimeAndDoWork(std::int64_t durationNs)
+    {
+        m_driverProxy.sendClientKeepalive();
+        advanceTimeAndDoWork(durationNs);
+    }
+
+    std::int64_t counterValue(std::int32_t counterId)
+    {
+        return m_countersValuesBuffer.getInt64Volatile(CountersManager::counterOffset(counterId));
+    }
+
+    static bool fileExists(const std::string& fileName)
+    {
+        return 0 == ::access(fileName.c_str(), F_OK);
+    }
+
+    void sendSetupFrame(std::int32_t sessionId)
+    {
+        std::array<std::uint8_t, sizeof(protocol::SetupDefn)> frame;
+        AtomicBuffer frameBuffer{&frame[0], frame.size()};
+        protocol::SetupFlyweight setup{frameBuffer, 0};
+
+        frameBuffer.setMemory(0, frameBuffer.capacity(), 0);
+        setup
+            .sessionId(sessionId)
+            .streamId(STREAM_ID)
+            .initialTermId(INITIAL_TERM_ID)
+            .actionTermId(INITIAL_TERM_ID)
+            .termOffset(0)
+            .termLength(TERM_LENGTH)
+            .mtu(MTU_LENGTH)
+            .version(protocol::HeaderFlyweight::CURRENT_VERSION)
+            .type(protocol::HeaderFlyweight::HDR_TYPE_SETUP)
+            .frameLength(protocol::SetupFlyweight::headerLength());
+
+        // a plain socket, as a transport would also bind a receive socket to the endpoint port
+        std::unique_ptr<InetAddress> endpoint = InetAddress::parse(SETUP_ENDPOINT);
+        const int socketFd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        ::sendto(socketFd, &frame[0], protocol::SetupFlyweight::headerLength(), 0, endpoint->address(), endpoint->length());
+        ::close(socketFd);
+    }
+
+    void receiveUntilImageCount(std::size_t count)
+    {
+        for (int i = 0; i < 1000 && m_conductor->publicationImageCount() != count; i++)
+        {
+            m_receiver->doWork();
+        }
+
+        receiveResponses();
+    }
+};
+
+TEST_F(DriverConductorTest, shouldAddPublicationWithLogBuffer)
+{
+    const std::int64_t correlationId = m_driverProxy.addPublication(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.publicationsReady.size());
+    EXPECT_EQ(correlationId, m_responses.publicationsReady[0]);
+    EXPECT_TRUE(fileExists(m_responses.logFileNames[0]));
+    EXPECT_EQ(1u, m_conductor->networkPublicationCount());
+    EXPECT_EQ(1u, m_sender->networkPublicationCount());
+    EXPECT_EQ(1u, m_conductor->clientCount());
+}
+
+TEST_F(DriverConductorTest, shouldShareActivePublicationForSameChannelAndStream)
+{
+    m_driverProxy.addPublication(CHANNEL, STREAM_ID);
+    m_driverProxy.addPublication(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(2u, m_responses.publicationsReady.size());
+    EXPECT_EQ(m_responses.sessionIds[0], m_responses.sessionIds[1]);
+    EXPECT_EQ(m_responses.logFileNames[0], m_responses.logFileNames[1]);
+    EXPECT_EQ(1u, m_conductor->networkPublicationCount());
+    EXPECT_EQ(1u, m_conductor->sendChannelEndpointCount());
+}
+
+TEST_F(DriverConductorTest, shouldReplyWithErrorForInvalidChannel)
+{
+    m_driverProxy.addPublication("aeron:tcp?endpoint=localhost:9071", STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.errorCodes.size());
+    EXPECT_EQ(ERROR_CODE_INVALID_CHANNEL, m_responses.errorCodes[0]);
+    EXPECT_EQ(0u, m_conductor->networkPublicationCount());
+}
+
+TEST_F(DriverConductorTest, shouldReplyWithErrorForUnknownPublicationAndSubscription)
+{
+    m_driverProxy.removePublication(42);
+    m_driverProxy.removeSubscription(43);
+    doWorkAndReceive();
+
+    ASSERT_EQ(2u, m_responses.errorCodes.size());
+    EXPECT_EQ(ERROR_CODE_UNKNOWN_PUBLICATION, m_responses.errorCodes[0]);
+    EXPECT_EQ(ERROR_CODE_UNKNOWN_SUBSCRIPTION, m_responses.errorCodes[1]);
+}
+
+TEST_F(DriverConductorTest, shouldLingerRemovedPublicationBeforeDeletingLogBuffer)
+{
+    const std::int64_t registrationId = m_driverProxy.addPublication(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+    const std::string logFileName = m_responses.logFileNames[0];
+
+    const std::int64_t correlationId = m_driverProxy.removePublication(registrationId);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.operationsSucceeded.size());
+    EXPECT_EQ(correlationId, m_responses.operationsSucceeded[0]);
+
+    advanceTimeAndDoWork(DriverConductor::TIMER_INTERVAL_NS + 1);
+    EXPECT_EQ(1u, m_conductor->networkPublicationCount());
+
+    advanceTimeAndDoWork(PUBLICATION_LINGER_NS);
+    EXPECT_EQ(1u, m_conductor->networkPublicationCount());
+    EXPECT_TRUE(fileExists(logFileName));
+
+    advanceTimeAndDoWork(DriverConductor::TIMER_INTERVAL_NS + 1);
+    EXPECT_EQ(0u, m_conductor->networkPublicationCount());
+    EXPECT_EQ(0u, m_sender->networkPublicationCount());
+    EXPECT_EQ(0u, m_conductor->sendChannelEndpointCount());
+    EXPECT_FALSE(fileExists(logFileName));
+}
+
+TEST_F(DriverConductorTest, shouldAddAndRemoveSubscription)
+{
+    const std::int64_t registrationId = m_driverProxy.addSubscription(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.operationsSucceeded.size());
+    EXPECT_EQ(registrationId, m_responses.operationsSucceeded[0]);
+    EXPECT_EQ(1u, m_conductor->subscriptionCount());
+    EXPECT_EQ(1u, m_conductor->receiveChannelEndpointCount());
+
+    const std::int64_t correlationId = m_driverProxy.removeSubscription(registrationId);
+    doWorkAndReceive();
+
+    ASSERT_EQ(2u, m_responses.operationsSucceeded.size());
+    EXPECT_EQ(correlationId, m_responses.operationsSucceeded[1]);
+    EXPECT_EQ(0u, m_conductor->subscriptionCount());
+    EXPECT_EQ(0u, m_conductor->receiveChannelEndpointCount());
+}
+
+TEST_F(DriverConductorTest, shouldTimeoutClientAndRemoveItsResources)
+{
+    m_driverProxy.addPublication(CHANNEL, STREAM_ID);
+    m_driverProxy.addSubscription(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    EXPECT_EQ(1u, m_conductor->clientCount());
+
+    advanceTimeAndDoWork(CLIENT_LIVENESS_TIMEOUT_NS / 2);
+    m_driverProxy.sendClientKeepalive();
+    advanceTimeAndDoWork(CLIENT_LIVENESS_TIMEOUT_NS / 2 + 1);
+    EXPECT_EQ(1u, m_conductor->clientCount());
+
+    advanceTimeAndDoWork(CLIENT_LIVENESS_TIMEOUT_NS + 1);
+    EXPECT_EQ(0u, m_conductor->clientCount());
+    EXPECT_EQ(0u, m_conductor->subscriptionCount());
+    EXPECT_EQ(0u, m_conductor->receiveChannelEndpointCount());
+
+    advanceTimeAndDoWork(PUBLICATION_LINGER_NS + 1);
+    advanceTimeAndDoWork(PUBLICATION_LINGER_NS + 1);
+    EXPECT_EQ(0u, m_conductor->networkPublicationCount());
+}
+
+TEST_F(DriverConductorTest, shouldUpdateConsumerHeartbeatTime)
+{
+    m_epochTime = 12345;
+    advanceTimeAndDoWork(DriverConductor::TIMER_INTERVAL_NS + 1);
+
+    EXPECT_EQ(12345, m_driverProxy.timeOfLastDriverKeepalive());
+}
+
+TEST_F(DriverConductorTest, shouldCreateImageOnSetupAndPutSessionOnCoolDownWhenInactive)
+{
+    const std::int64_t registrationId = m_driverProxy.addSubscription(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    sendSetupFrame(SESSION_ID);
+    receiveUntilImageCount(1);
+
+    ASSERT_EQ(1u, m_conductor->publicationImageCount());
+    ASSERT_EQ(1u, m_responses.availableImages.size());
+    ASSERT_EQ(1u, m_responses.imageSubscriptions.size());
+    EXPECT_EQ(registrationId, m_responses.imageSubscriptions[0]);
+    const std::string logFileName = m_responses.logFileNames[0];
+    EXPECT_TRUE(fileExists(logFileName));
+
+    keepaliveAndAdvanceTimeAndDoWork(IMAGE_LIVENESS_TIMEOUT_NS + 1);
+    keepaliveAndAdvanceTimeAndDoWork(DriverConductor::TIMER_INTERVAL_NS + 1);
+    ASSERT_EQ(1u, m_responses.unavailableImages.size());
+    EXPECT_EQ(m_responses.availableImages[0], m_responses.unavailableImages[0]);
+
+    sendSetupFrame(SESSION_ID);
+    for (int i = 0; i < 100; i++)
+    {
+        m_receiver->doWork();
+    }
+    EXPECT_EQ(1u, m_conductor->publicationImageCount());
+    EXPECT_EQ(1u, m_responses.availableImages.size());
+
+    keepaliveAndAdvanceTimeAndDoWork(IMAGE_LIVENESS_TIMEOUT_NS + 1);
+    EXPECT_EQ(0u, m_conductor->publicationImageCount());
+    EXPECT_FALSE(fileExists(logFileName));
+
+    sendSetupFrame(SESSION_ID);
+    receiveUntilImageCount(1);
+    EXPECT_EQ(1u, m_conductor->publicationImageCount());
+    EXPECT_EQ(2u, m_responses.availableImages.size());
+}
+
+TEST_F(DriverConductorTest, shouldLinkNewSubscriptionToActiveImage)
+{
+    m_driverProxy.addSubscription(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    sendSetupFrame(SESSION_ID);
+    receiveUntilImageCount(1);
+    ASSERT_EQ(1u, m_responses.availableImages.size());
+
+    const std::int64_t registrationId = m_driverProxy.addSubscription(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(2u, m_responses.availableImages.size());
+    EXPECT_EQ(m_responses.availableImages[0], m_responses.availableImages[1]);
+    EXPECT_EQ(registrationId, m_responses.imageSubscriptions[1]);
+    EXPECT_EQ(1u, m_conductor->receiveChannelEndpointCount());
+}
+
+TEST_F(DriverConductorTest, shouldLinkIpcSubscriptionToIpcPublicationWithoutEndpoints)
+{
+    const std::int64_t subscriptionId = m_driverProxy.addSubscription(IPC_CHANNEL, STREAM_ID);
+    const std::int64_t publicationId = m_driverProxy.addPublication(IPC_CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.publicationsReady.size());
+    ASSERT_EQ(1u, m_responses.availableImages.size());
+    EXPECT_EQ(publicationId, m_responses.availableImages[0]);
+    EXPECT_EQ(subscriptionId, m_responses.imageSubscriptions[0]);
+    EXPECT_EQ(m_responses.logFileNames[0], m_responses.logFileNames[1]);
+    EXPECT_EQ(1u, m_conductor->directPublicationCount());
+    EXPECT_EQ(0u, m_conductor->networkPublicationCount());
+    EXPECT_EQ(0u, m_conductor->sendChannelEndpointCount());
+    EXPECT_EQ(0u, m_conductor->receiveChannelEndpointCount());
+    EXPECT_EQ(0u, m_sender->networkPublicationCount());
+
+    const std::int32_t publisherLimitId = m_responses.positionLimitCounterIds[0];
+    const std::int32_t subscriberPositionId = m_responses.subscriberPositionIds[0];
+    EXPECT_EQ(TERM_LENGTH / 2, counterValue(publisherLimitId));
+
+    m_countersValuesBuffer.putInt64Ordered(CountersManager::counterOffset(subscriberPositionId), 1024);
+    doWorkAndReceive();
+    EXPECT_EQ(1024 + (TERM_LENGTH / 2), counterValue(publisherLimitId));
+}
+
+TEST_F(DriverConductorTest, shouldHoldIpcPublisherLimitUntilSubscriberJoins)
+{
+    const std::int64_t publicationId = m_driverProxy.addPublication(IPC_CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.publicationsReady.size());
+    const std::int32_t publisherLimitId = m_responses.positionLimitCounterIds[0];
+    EXPECT_EQ(0, counterValue(publisherLimitId));
+    EXPECT_EQ(0u, m_responses.availableImages.size());
+
+    const std::int64_t subscriptionId = m_driverProxy.addSubscription(IPC_CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.availableImages.size());
+    EXPECT_EQ(publicationId, m_responses.availableImages[0]);
+    EXPECT_EQ(subscriptionId, m_responses.imageSubscriptions[0]);
+    EXPECT_EQ(TERM_LENGTH / 2, counterValue(publisherLimitId));
+
+    m_driverProxy.removeSubscription(subscriptionId);
+    doWorkAndReceive();
+    EXPECT_EQ(0, counterValue(publisherLimitId));
+}
+
+TEST_F(DriverConductorTest, shouldMakeImageUnavailableWhenIpcPublicationRemoved)
+{
+    m_driverProxy.addSubscription(IPC_CHANNEL, STREAM_ID);
+    const std::int64_t publicationId = m_driverProxy.addPublication(IPC_CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+    const std::string logFileName = m_responses.logFileNames[0];
+
+    m_driverProxy.removePublication(publicationId);
+    doWorkAndReceive();
+    EXPECT_EQ(0u, m_responses.unavailableImages.size());
+
+    keepaliveAndAdvanceTimeAndDoWork(DriverConductor::TIMER_INTERVAL_NS + 1);
+    ASSERT_EQ(1u, m_responses.unavailableImages.size());
+    EXPECT_EQ(publicationId, m_responses.unavailableImages[0]);
+    EXPECT_EQ(1u, m_conductor->directPublicationCount());
+    EXPECT_TRUE(fileExists(logFileName));
+
+    keepaliveAndAdvanceTimeAndDoWork(PUBLICATION_LINGER_NS + 1);
+    EXPECT_EQ(0u, m_conductor->directPublicationCount());
+    EXPECT_FALSE(fileExists(logFileName));
+}
+
+TEST_F(DriverConductorTest, shouldLinkSpyToNetworkPublicationAndHoldBackPublisherLimit)
+{
+    const std::int64_t subscriptionId = m_driverProxy.addSubscription(SPY_CHANNEL, STREAM_ID);
+    const std::int64_t publicationId = m_driverProxy.addPublication(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.publicationsReady.size());
+    ASSERT_EQ(1u, m_responses.availableImages.size());
+    EXPECT_EQ(publicationId, m_responses.availableImages[0]);
+    EXPECT_EQ(subscriptionId, m_responses.imageSubscriptions[0]);
+    EXPECT_EQ(m_responses.logFileNames[0], m_responses.logFileNames[1]);
+    EXPECT_EQ(0u, m_conductor->receiveChannelEndpointCount());
+
+    const std::int32_t publisherLimitId = m_responses.positionLimitCounterIds[0];
+    const std::int32_t spyPositionId = m_responses.subscriberPositionIds[0];
+    // the sender position counter is allocated straight after the publisher limit
+    const std::int32_t senderPositionId = publisherLimitId + 1;
+    EXPECT_EQ(TERM_LENGTH / 2, counterValue(publisherLimitId));
+
+    m_countersValuesBuffer.putInt64Ordered(CountersManager::counterOffset(senderPositionId), 4096);
+    doWorkAndReceive();
+    EXPECT_EQ(TERM_LENGTH / 2, counterValue(publisherLimitId));
+
+    m_countersValuesBuffer.putInt64Ordered(CountersManager::counterOffset(spyPositionId), 4096);
+    doWorkAndReceive();
+    EXPECT_EQ(4096 + (TERM_LENGTH / 2), counterValue(publisherLimitId));
+
+    m_driverProxy.removeSubscription(subscriptionId);
+    doWorkAndReceive();
+    EXPECT_EQ(0u, m_conductor->subscriptionCount());
+}
+
+TEST_F(DriverConductorTest, shouldMakeSpyImageUnavailableWhenPublicationRemoved)
+{
+    const std::int64_t publicationId = m_driverProxy.addPublication(CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+    m_driverProxy.addSubscription(SPY_CHANNEL, STREAM_ID);
+    doWorkAndReceive();
+
+    ASSERT_EQ(1u, m_responses.availableImages.size());
+    EXPECT_EQ(publicationId, m_responses.availableImages[0]);
+
+    m_driverProxy.removePublication(publicationId);
+    keepaliveAndAdvanceTimeAndDoWork(DriverConductor::TIMER_INTERVAL_NS + 1);
+    ASSERT_EQ(1u, m_responses.unavailableImages.size());
+    EXPECT_EQ(publicationId, m_responses.unavailableImages[0]);
+
+    keepaliveAndAdvanceTimeAndDoWork(PUBLICATION_LINGER_NS + 1);
+    EXPECT_EQ(0u, m_conductor->networkPublicationCount());
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FeedbackDelayGenerator.h"
+
+using namespace aeron::driver;
+using namespace testing;
+
+#define MAX_BACKOFF_NS (60 * 1000 * 1000)
+
+TEST(FeedbackDelayGeneratorTest, shouldFeedbackImmediatelyOnlyWhenAskedTo)
+{
+    StaticFeedbackDelayGenerator immediate{MAX_BACKOFF_NS, true};
+    StaticFeedbackDelayGenerator delayed{MAX_BACKOFF_NS, false};
+    OptimalMulticastDelayGenerator multicast{MAX_BACKOFF_NS, 10, 7};
+
+    EXPECT_TRUE(immediate.shouldFeedbackImmediately());
+    EXPECT_FALSE(delayed.shouldFeedbackImmediately());
+    EXPECT_FALSE(multicast.shouldFeedbackImmediately());
+    EXPECT_EQ(MAX_BACKOFF_NS, immediate.generateDelay());
+}
+
+TEST(FeedbackDelayGeneratorTest, shouldGenerateMulticastDelaysWithinMaxBackoff)
+{
+    OptimalMulticastDelayGenerator generator{MAX_BACKOFF_NS, 10, 7};
+
+    for (int i = 0; i < 10000; i++)
+    {
+        const std::int64_t delay = generator.generateDelay();
+
+        ASSERT_GE(delay, 0);
+        ASSERT_LE(delay, MAX_BACKOFF_NS);
+    }
+}
+
+TEST(FeedbackDelayGeneratorTest, shouldFavourLateDelaysMoreForLargerGroups)
+{
+    OptimalMulticastDelayGenerator smallGroup{MAX_BACKOFF_NS, 2, 7};
+    OptimalMulticastDelayGenerator largeGroup{MAX_BACKOFF_NS, 1000, 7};
+    const std::int64_t earlyDelay = MAX_BACKOFF_NS / 10;
+    int smallGroupEarly = 0;
+    int largeGroupEarly = 0;
+
+    for (int i = 0; i < 10000; i++)
+    {
+        smallGroupEarly += smallGroup.generateDelay() < earlyDelay ? 1 : 0;
+        largeGroupEarly += largeGroup.generateDelay() < earlyDelay ? 1 : 0;
+    }
+
+    EXPECT_GT(smallGroupEarly, largeGroupEarly);
+}
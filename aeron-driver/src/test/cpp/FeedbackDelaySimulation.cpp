@@ -0,0 +1,137 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "FeedbackDelayGenerator.h"
+
+using namespace aeron::driver;
+
+/*
+ * Simulation of NAK implosion in a multicast group.
+ *
+ * Each of the packets sent is lost by each receiver independently with the loss rate. Every receiver that loses it
+ * waits for a delay from its FeedbackDelayGenerator before it NAKs. The first NAK reaches the sender, which
+ * retransmits, and the retransmit reaches every receiver one round trip after that first NAK. Receivers whose delay
+ * runs out before the retransmit arrives NAK too; the rest are suppressed by it.
+ *
+ * Prints the NAKs sent per lost packet and the mean time to recover it, for immediate feedback and for the optimal
+ * multicast backoff tuned for the default group size and for the actual group size.
+ *
+ * Usage: feedbackDelaySimulation [rtt us] [max backoff us] [packets]
+ */
+
+struct Outcome
+{
+    double naksPerLoss;
+    double recoveryUs;
+};
+
+static Outcome simulate(
+    std::int32_t groupSize,
+    double lossRate,
+    std::int64_t rttNs,
+    std::int64_t packets,
+    FeedbackDelayGenerator& generator,
+    std::default_random_engine& random)
+{
+    std::bernoulli_distribution isLost(lossRate);
+    std::vector<std::int64_t> delays;
+    std::int64_t lossEvents = 0;
+    std::int64_t naks = 0;
+    double recoveryNs = 0;
+
+    for (std::int64_t packet = 0; packet < packets; packet++)
+    {
+        delays.clear();
+        for (std::int32_t receiver = 0; receiver < groupSize; receiver++)
+        {
+            if (isLost(random))
+            {
+                delays.push_back(generator.shouldFeedbackImmediately() ? 0 : generator.generateDelay());
+            }
+        }
+
+        if (delays.empty())
+        {
+            continue;
+        }
+
+        const std::int64_t firstNak = *std::min_element(delays.begin(), delays.end());
+        const std::int64_t retransmitArrives = firstNak + rttNs;
+
+        lossEvents++;
+        naks += std::count_if(
+            delays.begin(), delays.end(), [&](std::int64_t delay) { return delay < retransmitArrives; });
+        recoveryNs += retransmitArrives;
+    }
+
+    if (0 == lossEvents)
+    {
+        return Outcome{0, 0};
+    }
+
+    return Outcome{(double) naks / lossEvents, recoveryNs / lossEvents / 1000.0};
+}
+
+int main(int argc, char** argv)
+{
+    const std::int64_t rttNs = (argc > 1 ? std::atoll(argv[1]) : 1000) * 1000;
+    const std::int64_t maxBackoffNs = (argc > 2 ? std::atoll(argv[2]) : 60000) * 1000;
+    const std::int64_t packets = argc > 3 ? std::atoll(argv[3]) : 100000;
+    const std::int32_t defaultGroupSize = 10;
+
+    std::default_random_engine random(42);
+    StaticFeedbackDelayGenerator immediate{0, true};
+    OptimalMulticastDelayGenerator defaultOptimal{maxBackoffNs, defaultGroupSize, 42};
+
+    std::printf(
+        "rtt=%lldus max backoff=%lldus packets=%lld\n",
+        (long long) (rttNs / 1000), (long long) (maxBackoffNs / 1000), (long long) packets);
+    std::printf(
+        "%8s %8s | %12s | %12s %12s | %12s %12s\n",
+        "group", "loss", "immediate", "optimal(10)", "recovery us", "optimal(N)", "recovery us");
+
+    for (std::int32_t groupSize : { 1, 10, 100, 1000 })
+    {
+        OptimalMulticastDelayGenerator tunedOptimal{maxBackoffNs, groupSize, 42};
+
+        for (double lossRate : { 0.001, 0.01, 0.1 })
+        {
+            const std::int64_t trials = std::max<std::int64_t>(1, packets / groupSize);
+            const Outcome immediateOutcome = simulate(groupSize, lossRate, rttNs, trials, immediate, random);
+            const Outcome defaultOutcome = simulate(groupSize, lossRate, rttNs, trials, defaultOptimal, random);
+            const Outcome tunedOutcome = simulate(groupSize, lossRate, rttNs, trials, tunedOptimal, random);
+
+            std::printf(
+                "%8d %8.3f | %12.2f | %12.2f %12.0f | %12.2f %12.0f\n",
+                groupSize,
+                lossRate,
+                immediateOutcome.naksPerLoss,
+                defaultOutcome.naksPerLoss,
+                defaultOutcome.recoveryUs,
+                tunedOutcome.naksPerLoss,
+                tunedOutcome.recoveryUs);
+        }
+    }
+
+    return 0;
+}
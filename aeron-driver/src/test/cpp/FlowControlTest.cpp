@@ -0,0 +1,126 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+
+#include <gtest/gtest.h>
+
+#include "FlowControl.h"
+
+using namespace aeron::concurrent;
+using namespace aeron::driver;
+using namespace aeron::driver::media;
+using namespace aeron::protocol;
+using namespace testing;
+
+#define INITIAL_TERM_ID (3)
+#define POSITION_BITS_TO_SHIFT (16)
+#define WINDOW_LENGTH (4096)
+
+class FlowControlTest : public Test
+{
+public:
+    FlowControlTest() :
+        m_smBuffer(&m_smBytes[0], m_smBytes.size()),
+        m_statusMessage(m_smBuffer, 0),
+        m_firstReceiver(InetAddress::fromIPv4("127.0.0.1", 40001)),
+        m_secondReceiver(InetAddress::fromIPv4("127.0.0.2", 40001))
+    {
+        m_smBytes.fill(0);
+    }
+
+protected:
+    std::array<std::uint8_t, StatusMessageFlyweight::headerLength()> m_smBytes;
+    AtomicBuffer m_smBuffer;
+    StatusMessageFlyweight m_statusMessage;
+    std::unique_ptr<InetAddress> m_firstReceiver;
+    std::unique_ptr<InetAddress> m_secondReceiver;
+
+    std::int64_t onStatusMessage(
+        FlowControl& flowControl,
+        InetAddress& receiver,
+        std::int32_t termOffset,
+        std::int64_t senderLimit,
+        std::int64_t nowNs = 0)
+    {
+        m_statusMessage
+            .consumptionTermId(INITIAL_TERM_ID)
+            .consumptionTermOffset(termOffset)
+            .receiverWindow(WINDOW_LENGTH);
+
+        return flowControl.onStatusMessage(
+            m_statusMessage, receiver, senderLimit, INITIAL_TERM_ID, POSITION_BITS_TO_SHIFT, nowNs);
+    }
+};
+
+TEST_F(FlowControlTest, shouldNotMoveUnicastLimitBackwards)
+{
+    UnicastFlowControl flowControl;
+
+    EXPECT_EQ(1024 + WINDOW_LENGTH, onStatusMessage(flowControl, *m_firstReceiver, 1024, 0));
+    EXPECT_EQ(2048 + WINDOW_LENGTH, onStatusMessage(flowControl, *m_firstReceiver, 1024, 2048 + WINDOW_LENGTH));
+}
+
+TEST_F(FlowControlTest, shouldFollowFastestReceiverWithMaxMulticast)
+{
+    MaxMulticastFlowControl flowControl;
+
+    std::int64_t senderLimit = onStatusMessage(flowControl, *m_firstReceiver, 8192, 0);
+    senderLimit = onStatusMessage(flowControl, *m_secondReceiver, 1024, senderLimit);
+
+    EXPECT_EQ(8192 + WINDOW_LENGTH, senderLimit);
+}
+
+TEST_F(FlowControlTest, shouldHoldBackToSlowestReceiverWithMinMulticast)
+{
+    MinMulticastFlowControl flowControl;
+
+    std::int64_t senderLimit = onStatusMessage(flowControl, *m_firstReceiver, 8192, 0);
+    EXPECT_EQ(8192 + WINDOW_LENGTH, senderLimit);
+
+    senderLimit = onStatusMessage(flowControl, *m_secondReceiver, 1024, senderLimit);
+    EXPECT_EQ(1024 + WINDOW_LENGTH, senderLimit);
+    EXPECT_EQ(2u, flowControl.receiverCount());
+
+    senderLimit = onStatusMessage(flowControl, *m_secondReceiver, 16384, senderLimit);
+    EXPECT_EQ(8192 + WINDOW_LENGTH, senderLimit);
+    EXPECT_EQ(2u, flowControl.receiverCount());
+}
+
+TEST_F(FlowControlTest, shouldDropTimedOutReceiverWithMinMulticast)
+{
+    const std::int64_t timeoutNs = 1000;
+    MinMulticastFlowControl flowControl{timeoutNs};
+
+    std::int64_t senderLimit = onStatusMessage(flowControl, *m_firstReceiver, 1024, 0, 0);
+    senderLimit = onStatusMessage(flowControl, *m_secondReceiver, 8192, senderLimit, timeoutNs);
+    EXPECT_EQ(1024 + WINDOW_LENGTH, senderLimit);
+
+    EXPECT_EQ(senderLimit, flowControl.onIdle(timeoutNs, senderLimit));
+    EXPECT_EQ(8192 + WINDOW_LENGTH, flowControl.onIdle(timeoutNs + 1, senderLimit));
+    EXPECT_EQ(1u, flowControl.receiverCount());
+}
+
+TEST_F(FlowControlTest, shouldKeepSenderLimitWhenAllReceiversTimedOutWithMinMulticast)
+{
+    const std::int64_t timeoutNs = 1000;
+    MinMulticastFlowControl flowControl{timeoutNs};
+
+    const std::int64_t senderLimit = onStatusMessage(flowControl, *m_firstReceiver, 1024, 0, 0);
+
+    EXPECT_EQ(senderLimit, flowControl.onIdle(timeoutNs + 1, senderLimit));
+    EXPECT_EQ(0u, flowControl.receiverCount());
+}
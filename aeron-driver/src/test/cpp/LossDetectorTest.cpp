@@ -0,0 +1,192 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "LossDetector.h"
+
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::logbuffer;
+using namespace aeron::driver;
+using namespace testing;
+
+#define TERM_LENGTH (64 * 1024)
+#define POSITION_BITS_TO_SHIFT (16)
+#define INITIAL_TERM_ID (3)
+#define FRAME_LENGTH (1024)
+#define DELAY_NS (20)
+
+typedef std::tuple<std::int32_t, std::int32_t, std::int32_t> nak_t;
+
+class LossDetectorTest : public Test
+{
+public:
+    LossDetectorTest() :
+        m_termBuffer(&m_termBytes[0], m_termBytes.size()),
+        m_immediate(DELAY_NS, true),
+        m_delayed(DELAY_NS, false)
+    {
+        m_termBytes.fill(0);
+    }
+
+protected:
+    std::array<std::uint8_t, TERM_LENGTH> m_termBytes;
+    AtomicBuffer m_termBuffer;
+    StaticFeedbackDelayGenerator m_immediate;
+    StaticFeedbackDelayGenerator m_delayed;
+    std::vector<nak_t> m_naks;
+
+    LossDetector newLossDetector(FeedbackDelayGenerator& delayGenerator, std::int32_t coalesceLength = 0)
+    {
+        return LossDetector(
+            delayGenerator,
+            [&](std::int32_t termId, std::int32_t termOffset, std::int32_t length)
+            {
+                m_naks.push_back(nak_t{termId, termOffset, length});
+            },
+            coalesceLength);
+    }
+
+    void insertFrame(std::int32_t termOffset)
+    {
+        FrameDescriptor::frameLengthOrdered(m_termBuffer, termOffset, FRAME_LENGTH);
+    }
+
+    std::int32_t scan(
+        LossDetector& lossDetector, std::int64_t rebuildPosition, std::int64_t hwmPosition, std::int64_t nowNs)
+    {
+        return lossDetector.scan(
+            m_termBuffer,
+            rebuildPosition,
+            hwmPosition,
+            nowNs,
+            TERM_LENGTH - 1,
+            POSITION_BITS_TO_SHIFT,
+            INITIAL_TERM_ID);
+    }
+};
+
+TEST_F(LossDetectorTest, shouldNotNakWhenNoGap)
+{
+    LossDetector lossDetector = newLossDetector(m_immediate);
+    insertFrame(0);
+    insertFrame(FRAME_LENGTH);
+
+    EXPECT_EQ(0, scan(lossDetector, 0, 2 * FRAME_LENGTH, 0));
+    EXPECT_EQ(0u, lossDetector.activeGapCount());
+    EXPECT_TRUE(m_naks.empty());
+}
+
+TEST_F(LossDetectorTest, shouldNakEveryGapInOneScan)
+{
+    LossDetector lossDetector = newLossDetector(m_immediate);
+    insertFrame(FRAME_LENGTH);
+    insertFrame(3 * FRAME_LENGTH);
+    insertFrame(6 * FRAME_LENGTH);
+
+    EXPECT_EQ(3, scan(lossDetector, 0, 7 * FRAME_LENGTH, 0));
+
+    ASSERT_EQ(3u, m_naks.size());
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID, 0, FRAME_LENGTH), m_naks[0]);
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID, 2 * FRAME_LENGTH, FRAME_LENGTH), m_naks[1]);
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID, 4 * FRAME_LENGTH, 2 * FRAME_LENGTH), m_naks[2]);
+}
+
+TEST_F(LossDetectorTest, shouldCoalesceGapsSeparatedByLessThanCoalesceLength)
+{
+    LossDetector lossDetector = newLossDetector(m_immediate, FRAME_LENGTH);
+    insertFrame(FRAME_LENGTH);
+    insertFrame(3 * FRAME_LENGTH);
+    insertFrame(4 * FRAME_LENGTH);
+    insertFrame(6 * FRAME_LENGTH);
+
+    EXPECT_EQ(2, scan(lossDetector, 0, 7 * FRAME_LENGTH, 0));
+
+    ASSERT_EQ(2u, m_naks.size());
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID, 0, 3 * FRAME_LENGTH), m_naks[0]);
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID, 5 * FRAME_LENGTH, FRAME_LENGTH), m_naks[1]);
+}
+
+TEST_F(LossDetectorTest, shouldNakGapUpToHeartbeatPosition)
+{
+    LossDetector lossDetector = newLossDetector(m_immediate);
+    insertFrame(0);
+
+    EXPECT_EQ(1, scan(lossDetector, FRAME_LENGTH, 3 * FRAME_LENGTH, 0));
+
+    ASSERT_EQ(1u, m_naks.size());
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID, FRAME_LENGTH, 2 * FRAME_LENGTH), m_naks[0]);
+}
+
+TEST_F(LossDetectorTest, shouldWaitForDelayBeforeNakingWhenNotImmediate)
+{
+    LossDetector lossDetector = newLossDetector(m_delayed);
+    insertFrame(FRAME_LENGTH);
+
+    EXPECT_EQ(0, scan(lossDetector, 0, 2 * FRAME_LENGTH, 0));
+    EXPECT_EQ(1u, lossDetector.activeGapCount());
+    EXPECT_EQ(0, scan(lossDetector, 0, 2 * FRAME_LENGTH, DELAY_NS - 1));
+    EXPECT_EQ(1, scan(lossDetector, 0, 2 * FRAME_LENGTH, DELAY_NS));
+
+    ASSERT_EQ(1u, m_naks.size());
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID, 0, FRAME_LENGTH), m_naks[0]);
+}
+
+TEST_F(LossDetectorTest, shouldRepeatNakEveryDelayUntilGapFilled)
+{
+    LossDetector lossDetector = newLossDetector(m_immediate);
+    insertFrame(FRAME_LENGTH);
+
+    EXPECT_EQ(1, scan(lossDetector, 0, 2 * FRAME_LENGTH, 0));
+    EXPECT_EQ(0, scan(lossDetector, 0, 2 * FRAME_LENGTH, DELAY_NS - 1));
+    EXPECT_EQ(1, scan(lossDetector, 0, 2 * FRAME_LENGTH, DELAY_NS));
+
+    insertFrame(0);
+
+    EXPECT_EQ(0, scan(lossDetector, 2 * FRAME_LENGTH, 2 * FRAME_LENGTH, 2 * DELAY_NS));
+    EXPECT_EQ(0u, lossDetector.activeGapCount());
+    EXPECT_EQ(2u, m_naks.size());
+}
+
+TEST_F(LossDetectorTest, shouldKeepTimerOfGapThatIsPartlyFilled)
+{
+    LossDetector lossDetector = newLossDetector(m_delayed);
+    insertFrame(3 * FRAME_LENGTH);
+
+    EXPECT_EQ(0, scan(lossDetector, 0, 4 * FRAME_LENGTH, 0));
+
+    insertFrame(0);
+
+    EXPECT_EQ(1, scan(lossDetector, FRAME_LENGTH, 4 * FRAME_LENGTH, DELAY_NS));
+
+    ASSERT_EQ(1u, m_naks.size());
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID, FRAME_LENGTH, 2 * FRAME_LENGTH), m_naks[0]);
+}
+
+TEST_F(LossDetectorTest, shouldOnlyScanToEndOfTermAndUseTermIdOfRebuildPosition)
+{
+    LossDetector lossDetector = newLossDetector(m_immediate);
+    const std::int64_t rebuildPosition = (2L * TERM_LENGTH) + TERM_LENGTH - FRAME_LENGTH;
+
+    EXPECT_EQ(1, scan(lossDetector, rebuildPosition, rebuildPosition + (3 * FRAME_LENGTH), 0));
+
+    ASSERT_EQ(1u, m_naks.size());
+    EXPECT_EQ(nak_t(INITIAL_TERM_ID + 2, TERM_LENGTH - FRAME_LENGTH, FRAME_LENGTH), m_naks[0]);
+}
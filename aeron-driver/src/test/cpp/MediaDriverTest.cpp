@@ -0,0 +1,210 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Context.h>
+#include <CncFileDescriptor.h>
+#include <DriverListenerAdapter.h>
+#include <DriverProxy.h>
+
+#include "media/UdpChannel.h"
+#include "media/UdpChannelTransport.h"
+#include "MediaDriver.h"
+
+using namespace aeron;
+using namespace aeron::command;
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::broadcast;
+using namespace aeron::concurrent::ringbuffer;
+using namespace aeron::driver;
+using namespace aeron::driver::media;
+using namespace testing;
+
+#define STREAM_ID (10)
+#define BASE_PORT (9073)
+#define AERON_DIR "./media-driver-test"
+
+struct ClientResponses
+{
+    std::vector<std::int64_t> publicationsReady;
+    std::vector<std::int64_t> operationsSucceeded;
+    std::vector<std::int64_t> imageSubscriptions;
+
+    void onNewPublication(
+        std::int32_t streamId,
+        std::int32_t sessionId,
+        std::int32_t positionLimitCounterId,
+        const std::string& logFileName,
+        std::int64_t correlationId)
+    {
+        publicationsReady.push_back(correlationId);
+    }
+
+    void onAvailableImage(
+        std::int32_t streamId,
+        std::int32_t sessionId,
+        const std::string& logFileName,
+        const std::string& sourceIdentity,
+        std::int32_t subscriberPositionCount,
+        const ImageBuffersReadyDefn::SubscriberPosition* subscriberPositions,
+        std::int64_t correlationId)
+    {
+        for (std::int32_t i = 0; i < subscriberPositionCount; i++)
+        {
+            imageSubscriptions.push_back(subscriberPositions[i].registrationId);
+        }
+    }
+
+    void onOperationSuccess(std::int64_t correlationId)
+    {
+        operationsSucceeded.push_back(correlationId);
+    }
+
+    void onUnavailableImage(std::int32_t streamId, std::int64_t correlationId)
+    {
+    }
+
+    void onErrorResponse(std::int64_t offendingCommandCorrelationId, std::int32_t errorCode, const std::string& message)
+    {
+    }
+};
+
+class MediaDriverTest : public TestWithParam<ThreadingMode>
+{
+public:
+    MediaDriverTest()
+    {
+        m_context
+            .aeronDir(AERON_DIR)
+            .threadingMode(GetParam())
+            .termBufferLength(64 * 1024)
+            .toDriverBufferLength(64 * 1024)
+            .toClientsBufferLength(64 * 1024)
+            .counterValuesBufferLength(64 * 1024);
+    }
+
+    virtual void TearDown()
+    {
+        ::unlink((std::string(AERON_DIR) + "/" + CncFileDescriptor::CNC_FILE).c_str());
+        ::rmdir(AERON_DIR "/publications");
+        ::rmdir(AERON_DIR "/images");
+        ::rmdir(AERON_DIR);
+    }
+
+protected:
+    MediaDriver::Context m_context;
+
+    // each threading mode has its own port, so a socket the driver of another is slow to let go of is not in the way
+    std::string channel() const
+    {
+        return "aeron:udp?endpoint=localhost:" + std::to_string(BASE_PORT + GetParam());
+    }
+
+    static bool awaitCondition(const std::function<bool()>& condition, const std::function<void()>& poll)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+
+            poll();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return true;
+    }
+};
+
+TEST_P(MediaDriverTest, shouldRunAgentsOnThreadsForThreadingMode)
+{
+    MediaDriver driver{m_context};
+    driver.start();
+
+    switch (GetParam())
+    {
+        case DEDICATED:
+            EXPECT_EQ(3u, driver.agentRunnerCount());
+            break;
+
+        case SHARED_NETWORK:
+            EXPECT_EQ(2u, driver.agentRunnerCount());
+            break;
+
+        case SHARED:
+            EXPECT_EQ(1u, driver.agentRunnerCount());
+            break;
+    }
+
+    driver.close();
+    EXPECT_EQ(0u, driver.agentRunnerCount());
+}
+
+TEST_P(MediaDriverTest, shouldServiceClientThroughCncFile)
+{
+    MediaDriver driver{m_context};
+    driver.start();
+
+    MemoryMappedFile::ptr_t cncFile =
+        MemoryMappedFile::mapExisting((std::string(AERON_DIR) + "/" + CncFileDescriptor::CNC_FILE).c_str());
+    ASSERT_EQ(CncFileDescriptor::CNC_VERSION, CncFileDescriptor::cncVersion(cncFile));
+
+    AtomicBuffer toDriverBuffer = CncFileDescriptor::createToDriverBuffer(cncFile);
+    AtomicBuffer toClientsBuffer = CncFileDescriptor::createToClientsBuffer(cncFile);
+    ManyToOneRingBuffer toDriverCommands{toDriverBuffer};
+    DriverProxy driverProxy{toDriverCommands};
+    BroadcastReceiver broadcastReceiver{toClientsBuffer};
+    CopyBroadcastReceiver copyBroadcastReceiver{broadcastReceiver};
+    ClientResponses responses;
+    DriverListenerAdapter<ClientResponses> listenerAdapter{copyBroadcastReceiver, responses};
+
+    auto receiveResponses = [&]()
+    {
+        while (listenerAdapter.receiveMessages() > 0)
+        {
+        }
+    };
+
+    const std::int64_t publicationId = driverProxy.addPublication(channel(), STREAM_ID);
+    ASSERT_TRUE(awaitCondition([&]() { return !responses.publicationsReady.empty(); }, receiveResponses));
+    EXPECT_EQ(publicationId, responses.publicationsReady[0]);
+
+    const std::int64_t subscriptionId = driverProxy.addSubscription(channel(), STREAM_ID);
+    ASSERT_TRUE(awaitCondition([&]() { return !responses.imageSubscriptions.empty(); }, receiveResponses));
+    EXPECT_EQ(subscriptionId, responses.operationsSucceeded[0]);
+    EXPECT_EQ(subscriptionId, responses.imageSubscriptions[0]);
+
+    driver.close();
+
+    std::unique_ptr<UdpChannel> udpChannel = UdpChannel::parse(channel().c_str());
+    UdpChannelTransport transport{udpChannel, &udpChannel->remoteData(), &udpChannel->remoteData(), nullptr};
+    EXPECT_NO_THROW(transport.openDatagramChannel());
+}
+
+INSTANTIATE_TEST_CASE_P(
+    ThreadingModes, MediaDriverTest, Values(DEDICATED, SHARED_NETWORK, SHARED));
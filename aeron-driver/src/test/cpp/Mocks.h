@@ -17,13 +17,18 @@ namespace aeron { namespace driver { namespace media {
 class MockReceiveChannelEndpoint : public ReceiveChannelEndpoint
 {
 public:
-    MockReceiveChannelEndpoint(std::unique_ptr<UdpChannel>&& channel) : ReceiveChannelEndpoint(std::move(channel))
+    MockReceiveChannelEndpoint(
+        std::unique_ptr<UdpChannel>&& channel, std::shared_ptr<DataPacketDispatcher> dispatcher = nullptr)
+        : ReceiveChannelEndpoint(std::move(channel), std::move(dispatcher))
     { }
 
     virtual ~MockReceiveChannelEndpoint() = default;
 
     MOCK_METHOD0(pollForData, std::int32_t());
     MOCK_METHOD3(sendSetupElicitingStatusMessage, void(InetAddress &address, std::int32_t sessionId, std::int32_t streamId));
+    MOCK_METHOD6(sendNakMessage, void(InetAddress &address, std::int32_t sessionId, std::int32_t streamId, std::int32_t termId, std::int32_t termOffset, std::int32_t length));
+    MOCK_METHOD4(sendRttMeasurement, void(InetAddress &address, std::int32_t sessionId, std::int32_t streamId, std::int64_t echoTimestampNs));
+    MOCK_METHOD6(queueStatusMessage, void(InetAddress &address, std::int32_t sessionId, std::int32_t streamId, std::int32_t termId, std::int32_t termOffset, std::int32_t receiverWindow));
 };
 
 }}};
@@ -34,13 +39,17 @@ class MockPublicationImage : public PublicationImage
 {
 public:
     MockPublicationImage() : PublicationImage(
-        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
         std::unique_ptr<MappedRawLog>(nullptr),
         std::shared_ptr<InetAddress>(nullptr),
         std::shared_ptr<InetAddress>(nullptr),
         std::shared_ptr<ReceiveChannelEndpoint>(nullptr),
         std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>>(nullptr),
         std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<CongestionControl>(new StaticWindowCongestionControl()),
         m_delayGenerator,
         mockCurrentTime
     ){}
@@ -0,0 +1,292 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+
+#include <gtest/gtest.h>
+
+#include <concurrent/CountersManager.h>
+#include <protocol/DataHeaderFlyweight.h>
+
+#include "media/ReceiveChannelEndpoint.h"
+#include "PublicationImage.h"
+
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::logbuffer;
+using namespace aeron::driver;
+using namespace aeron::driver::media;
+using namespace testing;
+
+#define SESSION_ID (1)
+#define STREAM_ID (10)
+#define INITIAL_TERM_ID (3)
+#define TERM_LENGTH (LogBufferDescriptor::TERM_MIN_LENGTH)
+#define WINDOW_LENGTH (4096)
+#define DATAGRAM_LENGTH (1024)
+
+typedef std::array<std::uint8_t, DATAGRAM_LENGTH> datagram_t;
+
+class PublicationImageTest : public Test
+{
+public:
+    PublicationImageTest() :
+        m_countersBuffer(&m_counterBytes[0], m_counterBytes.size()),
+        m_packet(&m_packetBytes[0], m_packetBytes.size()),
+        m_delayGenerator(0, false)
+    {
+        m_counterBytes.fill(0);
+
+        std::unique_ptr<MappedRawLog> rawLog{new MappedRawLog{"./publication-image-test.map", true, TERM_LENGTH}};
+        m_termBuffer = &rawLog->termBuffer(0);
+        UnsafeBufferPosition hwmPosition{m_countersBuffer, 0};
+
+        m_image = std::make_shared<PublicationImage>(
+            1, 0, 0, SESSION_ID, STREAM_ID, INITIAL_TERM_ID, INITIAL_TERM_ID, 0, WINDOW_LENGTH, 0,
+            std::move(rawLog),
+            nullptr,
+            nullptr,
+            nullptr,
+            std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>>(
+                new std::vector<ReadablePosition<UnsafeBufferPosition>>()),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(hwmPosition)),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+            std::unique_ptr<CongestionControl>(new StaticWindowCongestionControl()),
+            m_delayGenerator,
+            []() { return 0L; });
+    }
+
+protected:
+    std::array<std::uint8_t, 4096> m_counterBytes;
+    AtomicBuffer m_countersBuffer;
+    datagram_t m_packetBytes;
+    AtomicBuffer m_packet;
+    StaticFeedbackDelayGenerator m_delayGenerator;
+    AtomicBuffer* m_termBuffer;
+    PublicationImage::ptr_t m_image;
+
+    std::int64_t hwmPosition()
+    {
+        return *reinterpret_cast<std::int64_t*>(&m_counterBytes[CountersManager::counterOffset(0)]);
+    }
+
+    std::int32_t insertFrame(std::int32_t termOffset, std::uint8_t fill)
+    {
+        return insertFrame(*m_image, INITIAL_TERM_ID, termOffset, fill);
+    }
+
+    std::int32_t insertFrame(PublicationImage& image, std::int32_t termId, std::int32_t termOffset, std::uint8_t fill)
+    {
+        m_packetBytes.fill(fill);
+
+        aeron::protocol::DataHeaderFlyweight header{m_packet, 0};
+        header.sessionId(SESSION_ID)
+            .streamId(STREAM_ID)
+            .termId(termId)
+            .termOffset(termOffset)
+            .version(DataFrameHeader::CURRENT_VERSION)
+            .flags((std::int8_t) FrameDescriptor::UNFRAGMENTED)
+            .type(DataFrameHeader::HDR_TYPE_DATA)
+            .frameLength(DATAGRAM_LENGTH);
+
+        return image.insertPacket(termId, termOffset, m_packet, DATAGRAM_LENGTH);
+    }
+
+    std::int32_t insertPaddingHeader(
+        PublicationImage& image, std::int32_t termId, std::int32_t termOffset, std::int32_t frameLength)
+    {
+        aeron::protocol::DataHeaderFlyweight header{m_packet, 0};
+        header.sessionId(SESSION_ID)
+            .streamId(STREAM_ID)
+            .termId(termId)
+            .termOffset(termOffset)
+            .version(DataFrameHeader::CURRENT_VERSION)
+            .flags((std::int8_t) FrameDescriptor::UNFRAGMENTED)
+            .type(DataFrameHeader::HDR_TYPE_PAD)
+            .frameLength(frameLength);
+
+        return image.insertPacket(termId, termOffset, m_packet, DataFrameHeader::LENGTH);
+    }
+
+    PublicationImage::ptr_t newImage(const char* logFile, std::int32_t termOffset, UnsafeBufferPosition& hwmPosition)
+    {
+        return std::make_shared<PublicationImage>(
+            2, 0, 0, SESSION_ID, STREAM_ID, INITIAL_TERM_ID, INITIAL_TERM_ID, termOffset, WINDOW_LENGTH, 0,
+            std::unique_ptr<MappedRawLog>(new MappedRawLog{logFile, true, TERM_LENGTH}),
+            nullptr,
+            nullptr,
+            nullptr,
+            std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>>(
+                new std::vector<ReadablePosition<UnsafeBufferPosition>>()),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(hwmPosition)),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+            std::unique_ptr<CongestionControl>(new StaticWindowCongestionControl()),
+            m_delayGenerator,
+            []() { return 0L; });
+    }
+};
+
+TEST_F(PublicationImageTest, shouldInsertInOrderPacketsAndAdvanceRebuildPosition)
+{
+    insertFrame(0, 1);
+    insertFrame(DATAGRAM_LENGTH, 2);
+
+    EXPECT_EQ(2 * DATAGRAM_LENGTH, hwmPosition());
+    EXPECT_EQ(2 * DATAGRAM_LENGTH, m_image->rebuildPosition());
+    EXPECT_EQ(DATAGRAM_LENGTH, m_termBuffer->getInt32(DATAGRAM_LENGTH));
+    EXPECT_EQ(2, m_termBuffer->getUInt8(DATAGRAM_LENGTH + DataFrameHeader::LENGTH));
+}
+
+TEST_F(PublicationImageTest, shouldAdvanceRebuildPositionOverReceivedDataWhenGapFilled)
+{
+    insertFrame(DATAGRAM_LENGTH, 2);
+    insertFrame(2 * DATAGRAM_LENGTH, 3);
+
+    EXPECT_EQ(3 * DATAGRAM_LENGTH, hwmPosition());
+    EXPECT_EQ(0, m_image->rebuildPosition());
+
+    insertFrame(0, 1);
+
+    EXPECT_EQ(3 * DATAGRAM_LENGTH, hwmPosition());
+    EXPECT_EQ(3 * DATAGRAM_LENGTH, m_image->rebuildPosition());
+}
+
+TEST_F(PublicationImageTest, shouldNotOverwriteDuplicatePackets)
+{
+    insertFrame(DATAGRAM_LENGTH, 2);
+    insertFrame(DATAGRAM_LENGTH, 5);
+
+    EXPECT_EQ(2, m_termBuffer->getUInt8(DATAGRAM_LENGTH + DataFrameHeader::LENGTH));
+
+    insertFrame(0, 1);
+    insertFrame(0, 6);
+
+    EXPECT_EQ(1, m_termBuffer->getUInt8(DataFrameHeader::LENGTH));
+    EXPECT_EQ(2 * DATAGRAM_LENGTH, m_image->rebuildPosition());
+}
+
+TEST_F(PublicationImageTest, shouldRejectPacketsBeyondFlowControlWindow)
+{
+    insertFrame(WINDOW_LENGTH, 1);
+
+    EXPECT_EQ(0, hwmPosition());
+    EXPECT_EQ(0, m_termBuffer->getInt32(WINDOW_LENGTH));
+}
+
+TEST_F(PublicationImageTest, shouldRebuildOverPaddingHeaderIntoNextTerm)
+{
+    const std::int32_t padOffset = TERM_LENGTH - DATAGRAM_LENGTH;
+
+    UnsafeBufferPosition hwm{m_countersBuffer, 1};
+    PublicationImage::ptr_t image = newImage("./publication-image-pad-test.map", padOffset - DATAGRAM_LENGTH, hwm);
+
+    insertFrame(*image, INITIAL_TERM_ID, padOffset - DATAGRAM_LENGTH, 1);
+
+    // the sender puts only the header of the padding frame on the wire
+    insertPaddingHeader(*image, INITIAL_TERM_ID, padOffset, TERM_LENGTH - padOffset);
+
+    EXPECT_EQ(TERM_LENGTH, image->rebuildPosition());
+    EXPECT_EQ(TERM_LENGTH, hwm.get());
+
+    insertFrame(*image, INITIAL_TERM_ID + 1, 0, 2);
+
+    EXPECT_EQ(TERM_LENGTH + DATAGRAM_LENGTH, image->rebuildPosition());
+    EXPECT_EQ(TERM_LENGTH + DATAGRAM_LENGTH, hwm.get());
+}
+
+TEST_F(PublicationImageTest, shouldRebuildOverPaddingHeaderWhenGapBeforeItIsFilled)
+{
+    const std::int32_t padOffset = TERM_LENGTH - DATAGRAM_LENGTH;
+
+    UnsafeBufferPosition hwm{m_countersBuffer, 1};
+    PublicationImage::ptr_t image = newImage("./publication-image-pad-gap-test.map", padOffset - DATAGRAM_LENGTH, hwm);
+
+    insertPaddingHeader(*image, INITIAL_TERM_ID, padOffset, TERM_LENGTH - padOffset);
+    insertFrame(*image, INITIAL_TERM_ID + 1, 0, 2);
+
+    EXPECT_EQ(TERM_LENGTH - (2 * DATAGRAM_LENGTH), image->rebuildPosition());
+
+    insertFrame(*image, INITIAL_TERM_ID, padOffset - DATAGRAM_LENGTH, 1);
+
+    EXPECT_EQ(TERM_LENGTH + DATAGRAM_LENGTH, image->rebuildPosition());
+    EXPECT_EQ(TERM_LENGTH + DATAGRAM_LENGTH, hwm.get());
+}
+
+TEST_F(PublicationImageTest, shouldCleanTermsBehindSubscriberSoPartitionsCanBeReused)
+{
+    const std::int32_t termCount = 5;
+    const std::int32_t framesPerTerm = TERM_LENGTH / DATAGRAM_LENGTH;
+
+    std::unique_ptr<MappedRawLog> rawLog{new MappedRawLog{"./publication-image-clean-test.map", true, TERM_LENGTH}};
+    MappedRawLog* log = rawLog.get();
+
+    UnsafeBufferPosition hwm{m_countersBuffer, 1};
+    UnsafeBufferPosition subscriberPosition{m_countersBuffer, 2};
+    UnsafeBufferPosition receiverWindowPosition{m_countersBuffer, 3};
+    UnsafeBufferPosition rttPosition{m_countersBuffer, 4};
+    UnsafeBufferPosition rttVariancePosition{m_countersBuffer, 5};
+
+    std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>> subscriberPositions{
+        new std::vector<ReadablePosition<UnsafeBufferPosition>>()};
+    subscriberPositions->push_back(ReadablePosition<UnsafeBufferPosition>{subscriberPosition});
+
+    std::shared_ptr<ReceiveChannelEndpoint> endpoint =
+        std::make_shared<ReceiveChannelEndpoint>(UdpChannel::parse("aeron:udp?endpoint=localhost:9083"));
+    endpoint->openDatagramChannel();
+
+    PublicationImage image{
+        2, 0, 0, SESSION_ID, STREAM_ID, INITIAL_TERM_ID, INITIAL_TERM_ID, 0, WINDOW_LENGTH, 0,
+        std::move(rawLog),
+        InetAddress::fromIPv4("127.0.0.1", 9084),
+        InetAddress::fromIPv4("127.0.0.1", 9084),
+        endpoint,
+        std::move(subscriberPositions),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(hwm)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(receiverWindowPosition)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(rttPosition)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(rttVariancePosition)),
+        std::unique_ptr<CongestionControl>(new StaticWindowCongestionControl()),
+        m_delayGenerator,
+        []() { return 0L; }};
+
+    // every partition is used at least once dirty, the rebuild would stall on the first if it were not cleaned
+    for (std::int32_t term = 0; term < termCount; term++)
+    {
+        for (std::int32_t frame = 0; frame < framesPerTerm; frame++)
+        {
+            insertFrame(image, INITIAL_TERM_ID + term, frame * DATAGRAM_LENGTH, (std::uint8_t) (term + 1));
+
+            subscriberPosition.setOrdered(image.rebuildPosition());
+            image.cleanBuffer();
+            image.scheduleStatusMessage(0);
+        }
+    }
+
+    EXPECT_EQ((std::int64_t) termCount * TERM_LENGTH, image.rebuildPosition());
+    EXPECT_EQ((std::int64_t) termCount * TERM_LENGTH, hwm.get());
+
+    const std::int32_t lastPartition =
+        LogBufferDescriptor::indexByTerm(INITIAL_TERM_ID, INITIAL_TERM_ID + termCount - 1);
+    const std::int32_t cleanedPartition =
+        LogBufferDescriptor::indexByTerm(INITIAL_TERM_ID, INITIAL_TERM_ID + termCount - 2);
+
+    EXPECT_EQ(termCount, log->termBuffer(lastPartition).getUInt8(DataFrameHeader::LENGTH));
+    EXPECT_EQ(0, log->termBuffer(cleanedPartition).getInt32(0));
+    EXPECT_EQ(0, log->termBuffer(cleanedPartition).getInt32(TERM_LENGTH - DATAGRAM_LENGTH));
+}
@@ -0,0 +1,335 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Mocks.h"
+
+#include <protocol/DataHeaderFlyweight.h>
+
+#include <DataPacketDispatcher.h>
+
+using namespace aeron::concurrent;
+using namespace aeron::driver;
+using namespace aeron::driver::media;
+using namespace testing;
+
+#define SESSION_ID (1)
+#define STREAM_ID (10)
+#define NAK_DELAY_NS (1000)
+#define SM_TIMEOUT_NS (1000 * 1000)
+
+class ReceiverTest : public Test
+{
+public:
+    ReceiverTest() :
+        m_dataBufferAtomic(&m_dataBuffer[0], m_dataBuffer.size()),
+        m_dataHeaderFlyweight(m_dataBufferAtomic, 0),
+        m_receiver(std::make_shared<Receiver>([&]() { return m_nanoTime; })),
+        m_dispatcher(std::make_shared<DataPacketDispatcher>(std::make_shared<MockDriverConductorProxy>(), *m_receiver)),
+        m_endpoint(UdpChannel::parse("aeron:udp?endpoint=localhost:9069"), m_dispatcher),
+        m_address(InetAddress::parse("127.0.0.1:9070"))
+    {
+        m_dataBuffer.fill(0);
+        m_dataHeaderFlyweight.sessionId(SESSION_ID).streamId(STREAM_ID);
+        m_dispatcher->addSubscription(STREAM_ID);
+    }
+
+protected:
+    std::array<std::uint8_t, 128> m_dataBuffer;
+    AtomicBuffer m_dataBufferAtomic;
+    DataHeaderFlyweight m_dataHeaderFlyweight;
+    long m_nanoTime = 0;
+    std::shared_ptr<Receiver> m_receiver;
+    std::shared_ptr<DataPacketDispatcher> m_dispatcher;
+    MockReceiveChannelEndpoint m_endpoint;
+    std::unique_ptr<InetAddress> m_address;
+    std::array<std::uint8_t, 4096> m_counterBytes;
+
+    /**
+     * An active image with one subscriber, the high-water mark is counter 0, the subscriber position counter 1, the
+     * receiver window counter 2 and the RTT and RTT variance counters 3 and 4.
+     */
+    PublicationImage::ptr_t newImageWithSubscriber(
+        std::shared_ptr<ReceiveChannelEndpoint> endpoint,
+        FeedbackDelayGenerator& delayGenerator,
+        std::unique_ptr<CongestionControl> congestionControl =
+            std::unique_ptr<CongestionControl>(new StaticWindowCongestionControl()))
+    {
+        m_counterBytes.fill(0);
+        AtomicBuffer countersBuffer{&m_counterBytes[0], static_cast<aeron::util::index_t>(m_counterBytes.size())};
+        UnsafeBufferPosition hwmPosition{countersBuffer, 0};
+        UnsafeBufferPosition subscriberPosition{countersBuffer, 1};
+        UnsafeBufferPosition receiverWindowPosition{countersBuffer, 2};
+        UnsafeBufferPosition rttPosition{countersBuffer, 3};
+        UnsafeBufferPosition rttVariancePosition{countersBuffer, 4};
+
+        std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>> subscriberPositions{
+            new std::vector<ReadablePosition<UnsafeBufferPosition>>()};
+        subscriberPositions->push_back(ReadablePosition<UnsafeBufferPosition>{subscriberPosition});
+
+        PublicationImage::ptr_t image = std::make_shared<PublicationImage>(
+            1, 0, SM_TIMEOUT_NS, SESSION_ID, STREAM_ID, 0, 0, 0, 4096, 0,
+            std::unique_ptr<MappedRawLog>(
+                new MappedRawLog{"./receiver-test.map", true, LogBufferDescriptor::TERM_MIN_LENGTH}),
+            nullptr,
+            std::shared_ptr<InetAddress>(InetAddress::parse("127.0.0.1:9070")),
+            endpoint,
+            std::move(subscriberPositions),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(hwmPosition)),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(receiverWindowPosition)),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(rttPosition)),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(rttVariancePosition)),
+            std::move(congestionControl),
+            delayGenerator,
+            [&]() { return m_nanoTime; });
+
+        image->status(PublicationImageStatus::ACTIVE);
+        m_receiver->onNewPublicationImage(image);
+
+        return image;
+    }
+
+    void subscriberPosition(std::int64_t position)
+    {
+        *reinterpret_cast<std::int64_t*>(&m_counterBytes[CountersManager::counterOffset(1)]) = position;
+    }
+
+    std::int64_t receiverWindow()
+    {
+        return counterValue(2);
+    }
+
+    std::int64_t counterValue(std::int32_t counterId)
+    {
+        return *reinterpret_cast<std::int64_t*>(&m_counterBytes[CountersManager::counterOffset(counterId)]);
+    }
+
+    void insertFrame(PublicationImage& image, std::int32_t termOffset)
+    {
+        m_dataHeaderFlyweight
+            .termId(0)
+            .termOffset(termOffset)
+            .type(DataFrameHeader::HDR_TYPE_DATA)
+            .frameLength(128);
+        image.insertPacket(0, termOffset, m_dataBufferAtomic, 128);
+    }
+};
+
+TEST_F(ReceiverTest, shouldExpirePendingSetupMessageSoSetupCanBeElicitedAgain)
+{
+    EXPECT_CALL(m_endpoint, sendSetupElicitingStatusMessage(_, SESSION_ID, STREAM_ID)).Times(2);
+
+    m_dispatcher->onDataPacket(m_endpoint, m_dataHeaderFlyweight, m_dataBufferAtomic, 128, *m_address);
+    m_dispatcher->onDataPacket(m_endpoint, m_dataHeaderFlyweight, m_dataBufferAtomic, 128, *m_address);
+    EXPECT_EQ(1u, m_receiver->pendingSetupMessageCount());
+
+    m_nanoTime += Receiver::PENDING_SETUP_TIMEOUT_NS;
+    m_receiver->doWork();
+    EXPECT_EQ(1u, m_receiver->pendingSetupMessageCount());
+
+    m_nanoTime += 1;
+    m_receiver->doWork();
+    EXPECT_EQ(0u, m_receiver->pendingSetupMessageCount());
+
+    m_dispatcher->onDataPacket(m_endpoint, m_dataHeaderFlyweight, m_dataBufferAtomic, 128, *m_address);
+    EXPECT_EQ(1u, m_receiver->pendingSetupMessageCount());
+}
+
+TEST_F(ReceiverTest, shouldDropPendingSetupMessagesWhenEndpointClosed)
+{
+    EXPECT_CALL(m_endpoint, sendSetupElicitingStatusMessage(_, SESSION_ID, STREAM_ID)).Times(1);
+
+    m_endpoint.openDatagramChannel();
+    m_receiver->onRegisterReceiveChannelEndpoint(m_endpoint);
+    m_dispatcher->onDataPacket(m_endpoint, m_dataHeaderFlyweight, m_dataBufferAtomic, 128, *m_address);
+    EXPECT_EQ(1u, m_receiver->pendingSetupMessageCount());
+
+    m_receiver->onCloseReceiveChannelEndpoint(m_endpoint);
+    EXPECT_EQ(0u, m_receiver->pendingSetupMessageCount());
+}
+
+TEST_F(ReceiverTest, shouldNakGapsInActiveImagesUntilTheyGoInactive)
+{
+    std::array<std::uint8_t, 4096> counterBytes;
+    counterBytes.fill(0);
+    AtomicBuffer countersBuffer{&counterBytes[0], counterBytes.size()};
+    UnsafeBufferPosition hwmPosition{countersBuffer, 0};
+    StaticFeedbackDelayGenerator delayGenerator{NAK_DELAY_NS, true};
+    std::shared_ptr<MockReceiveChannelEndpoint> endpoint =
+        std::make_shared<MockReceiveChannelEndpoint>(UdpChannel::parse("aeron:udp?endpoint=localhost:9071"));
+
+    PublicationImage::ptr_t image = std::make_shared<PublicationImage>(
+        1, 0, 0, SESSION_ID, STREAM_ID, 0, 0, 0, 4096, 0,
+        std::unique_ptr<MappedRawLog>(
+            new MappedRawLog{"./receiver-test.map", true, LogBufferDescriptor::TERM_MIN_LENGTH}),
+        nullptr,
+        std::shared_ptr<InetAddress>(InetAddress::parse("127.0.0.1:9070")),
+        endpoint,
+        std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>>(
+            new std::vector<ReadablePosition<UnsafeBufferPosition>>()),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(hwmPosition)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<CongestionControl>(new StaticWindowCongestionControl()),
+        delayGenerator,
+        [&]() { return m_nanoTime; });
+
+    m_dataHeaderFlyweight
+        .termId(0)
+        .termOffset(128)
+        .type(DataFrameHeader::HDR_TYPE_DATA)
+        .frameLength(128);
+    image->insertPacket(0, 128, m_dataBufferAtomic, 128);
+    image->status(PublicationImageStatus::ACTIVE);
+    m_receiver->onNewPublicationImage(image);
+
+    EXPECT_CALL(*endpoint, sendNakMessage(_, SESSION_ID, STREAM_ID, 0, 0, 128)).Times(2);
+
+    m_receiver->doWork();
+    m_nanoTime += NAK_DELAY_NS - 1;
+    m_receiver->doWork();
+    m_nanoTime += 1;
+    m_receiver->doWork();
+    EXPECT_EQ(1u, m_receiver->publicationImageCount());
+
+    image->status(PublicationImageStatus::INACTIVE);
+    m_nanoTime += NAK_DELAY_NS;
+    m_receiver->doWork();
+    EXPECT_EQ(0u, m_receiver->publicationImageCount());
+}
+
+TEST_F(ReceiverTest, shouldSendStatusMessageOnTimeoutAndWhenConsumptionPassesGain)
+{
+    StaticFeedbackDelayGenerator delayGenerator{NAK_DELAY_NS, true};
+    std::shared_ptr<MockReceiveChannelEndpoint> endpoint =
+        std::make_shared<MockReceiveChannelEndpoint>(UdpChannel::parse("aeron:udp?endpoint=localhost:9071"));
+    PublicationImage::ptr_t image = newImageWithSubscriber(endpoint, delayGenerator);
+
+    // the subscriber has kept up so the window doubles, which puts the gain at a quarter of 8192
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, SESSION_ID, STREAM_ID, 0, 0, 8192)).Times(1);
+    m_receiver->doWork();
+    m_nanoTime += SM_TIMEOUT_NS - 1;
+    m_receiver->doWork();
+    Mock::VerifyAndClearExpectations(endpoint.get());
+
+    for (std::int32_t termOffset = 0; termOffset < 2048; termOffset += 128)
+    {
+        insertFrame(*image, termOffset);
+    }
+
+    subscriberPosition(2048 - 128);
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, _, _, _, _, _)).Times(0);
+    m_receiver->doWork();
+    Mock::VerifyAndClearExpectations(endpoint.get());
+
+    subscriberPosition(2048);
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, SESSION_ID, STREAM_ID, 0, 2048, 16384)).Times(1);
+    m_receiver->doWork();
+    m_receiver->doWork();
+    Mock::VerifyAndClearExpectations(endpoint.get());
+
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, SESSION_ID, STREAM_ID, 0, 2048, _)).Times(1);
+    m_nanoTime += SM_TIMEOUT_NS;
+    m_receiver->doWork();
+}
+
+TEST_F(ReceiverTest, shouldShrinkWindowForSlowSubscriberAndGrowItOnceCaughtUp)
+{
+    StaticFeedbackDelayGenerator delayGenerator{NAK_DELAY_NS, true};
+    std::shared_ptr<MockReceiveChannelEndpoint> endpoint =
+        std::make_shared<MockReceiveChannelEndpoint>(UdpChannel::parse("aeron:udp?endpoint=localhost:9071"));
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, _, _, _, _, _)).Times(AnyNumber());
+    PublicationImage::ptr_t image = newImageWithSubscriber(endpoint, delayGenerator);
+
+    m_receiver->doWork();
+    EXPECT_EQ(8192, image->windowLength());
+
+    insertFrame(*image, 0);
+    m_nanoTime += SM_TIMEOUT_NS;
+    m_receiver->doWork();
+    m_nanoTime += SM_TIMEOUT_NS;
+    m_receiver->doWork();
+    EXPECT_EQ(8192, image->windowLength()) << "a subscriber that drains nothing is held to the minimum window";
+
+    subscriberPosition(128);
+    m_nanoTime += SM_TIMEOUT_NS;
+    m_receiver->doWork();
+    EXPECT_EQ(16384, image->windowLength());
+
+    m_nanoTime += SM_TIMEOUT_NS;
+    m_receiver->doWork();
+    m_nanoTime += SM_TIMEOUT_NS;
+    m_receiver->doWork();
+    EXPECT_EQ(LogBufferDescriptor::TERM_MIN_LENGTH / 2, image->windowLength());
+}
+
+TEST_F(ReceiverTest, shouldAdvertiseCutCongestionWindowAfterLoss)
+{
+    StaticFeedbackDelayGenerator delayGenerator{NAK_DELAY_NS, true};
+    std::shared_ptr<MockReceiveChannelEndpoint> endpoint =
+        std::make_shared<MockReceiveChannelEndpoint>(UdpChannel::parse("aeron:udp?endpoint=localhost:9071"));
+    EXPECT_CALL(*endpoint, sendNakMessage(_, _, _, _, _, _)).Times(AnyNumber());
+    PublicationImage::ptr_t image = newImageWithSubscriber(
+        endpoint, delayGenerator, std::unique_ptr<CongestionControl>(new CubicCongestionControl(0, 4096, 1024)));
+
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, SESSION_ID, STREAM_ID, 0, 0, 4096)).Times(1);
+    m_receiver->doWork();
+    EXPECT_EQ(8192, image->windowLength());
+    EXPECT_EQ(4096, receiverWindow());
+    Mock::VerifyAndClearExpectations(endpoint.get());
+
+    const std::int32_t cutWindowLength = (std::int32_t) (4096 * CubicCongestionControl::BETA);
+    insertFrame(*image, 128);
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, SESSION_ID, STREAM_ID, 0, 0, cutWindowLength)).Times(1);
+    m_nanoTime += SM_TIMEOUT_NS;
+    m_receiver->doWork();
+    EXPECT_EQ(cutWindowLength, receiverWindow());
+}
+
+TEST_F(ReceiverTest, shouldProbeRttWithStatusMessageAndSmoothEchoes)
+{
+    StaticFeedbackDelayGenerator delayGenerator{NAK_DELAY_NS, true};
+    std::shared_ptr<MockReceiveChannelEndpoint> endpoint =
+        std::make_shared<MockReceiveChannelEndpoint>(UdpChannel::parse("aeron:udp?endpoint=localhost:9071"));
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, _, _, _, _, _)).Times(AnyNumber());
+    PublicationImage::ptr_t image = newImageWithSubscriber(endpoint, delayGenerator);
+
+    EXPECT_CALL(*endpoint, sendRttMeasurement(_, SESSION_ID, STREAM_ID, 0)).Times(1);
+    m_receiver->doWork();
+    m_receiver->doWork();
+    Mock::VerifyAndClearExpectations(endpoint.get());
+
+    m_nanoTime = 1500;
+    image->onRttMeasurement(0, 500);
+    EXPECT_EQ(1000, image->rttNs());
+    EXPECT_EQ(1000, counterValue(3));
+    EXPECT_EQ(500, counterValue(4));
+
+    m_nanoTime = 3000;
+    image->onRttMeasurement(1000, 0);
+    EXPECT_EQ(1125, counterValue(3));
+    EXPECT_EQ(625, counterValue(4));
+
+    image->onRttMeasurement(m_nanoTime + 1, 0);
+    EXPECT_EQ(1125, image->rttNs()) << "an echo from the future is not a sample";
+
+    EXPECT_CALL(*endpoint, queueStatusMessage(_, _, _, _, _, _)).Times(AnyNumber());
+    EXPECT_CALL(*endpoint, sendRttMeasurement(_, SESSION_ID, STREAM_ID, SM_TIMEOUT_NS)).Times(1);
+    m_nanoTime = SM_TIMEOUT_NS;
+    m_receiver->doWork();
+}
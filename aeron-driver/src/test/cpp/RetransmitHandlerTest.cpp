@@ -0,0 +1,158 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "RetransmitHandler.h"
+
+using namespace aeron::driver;
+using namespace testing;
+
+#define TERM_ID (7)
+#define TERM_LENGTH (64 * 1024)
+#define FRAME_LENGTH (1024)
+#define DELAY_NS (20)
+#define LINGER_NS (100)
+
+typedef std::tuple<std::int32_t, std::int32_t, std::int32_t> retransmit_t;
+
+class RetransmitHandlerTest : public Test
+{
+public:
+    RetransmitHandlerTest() :
+        m_immediate(0, true),
+        m_delayed(DELAY_NS, false),
+        m_linger(LINGER_NS, false),
+        m_resendHandler(
+            [&](std::int32_t termId, std::int32_t termOffset, std::int32_t length)
+            {
+                m_retransmits.push_back(retransmit_t{termId, termOffset, length});
+            })
+    {
+    }
+
+protected:
+    StaticFeedbackDelayGenerator m_immediate;
+    StaticFeedbackDelayGenerator m_delayed;
+    StaticFeedbackDelayGenerator m_linger;
+    std::vector<retransmit_t> m_retransmits;
+    resend_handler_t m_resendHandler;
+
+    void onNak(RetransmitHandler& handler, std::int32_t termOffset, std::int32_t length, std::int64_t nowNs)
+    {
+        handler.onNak(TERM_ID, termOffset, length, TERM_LENGTH, nowNs, m_resendHandler);
+    }
+};
+
+TEST_F(RetransmitHandlerTest, shouldRetransmitImmediatelyAndIgnoreRepeatsWhileLingering)
+{
+    RetransmitHandler handler{m_immediate, m_linger};
+
+    onNak(handler, 0, FRAME_LENGTH, 0);
+    onNak(handler, 0, FRAME_LENGTH, 1);
+
+    ASSERT_EQ(1u, m_retransmits.size());
+    EXPECT_EQ(retransmit_t(TERM_ID, 0, FRAME_LENGTH), m_retransmits[0]);
+
+    EXPECT_EQ(0, handler.processTimeouts(LINGER_NS - 1, m_resendHandler));
+    EXPECT_EQ(1u, handler.activeRetransmitCount());
+    EXPECT_EQ(0, handler.processTimeouts(LINGER_NS, m_resendHandler));
+    EXPECT_EQ(0u, handler.activeRetransmitCount());
+
+    onNak(handler, 0, FRAME_LENGTH, LINGER_NS);
+    EXPECT_EQ(2u, m_retransmits.size());
+}
+
+TEST_F(RetransmitHandlerTest, shouldRetransmitAfterDelay)
+{
+    RetransmitHandler handler{m_delayed, m_linger};
+
+    onNak(handler, 0, FRAME_LENGTH, 0);
+    EXPECT_TRUE(m_retransmits.empty());
+
+    EXPECT_EQ(0, handler.processTimeouts(DELAY_NS - 1, m_resendHandler));
+    EXPECT_EQ(1, handler.processTimeouts(DELAY_NS, m_resendHandler));
+
+    ASSERT_EQ(1u, m_retransmits.size());
+    EXPECT_EQ(retransmit_t(TERM_ID, 0, FRAME_LENGTH), m_retransmits[0]);
+}
+
+TEST_F(RetransmitHandlerTest, shouldCoalesceOverlappingNaksWhileDelayed)
+{
+    RetransmitHandler handler{m_delayed, m_linger};
+
+    onNak(handler, FRAME_LENGTH, 2 * FRAME_LENGTH, 0);
+    onNak(handler, 0, 2 * FRAME_LENGTH, 1);
+    onNak(handler, 2 * FRAME_LENGTH, 2 * FRAME_LENGTH, 2);
+    EXPECT_EQ(1u, handler.activeRetransmitCount());
+
+    EXPECT_EQ(1, handler.processTimeouts(DELAY_NS, m_resendHandler));
+
+    ASSERT_EQ(1u, m_retransmits.size());
+    EXPECT_EQ(retransmit_t(TERM_ID, 0, 4 * FRAME_LENGTH), m_retransmits[0]);
+}
+
+TEST_F(RetransmitHandlerTest, shouldOnlyRetransmitWhatWasNotJustSentWhileLingering)
+{
+    RetransmitHandler handler{m_immediate, m_linger};
+
+    onNak(handler, 0, 2 * FRAME_LENGTH, 0);
+    onNak(handler, FRAME_LENGTH, 2 * FRAME_LENGTH, 1);
+
+    ASSERT_EQ(2u, m_retransmits.size());
+    EXPECT_EQ(retransmit_t(TERM_ID, 0, 2 * FRAME_LENGTH), m_retransmits[0]);
+    EXPECT_EQ(retransmit_t(TERM_ID, 2 * FRAME_LENGTH, FRAME_LENGTH), m_retransmits[1]);
+}
+
+TEST_F(RetransmitHandlerTest, shouldNotCoalesceNaksForDifferentTerms)
+{
+    RetransmitHandler handler{m_immediate, m_linger};
+
+    onNak(handler, 0, FRAME_LENGTH, 0);
+    handler.onNak(TERM_ID + 1, 0, FRAME_LENGTH, TERM_LENGTH, 0, m_resendHandler);
+
+    ASSERT_EQ(2u, m_retransmits.size());
+    EXPECT_EQ(retransmit_t(TERM_ID + 1, 0, FRAME_LENGTH), m_retransmits[1]);
+}
+
+TEST_F(RetransmitHandlerTest, shouldIgnoreNaksOutsideTerm)
+{
+    RetransmitHandler handler{m_immediate, m_linger};
+
+    onNak(handler, TERM_LENGTH - FRAME_LENGTH, 2 * FRAME_LENGTH, 0);
+    onNak(handler, -FRAME_LENGTH, FRAME_LENGTH, 0);
+    onNak(handler, 0, 0, 0);
+
+    EXPECT_TRUE(m_retransmits.empty());
+    EXPECT_EQ(0u, handler.activeRetransmitCount());
+}
+
+TEST_F(RetransmitHandlerTest, shouldLimitActiveRetransmits)
+{
+    const std::int32_t maxRetransmits = RetransmitHandler::MAX_RETRANSMITS;
+    RetransmitHandler handler{m_delayed, m_linger};
+
+    for (std::int32_t i = 0; i < maxRetransmits + 1; i++)
+    {
+        onNak(handler, 2 * i * FRAME_LENGTH, FRAME_LENGTH, 0);
+    }
+
+    EXPECT_EQ((std::size_t) maxRetransmits, handler.activeRetransmitCount());
+    EXPECT_EQ(maxRetransmits, handler.processTimeouts(DELAY_NS, m_resendHandler));
+}
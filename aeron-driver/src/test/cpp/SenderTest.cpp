@@ -0,0 +1,685 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/time.h>
+
+#include <array>
+
+#include <gtest/gtest.h>
+
+#include <concurrent/CountersManager.h>
+#include <protocol/DataHeaderFlyweight.h>
+#include <protocol/NakFlyweight.h>
+#include <protocol/RttMeasurementFlyweight.h>
+#include <protocol/StatusMessageFlyweight.h>
+
+#include "Sender.h"
+
+#include "GTestSkip.h"
+
+using namespace aeron::concurrent;
+using namespace aeron::concurrent::logbuffer;
+using namespace aeron::driver;
+using namespace aeron::driver::media;
+using namespace testing;
+
+#define SESSION_ID (1)
+#define STREAM_ID (10)
+#define INITIAL_TERM_ID (3)
+#define MTU_LENGTH (4096)
+#define TERM_LENGTH (LogBufferDescriptor::TERM_MIN_LENGTH)
+#define FRAME_LENGTH (1024)
+#define SENDER_LIMIT_COUNTER_OFFSET (10)
+#define RETRANSMIT_LINGER_NS (1000)
+#define URI "aeron:udp?endpoint=localhost:9068"
+
+class SenderTest : public Test
+{
+public:
+    SenderTest() :
+        m_countersBuffer(m_counterBytes, sizeof(m_counterBytes)),
+        m_sendChannel(UdpChannel::parse(URI)),
+        m_receiveChannel(UdpChannel::parse(URI)),
+        m_receiver(m_receiveChannel, &m_receiveChannel->remoteData(), &m_receiveChannel->remoteData(), nullptr),
+        m_retransmitDelayGenerator(0, true),
+        m_retransmitLingerGenerator(RETRANSMIT_LINGER_NS, false),
+        m_sender([&]() { return m_nanoTime; })
+    {
+        m_countersBuffer.setMemory(0, m_countersBuffer.capacity(), 0);
+        m_endpoint = std::make_shared<SendChannelEndpoint>(UdpChannel::parse(URI));
+        m_endpoint->openDatagramChannel();
+        m_receiver.openDatagramChannel();
+    }
+
+protected:
+    std::uint8_t m_counterBytes[4096];
+    AtomicBuffer m_countersBuffer;
+    std::unique_ptr<UdpChannel> m_sendChannel;
+    std::unique_ptr<UdpChannel> m_receiveChannel;
+    UdpChannelTransport m_receiver;
+    std::shared_ptr<SendChannelEndpoint> m_endpoint;
+    StaticFeedbackDelayGenerator m_retransmitDelayGenerator;
+    StaticFeedbackDelayGenerator m_retransmitLingerGenerator;
+    long m_nanoTime = 0;
+    Sender m_sender;
+
+    std::int64_t* senderPositionCounter(std::int32_t counterId)
+    {
+        return reinterpret_cast<std::int64_t*>(m_counterBytes + CountersManager::counterOffset(counterId));
+    }
+
+    NetworkPublication::ptr_t newPublication(
+        std::int32_t sessionId,
+        std::int32_t counterId,
+        std::int64_t position,
+        MappedRawLog*& log,
+        std::unique_ptr<TokenBucket> pacer = std::unique_ptr<TokenBucket>(nullptr),
+        std::int32_t priorityClass = Sender::NORMAL_PRIORITY)
+    {
+        const std::string location = "./sender-test-" + std::to_string(sessionId) + ".map";
+        std::unique_ptr<MappedRawLog> rawLog{new MappedRawLog{location.c_str(), true, TERM_LENGTH}};
+        log = rawLog.get();
+
+        UnsafeBufferPosition senderPosition{m_countersBuffer, counterId};
+        UnsafeBufferPosition senderLimit{m_countersBuffer, counterId + SENDER_LIMIT_COUNTER_OFFSET};
+        *senderPositionCounter(counterId) = position;
+
+        return std::make_shared<NetworkPublication>(
+            sessionId, sessionId, STREAM_ID, INITIAL_TERM_ID, MTU_LENGTH, priorityClass,
+            std::move(rawLog),
+            m_endpoint,
+            std::unique_ptr<Position<UnsafeBufferPosition>>(
+                new Position<UnsafeBufferPosition>(senderPosition)),
+            std::unique_ptr<Position<UnsafeBufferPosition>>(
+                new Position<UnsafeBufferPosition>(senderLimit)),
+            std::unique_ptr<FlowControl>(new UnicastFlowControl()),
+            std::unique_ptr<RetransmitHandler>(
+                new RetransmitHandler(m_retransmitDelayGenerator, m_retransmitLingerGenerator)),
+            std::move(pacer),
+            [&]() { return m_nanoTime; });
+    }
+
+    static void appendFrames(MappedRawLog* log, std::int32_t sessionId, std::int32_t count)
+    {
+        for (std::int32_t i = 0; i < count; i++)
+        {
+            appendFrame(log->termBuffer(0), sessionId, INITIAL_TERM_ID, i * FRAME_LENGTH, FRAME_LENGTH);
+        }
+
+        const std::int64_t rawTail = (((std::int64_t) INITIAL_TERM_ID) << 32) | (count * FRAME_LENGTH);
+        log->logMetaDataBuffer().putInt64(LogBufferDescriptor::TERM_TAIL_COUNTER_OFFSET, rawTail);
+    }
+
+    static void appendFrame(
+        AtomicBuffer& termBuffer,
+        std::int32_t sessionId,
+        std::int32_t termId,
+        std::int32_t termOffset,
+        std::int32_t frameLength,
+        std::uint16_t type = DataFrameHeader::HDR_TYPE_DATA)
+    {
+        aeron::protocol::DataHeaderFlyweight header{termBuffer, termOffset};
+
+        header.sessionId(sessionId)
+            .streamId(STREAM_ID)
+            .termId(termId)
+            .termOffset(termOffset)
+            .version(DataFrameHeader::CURRENT_VERSION)
+            .flags((std::int8_t) FrameDescriptor::UNFRAGMENTED)
+            .type(type)
+            .frameLength(frameLength);
+    }
+
+    std::vector<std::int32_t> receiveDatagrams(std::int32_t count, std::vector<std::int32_t>* sessionIds = nullptr)
+    {
+        std::vector<std::int32_t> lengths;
+        timeval t0;
+        timeval t1;
+        gettimeofday(&t0, NULL);
+
+        do
+        {
+            const std::int32_t received = m_receiver.receiveBatch();
+            for (std::int32_t i = 0; i < received; i++)
+            {
+                lengths.push_back(m_receiver.receiveLength(i));
+                if (nullptr != sessionIds)
+                {
+                    sessionIds->push_back(m_receiver.receiveBuffer(i).getInt32(DataFrameHeader::SESSION_ID_FIELD_OFFSET));
+                }
+            }
+            gettimeofday(&t1, NULL);
+        }
+        while ((std::int32_t) lengths.size() < count && t1.tv_sec - t0.tv_sec < 5);
+
+        return lengths;
+    }
+};
+
+TEST_F(SenderTest, shouldSendFramesInMtuSizedDatagramsAndAdvanceSenderPosition)
+{
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, 0, rawLog);
+    AtomicBuffer& termBuffer = rawLog->termBuffer(0);
+
+    for (std::int32_t i = 0; i < 10; i++)
+    {
+        appendFrame(termBuffer, SESSION_ID, INITIAL_TERM_ID, i * FRAME_LENGTH, FRAME_LENGTH);
+    }
+
+    publication->senderPositionLimit(TERM_LENGTH);
+    m_sender.onNewNetworkPublication(publication);
+
+    EXPECT_EQ(10 * FRAME_LENGTH, m_sender.doWork());
+    EXPECT_EQ(10 * FRAME_LENGTH, *senderPositionCounter(0));
+
+    std::vector<std::int32_t> lengths = receiveDatagrams(3);
+    ASSERT_EQ(3u, lengths.size());
+    EXPECT_EQ(MTU_LENGTH, lengths[0]);
+    EXPECT_EQ(MTU_LENGTH, lengths[1]);
+    EXPECT_EQ(2 * FRAME_LENGTH, lengths[2]);
+}
+
+TEST_F(SenderTest, shouldNotSendBeyondSenderPositionLimit)
+{
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, 0, rawLog);
+    AtomicBuffer& termBuffer = rawLog->termBuffer(0);
+
+    for (std::int32_t i = 0; i < 4; i++)
+    {
+        appendFrame(termBuffer, SESSION_ID, INITIAL_TERM_ID, i * FRAME_LENGTH, FRAME_LENGTH);
+    }
+
+    publication->senderPositionLimit(2 * FRAME_LENGTH);
+    m_sender.onNewNetworkPublication(publication);
+
+    EXPECT_EQ(2 * FRAME_LENGTH, m_sender.doWork());
+    EXPECT_EQ(2 * FRAME_LENGTH, *senderPositionCounter(0));
+    EXPECT_EQ(0, m_sender.doWork());
+    EXPECT_EQ(2 * FRAME_LENGTH, *senderPositionCounter(0));
+
+    publication->senderPositionLimit(4 * FRAME_LENGTH);
+
+    EXPECT_EQ(2 * FRAME_LENGTH, m_sender.doWork());
+    EXPECT_EQ(4 * FRAME_LENGTH, *senderPositionCounter(0));
+}
+
+TEST_F(SenderTest, shouldPaceDataToRateOfTokenBucket)
+{
+    // one frame per microsecond, with up to two back to back
+    MappedRawLog* rawLog;
+    std::unique_ptr<TokenBucket> pacer{new TokenBucket(FRAME_LENGTH * 1000L * 1000, 2 * FRAME_LENGTH, 0)};
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, 0, rawLog, std::move(pacer));
+    AtomicBuffer& termBuffer = rawLog->termBuffer(0);
+
+    for (std::int32_t i = 0; i < 8; i++)
+    {
+        appendFrame(termBuffer, SESSION_ID, INITIAL_TERM_ID, i * FRAME_LENGTH, FRAME_LENGTH);
+    }
+
+    publication->senderPositionLimit(TERM_LENGTH);
+    m_sender.onNewNetworkPublication(publication);
+
+    EXPECT_EQ(2 * FRAME_LENGTH, m_sender.doWork());
+    EXPECT_EQ(0, m_sender.doWork());
+    EXPECT_EQ(2 * FRAME_LENGTH, *senderPositionCounter(0));
+
+    m_nanoTime += 1000;
+    EXPECT_EQ(FRAME_LENGTH, m_sender.doWork());
+
+    m_nanoTime += 10 * 1000;
+    EXPECT_EQ(2 * FRAME_LENGTH, m_sender.doWork());
+    EXPECT_EQ(5 * FRAME_LENGTH, *senderPositionCounter(0));
+}
+
+TEST_F(SenderTest, shouldOnlyTakeTokensForPaddingHeaderAtEndOfTerm)
+{
+    // one frame per microsecond, with up to four back to back
+    const std::int32_t termOffset = TERM_LENGTH - (16 * FRAME_LENGTH);
+    MappedRawLog* rawLog;
+    std::unique_ptr<TokenBucket> pacer{new TokenBucket(FRAME_LENGTH * 1000L * 1000, 4 * FRAME_LENGTH, 0)};
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, termOffset, rawLog, std::move(pacer));
+
+    appendFrame(rawLog->termBuffer(0), SESSION_ID, INITIAL_TERM_ID, termOffset, FRAME_LENGTH);
+    appendFrame(
+        rawLog->termBuffer(0), SESSION_ID, INITIAL_TERM_ID, termOffset + FRAME_LENGTH,
+        TERM_LENGTH - termOffset - FRAME_LENGTH, DataFrameHeader::HDR_TYPE_PAD);
+    for (std::int32_t i = 0; i < 4; i++)
+    {
+        appendFrame(rawLog->termBuffer(1), SESSION_ID, INITIAL_TERM_ID + 1, i * FRAME_LENGTH, FRAME_LENGTH);
+    }
+
+    publication->senderPositionLimit(2 * TERM_LENGTH);
+    m_sender.onNewNetworkPublication(publication);
+
+    // what is left of the burst after the frame and the padding header goes on two frames of the next term
+    EXPECT_EQ((3 * FRAME_LENGTH) + DataFrameHeader::LENGTH, m_sender.doWork());
+    EXPECT_EQ(TERM_LENGTH + (2 * FRAME_LENGTH), *senderPositionCounter(0));
+
+    m_nanoTime += 2000;
+    EXPECT_EQ(2 * FRAME_LENGTH, m_sender.doWork());
+    EXPECT_EQ(TERM_LENGTH + (4 * FRAME_LENGTH), *senderPositionCounter(0));
+}
+
+TEST_F(SenderTest, shouldMovePastPaddingAtEndOfTerm)
+{
+    const std::int32_t termOffset = TERM_LENGTH - (2 * FRAME_LENGTH);
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, termOffset, rawLog);
+
+    appendFrame(rawLog->termBuffer(0), SESSION_ID, INITIAL_TERM_ID, termOffset, FRAME_LENGTH);
+    appendFrame(
+        rawLog->termBuffer(0), SESSION_ID, INITIAL_TERM_ID, termOffset + FRAME_LENGTH, FRAME_LENGTH,
+        DataFrameHeader::HDR_TYPE_PAD);
+    appendFrame(rawLog->termBuffer(1), SESSION_ID, INITIAL_TERM_ID + 1, 0, FRAME_LENGTH);
+
+    publication->senderPositionLimit(2 * TERM_LENGTH);
+    m_sender.onNewNetworkPublication(publication);
+
+    // the quantum of the publication is not spent at the end of the term, so it carries on into the next one
+    EXPECT_EQ((2 * FRAME_LENGTH) + DataFrameHeader::LENGTH, m_sender.doWork());
+    EXPECT_EQ(TERM_LENGTH + FRAME_LENGTH, *senderPositionCounter(0));
+
+    std::vector<std::int32_t> lengths = receiveDatagrams(2);
+    ASSERT_EQ(2u, lengths.size());
+    EXPECT_EQ(FRAME_LENGTH + DataFrameHeader::LENGTH, lengths[0]);
+    EXPECT_EQ(FRAME_LENGTH, lengths[1]);
+}
+
+TEST_F(SenderTest, shouldNotChargePaddingAtEndOfTermAgainstQuantum)
+{
+    const std::int32_t termOffset = TERM_LENGTH - (16 * FRAME_LENGTH);
+    const std::int32_t framesInNextTerm = 8;
+    Sender sender{[&]() { return m_nanoTime; }, MTU_LENGTH, MTU_LENGTH, MTU_LENGTH};
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, termOffset, rawLog);
+
+    appendFrame(rawLog->termBuffer(0), SESSION_ID, INITIAL_TERM_ID, termOffset, FRAME_LENGTH);
+    appendFrame(
+        rawLog->termBuffer(0), SESSION_ID, INITIAL_TERM_ID, termOffset + FRAME_LENGTH,
+        TERM_LENGTH - termOffset - FRAME_LENGTH, DataFrameHeader::HDR_TYPE_PAD);
+    for (std::int32_t i = 0; i < framesInNextTerm; i++)
+    {
+        appendFrame(rawLog->termBuffer(1), SESSION_ID, INITIAL_TERM_ID + 1, i * FRAME_LENGTH, FRAME_LENGTH);
+    }
+
+    publication->senderPositionLimit(2 * TERM_LENGTH);
+    sender.onNewNetworkPublication(publication);
+
+    EXPECT_EQ(FRAME_LENGTH + DataFrameHeader::LENGTH, sender.doWork());
+    EXPECT_EQ(TERM_LENGTH, *senderPositionCounter(0));
+
+    // the credit left after the frame and padding header carries over rather than the padding putting it in debt
+    const std::int32_t carried = MTU_LENGTH - (FRAME_LENGTH + DataFrameHeader::LENGTH);
+    const std::int32_t framesSent = (carried + MTU_LENGTH) / FRAME_LENGTH;
+
+    EXPECT_EQ(framesSent * FRAME_LENGTH, sender.doWork());
+    EXPECT_EQ(TERM_LENGTH + (framesSent * FRAME_LENGTH), *senderPositionCounter(0));
+}
+
+TEST_F(SenderTest, shouldSendSetupUntilLimitSetThenHeartbeatWhenIdle)
+{
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, 0, rawLog);
+    m_sender.onNewNetworkPublication(publication);
+
+    EXPECT_EQ(0, m_sender.doWork());
+    std::vector<std::int32_t> lengths = receiveDatagrams(1);
+    ASSERT_EQ(1u, lengths.size());
+    EXPECT_EQ(aeron::protocol::SetupFlyweight::headerLength(), lengths[0]);
+    EXPECT_EQ(DataFrameHeader::HDR_TYPE_SETUP, m_receiver.receiveBuffer(0).getUInt16(DataFrameHeader::TYPE_FIELD_OFFSET));
+
+    publication->senderPositionLimit(TERM_LENGTH);
+    m_nanoTime += NetworkPublication::PUBLICATION_HEARTBEAT_TIMEOUT_NS + 1;
+
+    EXPECT_EQ(0, m_sender.doWork());
+    lengths = receiveDatagrams(1);
+    ASSERT_EQ(1u, lengths.size());
+    EXPECT_EQ(DataFrameHeader::LENGTH, lengths[0]);
+    EXPECT_EQ(DataFrameHeader::HDR_TYPE_DATA, m_receiver.receiveBuffer(0).getUInt16(DataFrameHeader::TYPE_FIELD_OFFSET));
+    EXPECT_EQ(0, m_receiver.receiveBuffer(0).getInt32(DataFrameHeader::FRAME_LENGTH_FIELD_OFFSET));
+}
+
+TEST_F(SenderTest, shouldSendPublicationsRoundRobin)
+{
+    MappedRawLog* firstLog;
+    MappedRawLog* secondLog;
+    NetworkPublication::ptr_t first = newPublication(SESSION_ID, 0, 0, firstLog);
+    NetworkPublication::ptr_t second = newPublication(SESSION_ID + 1, 1, 0, secondLog);
+
+    for (std::int32_t i = 0; i < 2; i++)
+    {
+        appendFrame(firstLog->termBuffer(0), SESSION_ID, INITIAL_TERM_ID, i * FRAME_LENGTH, FRAME_LENGTH);
+        appendFrame(secondLog->termBuffer(0), SESSION_ID + 1, INITIAL_TERM_ID, i * FRAME_LENGTH, FRAME_LENGTH);
+    }
+
+    first->senderPositionLimit(FRAME_LENGTH);
+    second->senderPositionLimit(FRAME_LENGTH);
+    m_sender.onNewNetworkPublication(first);
+    m_sender.onNewNetworkPublication(second);
+
+    EXPECT_EQ(2 * FRAME_LENGTH, m_sender.doWork());
+
+    first->senderPositionLimit(2 * FRAME_LENGTH);
+    second->senderPositionLimit(2 * FRAME_LENGTH);
+
+    EXPECT_EQ(2 * FRAME_LENGTH, m_sender.doWork());
+
+    std::vector<std::int32_t> sessionIds;
+    receiveDatagrams(4, &sessionIds);
+    ASSERT_EQ(4u, sessionIds.size());
+    EXPECT_EQ(SESSION_ID, sessionIds[0]);
+    EXPECT_EQ(SESSION_ID + 1, sessionIds[1]);
+    EXPECT_EQ(SESSION_ID + 1, sessionIds[2]);
+    EXPECT_EQ(SESSION_ID, sessionIds[3]);
+
+    m_sender.onRemoveNetworkPublication(*first);
+    EXPECT_EQ(1u, m_sender.networkPublicationCount());
+}
+
+TEST_F(SenderTest, shouldSendHigherPriorityFirstAndUpToQuantumOfClass)
+{
+    Sender sender{[&]() { return m_nanoTime; }, 4 * FRAME_LENGTH, 2 * FRAME_LENGTH, FRAME_LENGTH};
+    MappedRawLog* lowLog;
+    MappedRawLog* highLog;
+    NetworkPublication::ptr_t low = newPublication(SESSION_ID, 0, 0, lowLog, nullptr, Sender::LOW_PRIORITY);
+    NetworkPublication::ptr_t high = newPublication(SESSION_ID + 1, 1, 0, highLog, nullptr, Sender::HIGH_PRIORITY);
+
+    appendFrames(lowLog, SESSION_ID, 8);
+    appendFrames(highLog, SESSION_ID + 1, 8);
+
+    low->senderPositionLimit(TERM_LENGTH);
+    high->senderPositionLimit(TERM_LENGTH);
+    sender.onNewNetworkPublication(low);
+    sender.onNewNetworkPublication(high);
+
+    EXPECT_EQ(5 * FRAME_LENGTH, sender.doWork());
+    EXPECT_EQ(FRAME_LENGTH, *senderPositionCounter(0));
+    EXPECT_EQ(4 * FRAME_LENGTH, *senderPositionCounter(1));
+
+    std::vector<std::int32_t> sessionIds;
+    receiveDatagrams(2, &sessionIds);
+    ASSERT_EQ(2u, sessionIds.size());
+    EXPECT_EQ(SESSION_ID + 1, sessionIds[0]);
+    EXPECT_EQ(SESSION_ID, sessionIds[1]);
+
+    EXPECT_EQ(5 * FRAME_LENGTH, sender.doWork());
+    EXPECT_EQ(FRAME_LENGTH, sender.doWork());
+    EXPECT_EQ(8 * FRAME_LENGTH, *senderPositionCounter(1));
+    EXPECT_EQ(3 * FRAME_LENGTH, *senderPositionCounter(0));
+    EXPECT_EQ(2u, sender.networkPublicationCount());
+
+    sender.onRemoveNetworkPublication(*low);
+    EXPECT_EQ(1u, sender.networkPublicationCount());
+}
+
+TEST_F(SenderTest, shouldPublishQueueingDelayOfPriorityClass)
+{
+    std::array<std::uint8_t, 4096> metaDataBytes;
+    std::array<std::uint8_t, 1024> valuesBytes;
+    AtomicBuffer metaDataBuffer{&metaDataBytes[0], metaDataBytes.size()};
+    AtomicBuffer valuesBuffer{&valuesBytes[0], valuesBytes.size()};
+    CountersManager countersManager{metaDataBuffer, valuesBuffer};
+    AtomicCounter highDelay{valuesBuffer, countersManager.allocate("high delay"), countersManager};
+    AtomicCounter lowDelay{valuesBuffer, countersManager.allocate("low delay"), countersManager};
+
+    Sender sender{[&]() { return m_nanoTime; }, 4 * FRAME_LENGTH, 2 * FRAME_LENGTH, FRAME_LENGTH};
+    sender.queueingDelayCounter(Sender::HIGH_PRIORITY, &highDelay);
+    sender.queueingDelayCounter(Sender::LOW_PRIORITY, &lowDelay);
+
+    MappedRawLog* lowLog;
+    MappedRawLog* highLog;
+    NetworkPublication::ptr_t low = newPublication(SESSION_ID, 0, 0, lowLog, nullptr, Sender::LOW_PRIORITY);
+    NetworkPublication::ptr_t high = newPublication(SESSION_ID + 1, 1, 0, highLog, nullptr, Sender::HIGH_PRIORITY);
+
+    appendFrames(lowLog, SESSION_ID, 4);
+    appendFrames(highLog, SESSION_ID + 1, 4);
+
+    low->senderPositionLimit(TERM_LENGTH);
+    high->senderPositionLimit(TERM_LENGTH);
+    sender.onNewNetworkPublication(low);
+    sender.onNewNetworkPublication(high);
+
+    for (std::int32_t i = 0; i < 4; i++)
+    {
+        sender.doWork();
+        m_nanoTime += 1000;
+    }
+
+    // the high priority frames went out on the cycle they were found, the low priority ones took three cycles more
+    EXPECT_EQ(4 * FRAME_LENGTH, *senderPositionCounter(0));
+    EXPECT_EQ(0, highDelay.get());
+    EXPECT_EQ(3000 / 8, lowDelay.get());
+}
+
+TEST_F(SenderTest, shouldApplyStatusMessageFromReceiverToSenderLimit)
+{
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, 0, rawLog);
+    m_sender.onNewNetworkPublication(publication);
+
+    m_sender.doWork();
+    ASSERT_EQ(1u, receiveDatagrams(1).size());
+
+    std::uint8_t smBytes[aeron::protocol::StatusMessageFlyweight::headerLength()];
+    AtomicBuffer smBuffer{smBytes, sizeof(smBytes)};
+    aeron::protocol::StatusMessageFlyweight statusMessage{smBuffer, 0};
+    statusMessage
+        .sessionId(SESSION_ID)
+        .streamId(STREAM_ID)
+        .consumptionTermId(INITIAL_TERM_ID)
+        .consumptionTermOffset(FRAME_LENGTH)
+        .receiverWindow(4 * FRAME_LENGTH)
+        .version(aeron::protocol::HeaderFlyweight::CURRENT_VERSION)
+        .flags(0)
+        .type(aeron::protocol::HeaderFlyweight::HDR_TYPE_SM)
+        .frameLength(aeron::protocol::StatusMessageFlyweight::headerLength());
+
+    InetAddress& senderAddress = m_receiver.receiveAddress(0);
+    ASSERT_EQ(
+        (ssize_t) sizeof(smBytes),
+        sendto(m_receiver.receiveSocketFd(), smBytes, sizeof(smBytes), 0, senderAddress.address(), senderAddress.length()));
+
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+    do
+    {
+        m_sender.doWork();
+        gettimeofday(&t1, NULL);
+    }
+    while (0 == publication->senderPositionLimit() && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(5 * FRAME_LENGTH, publication->senderPositionLimit());
+    EXPECT_EQ(5 * FRAME_LENGTH, *senderPositionCounter(SENDER_LIMIT_COUNTER_OFFSET));
+}
+
+TEST_F(SenderTest, shouldRetransmitNakedRangeOnceUntilLingerExpires)
+{
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, 0, rawLog);
+    AtomicBuffer& termBuffer = rawLog->termBuffer(0);
+
+    for (std::int32_t i = 0; i < 4; i++)
+    {
+        appendFrame(termBuffer, SESSION_ID, INITIAL_TERM_ID, i * FRAME_LENGTH, FRAME_LENGTH);
+    }
+
+    publication->senderPositionLimit(TERM_LENGTH);
+    m_sender.onNewNetworkPublication(publication);
+
+    EXPECT_EQ(4 * FRAME_LENGTH, m_sender.doWork());
+    ASSERT_EQ(1u, receiveDatagrams(1).size());
+
+    std::uint8_t nakBytes[aeron::protocol::NakFlyweight::headerLength()];
+    AtomicBuffer nakBuffer{nakBytes, sizeof(nakBytes)};
+    aeron::protocol::NakFlyweight nak{nakBuffer, 0};
+    nak
+        .sessionId(SESSION_ID)
+        .streamId(STREAM_ID)
+        .termId(INITIAL_TERM_ID)
+        .termOffset(FRAME_LENGTH)
+        .length(2 * FRAME_LENGTH)
+        .version(aeron::protocol::HeaderFlyweight::CURRENT_VERSION)
+        .flags(0)
+        .type(aeron::protocol::HeaderFlyweight::HDR_TYPE_NAK)
+        .frameLength(aeron::protocol::NakFlyweight::headerLength());
+
+    InetAddress& senderAddress = m_receiver.receiveAddress(0);
+    for (std::int32_t i = 0; i < 2; i++)
+    {
+        ASSERT_EQ(
+            (ssize_t) sizeof(nakBytes),
+            sendto(
+                m_receiver.receiveSocketFd(),
+                nakBytes,
+                sizeof(nakBytes),
+                0,
+                senderAddress.address(),
+                senderAddress.length()));
+    }
+
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+    std::int32_t received = 0;
+    do
+    {
+        m_sender.doWork();
+        received = m_receiver.receiveBatch();
+        gettimeofday(&t1, NULL);
+    }
+    while (0 == received && t1.tv_sec - t0.tv_sec < 5);
+
+    ASSERT_EQ(1, received);
+    EXPECT_EQ(2 * FRAME_LENGTH, m_receiver.receiveLength(0));
+    EXPECT_EQ(FRAME_LENGTH, m_receiver.receiveBuffer(0).getInt32(DataFrameHeader::TERM_OFFSET_FIELD_OFFSET));
+
+    // the second NAK lands while the first retransmit lingers and nothing beyond the sender position is sent
+    for (std::int32_t i = 0; i < 100; i++)
+    {
+        m_sender.doWork();
+    }
+    publication->onNak(INITIAL_TERM_ID, 4 * FRAME_LENGTH, FRAME_LENGTH);
+    EXPECT_EQ(0, m_receiver.receiveBatch());
+
+    m_nanoTime += RETRANSMIT_LINGER_NS;
+    m_sender.doWork();
+    publication->onNak(INITIAL_TERM_ID, FRAME_LENGTH, 2 * FRAME_LENGTH);
+
+    std::vector<std::int32_t> lengths = receiveDatagrams(1);
+    ASSERT_EQ(1u, lengths.size());
+    EXPECT_EQ(2 * FRAME_LENGTH, lengths[0]);
+}
+
+TEST_F(SenderTest, shouldEchoRttProbeFromReceiver)
+{
+    const std::int32_t rttmType = aeron::protocol::HeaderFlyweight::HDR_TYPE_RTTM;
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, 0, rawLog);
+    m_sender.onNewNetworkPublication(publication);
+
+    m_sender.doWork();
+    ASSERT_EQ(1u, receiveDatagrams(1).size());
+
+    std::uint8_t probeBytes[aeron::protocol::RttMeasurementFlyweight::headerLength()];
+    AtomicBuffer probeBuffer{probeBytes, sizeof(probeBytes)};
+    aeron::protocol::RttMeasurementFlyweight probe{probeBuffer, 0};
+    probe
+        .sessionId(SESSION_ID)
+        .streamId(STREAM_ID)
+        .echoTimestampNs(123456789)
+        .receptionDelta(0)
+        .version(aeron::protocol::HeaderFlyweight::CURRENT_VERSION)
+        .flags(0)
+        .type(aeron::protocol::HeaderFlyweight::HDR_TYPE_RTTM)
+        .frameLength(aeron::protocol::RttMeasurementFlyweight::headerLength());
+
+    InetAddress& senderAddress = m_receiver.receiveAddress(0);
+    ASSERT_EQ(
+        (ssize_t) sizeof(probeBytes),
+        sendto(
+            m_receiver.receiveSocketFd(),
+            probeBytes,
+            sizeof(probeBytes),
+            0,
+            senderAddress.address(),
+            senderAddress.length()));
+
+    bool isEchoed = false;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+    do
+    {
+        m_sender.doWork();
+        for (std::int32_t i = 0, count = m_receiver.receiveBatch(); i < count; i++)
+        {
+            aeron::protocol::RttMeasurementFlyweight echo{m_receiver.receiveBuffer(i), 0};
+            if (rttmType == echo.type())
+            {
+                EXPECT_TRUE(echo.isReply());
+                EXPECT_EQ(SESSION_ID, echo.sessionId());
+                EXPECT_EQ(123456789, echo.echoTimestampNs());
+                isEchoed = true;
+            }
+        }
+        gettimeofday(&t1, NULL);
+    }
+    while (!isEchoed && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_TRUE(isEchoed);
+}
+
+TEST_F(SenderTest, shouldPublishPositionHeldByZeroCopySendsUntilReleased)
+{
+    m_endpoint = std::make_shared<SendChannelEndpoint>(UdpChannel::parse(URI "|zc=true"));
+    m_endpoint->openDatagramChannel();
+
+    if (!m_endpoint->isZeroCopyEnabled())
+    {
+        GTEST_SKIP() << "zero-copy sends unavailable";
+    }
+
+    MappedRawLog* rawLog;
+    NetworkPublication::ptr_t publication = newPublication(SESSION_ID, 0, 0, rawLog);
+    const std::int64_t nothingHeld = std::numeric_limits<std::int64_t>::max();
+
+    for (std::int32_t i = 0; i < 4; i++)
+    {
+        appendFrame(rawLog->termBuffer(0), SESSION_ID, INITIAL_TERM_ID, i * FRAME_LENGTH, FRAME_LENGTH);
+    }
+    publication->senderPositionLimit(TERM_LENGTH);
+
+    EXPECT_EQ(nothingHeld, publication->zeroCopyHeldPosition());
+    EXPECT_EQ(4 * FRAME_LENGTH, publication->send(m_nanoTime, TERM_LENGTH));
+    EXPECT_EQ(0, publication->zeroCopyHeldPosition());
+
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        m_receiver.receiveBatch();
+        publication->send(m_nanoTime, TERM_LENGTH);
+        gettimeofday(&t1, NULL);
+    }
+    while (nothingHeld != publication->zeroCopyHeldPosition() && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(nothingHeld, publication->zeroCopyHeldPosition());
+}
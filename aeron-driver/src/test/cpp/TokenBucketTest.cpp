@@ -0,0 +1,67 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "TokenBucket.h"
+
+using namespace aeron::driver;
+using namespace testing;
+
+#define RATE_BYTES_PER_SECOND (100L * 1000 * 1000)
+#define BURST_LENGTH (64 * 1024)
+#define MICROSECOND_NS (1000)
+
+TEST(TokenBucketTest, shouldStartWithBurstAvailableAndNotExceedIt)
+{
+    TokenBucket bucket{RATE_BYTES_PER_SECOND, BURST_LENGTH, 0};
+
+    EXPECT_EQ(BURST_LENGTH, bucket.available(0));
+    EXPECT_EQ(BURST_LENGTH, bucket.available(1000 * MICROSECOND_NS));
+}
+
+TEST(TokenBucketTest, shouldAccrueAtRateOnceConsumed)
+{
+    TokenBucket bucket{RATE_BYTES_PER_SECOND, BURST_LENGTH, 0};
+
+    bucket.consume(BURST_LENGTH);
+    EXPECT_EQ(0, bucket.available(0));
+    EXPECT_EQ(100, bucket.available(MICROSECOND_NS));
+    EXPECT_EQ(1100, bucket.available(11 * MICROSECOND_NS));
+}
+
+TEST(TokenBucketTest, shouldAccrueFractionsOfBytesOverManyPolls)
+{
+    TokenBucket bucket{RATE_BYTES_PER_SECOND, BURST_LENGTH, 0};
+    bucket.consume(BURST_LENGTH);
+
+    for (std::int64_t nowNs = 1; nowNs <= 10 * MICROSECOND_NS; nowNs++)
+    {
+        bucket.available(nowNs);
+    }
+
+    EXPECT_EQ(1000, bucket.available(10 * MICROSECOND_NS));
+}
+
+TEST(TokenBucketTest, shouldHoldBackWhileInDebt)
+{
+    TokenBucket bucket{RATE_BYTES_PER_SECOND, BURST_LENGTH, 0};
+
+    bucket.consume(BURST_LENGTH + 1000);
+    EXPECT_EQ(0, bucket.available(5 * MICROSECOND_NS));
+    EXPECT_EQ(0, bucket.available(10 * MICROSECOND_NS));
+    EXPECT_EQ(500, bucket.available(15 * MICROSECOND_NS));
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2015 - 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "concurrent/CommandQueue.h"
+#include "concurrent/CompositeAgent.h"
+#include "concurrent/IdleStrategy.h"
+
+using namespace aeron::driver::concurrent;
+
+class RecordingAgent
+{
+public:
+    RecordingAgent(int workCount, std::vector<int>& calls, int id) : m_workCount(workCount), m_calls(calls), m_id(id)
+    {
+    }
+
+    int doWork()
+    {
+        m_calls.push_back(m_id);
+        return m_workCount;
+    }
+
+    void onClose()
+    {
+        m_calls.push_back(-m_id);
+    }
+
+private:
+    int m_workCount;
+    std::vector<int>& m_calls;
+    int m_id;
+};
+
+class CountingIdleStrategy
+{
+public:
+    CountingIdleStrategy(int& idleCount) : m_idleCount(idleCount)
+    {
+    }
+
+    void idle(int workCount)
+    {
+        if (0 == workCount)
+        {
+            m_idleCount++;
+        }
+    }
+
+private:
+    int& m_idleCount;
+};
+
+TEST(CompositeAgentTest, shouldRunAgentsInOrderAndSumWork)
+{
+    std::vector<int> calls;
+    CompositeAgent agent;
+
+    agent
+        .add(std::make_shared<RecordingAgent>(2, calls, 1))
+        .add(std::make_shared<RecordingAgent>(0, calls, 2))
+        .add(std::make_shared<RecordingAgent>(3, calls, 3));
+
+    EXPECT_EQ(3u, agent.agentCount());
+    EXPECT_EQ(5, agent.doWork());
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), calls);
+}
+
+TEST(CompositeAgentTest, shouldCloseAllAgents)
+{
+    std::vector<int> calls;
+    CompositeAgent agent;
+
+    agent
+        .add(std::make_shared<RecordingAgent>(0, calls, 1))
+        .add(std::make_shared<RecordingAgent>(0, calls, 2));
+
+    agent.onClose();
+    EXPECT_EQ(std::vector<int>({-1, -2}), calls);
+}
+
+TEST(CompositeAgentTest, shouldIdleThroughWrappedIdleStrategy)
+{
+    int idleCount = 0;
+    IdleStrategy idleStrategy = CountingIdleStrategy(idleCount);
+    IdleStrategy copy = idleStrategy;
+
+    idleStrategy.idle(0);
+    copy.idle(0);
+    copy.idle(1);
+
+    EXPECT_EQ(2, idleCount);
+}
+
+TEST(CompositeAgentTest, shouldExecuteQueuedCommandsInOrderOnDrainingThread)
+{
+    CommandQueue queue{4};
+    std::vector<int> executed;
+    const int commandCount = 100;
+
+    std::thread producer([&]()
+    {
+        for (int i = 0; i < commandCount; i++)
+        {
+            queue.offer([&executed, i]() { executed.push_back(i); });
+        }
+    });
+
+    while (executed.size() < (std::size_t) commandCount)
+    {
+        queue.drain();
+    }
+
+    producer.join();
+
+    for (int i = 0; i < commandCount; i++)
+    {
+        EXPECT_EQ(i, executed[i]);
+    }
+}
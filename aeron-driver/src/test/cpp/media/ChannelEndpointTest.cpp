@@ -15,12 +15,17 @@
  */
 
 #include <gtest/gtest.h>
+#include <sys/time.h>
 #include <protocol/SetupFlyweight.h>
+#include <protocol/DataHeaderFlyweight.h>
+#include "buffer/MappedRawLog.h"
 #include "media/ReceiveChannelEndpoint.h"
 #include "media/SendChannelEndpoint.h"
+#include "DataPacketDispatcher.h"
 
 using namespace aeron;
 using namespace aeron::driver::media;
+using namespace aeron::concurrent::status;
 
 class ChannelEndpointTest : public testing::Test
 {
@@ -30,7 +35,7 @@ TEST_F(ChannelEndpointTest, initialisesEndpoint)
 {
     const char* uri = "aeron:udp?endpoint=224.10.9.9:54326|interface=localhost";
     std::uint8_t setupBytes[protocol::SetupFlyweight::headerLength()];
-    concurrent::AtomicBuffer setupBuffer{setupBytes, protocol::SetupFlyweight::headerLength()};
+    aeron::concurrent::AtomicBuffer setupBuffer{setupBytes, protocol::SetupFlyweight::headerLength()};
     protocol::SetupFlyweight setupFlyweight{setupBuffer, 0};
 
     ReceiveChannelEndpoint receive{std::move(UdpChannel::parse(uri))};
@@ -63,4 +68,283 @@ TEST_F(ChannelEndpointTest, initialisesEndpoint)
 
     send.send(setupBuffer.buffer(), setupBuffer.capacity());
     receive.pollForData();
-}
\ No newline at end of file
+}
+
+TEST_F(ChannelEndpointTest, sendsFramesStraightFromTermBuffer)
+{
+    const std::int32_t frameLength = 1000;
+    const std::int32_t alignedFrameLength = 1024;
+    const std::int32_t frameCount = 5;
+    const std::int32_t mtu = 2048;
+    const char* uri = "aeron:udp?endpoint=localhost:9044";
+
+    driver::buffer::MappedRawLog rawLog{"./send-from-term.map", true, 1 << 16};
+    aeron::concurrent::AtomicBuffer& termBuffer = rawLog.termBuffer(0);
+
+    for (std::int32_t i = 0; i < frameCount; i++)
+    {
+        protocol::DataHeaderFlyweight header{termBuffer, i * alignedFrameLength};
+        header
+            .termOffset(i * alignedFrameLength)
+            .version(protocol::HeaderFlyweight::CURRENT_VERSION)
+            .type(protocol::HeaderFlyweight::HDR_TYPE_DATA)
+            .frameLength(frameLength);
+    }
+
+    std::unique_ptr<UdpChannel> receiveChannel = UdpChannel::parse(uri);
+    UdpChannelTransport receive{receiveChannel, &receiveChannel->remoteData(), &receiveChannel->remoteData(), nullptr};
+    SendChannelEndpoint send{std::move(UdpChannel::parse(uri))};
+
+    receive.openDatagramChannel();
+    send.openDatagramChannel();
+
+    const std::int32_t consumed = send.sendFromTerm(termBuffer, 0, termBuffer.capacity(), mtu);
+
+    EXPECT_EQ(frameCount * alignedFrameLength, consumed);
+    EXPECT_EQ(0, send.queuedSendCount());
+
+    std::int32_t datagrams = 0;
+    std::int32_t bytes = 0;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        const std::int32_t count = receive.receiveBatch();
+
+        for (std::int32_t i = 0; i < count; i++)
+        {
+            EXPECT_EQ(bytes, receive.receiveBuffer(i).getInt32(aeron::concurrent::logbuffer::DataFrameHeader::TERM_OFFSET_FIELD_OFFSET));
+            bytes += receive.receiveLength(i);
+        }
+
+        datagrams += count;
+        gettimeofday(&t1, NULL);
+    }
+    while (bytes < consumed && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(3, datagrams);
+    EXPECT_EQ(consumed, bytes);
+}
+
+TEST_F(ChannelEndpointTest, sendsQueuedStatusMessagesInOneBatchToTheirAddresses)
+{
+    const std::int32_t smType = protocol::HeaderFlyweight::HDR_TYPE_SM;
+    std::unique_ptr<UdpChannel> sourceChannelA = UdpChannel::parse("aeron:udp?endpoint=localhost:9047");
+    std::unique_ptr<UdpChannel> sourceChannelB = UdpChannel::parse("aeron:udp?endpoint=localhost:9048");
+    UdpChannelTransport sourceA{sourceChannelA, &sourceChannelA->remoteData(), &sourceChannelA->remoteData(), nullptr};
+    UdpChannelTransport sourceB{sourceChannelB, &sourceChannelB->remoteData(), &sourceChannelB->remoteData(), nullptr};
+    ReceiveChannelEndpoint receive{std::move(UdpChannel::parse("aeron:udp?endpoint=localhost:9046"))};
+    std::unique_ptr<InetAddress> addressA = InetAddress::parse("127.0.0.1:9047");
+    std::unique_ptr<InetAddress> addressB = InetAddress::parse("127.0.0.1:9048");
+
+    sourceA.openDatagramChannel();
+    sourceB.openDatagramChannel();
+    receive.openDatagramChannel();
+
+    receive.queueStatusMessage(*addressA, 1, 10, 5, 1024, 4096);
+    receive.queueStatusMessage(*addressB, 2, 10, 5, 2048, 4096);
+    receive.queueStatusMessage(*addressA, 3, 10, 5, 3072, 4096);
+    EXPECT_EQ(3, receive.pendingStatusMessageCount());
+
+    EXPECT_EQ(3, receive.sendPendingStatusMessages());
+    EXPECT_EQ(0, receive.pendingStatusMessageCount());
+    EXPECT_EQ(0, receive.sendPendingStatusMessages());
+
+    std::vector<std::int32_t> sessionIdsA;
+    std::vector<std::int32_t> sessionIdsB;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        for (std::int32_t i = 0, count = sourceA.receiveBatch(); i < count; i++)
+        {
+            protocol::StatusMessageFlyweight statusMessage{sourceA.receiveBuffer(i), 0};
+            EXPECT_EQ(smType, statusMessage.type());
+            EXPECT_EQ(4096, statusMessage.receiverWindow());
+            sessionIdsA.push_back(statusMessage.sessionId());
+        }
+
+        for (std::int32_t i = 0, count = sourceB.receiveBatch(); i < count; i++)
+        {
+            protocol::StatusMessageFlyweight statusMessage{sourceB.receiveBuffer(i), 0};
+            EXPECT_EQ(2048, statusMessage.consumptionTermOffset());
+            sessionIdsB.push_back(statusMessage.sessionId());
+        }
+
+        gettimeofday(&t1, NULL);
+    }
+    while ((sessionIdsA.size() < 2 || sessionIdsB.size() < 1) && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(std::vector<std::int32_t>({1, 3}), sessionIdsA);
+    EXPECT_EQ(std::vector<std::int32_t>({2}), sessionIdsB);
+}
+
+TEST_F(ChannelEndpointTest, sendsFromTermWithZeroCopyUntilReleased)
+{
+    const std::int32_t frameLength = 8000;
+    const std::int32_t alignedFrameLength = 8000;
+    const std::int32_t frameCount = 4;
+    const char* uri = "aeron:udp?endpoint=localhost:9046|zc=true";
+
+    driver::buffer::MappedRawLog rawLog{"./send-zero-copy.map", true, 1 << 16};
+    aeron::concurrent::AtomicBuffer& termBuffer = rawLog.termBuffer(0);
+
+    for (std::int32_t i = 0; i < frameCount; i++)
+    {
+        protocol::DataHeaderFlyweight header{termBuffer, i * alignedFrameLength};
+        header
+            .termOffset(i * alignedFrameLength)
+            .version(protocol::HeaderFlyweight::CURRENT_VERSION)
+            .type(protocol::HeaderFlyweight::HDR_TYPE_DATA)
+            .frameLength(frameLength);
+    }
+
+    std::unique_ptr<UdpChannel> receiveChannel = UdpChannel::parse(uri);
+    UdpChannelTransport receive{receiveChannel, &receiveChannel->remoteData(), &receiveChannel->remoteData(), nullptr};
+    SendChannelEndpoint send{std::move(UdpChannel::parse(uri))};
+
+    receive.openDatagramChannel();
+    send.openDatagramChannel();
+
+    if (!send.isZeroCopyEnabled())
+    {
+        return;
+    }
+
+    const std::int32_t consumed = send.sendFromTerm(termBuffer, 0, termBuffer.capacity(), alignedFrameLength);
+
+    EXPECT_EQ(frameCount * alignedFrameLength, consumed);
+    EXPECT_EQ(frameCount, (std::int32_t) send.zeroCopySequence());
+
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        receive.receiveBatch();
+        gettimeofday(&t1, NULL);
+    }
+    while (send.reapZeroCopyCompletions() != send.zeroCopySequence() && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(frameCount, (std::int32_t) send.reapZeroCopyCompletions());
+}
+
+static void sendDataFrame(
+    UdpChannelTransport& transport, std::int32_t sessionId, std::int32_t streamId, std::int32_t termId,
+    std::int32_t termOffset, std::int32_t frameLength, std::int32_t datagramLength)
+{
+    std::uint8_t bytes[2048] = {};
+    aeron::concurrent::AtomicBuffer buffer{bytes, datagramLength};
+    protocol::DataHeaderFlyweight header{buffer, 0};
+
+    header
+        .sessionId(sessionId)
+        .streamId(streamId)
+        .termId(termId)
+        .termOffset(termOffset)
+        .version(protocol::HeaderFlyweight::CURRENT_VERSION)
+        .type(protocol::HeaderFlyweight::HDR_TYPE_DATA)
+        .frameLength(frameLength);
+    buffer.putInt32(protocol::DataHeaderFlyweight::headerLength(), termOffset);
+
+    transport.send(bytes, datagramLength);
+}
+
+static void pollUntilHighWaterMark(ReceiveChannelEndpoint& receive, std::int64_t* hwm, std::int64_t position)
+{
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        receive.pollForData();
+        gettimeofday(&t1, NULL);
+    }
+    while (*hwm < position && t1.tv_sec - t0.tv_sec < 5);
+}
+
+TEST_F(ChannelEndpointTest, receivesInOrderFramesStraightIntoTermBuffer)
+{
+    const std::int32_t sessionId = 2;
+    const std::int32_t streamId = 3;
+    const std::int32_t termId = 5;
+    const std::int32_t frameLength = 1000;
+    const std::int32_t datagramLength = 1024;
+    const char* uri = "aeron:udp?endpoint=localhost:9045";
+
+    std::uint8_t counterBytes[4096] = {};
+    aeron::concurrent::AtomicBuffer countersBuffer{counterBytes, sizeof(counterBytes)};
+    aeron::concurrent::status::UnsafeBufferPosition hwmCounter{countersBuffer, 0};
+    std::int64_t* hwm = reinterpret_cast<std::int64_t*>(
+        counterBytes + aeron::concurrent::CountersManager::counterOffset(0));
+
+    std::unique_ptr<driver::buffer::MappedRawLog> rawLog{
+        new driver::buffer::MappedRawLog{"./receive-in-place.map", true, 1 << 16}};
+    aeron::concurrent::AtomicBuffer& termBuffer = rawLog->termBuffer(0);
+    driver::StaticFeedbackDelayGenerator delayGenerator{0, false};
+
+    std::shared_ptr<driver::PublicationImage> image = std::make_shared<driver::PublicationImage>(
+        1, 0, 0, sessionId, streamId, termId, termId, 0, 1 << 16, 0,
+        std::move(rawLog),
+        nullptr,
+        nullptr,
+        nullptr,
+        std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>>(
+            new std::vector<ReadablePosition<UnsafeBufferPosition>>()),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(hwmCounter)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<driver::CongestionControl>(new driver::StaticWindowCongestionControl()),
+        delayGenerator,
+        []() { return 0L; });
+
+    driver::Receiver receiver;
+    std::shared_ptr<driver::DataPacketDispatcher> dispatcher = std::make_shared<driver::DataPacketDispatcher>(
+        std::make_shared<driver::DriverConductorProxy>(), receiver);
+    dispatcher->addSubscription(streamId);
+    dispatcher->addPublicationImage(image);
+
+    std::unique_ptr<UdpChannel> sendChannel = UdpChannel::parse(uri);
+    UdpChannelTransport send{sendChannel, &sendChannel->remoteData(), &sendChannel->localData(), nullptr};
+    ReceiveChannelEndpoint receive{std::move(UdpChannel::parse(uri)), dispatcher};
+
+    receive.openDatagramChannel();
+    send.openDatagramChannel();
+
+    sendDataFrame(send, sessionId, streamId, termId, 0, frameLength, datagramLength);
+    pollUntilHighWaterMark(receive, hwm, datagramLength);
+
+    EXPECT_EQ(datagramLength, *hwm);
+    EXPECT_EQ(datagramLength, image->rebuildPosition());
+    EXPECT_EQ(frameLength, termBuffer.getInt32(0));
+    EXPECT_EQ(0, termBuffer.getInt32(protocol::DataHeaderFlyweight::headerLength()));
+    EXPECT_TRUE(nullptr != receive.receivedTarget(0));
+
+    sendDataFrame(send, sessionId, streamId, termId, datagramLength, frameLength, datagramLength);
+    pollUntilHighWaterMark(receive, hwm, 2 * datagramLength);
+
+    EXPECT_EQ(2 * datagramLength, image->rebuildPosition());
+    EXPECT_EQ(frameLength, termBuffer.getInt32(datagramLength));
+    EXPECT_EQ(datagramLength, termBuffer.getInt32(datagramLength + protocol::DataHeaderFlyweight::headerLength()));
+
+    sendDataFrame(send, sessionId, streamId, termId, 3 * datagramLength, frameLength, datagramLength);
+    pollUntilHighWaterMark(receive, hwm, 4 * datagramLength);
+
+    EXPECT_EQ(4 * datagramLength, *hwm);
+    EXPECT_EQ(2 * datagramLength, image->rebuildPosition());
+    EXPECT_TRUE(nullptr == receive.receivedTarget(0));
+    EXPECT_EQ(frameLength, termBuffer.getInt32(3 * datagramLength));
+    EXPECT_EQ(3 * datagramLength, termBuffer.getInt32(3 * datagramLength + protocol::DataHeaderFlyweight::headerLength()));
+
+    for (std::int32_t offset = 2 * datagramLength; offset < 3 * datagramLength; offset += 4)
+    {
+        ASSERT_EQ(0, termBuffer.getInt32(offset)) << "offset " << offset;
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/time.h>
+
+#include "../Mocks.h"
+#include "media/DataTransportPoller.h"
+
+using namespace aeron::driver::media;
+using namespace testing;
+
+static const std::int32_t ENDPOINT_COUNT = 8;
+static const std::int32_t BASE_PORT = 9051;
+
+class DataTransportPollerTest : public Test
+{
+public:
+    DataTransportPollerTest()
+    {
+        for (std::int32_t i = 0; i < ENDPOINT_COUNT; i++)
+        {
+            std::string uri = "aeron:udp?endpoint=localhost:" + std::to_string(BASE_PORT + i);
+            m_endpoints.emplace_back(new MockReceiveChannelEndpoint(UdpChannel::parse(uri.c_str())));
+            m_endpoints.back()->openDatagramChannel();
+        }
+
+        m_sendChannel = UdpChannel::parse("aeron:udp?endpoint=localhost:9059");
+        m_sender.reset(new UdpChannelTransport{
+            m_sendChannel, &m_sendChannel->remoteData(), &m_sendChannel->remoteData(), nullptr});
+        m_sender->openDatagramChannel();
+    }
+
+protected:
+    std::vector<std::unique_ptr<MockReceiveChannelEndpoint>> m_endpoints;
+    std::unique_ptr<UdpChannel> m_sendChannel;
+    std::unique_ptr<UdpChannelTransport> m_sender;
+
+    void sendTo(std::int32_t index)
+    {
+        std::uint8_t frame[64] = {};
+        std::string uri = "aeron:udp?endpoint=localhost:" + std::to_string(BASE_PORT + index);
+        std::unique_ptr<UdpChannel> channel = UdpChannel::parse(uri.c_str());
+        const InetAddress& address = channel->remoteData();
+
+        sendto(m_sender->receiveSocketFd(), frame, sizeof(frame), 0, address.address(), address.length());
+    }
+
+    std::int32_t pollUntilReceived(DataTransportPoller& poller)
+    {
+        std::int32_t bytesReceived = 0;
+        timeval t0;
+        timeval t1;
+        gettimeofday(&t0, NULL);
+
+        do
+        {
+            bytesReceived = poller.pollTransports();
+            gettimeofday(&t1, NULL);
+        }
+        while (0 == bytesReceived && t1.tv_sec - t0.tv_sec < 5);
+
+        return bytesReceived;
+    }
+};
+
+TEST_F(DataTransportPollerTest, shouldPollEveryEndpointWhenUnderIterationThreshold)
+{
+    DataTransportPoller poller{ENDPOINT_COUNT};
+
+    for (auto& endpoint : m_endpoints)
+    {
+        poller.registerForRead(*endpoint);
+        EXPECT_CALL(*endpoint, pollForData()).Times(1).WillOnce(Return(0));
+    }
+
+    EXPECT_EQ(0, poller.pollTransports());
+}
+
+TEST_F(DataTransportPollerTest, shouldOnlyPollReadableEndpointsOverIterationThreshold)
+{
+    DataTransportPoller poller{2};
+    const std::int32_t readable = 3;
+
+    for (std::int32_t i = 0; i < ENDPOINT_COUNT; i++)
+    {
+        poller.registerForRead(*m_endpoints[i]);
+
+        if (i == readable)
+        {
+            EXPECT_CALL(*m_endpoints[i], pollForData()).WillRepeatedly(Return(64));
+        }
+        else
+        {
+            EXPECT_CALL(*m_endpoints[i], pollForData()).Times(0);
+        }
+    }
+
+    EXPECT_EQ(0, poller.pollTransports());
+
+    sendTo(readable);
+
+    EXPECT_EQ(64, pollUntilReceived(poller));
+}
+
+TEST_F(DataTransportPollerTest, shouldStopPollingCancelledEndpoint)
+{
+    DataTransportPoller poller{2};
+
+    for (auto& endpoint : m_endpoints)
+    {
+        poller.registerForRead(*endpoint);
+    }
+
+    poller.cancelRead(*m_endpoints[0]);
+    EXPECT_EQ((std::size_t) (ENDPOINT_COUNT - 1), poller.transportCount());
+    EXPECT_CALL(*m_endpoints[0], pollForData()).Times(0);
+    EXPECT_CALL(*m_endpoints[1], pollForData()).WillRepeatedly(Return(64));
+
+    sendTo(0);
+    sendTo(1);
+
+    EXPECT_EQ(64, pollUntilReceived(poller));
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <concurrent/CountersManager.h>
+#include <protocol/DataHeaderFlyweight.h>
+
+#include "aeron/util/Exceptions.h"
+#include "buffer/MappedRawLog.h"
+#include "media/PacketRing.h"
+#include "media/PacketRingTransportPoller.h"
+#include "DataPacketDispatcher.h"
+#include "Receiver.h"
+
+#include "../GTestSkip.h"
+
+using namespace aeron;
+using namespace aeron::concurrent::status;
+using namespace aeron::driver::media;
+using namespace testing;
+
+static const std::uint16_t FILTERED_PORT = 9060;
+static const std::uint16_t UNFILTERED_PORT = 9061;
+static const std::uint16_t RECEIVER_PORT = 9062;
+
+class PacketRingTest : public Test
+{
+public:
+    PacketRingTest()
+    {
+        m_socketFd = socket(AF_INET, SOCK_DGRAM, 0);
+
+        try
+        {
+            m_ring.reset(new PacketRing("lo", 1 << 16, 4, 1));
+        }
+        catch (aeron::util::IOException& e)
+        {
+            m_unavailableReason = e.what();
+        }
+    }
+
+    ~PacketRingTest()
+    {
+        close(m_socketFd);
+    }
+
+protected:
+    int m_socketFd;
+    std::unique_ptr<PacketRing> m_ring;
+    std::string m_unavailableReason;
+
+    void sendTo(std::uint16_t port, const char* payload)
+    {
+        sendTo(port, payload, strlen(payload));
+    }
+
+    void sendTo(std::uint16_t port, const void* payload, std::size_t length)
+    {
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        sendto(m_socketFd, payload, length, 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    }
+
+    template <typename H>
+    std::int32_t pollFor(H&& handler, std::int32_t seconds)
+    {
+        std::int32_t datagrams = 0;
+        timeval t0;
+        timeval t1;
+        gettimeofday(&t0, NULL);
+
+        do
+        {
+            datagrams = m_ring->poll(handler, 4);
+            gettimeofday(&t1, NULL);
+        }
+        while (0 == datagrams && t1.tv_sec - t0.tv_sec < seconds);
+
+        return datagrams;
+    }
+};
+
+TEST_F(PacketRingTest, shouldReceiveDatagramsForFilteredPorts)
+{
+    if (!m_ring)
+    {
+        GTEST_SKIP() << "packet ring unavailable: " << m_unavailableReason;
+    }
+
+    m_ring->filterPorts({FILTERED_PORT});
+    sendTo(FILTERED_PORT, "ring-payload");
+
+    std::string received;
+    std::uint16_t receivedPort = 0;
+    std::uint32_t sourceAddress = 0;
+
+    const std::int32_t datagrams = pollFor(
+        [&](const std::uint8_t* payload, std::int32_t length, const sockaddr* source, std::uint16_t port)
+        {
+            received.assign(reinterpret_cast<const char*>(payload), (size_t) length);
+            receivedPort = port;
+            sourceAddress = ntohl(reinterpret_cast<const sockaddr_in*>(source)->sin_addr.s_addr);
+        },
+        5);
+
+    EXPECT_EQ(1, datagrams);
+    EXPECT_EQ("ring-payload", received);
+    EXPECT_EQ(FILTERED_PORT, receivedPort);
+    EXPECT_EQ((std::uint32_t) INADDR_LOOPBACK, sourceAddress);
+}
+
+TEST_F(PacketRingTest, shouldNotReceiveDatagramsForOtherPorts)
+{
+    if (!m_ring)
+    {
+        GTEST_SKIP() << "packet ring unavailable: " << m_unavailableReason;
+    }
+
+    m_ring->filterPorts({FILTERED_PORT});
+    sendTo(UNFILTERED_PORT, "ignored");
+    sendTo(FILTERED_PORT, "marker");
+
+    std::vector<std::uint16_t> ports;
+
+    pollFor(
+        [&](const std::uint8_t* payload, std::int32_t length, const sockaddr* source, std::uint16_t port)
+        {
+            ports.push_back(port);
+        },
+        5);
+
+    ASSERT_EQ(1u, ports.size());
+    EXPECT_EQ(FILTERED_PORT, ports[0]);
+}
+
+TEST_F(PacketRingTest, shouldReceiveForEndpointsOfReceiverFromRingInPlaceOfTheirSockets)
+{
+    if (!m_ring)
+    {
+        GTEST_SKIP() << "packet ring unavailable: " << m_unavailableReason;
+    }
+
+    const std::int32_t sessionId = 2;
+    const std::int32_t streamId = 3;
+    const std::int32_t termId = 5;
+    const std::int32_t frameLength = 1000;
+    const std::int32_t datagramLength = 1024;
+
+    std::uint8_t counterBytes[4096] = {};
+    aeron::concurrent::AtomicBuffer countersBuffer{counterBytes, sizeof(counterBytes)};
+    UnsafeBufferPosition hwmCounter{countersBuffer, 0};
+    std::int64_t* hwm =
+        reinterpret_cast<std::int64_t*>(counterBytes + aeron::concurrent::CountersManager::counterOffset(0));
+
+    std::unique_ptr<driver::buffer::MappedRawLog> rawLog{
+        new driver::buffer::MappedRawLog{"./packet-ring-receive.map", true, 1 << 16}};
+    driver::StaticFeedbackDelayGenerator delayGenerator{0, false};
+
+    std::shared_ptr<driver::PublicationImage> image = std::make_shared<driver::PublicationImage>(
+        1, 0, 0, sessionId, streamId, termId, termId, 0, 1 << 16, 0,
+        std::move(rawLog),
+        nullptr,
+        nullptr,
+        nullptr,
+        std::unique_ptr<std::vector<ReadablePosition<UnsafeBufferPosition>>>(
+            new std::vector<ReadablePosition<UnsafeBufferPosition>>()),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(new Position<UnsafeBufferPosition>(hwmCounter)),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<Position<UnsafeBufferPosition>>(nullptr),
+        std::unique_ptr<driver::CongestionControl>(new driver::StaticWindowCongestionControl()),
+        delayGenerator,
+        []() { return 0L; });
+
+    std::shared_ptr<driver::Receiver> receiver = std::make_shared<driver::Receiver>(
+        []() { return 0L; },
+        std::unique_ptr<PacketRingTransportPoller>(new PacketRingTransportPoller("lo", 1 << 16, 4, 1)));
+    std::shared_ptr<driver::DataPacketDispatcher> dispatcher = std::make_shared<driver::DataPacketDispatcher>(
+        std::make_shared<driver::DriverConductorProxy>(), *receiver);
+    dispatcher->addSubscription(streamId);
+    dispatcher->addPublicationImage(image);
+
+    ReceiveChannelEndpoint endpoint{UdpChannel::parse("aeron:udp?endpoint=localhost:9062"), dispatcher};
+    endpoint.openDatagramChannel();
+    receiver->onRegisterReceiveChannelEndpoint(endpoint);
+    EXPECT_TRUE(receiver->isPacketRingEnabled());
+
+    std::uint8_t bytes[datagramLength] = {};
+    aeron::concurrent::AtomicBuffer buffer{bytes, datagramLength};
+    protocol::DataHeaderFlyweight header{buffer, 0};
+    header
+        .sessionId(sessionId)
+        .streamId(streamId)
+        .termId(termId)
+        .termOffset(0)
+        .version(protocol::HeaderFlyweight::CURRENT_VERSION)
+        .type(protocol::HeaderFlyweight::HDR_TYPE_DATA)
+        .frameLength(frameLength);
+    sendTo(RECEIVER_PORT, bytes, sizeof(bytes));
+
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+    do
+    {
+        receiver->doWork();
+        gettimeofday(&t1, NULL);
+    }
+    while (*hwm < datagramLength && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(datagramLength, *hwm);
+    EXPECT_EQ(datagramLength, image->rebuildPosition());
+    EXPECT_EQ(0, endpoint.pollForData()) << "the socket of the endpoint is filtered while the ring receives for it";
+
+    receiver->onCloseReceiveChannelEndpoint(endpoint);
+}
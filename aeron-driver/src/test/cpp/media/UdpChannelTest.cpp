@@ -76,3 +76,76 @@ TEST_F(UdpChannelTest, createValidUnicastUdpChannel)
     EXPECT_EQ(*InetAddress::parse("localhost", AF_INET), channel->localInterface().address());
     EXPECT_FALSE(channel->isMulticast());
 }
+
+TEST_F(UdpChannelTest, parsesSegmentationOffloadParameter)
+{
+    auto withGso = UdpChannel::parse("aeron:udp?endpoint=localhost:40124|gso=true");
+    auto withoutGso = UdpChannel::parse("aeron:udp?endpoint=localhost:40124|gso=false");
+    auto byDefault = UdpChannel::parse("aeron:udp?endpoint=localhost:40124");
+
+    EXPECT_TRUE(withGso->isGso());
+    EXPECT_FALSE(withoutGso->isGso());
+    EXPECT_FALSE(byDefault->isGso());
+}
+
+TEST_F(UdpChannelTest, parsesReceiveOffloadParameter)
+{
+    auto withGro = UdpChannel::parse("aeron:udp?endpoint=localhost:40124|gro=true");
+    auto byDefault = UdpChannel::parse("aeron:udp?endpoint=localhost:40124");
+
+    EXPECT_TRUE(withGro->isGro());
+    EXPECT_FALSE(byDefault->isGro());
+    EXPECT_THROW(UdpChannel::parse("aeron:udp?endpoint=localhost:40124|gro=1"), InvalidChannelException);
+}
+
+TEST_F(UdpChannelTest, parsesZeroCopyParameter)
+{
+    auto withZeroCopy = UdpChannel::parse("aeron:udp?endpoint=localhost:40124|zc=true");
+    auto byDefault = UdpChannel::parse("aeron:udp?endpoint=localhost:40124");
+
+    EXPECT_TRUE(withZeroCopy->isZeroCopy());
+    EXPECT_FALSE(byDefault->isZeroCopy());
+    EXPECT_THROW(UdpChannel::parse("aeron:udp?endpoint=localhost:40124|zc=on"), InvalidChannelException);
+}
+
+TEST_F(UdpChannelTest, parsesFlowControlParameter)
+{
+    auto withMin = UdpChannel::parse("aeron:udp?endpoint=224.10.9.9:40124|interface=localhost|fc=min");
+    auto byDefault = UdpChannel::parse("aeron:udp?endpoint=224.10.9.9:40124|interface=localhost");
+
+    EXPECT_EQ(std::string(UdpChannel::MIN_FLOW_CONTROL), withMin->flowControl());
+    EXPECT_EQ("", byDefault->flowControl());
+    EXPECT_THROW(
+        UdpChannel::parse("aeron:udp?endpoint=224.10.9.9:40124|interface=localhost|fc=slowest"),
+        InvalidChannelException);
+}
+
+TEST_F(UdpChannelTest, parsesPacingParameters)
+{
+    auto withPacing = UdpChannel::parse("aeron:udp?endpoint=localhost:40124|pacing-rate=125000000|pacing-burst=65536");
+    auto byDefault = UdpChannel::parse("aeron:udp?endpoint=localhost:40124");
+
+    EXPECT_EQ(125000000, withPacing->pacingRate(0));
+    EXPECT_EQ(65536, withPacing->pacingBurstLength(4096));
+    EXPECT_EQ(0, byDefault->pacingRate(0));
+    EXPECT_EQ(4096, byDefault->pacingBurstLength(4096));
+    EXPECT_THROW(UdpChannel::parse("aeron:udp?endpoint=localhost:40124|pacing-rate=fast"), InvalidChannelException);
+    EXPECT_THROW(UdpChannel::parse("aeron:udp?endpoint=localhost:40124|pacing-burst=-1"), InvalidChannelException);
+}
+
+TEST_F(UdpChannelTest, parsesPriority)
+{
+    auto high = UdpChannel::parse("aeron:udp?endpoint=localhost:40124|priority=high");
+    auto low = UdpChannel::parse("aeron:udp?endpoint=localhost:40124|priority=low");
+    auto byDefault = UdpChannel::parse("aeron:udp?endpoint=localhost:40124");
+
+    EXPECT_EQ(UdpChannel::HIGH_PRIORITY, high->priority());
+    EXPECT_EQ(UdpChannel::LOW_PRIORITY, low->priority());
+    EXPECT_EQ("", byDefault->priority());
+    EXPECT_THROW(UdpChannel::parse("aeron:udp?endpoint=localhost:40124|priority=urgent"), InvalidChannelException);
+}
+
+TEST_F(UdpChannelTest, throwsExceptionOnInvalidSegmentationOffloadValue)
+{
+    EXPECT_THROW(UdpChannel::parse("aeron:udp?endpoint=localhost:40124|gso=yes"), InvalidChannelException);
+}
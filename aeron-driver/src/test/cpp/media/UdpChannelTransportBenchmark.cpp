@@ -0,0 +1,352 @@
+/*
+ * Copyright 2016 Real Logic Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <thread>
+#include <atomic>
+
+#include "aeron/util/Exceptions.h"
+#include "media/UdpChannel.h"
+#include "media/UdpChannelTransport.h"
+#include "media/PacketRing.h"
+
+using namespace aeron::driver::media;
+
+static const std::int32_t FRAME_LENGTH = 1408;
+static const std::int32_t FRAMES_PER_ITERATION = 32;
+
+static std::uint8_t frames[FRAME_LENGTH * FRAMES_PER_ITERATION];
+
+static void drain(UdpChannelTransport& transport, std::atomic<bool>& running)
+{
+    while (running)
+    {
+        transport.receiveBatch();
+    }
+}
+
+enum SendMode
+{
+    SEND_TO, SEND_MMSG, SEND_GSO, SEND_IO_URING
+};
+
+static void sendFrames(benchmark::State& state, SendMode mode, const char* receiveUri, const char* sendUri)
+{
+    std::unique_ptr<UdpChannel> receiveChannel = UdpChannel::parse(receiveUri);
+    std::unique_ptr<UdpChannel> sendChannel = UdpChannel::parse(sendUri);
+
+    UdpChannelTransport receiver{
+        receiveChannel, &receiveChannel->remoteData(), &receiveChannel->remoteData(), nullptr, 64};
+    UdpChannelTransport sender{
+        sendChannel, &sendChannel->remoteData(), &sendChannel->localData(), nullptr,
+        UdpChannelTransport::DEFAULT_RECEIVE_BATCH_SIZE, FRAMES_PER_ITERATION};
+
+    sender.segmentationOffload(SEND_GSO == mode);
+    sender.ioUring(SEND_IO_URING == mode);
+    receiver.openDatagramChannel();
+    sender.openDatagramChannel();
+
+    std::atomic<bool> running{true};
+    std::thread t{drain, std::ref(receiver), std::ref(running)};
+
+    std::int32_t shortSends = 0;
+
+    while (state.KeepRunning())
+    {
+        if (SEND_TO == mode)
+        {
+            for (std::int32_t i = 0; i < FRAMES_PER_ITERATION; i++)
+            {
+                sender.send(&frames[i * FRAME_LENGTH], FRAME_LENGTH);
+            }
+        }
+        else
+        {
+            for (std::int32_t i = 0; i < FRAMES_PER_ITERATION; i++)
+            {
+                sender.queueSend(&frames[i * FRAME_LENGTH], FRAME_LENGTH);
+            }
+
+            sender.sendQueued(&shortSends);
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * FRAME_LENGTH * FRAMES_PER_ITERATION);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * FRAMES_PER_ITERATION);
+
+    running.store(false);
+    t.join();
+}
+
+static void BM_SendTo(benchmark::State& state)
+{
+    sendFrames(state, SEND_TO, "aeron:udp?endpoint=localhost:9020", "aeron:udp?endpoint=localhost:9020|interface=localhost:9021");
+}
+BENCHMARK(BM_SendTo);
+
+static void BM_SendMmsg(benchmark::State& state)
+{
+    sendFrames(state, SEND_MMSG, "aeron:udp?endpoint=localhost:9022", "aeron:udp?endpoint=localhost:9022|interface=localhost:9023");
+}
+BENCHMARK(BM_SendMmsg);
+
+static void BM_SendGso(benchmark::State& state)
+{
+    sendFrames(state, SEND_GSO, "aeron:udp?endpoint=localhost:9024", "aeron:udp?endpoint=localhost:9024|interface=localhost:9025|gso=true");
+}
+BENCHMARK(BM_SendGso);
+
+static void BM_SendIoUring(benchmark::State& state)
+{
+    sendFrames(state, SEND_IO_URING, "aeron:udp?endpoint=localhost:9034", "aeron:udp?endpoint=localhost:9034|interface=localhost:9035");
+}
+BENCHMARK(BM_SendIoUring);
+
+static const std::int32_t LARGE_FRAMES_PER_ITERATION = 16;
+static const std::int32_t LARGE_FRAME_ITERATIONS_IN_FLIGHT = 8;
+
+static std::uint8_t largeFrames[65536 * LARGE_FRAMES_PER_ITERATION * LARGE_FRAME_ITERATIONS_IN_FLIGHT];
+
+/*
+ * Copying sends against MSG_ZEROCOPY sends over a range of datagram lengths to find where zero-copy starts to pay.
+ * Frames rotate through enough memory that the kernel is done with it before it comes round again, as the term
+ * buffers would. The label gives the share of zero-copy sends the kernel ended up copying, which is all of them on
+ * loopback so the crossover can only be seen over a NIC.
+ */
+static void sendLargeFrames(benchmark::State& state, bool zeroCopy, const char* receiveUri, const char* sendUri)
+{
+    const std::int32_t frameLength = static_cast<std::int32_t>(state.range_x());
+    std::unique_ptr<UdpChannel> receiveChannel = UdpChannel::parse(receiveUri);
+    std::unique_ptr<UdpChannel> sendChannel = UdpChannel::parse(sendUri);
+
+    UdpChannelTransport receiver{
+        receiveChannel, &receiveChannel->remoteData(), &receiveChannel->remoteData(), nullptr, 64};
+    UdpChannelTransport sender{
+        sendChannel, &sendChannel->remoteData(), &sendChannel->localData(), nullptr,
+        UdpChannelTransport::DEFAULT_RECEIVE_BATCH_SIZE, LARGE_FRAMES_PER_ITERATION};
+
+    sender.zeroCopy(zeroCopy);
+    receiver.openDatagramChannel();
+    sender.openDatagramChannel();
+
+    std::atomic<bool> running{true};
+    std::thread t{drain, std::ref(receiver), std::ref(running)};
+
+    std::int32_t shortSends = 0;
+    std::int64_t round = 0;
+
+    while (state.KeepRunning())
+    {
+        std::uint8_t* frames =
+            &largeFrames[(round++ % LARGE_FRAME_ITERATIONS_IN_FLIGHT) * 65536 * LARGE_FRAMES_PER_ITERATION];
+
+        for (std::int32_t i = 0; i < LARGE_FRAMES_PER_ITERATION; i++)
+        {
+            sender.queueSend(&frames[i * frameLength], frameLength);
+        }
+
+        sender.sendQueued(&shortSends, true);
+        sender.reapZeroCopyCompletions();
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * frameLength * LARGE_FRAMES_PER_ITERATION);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * LARGE_FRAMES_PER_ITERATION);
+
+    if (sender.isZeroCopyEnabled() && 0 != sender.zeroCopySequence())
+    {
+        state.SetLabel(std::to_string(sender.zeroCopyCopiedCount() * 100 / sender.zeroCopySequence()) + "% copied");
+    }
+
+    running.store(false);
+    t.join();
+}
+
+static void BM_SendCopy(benchmark::State& state)
+{
+    sendLargeFrames(state, false, "aeron:udp?endpoint=localhost:9047", "aeron:udp?endpoint=localhost:9047|interface=localhost:9048");
+}
+BENCHMARK(BM_SendCopy)->Arg(1408)->Arg(4096)->Arg(8192)->Arg(16384)->Arg(32768)->Arg(63000);
+
+static void BM_SendZeroCopy(benchmark::State& state)
+{
+    sendLargeFrames(state, true, "aeron:udp?endpoint=localhost:9049", "aeron:udp?endpoint=localhost:9049|interface=localhost:9050");
+}
+BENCHMARK(BM_SendZeroCopy)->Arg(1408)->Arg(4096)->Arg(8192)->Arg(16384)->Arg(32768)->Arg(63000);
+
+static void sendOne(UdpChannelTransport& transport, std::uint8_t* frame)
+{
+    std::int32_t shortSends = 0;
+
+    transport.queueSend(frame, FRAME_LENGTH);
+    transport.sendQueued(&shortSends);
+}
+
+static void awaitOne(UdpChannelTransport& transport)
+{
+    while (0 == transport.receiveBatch())
+    {
+    }
+}
+
+static void pingPong(benchmark::State& state, bool ioUring, const char* pingUri, const char* pongUri)
+{
+    std::unique_ptr<UdpChannel> pingChannel = UdpChannel::parse(pingUri);
+    std::unique_ptr<UdpChannel> pongChannel = UdpChannel::parse(pongUri);
+
+    UdpChannelTransport ping{pingChannel, &pingChannel->remoteData(), &pingChannel->localData(), nullptr, 1, 1};
+    UdpChannelTransport pong{pongChannel, &pongChannel->remoteData(), &pongChannel->localData(), nullptr, 1, 1};
+
+    ping.ioUring(ioUring);
+    pong.ioUring(ioUring);
+    ping.openDatagramChannel();
+    pong.openDatagramChannel();
+
+    while (state.KeepRunning())
+    {
+        sendOne(ping, &frames[0]);
+        awaitOne(pong);
+        sendOne(pong, &frames[FRAME_LENGTH]);
+        awaitOne(ping);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+static void BM_PingPongSocket(benchmark::State& state)
+{
+    pingPong(state, false,
+        "aeron:udp?endpoint=localhost:9036|interface=localhost:9037",
+        "aeron:udp?endpoint=localhost:9037|interface=localhost:9036");
+}
+BENCHMARK(BM_PingPongSocket);
+
+static void BM_PingPongIoUring(benchmark::State& state)
+{
+    pingPong(state, true,
+        "aeron:udp?endpoint=localhost:9038|interface=localhost:9039",
+        "aeron:udp?endpoint=localhost:9039|interface=localhost:9038");
+}
+BENCHMARK(BM_PingPongIoUring);
+
+static void sendBurst(UdpChannelTransport& transport, std::int32_t burst)
+{
+    std::int32_t shortSends = 0;
+
+    for (std::int32_t i = 0; i < burst; i++)
+    {
+        transport.queueSend(&frames[i * FRAME_LENGTH], FRAME_LENGTH);
+    }
+
+    transport.sendQueued(&shortSends);
+}
+
+static void receiveLatency(benchmark::State& state, std::int32_t batchSize, const char* receiveUri, const char* sendUri)
+{
+    std::unique_ptr<UdpChannel> receiveChannel = UdpChannel::parse(receiveUri);
+    std::unique_ptr<UdpChannel> sendChannel = UdpChannel::parse(sendUri);
+    const std::int32_t burst = static_cast<std::int32_t>(state.range_x());
+
+    UdpChannelTransport receiver{
+        receiveChannel, &receiveChannel->remoteData(), &receiveChannel->remoteData(), nullptr, batchSize};
+    UdpChannelTransport sender{
+        sendChannel, &sendChannel->remoteData(), &sendChannel->localData(), nullptr,
+        UdpChannelTransport::DEFAULT_RECEIVE_BATCH_SIZE, FRAMES_PER_ITERATION};
+
+    receiver.openDatagramChannel();
+    sender.openDatagramChannel();
+
+    while (state.KeepRunning())
+    {
+        sendBurst(sender, burst);
+
+        for (std::int32_t received = 0; received < burst;)
+        {
+            received += receiver.receiveBatch();
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * burst));
+}
+
+static void BM_ReceiveLatencySocket(benchmark::State& state)
+{
+    receiveLatency(state, 1,
+        "aeron:udp?endpoint=localhost:9062", "aeron:udp?endpoint=localhost:9062|interface=localhost:9063");
+}
+BENCHMARK(BM_ReceiveLatencySocket)->Arg(1)->Arg(FRAMES_PER_ITERATION);
+
+static void BM_ReceiveLatencyRecvMmsg(benchmark::State& state)
+{
+    receiveLatency(state, FRAMES_PER_ITERATION,
+        "aeron:udp?endpoint=localhost:9064", "aeron:udp?endpoint=localhost:9064|interface=localhost:9065");
+}
+BENCHMARK(BM_ReceiveLatencyRecvMmsg)->Arg(1)->Arg(FRAMES_PER_ITERATION);
+
+static void BM_ReceiveLatencyPacketRing(benchmark::State& state)
+{
+    std::unique_ptr<UdpChannel> receiveChannel = UdpChannel::parse("aeron:udp?endpoint=localhost:9066");
+    std::unique_ptr<UdpChannel> sendChannel = UdpChannel::parse(
+        "aeron:udp?endpoint=localhost:9066|interface=localhost:9067");
+    const std::int32_t burst = static_cast<std::int32_t>(state.range_x());
+
+    // the socket holds the port so the datagrams are not refused, its copies are left to overflow
+    UdpChannelTransport receiver{
+        receiveChannel, &receiveChannel->remoteData(), &receiveChannel->remoteData(), nullptr, 1};
+    UdpChannelTransport sender{
+        sendChannel, &sendChannel->remoteData(), &sendChannel->localData(), nullptr,
+        UdpChannelTransport::DEFAULT_RECEIVE_BATCH_SIZE, FRAMES_PER_ITERATION};
+
+    receiver.openDatagramChannel();
+    sender.openDatagramChannel();
+
+    std::unique_ptr<PacketRing> ring;
+    try
+    {
+        ring.reset(new PacketRing("lo"));
+        ring->filterPorts({9066});
+    }
+    catch (aeron::util::IOException&)
+    {
+        state.SetLabel("packet ring unavailable");
+    }
+
+    std::int32_t received = 0;
+    auto onDatagram =
+        [&](const std::uint8_t* payload, std::int32_t length, const sockaddr* source, std::uint16_t port)
+        {
+            received++;
+        };
+
+    while (state.KeepRunning())
+    {
+        if (!ring)
+        {
+            continue;
+        }
+
+        sendBurst(sender, burst);
+
+        for (received = 0; received < burst;)
+        {
+            ring->poll(onDatagram, PacketRing::DEFAULT_BLOCK_COUNT);
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * burst));
+}
+BENCHMARK(BM_ReceiveLatencyPacketRing)->Arg(1)->Arg(FRAMES_PER_ITERATION);
+
+BENCHMARK_MAIN();
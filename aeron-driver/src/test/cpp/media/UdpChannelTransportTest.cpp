@@ -14,12 +14,20 @@
  * limitations under the License.
  */
 
+#include <array>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <sys/time.h>
+#include <concurrent/AtomicCounter.h>
+#include <concurrent/CountersManager.h>
 #include "media/InetAddress.h"
 #include "media/UdpChannel.h"
 #include "media/UdpChannelTransport.h"
 
+#include "../GTestSkip.h"
+
+using namespace aeron::concurrent;
 using namespace aeron::driver::media;
 
 class UdpChannelTransportTest : public testing::Test
@@ -133,3 +141,436 @@ TEST_F(UdpChannelTransportTest, sendAndReceiveUnicastIPv6)
     EXPECT_GT(received, 0);
     EXPECT_STREQ(message, receiveBuffer);
 }
+
+TEST_F(UdpChannelTransportTest, receiveBatchOfUnicastIPv4Datagrams)
+{
+    const std::int32_t messageCount = 5;
+    in_addr any {INADDR_ANY};
+
+    std::unique_ptr<UdpChannel> channel = UdpChannel::parse("aeron:udp?endpoint=localhost:9012|interface=localhost:9011");
+
+    Inet4Address* bindAddress = new Inet4Address{any, channel->remoteData().port()};
+    std::uint16_t port = channel->remoteData().port();
+    UdpChannelTransport transport{channel, &channel->remoteData(), bindAddress, &channel->localData(), 8};
+
+    transport.openDatagramChannel();
+
+    for (std::int32_t i = 0; i < messageCount; i++)
+    {
+        std::int32_t message = i;
+        transport.send(&message, sizeof(message));
+    }
+
+    std::int32_t received = 0;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        const std::int32_t batchStart = received;
+        const std::int32_t count = transport.receiveBatch();
+
+        for (std::int32_t i = 0; i < count; i++)
+        {
+            EXPECT_EQ((std::int32_t) sizeof(std::int32_t), transport.receiveLength(i));
+            EXPECT_EQ(batchStart + i, transport.receiveBuffer(i).getInt32(0));
+            EXPECT_EQ(port, transport.receiveAddress(i).port());
+        }
+
+        received += count;
+        gettimeofday(&t1, NULL);
+    }
+    while (received < messageCount && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(messageCount, received);
+    EXPECT_EQ(messageCount, transport.datagramsReceivedCount());
+    EXPECT_GE(transport.receiveBatchCount(), 1);
+    EXPECT_LE(transport.receiveBatchCount(), messageCount);
+}
+
+TEST_F(UdpChannelTransportTest, receiveBatchOfDatagramsLargerThanDefaultMtu)
+{
+    const std::int32_t datagramLength = 9000;
+    std::vector<std::uint8_t> datagram((size_t) datagramLength, 7);
+    in_addr any {INADDR_ANY};
+
+    std::unique_ptr<UdpChannel> channel = UdpChannel::parse("aeron:udp?endpoint=localhost:9041|interface=localhost:9040");
+
+    Inet4Address* bindAddress = new Inet4Address{any, channel->remoteData().port()};
+    UdpChannelTransport transport{channel, &channel->remoteData(), bindAddress, &channel->localData(), 4};
+
+    transport.openDatagramChannel();
+    transport.send(&datagram[0], datagramLength);
+
+    std::int32_t received = 0;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        received = transport.receiveBatch();
+        gettimeofday(&t1, NULL);
+    }
+    while (0 == received && t1.tv_sec - t0.tv_sec < 5);
+
+    ASSERT_EQ(1, received);
+    EXPECT_EQ(datagramLength, transport.receiveLength(0));
+    EXPECT_EQ(7, transport.receiveBuffer(0).getUInt8(datagramLength - 1));
+}
+
+TEST_F(UdpChannelTransportTest, sendQueuedBatchOfUnicastIPv4Datagrams)
+{
+    const std::int32_t sendBatchSize = 4;
+    std::int32_t messages[sendBatchSize] = { 10, 11, 12, 13 };
+    in_addr any {INADDR_ANY};
+
+    std::unique_ptr<UdpChannel> channel = UdpChannel::parse("aeron:udp?endpoint=localhost:9014|interface=localhost:9013");
+
+    Inet4Address* bindAddress = new Inet4Address{any, channel->remoteData().port()};
+    UdpChannelTransport transport{
+        channel, &channel->remoteData(), bindAddress, &channel->localData(), sendBatchSize, sendBatchSize};
+
+    transport.openDatagramChannel();
+
+    for (std::int32_t i = 0; i < sendBatchSize; i++)
+    {
+        EXPECT_TRUE(transport.queueSend(&messages[i], sizeof(std::int32_t)));
+    }
+
+    EXPECT_FALSE(transport.queueSend(&messages[0], sizeof(std::int32_t)));
+    EXPECT_EQ(sendBatchSize, transport.queuedSendCount());
+
+    std::int32_t shortSends = -1;
+    std::int32_t bytesSent = transport.sendQueued(&shortSends);
+
+    EXPECT_EQ((std::int32_t) sizeof(messages), bytesSent);
+    EXPECT_EQ(0, shortSends);
+    EXPECT_EQ(0, transport.queuedSendCount());
+
+    std::int32_t received = 0;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        const std::int32_t count = transport.receiveBatch();
+
+        for (std::int32_t i = 0; i < count; i++)
+        {
+            EXPECT_EQ(messages[received + i], transport.receiveBuffer(i).getInt32(0));
+        }
+
+        received += count;
+        gettimeofday(&t1, NULL);
+    }
+    while (received < sendBatchSize && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(sendBatchSize, received);
+}
+
+TEST_F(UdpChannelTransportTest, countSendAndReceiveBatchesInCounters)
+{
+    const std::int32_t batchSize = 4;
+    std::int32_t messages[batchSize] = { 20, 21, 22, 23 };
+    in_addr any {INADDR_ANY};
+
+    std::array<std::uint8_t, 4096> metaDataBytes;
+    std::array<std::uint8_t, 1024> valuesBytes;
+    AtomicBuffer metaDataBuffer{&metaDataBytes[0], metaDataBytes.size()};
+    AtomicBuffer valuesBuffer{&valuesBytes[0], valuesBytes.size()};
+    CountersManager countersManager{metaDataBuffer, valuesBuffer};
+    AtomicCounter receiveBatches{valuesBuffer, countersManager.allocate("receive batches"), countersManager};
+    AtomicCounter datagramsReceived{valuesBuffer, countersManager.allocate("datagrams received"), countersManager};
+    AtomicCounter sendBatches{valuesBuffer, countersManager.allocate("send batches"), countersManager};
+    AtomicCounter datagramsSent{valuesBuffer, countersManager.allocate("datagrams sent"), countersManager};
+
+    std::unique_ptr<UdpChannel> channel = UdpChannel::parse("aeron:udp?endpoint=localhost:9032|interface=localhost:9031");
+
+    Inet4Address* bindAddress = new Inet4Address{any, channel->remoteData().port()};
+    UdpChannelTransport transport{
+        channel, &channel->remoteData(), bindAddress, &channel->localData(), batchSize, batchSize};
+
+    transport.receiveBatchCounters(&receiveBatches, &datagramsReceived);
+    transport.sendBatchCounters(&sendBatches, &datagramsSent);
+    transport.openDatagramChannel();
+
+    for (std::int32_t i = 0; i < batchSize; i++)
+    {
+        EXPECT_TRUE(transport.queueSend(&messages[i], sizeof(std::int32_t)));
+    }
+
+    std::int32_t shortSends = -1;
+    EXPECT_EQ((std::int32_t) sizeof(messages), transport.sendQueued(&shortSends));
+    EXPECT_GE(sendBatches.get(), 1);
+    EXPECT_EQ(batchSize, datagramsSent.get());
+
+    std::int32_t received = 0;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        received += transport.receiveBatch();
+        gettimeofday(&t1, NULL);
+    }
+    while (received < batchSize && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(batchSize, received);
+    EXPECT_EQ(transport.receiveBatchCount(), receiveBatches.get());
+    EXPECT_EQ(batchSize, datagramsReceived.get());
+}
+
+TEST_F(UdpChannelTransportTest, sendSegmentedRunOfEqualLengthDatagrams)
+{
+    const std::int32_t frameLength = 256;
+    const std::int32_t frameCount = 6;
+    const std::int32_t lastFrameLength = 64;
+    std::uint8_t frames[frameLength * frameCount];
+    in_addr any {INADDR_ANY};
+
+    for (std::int32_t i = 0; i < frameCount; i++)
+    {
+        memset(&frames[i * frameLength], i + 1, frameLength);
+    }
+
+    std::unique_ptr<UdpChannel> channel = UdpChannel::parse(
+        "aeron:udp?endpoint=localhost:9016|interface=localhost:9015|gso=true");
+
+    Inet4Address* bindAddress = new Inet4Address{any, channel->remoteData().port()};
+    UdpChannelTransport transport{channel, &channel->remoteData(), bindAddress, &channel->localData(), 8, 8};
+
+    transport.segmentationOffload(transport.udpChannel().isGso());
+    transport.openDatagramChannel();
+
+    for (std::int32_t i = 0; i < frameCount - 1; i++)
+    {
+        EXPECT_TRUE(transport.queueSend(&frames[i * frameLength], frameLength));
+    }
+    EXPECT_TRUE(transport.queueSend(&frames[(frameCount - 1) * frameLength], lastFrameLength));
+
+    std::int32_t shortSends = -1;
+    std::int32_t bytesSent = transport.sendQueued(&shortSends);
+
+    EXPECT_EQ(0, shortSends);
+    EXPECT_EQ(((frameCount - 1) * frameLength) + lastFrameLength, bytesSent);
+
+    std::int32_t received = 0;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        const std::int32_t count = transport.receiveBatch();
+
+        for (std::int32_t i = 0; i < count; i++)
+        {
+            const std::int32_t frameIndex = received + i;
+            const std::int32_t expectedLength = frameIndex < frameCount - 1 ? frameLength : lastFrameLength;
+
+            EXPECT_EQ(expectedLength, transport.receiveLength(i));
+            EXPECT_EQ(frameIndex + 1, transport.receiveBuffer(i).getUInt8(expectedLength - 1));
+        }
+
+        received += count;
+        gettimeofday(&t1, NULL);
+    }
+    while (received < frameCount && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(frameCount, received);
+}
+
+TEST_F(UdpChannelTransportTest, receiveCoalescedSegmentsSentWithSegmentationOffload)
+{
+    const std::int32_t frameLength = 512;
+    const std::int32_t frameCount = 4;
+    std::uint8_t frames[frameLength * frameCount];
+    in_addr any {INADDR_ANY};
+
+    for (std::int32_t i = 0; i < frameCount; i++)
+    {
+        memset(&frames[i * frameLength], i + 1, frameLength);
+    }
+
+    std::unique_ptr<UdpChannel> channel = UdpChannel::parse(
+        "aeron:udp?endpoint=localhost:9018|interface=localhost:9017|gso=true|gro=true");
+
+    Inet4Address* bindAddress = new Inet4Address{any, channel->remoteData().port()};
+    UdpChannelTransport transport{channel, &channel->remoteData(), bindAddress, &channel->localData(), 8, 8};
+
+    transport.segmentationOffload(true);
+    transport.openDatagramChannel();
+
+    for (std::int32_t i = 0; i < frameCount; i++)
+    {
+        transport.queueSend(&frames[i * frameLength], frameLength);
+    }
+
+    std::int32_t shortSends = -1;
+    transport.sendQueued(&shortSends);
+    EXPECT_EQ(0, shortSends);
+
+    std::int32_t segmentsReceived = 0;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        const std::int32_t count = transport.receiveBatch();
+
+        for (std::int32_t i = 0; i < count; i++)
+        {
+            const std::int32_t length = transport.receiveLength(i);
+            const std::int32_t segmentLength = transport.receiveSegmentLength(i);
+
+            EXPECT_EQ(frameLength, segmentLength);
+
+            for (std::int32_t offset = 0; offset < length; offset += segmentLength)
+            {
+                EXPECT_EQ(segmentsReceived + 1, transport.receiveBuffer(i).getUInt8(offset));
+                segmentsReceived++;
+            }
+        }
+
+        gettimeofday(&t1, NULL);
+    }
+    while (segmentsReceived < frameCount && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(frameCount, segmentsReceived);
+    EXPECT_LE(transport.datagramsReceivedCount(), frameCount);
+}
+
+TEST_F(UdpChannelTransportTest, sendRestWithoutSegmentationOffloadWhenRejectedAfterEarlierMessagesWent)
+{
+    const std::int32_t firstFrameLength = 64;
+    const std::int32_t frameLength = 256;
+    const std::int32_t frameCount = 3;
+    std::uint8_t frames[firstFrameLength + (frameLength * frameCount)];
+    in_addr any {INADDR_ANY};
+
+    memset(frames, 1, firstFrameLength);
+    for (std::int32_t i = 0; i < frameCount; i++)
+    {
+        memset(&frames[firstFrameLength + (i * frameLength)], i + 2, frameLength);
+    }
+
+    std::unique_ptr<UdpChannel> channel = UdpChannel::parse(
+        "aeron:udp?endpoint=localhost:9030|interface=localhost:9029|gso=true");
+
+    Inet4Address* bindAddress = new Inet4Address{any, channel->remoteData().port()};
+    UdpChannelTransport transport{channel, &channel->remoteData(), bindAddress, &channel->localData(), 8, 8};
+
+    transport.segmentationOffload(true);
+    transport.openDatagramChannel();
+
+    if (!transport.isGsoEnabled())
+    {
+        GTEST_SKIP() << "UDP segmentation offload unavailable";
+    }
+
+    // the kernel rejects segmented sends without checksums, the single datagram in the first message still goes
+    const int yes = 1;
+    ASSERT_EQ(0, setsockopt(transport.receiveSocketFd(), SOL_SOCKET, SO_NO_CHECK, &yes, sizeof(yes)));
+
+    EXPECT_TRUE(transport.queueSend(frames, firstFrameLength));
+    for (std::int32_t i = 0; i < frameCount; i++)
+    {
+        EXPECT_TRUE(transport.queueSend(&frames[firstFrameLength + (i * frameLength)], frameLength));
+    }
+
+    std::int32_t shortSends = -1;
+    std::int32_t bytesSent = transport.sendQueued(&shortSends);
+
+    EXPECT_EQ(0, shortSends);
+    EXPECT_EQ(firstFrameLength + (frameCount * frameLength), bytesSent);
+    EXPECT_FALSE(transport.isGsoEnabled());
+
+    std::int32_t received = 0;
+    timeval t0;
+    timeval t1;
+    gettimeofday(&t0, NULL);
+
+    do
+    {
+        const std::int32_t count = transport.receiveBatch();
+
+        for (std::int32_t i = 0; i < count; i++)
+        {
+            const std::int32_t frameIndex = received + i;
+
+            EXPECT_EQ(0 == frameIndex ? firstFrameLength : frameLength, transport.receiveLength(i));
+            EXPECT_EQ(frameIndex + 1, transport.receiveBuffer(i).getUInt8(0));
+        }
+
+        received += count;
+        gettimeofday(&t1, NULL);
+    }
+    while (received < frameCount + 1 && t1.tv_sec - t0.tv_sec < 5);
+
+    EXPECT_EQ(frameCount + 1, received);
+}
+
+TEST_F(UdpChannelTransportTest, sendAndReceiveBatchThroughIoUring)
+{
+    const std::int32_t sendBatchSize = 8;
+    const std::int32_t rounds = 4;
+    std::int32_t messages[sendBatchSize];
+    in_addr any {INADDR_ANY};
+
+    std::unique_ptr<UdpChannel> channel = UdpChannel::parse("aeron:udp?endpoint=localhost:9028|interface=localhost:9027");
+
+    Inet4Address* bindAddress = new Inet4Address{any, channel->remoteData().port()};
+    std::uint16_t port = channel->remoteData().port();
+    UdpChannelTransport transport{
+        channel, &channel->remoteData(), bindAddress, &channel->localData(), sendBatchSize, sendBatchSize};
+
+    transport.ioUring(true);
+    transport.openDatagramChannel();
+
+    if (!transport.isIoUringEnabled())
+    {
+        GTEST_SKIP() << "io_uring multishot receive unavailable, the transport kept the socket calls";
+    }
+
+    std::int32_t received = 0;
+
+    for (std::int32_t round = 0; round < rounds; round++)
+    {
+        for (std::int32_t i = 0; i < sendBatchSize; i++)
+        {
+            messages[i] = (round * sendBatchSize) + i;
+            EXPECT_TRUE(transport.queueSend(&messages[i], sizeof(std::int32_t)));
+        }
+
+        std::int32_t shortSends = -1;
+        EXPECT_EQ((std::int32_t) sizeof(messages), transport.sendQueued(&shortSends));
+        EXPECT_EQ(0, shortSends);
+
+        timeval t0;
+        timeval t1;
+        gettimeofday(&t0, NULL);
+
+        do
+        {
+            const std::int32_t count = transport.receiveBatch();
+
+            for (std::int32_t i = 0; i < count; i++)
+            {
+                EXPECT_EQ((std::int32_t) sizeof(std::int32_t), transport.receiveLength(i));
+                EXPECT_EQ(received + i, transport.receiveBuffer(i).getInt32(0));
+                EXPECT_EQ(port, transport.receiveAddress(i).port());
+            }
+
+            received += count;
+            gettimeofday(&t1, NULL);
+        }
+        while (received < (round + 1) * sendBatchSize && t1.tv_sec - t0.tv_sec < 5);
+    }
+
+    EXPECT_EQ(rounds * sendBatchSize, received);
+}